@@ -0,0 +1,125 @@
+#include "async.h"
+
+namespace mt
+{
+
+// ========== 线程池调度器 ==========
+ThreadPoolScheduler::ThreadPoolScheduler(unsigned int threads)
+    : ThreadPoolScheduler(threads, {})
+{
+}
+
+ThreadPoolScheduler::ThreadPoolScheduler(unsigned int threads, std::function<void()> threadInit)
+    : m_threadInit(std::move(threadInit)), m_idle(0), m_stopping(false)
+{
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 2;
+    }
+    m_workers.reserve(threads);
+    for (unsigned int i = 0; i < threads; ++i) {
+        m_workers.emplace_back([this] {
+            if (m_threadInit) m_threadInit();
+            WorkerLoop();
+        });
+    }
+    m_timerThread = std::thread([this] { TimerLoop(); });
+}
+
+ThreadPoolScheduler::~ThreadPoolScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_workCond.notify_all();
+    m_timerCond.notify_all();
+
+    m_timerThread.join();
+    for (std::thread& t : m_workers) t.join();
+}
+
+void ThreadPoolScheduler::AddWorker()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stopping) return;
+    m_workers.emplace_back([this] {
+        if (m_threadInit) m_threadInit();
+        WorkerLoop();
+    });
+}
+
+unsigned int ThreadPoolScheduler::ThreadCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (unsigned int)m_workers.size();
+}
+
+void ThreadPoolScheduler::Post(std::function<void()> fn)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(fn));
+    }
+    m_workCond.notify_one();
+}
+
+void ThreadPoolScheduler::PostAfter(std::chrono::milliseconds delay, std::function<void()> fn)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) return;
+        m_timers.emplace(std::chrono::steady_clock::now() + delay, std::move(fn));
+    }
+    m_timerCond.notify_one();
+}
+
+void ThreadPoolScheduler::WorkerLoop()
+{
+    for (;;) {
+        std::function<void()> fn;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            ++m_idle;
+            m_workCond.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+            --m_idle;
+            // 退出前先清空队列，保证已提交的协程都能跑完
+            if (m_queue.empty()) return;
+            fn = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        fn();
+    }
+}
+
+void ThreadPoolScheduler::TimerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopping) {
+        if (m_timers.empty()) {
+            m_timerCond.wait(lock);
+            continue;
+        }
+        auto first = m_timers.begin();
+        if (std::chrono::steady_clock::now() < first->first) {
+            m_timerCond.wait_until(lock, first->first);
+            continue;
+        }
+        std::function<void()> fn = std::move(first->second);
+        m_timers.erase(first);
+        if (m_idle > m_queue.size()) {
+            // 到期：有空闲工作线程时转入工作队列执行
+            m_queue.push_back(std::move(fn));
+            m_workCond.notify_one();
+        } else {
+            // 看门狗：工作线程全部被占用（可能卡在某个驱动调用里）时，
+            // 超时回调不能排在它们后面，由定时线程直接执行
+            lock.unlock();
+            fn();
+            lock.lock();
+        }
+    }
+    m_timers.clear();
+}
+
+} // namespace mt
@@ -0,0 +1,421 @@
+#ifndef ASYNC_H
+#define ASYNC_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// ========== C++20 协程异步采集基础设施 ==========
+// Task<T>      : 惰性协程任务，co_await 时才开始执行
+// Scheduler    : 可替换的调度器（线程池 / 内联）
+// WhenAll      : 并发等待一组任务
+// WithTimeout  : 单个任务的超时，超时返回 std::nullopt，迟到的结果被丢弃
+// SyncWait     : 在普通线程中阻塞等待任务完成
+// 不依赖 wxWidgets，可嵌入其它程序。
+namespace mt
+{
+
+// ===== 调度器接口 =====
+class Scheduler
+{
+public:
+    virtual ~Scheduler() = default;
+
+    virtual void Post(std::function<void()> fn) = 0;
+    // 到期回调应当短小（通常只唤醒等待方）：线程池忙满时它会在定时线程上直接执行
+    virtual void PostAfter(std::chrono::milliseconds delay, std::function<void()> fn) = 0;
+
+    // co_await scheduler.Schedule() → 切换到调度器线程继续执行
+    struct ScheduleAwaiter
+    {
+        Scheduler& scheduler;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { scheduler.Post([h] { h.resume(); }); }
+        void await_resume() const noexcept {}
+    };
+    ScheduleAwaiter Schedule() { return ScheduleAwaiter{*this}; }
+};
+
+// ===== 内联调度器：在调用线程立即执行，定时器从不触发 =====
+// 任务总是先于超时完成，结果确定，适合测试与同步调用
+class InlineScheduler : public Scheduler
+{
+public:
+    void Post(std::function<void()> fn) override { fn(); }
+    void PostAfter(std::chrono::milliseconds, std::function<void()>) override {}
+};
+
+// ===== 线程池调度器 =====
+class ThreadPoolScheduler : public Scheduler
+{
+public:
+    explicit ThreadPoolScheduler(unsigned int threads = 0);  // 0 = 硬件并发数
+    // threadInit 在每个工作线程开始取任务之前调用（设置优先级、亲和性等）
+    ThreadPoolScheduler(unsigned int threads, std::function<void()> threadInit);
+    ~ThreadPoolScheduler() override;  // 执行完已排队任务后退出，未到期定时器丢弃
+
+    ThreadPoolScheduler(const ThreadPoolScheduler&) = delete;
+    ThreadPoolScheduler& operator=(const ThreadPoolScheduler&) = delete;
+
+    void Post(std::function<void()> fn) override;
+    void PostAfter(std::chrono::milliseconds delay, std::function<void()> fn) override;
+
+    // 增加一个工作线程（同样先调用 threadInit）。用于替换卡在不返回的调用里、已被放弃的线程，
+    // 使线程池的可用并发度不因此下降；析构开始后调用无效
+    void AddWorker();
+    unsigned int ThreadCount() const;
+
+
+private:
+    void WorkerLoop();
+    void TimerLoop();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_workCond;
+    std::condition_variable m_timerCond;
+    std::deque<std::function<void()>> m_queue;
+    std::multimap<std::chrono::steady_clock::time_point, std::function<void()>> m_timers;
+    std::vector<std::thread> m_workers;
+    std::thread m_timerThread;
+    std::function<void()> m_threadInit;
+    size_t m_idle;     // 正在等待任务的工作线程数
+    bool m_stopping;
+};
+
+template <typename T> class Task;
+
+namespace detail
+{
+    struct PromiseBase
+    {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr error;
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // 完成时对称转移到等待者，避免深递归
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept { return false; }
+            template <typename P>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept
+            {
+                std::coroutine_handle<> next = h.promise().continuation;
+                return next ? next : std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    // 即发即弃协程：立即开始，结束时自行销毁
+    struct Detached
+    {
+        struct promise_type
+        {
+            Detached get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+}
+
+// ===== Task<T> =====
+template <typename T>
+class Task
+{
+public:
+    struct promise_type : detail::PromiseBase
+    {
+        std::optional<T> value;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        template <typename U>
+        void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+
+        T Result()
+        {
+            if (error) std::rethrow_exception(error);
+            return std::move(*value);
+        }
+    };
+
+    Task() = default;
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            if (m_handle) m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { if (m_handle) m_handle.destroy(); }
+
+    bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        m_handle.promise().continuation = awaiting;
+        return m_handle;
+    }
+    T await_resume() { return m_handle.promise().Result(); }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> h) : m_handle(h) {}
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+template <>
+class Task<void>
+{
+public:
+    struct promise_type : detail::PromiseBase
+    {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        void return_void() noexcept {}
+
+        void Result()
+        {
+            if (error) std::rethrow_exception(error);
+        }
+    };
+
+    Task() = default;
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            if (m_handle) m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { if (m_handle) m_handle.destroy(); }
+
+    bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        m_handle.promise().continuation = awaiting;
+        return m_handle;
+    }
+    void await_resume() { m_handle.promise().Result(); }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> h) : m_handle(h) {}
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+// ===== WhenAll：并发启动全部任务，全部完成后按原顺序返回结果 =====
+// 任一任务抛出异常时，等待全部结束后重新抛出第一个异常
+namespace detail
+{
+    template <typename T>
+    struct WhenAllState
+    {
+        std::atomic<size_t> remaining;
+        std::coroutine_handle<> awaiting;
+        std::vector<Task<T>> tasks;
+        std::vector<std::optional<T>> results;
+        std::mutex errorMutex;
+        std::exception_ptr error;
+
+        // 最后一个到达者负责恢复等待者
+        bool Arrive() { return remaining.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+    };
+
+    template <typename T>
+    Detached RunWhenAllItem(Task<T> task, std::shared_ptr<WhenAllState<T>> state, size_t index)
+    {
+        try {
+            state->results[index].emplace(co_await std::move(task));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(state->errorMutex);
+            if (!state->error) state->error = std::current_exception();
+        }
+        if (state->Arrive()) state->awaiting.resume();
+    }
+
+    // 等待器只持有共享状态（任务放在状态中），可被编译器安全地复制
+    template <typename T>
+    struct WhenAllAwaiter
+    {
+        std::shared_ptr<WhenAllState<T>> state;
+
+        bool await_ready() const noexcept { return state->tasks.empty(); }
+        bool await_suspend(std::coroutine_handle<> h)
+        {
+            // 多计一次：本函数自身也是一个到达者，防止任务同步完成时提前恢复
+            std::shared_ptr<WhenAllState<T>> st = state;
+            size_t count = st->tasks.size();
+            st->awaiting = h;
+            st->remaining.store(count + 1, std::memory_order_relaxed);
+            for (size_t i = 0; i < count; ++i) {
+                RunWhenAllItem(std::move(st->tasks[i]), st, i);
+            }
+            return !st->Arrive();
+        }
+        std::vector<T> await_resume()
+        {
+            if (state->error) std::rethrow_exception(state->error);
+            std::vector<T> out;
+            out.reserve(state->results.size());
+            for (std::optional<T>& r : state->results) out.push_back(std::move(*r));
+            return out;
+        }
+    };
+}
+
+template <typename T>
+Task<std::vector<T>> WhenAll(std::vector<Task<T>> tasks)
+{
+    auto state = std::make_shared<detail::WhenAllState<T>>();
+    state->results.resize(tasks.size());
+    state->tasks = std::move(tasks);
+    // 命名等待器而非临时对象：规避 GCC 对协程中临时等待器重复析构的问题
+    detail::WhenAllAwaiter<T> awaiter{state};
+    co_return co_await awaiter;
+}
+
+// ===== WithTimeout：在期限内完成返回结果，否则返回 std::nullopt =====
+// 超时后原任务继续在后台运行至结束，其结果被丢弃
+namespace detail
+{
+    template <typename T>
+    struct TimeoutState
+    {
+        std::atomic<bool> decided{false};  // 任务完成或超时，先到者胜出
+        std::atomic<int> arrivals{2};      // 胜出者 + 挂起方
+        std::coroutine_handle<> awaiting;
+        Task<T> task;
+        std::optional<T> value;
+        std::exception_ptr error;
+
+        void Win()
+        {
+            if (arrivals.fetch_sub(1, std::memory_order_acq_rel) == 1) awaiting.resume();
+        }
+    };
+
+    template <typename T>
+    Detached RunTimed(Task<T> task, std::shared_ptr<TimeoutState<T>> state)
+    {
+        std::optional<T> value;
+        std::exception_ptr error;
+        try {
+            value.emplace(co_await std::move(task));
+        } catch (...) {
+            error = std::current_exception();
+        }
+        if (!state->decided.exchange(true, std::memory_order_acq_rel)) {
+            state->value = std::move(value);
+            state->error = error;
+            state->Win();
+        }
+    }
+
+    template <typename T>
+    struct TimeoutAwaiter
+    {
+        Scheduler& scheduler;
+        std::chrono::milliseconds timeout;
+        std::shared_ptr<TimeoutState<T>> state;
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h)
+        {
+            std::shared_ptr<TimeoutState<T>> st = state;
+            st->awaiting = h;
+            RunTimed(std::move(st->task), st);
+            if (!st->decided.load(std::memory_order_acquire)) {
+                scheduler.PostAfter(timeout, [st] {
+                    if (!st->decided.exchange(true, std::memory_order_acq_rel)) st->Win();
+                });
+            }
+            return st->arrivals.fetch_sub(1, std::memory_order_acq_rel) != 1;
+        }
+        std::optional<T> await_resume()
+        {
+            if (state->error) std::rethrow_exception(state->error);
+            return std::move(state->value);
+        }
+    };
+}
+
+template <typename T>
+Task<std::optional<T>> WithTimeout(Scheduler& scheduler, Task<T> task, std::chrono::milliseconds timeout)
+{
+    auto state = std::make_shared<detail::TimeoutState<T>>();
+    state->task = std::move(task);
+    detail::TimeoutAwaiter<T> awaiter{scheduler, timeout, state};
+    co_return co_await awaiter;
+}
+
+// ===== 在调度器线程上执行阻塞函数 =====
+template <typename F>
+auto Offload(Scheduler& scheduler, F fn) -> Task<decltype(fn())>
+{
+    co_await scheduler.Schedule();
+    co_return fn();
+}
+
+// ===== SyncWait：阻塞当前线程直到任务完成 =====
+namespace detail
+{
+    template <typename T>
+    struct SyncWaitState
+    {
+        std::mutex mutex;
+        std::condition_variable cond;
+        bool done = false;
+        std::optional<T> value;
+        std::exception_ptr error;
+    };
+
+    template <typename T>
+    Detached RunSyncWait(Task<T> task, SyncWaitState<T>* state)
+    {
+        try {
+            state->value.emplace(co_await std::move(task));
+        } catch (...) {
+            state->error = std::current_exception();
+        }
+        // 持锁通知：等待方返回（并销毁 state）前必须重新获得锁
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->done = true;
+        state->cond.notify_one();
+    }
+}
+
+template <typename T>
+T SyncWait(Task<T> task)
+{
+    detail::SyncWaitState<T> state;
+    detail::RunSyncWait(std::move(task), &state);
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.cond.wait(lock, [&state] { return state.done; });
+    if (state.error) std::rethrow_exception(state.error);
+    return std::move(*state.value);
+}
+
+} // namespace mt
+
+#endif // ASYNC_H
@@ -0,0 +1,643 @@
+#include "audit.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <glob.h>
+    #include <net/if.h>
+    #include <sys/ioctl.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+    #include <linux/ethtool.h>
+    #include <linux/sockios.h>
+#endif
+
+namespace audit
+{
+
+const char* SeverityName(Severity severity)
+{
+    switch (severity) {
+        case Severity::Info: return "info";
+        case Severity::Warning: return "warning";
+        case Severity::Critical: return "critical";
+    }
+    return "";
+}
+
+// ========== 内置规则包 ==========
+// 来源在本机不存在的规则自动跳过：同一份规则包在各平台通用
+const char* DefaultRules()
+{
+    return R"(
+[cpu-governor]
+severity = warning
+title = CPU 频率调节器不是 performance
+source = /sys/devices/system/cpu/cpu*/cpufreq/scaling_governor
+expect = equals performance
+advice = cpupower frequency-set -g performance，或使用 tuned 的 throughput-performance / latency-performance
+
+[cpu-epp]
+severity = info
+title = 能耗性能偏好（EPP）不是 performance
+source = /sys/devices/system/cpu/cpu*/cpufreq/energy_performance_preference
+expect = equals performance
+advice = 向各核心的 cpufreq/energy_performance_preference 写入 performance
+
+[thp-enabled]
+severity = warning
+title = 透明大页为 always，可能引起延迟抖动与内存膨胀
+source = /sys/kernel/mm/transparent_hugepage/enabled
+expect = selected one-of madvise,never
+advice = 内核参数 transparent_hugepage=madvise，需要大页的程序自行 madvise
+
+[thp-defrag]
+severity = info
+title = 透明大页同步整理（defrag=always）会在缺页时阻塞
+source = /sys/kernel/mm/transparent_hugepage/defrag
+expect = selected none-of always
+advice = 向 /sys/kernel/mm/transparent_hugepage/defrag 写入 defer+madvise
+
+[cstate-limit]
+severity = info
+title = 未限制深度 C-state，空闲核心的唤醒延迟可达数百微秒
+source = /sys/module/intel_idle/parameters/max_cstate
+expect = max 1
+advice = 延迟敏感的主机加内核参数 intel_idle.max_cstate=1 processor.max_cstate=1
+
+[nic-rx-ring]
+severity = warning
+title = 网卡 RX 环小于硬件最大值，突发流量下容易丢包
+source = net:rx-ring
+expect = min-fact net:rx-ring-max
+advice = ethtool -G <网卡> rx <最大值>
+
+[nic-irq-spread]
+severity = warning
+title = 网卡中断集中在同一个 CPU 上
+source = net:irq-affinity
+expect = distinct-min 2
+when = snapshot:LogicalProcessors min 2
+advice = 启用 irqbalance，或把各队列的 /proc/irq/<n>/smp_affinity_list 分散到网卡所在 NUMA 节点的核心
+
+[numa-balancing]
+severity = info
+title = 多 NUMA 节点主机开启了自动 NUMA 平衡，已绑核的负载会受页迁移干扰
+source = /proc/sys/kernel/numa_balancing
+expect = equals 0
+when = snapshot:NumaNodes[1].Id present
+advice = 负载已按节点绑定时 sysctl kernel.numa_balancing=0
+
+[swappiness]
+severity = info
+title = swappiness 偏高，内存压力下会较早换出匿名页
+source = /proc/sys/vm/swappiness
+expect = max 10
+advice = sysctl vm.swappiness=10（写入 /etc/sysctl.d/）
+
+[memory-speed]
+severity = warning
+title = 内存运行频率低于额定频率
+source = snapshot:MemorySpeed
+expect = min-fact snapshot:MemoryRatedSpeed
+advice = 检查 BIOS 中的 XMP / EXPO 设置与内存插法（每通道条数多时会降频）
+
+[windows-power-plan]
+severity = warning
+title = 电源计划不是“高性能”或“卓越性能”
+source = reg:HKLM\SYSTEM\CurrentControlSet\Control\Power\User\PowerSchemes\ActivePowerScheme
+expect = one-of 8c5e7fda-e8bf-4a96-9a85-a6e23a8c635c,e9a42b02-d5df-448d-aa00-03f14749eb61
+advice = powercfg /setactive SCHEME_MIN
+)";
+}
+
+// ========== 规则解析 ==========
+namespace
+{
+#ifdef _WIN32
+    std::wstring Widen(const std::string& str)
+    {
+        int n = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0);
+        if (n <= 1) return std::wstring();
+        std::wstring out(n - 1, L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, &out[0], n);
+        return out;
+    }
+
+    std::string Narrow(const std::wstring& str)
+    {
+        int n = WideCharToMultiByte(CP_UTF8, 0, str.c_str(), (int)str.size(), nullptr, 0, nullptr, nullptr);
+        std::string out(n > 0 ? n : 0, '\0');
+        if (n > 0) WideCharToMultiByte(CP_UTF8, 0, str.c_str(), (int)str.size(), &out[0], n, nullptr, nullptr);
+        return out;
+    }
+#endif
+
+    std::string Trim(const std::string& s)
+    {
+        size_t begin = 0, end = s.size();
+        while (begin < end && (unsigned char)s[begin] <= ' ') ++begin;
+        while (end > begin && (unsigned char)s[end - 1] <= ' ') --end;
+        return s.substr(begin, end - begin);
+    }
+
+    std::vector<std::string> Split(const std::string& s, char sep)
+    {
+        std::vector<std::string> parts;
+        size_t pos = 0;
+        while (pos <= s.size()) {
+            size_t end = s.find(sep, pos);
+            if (end == std::string::npos) end = s.size();
+            std::string part = Trim(s.substr(pos, end - pos));
+            if (!part.empty()) parts.push_back(std::move(part));
+            pos = end + 1;
+        }
+        return parts;
+    }
+
+    bool ParseNumber(const std::string& s, double* out)
+    {
+        const char* begin = s.c_str();
+        char* end;
+        *out = strtod(begin, &end);
+        return end != begin;
+    }
+
+    bool ParseSeverity(const std::string& text, Severity* out)
+    {
+        if (text == "info") *out = Severity::Info;
+        else if (text == "warning") *out = Severity::Warning;
+        else if (text == "critical") *out = Severity::Critical;
+        else return false;
+        return true;
+    }
+
+    // "[来源] [selected] op 参数"；失败时返回错误说明
+    std::string ParseExpect(const std::string& text, bool withSource, Expect* out)
+    {
+        std::vector<std::string> tokens = Split(text, ' ');
+        size_t i = 0;
+        if (withSource) {
+            if (i >= tokens.size()) return "missing source";
+            out->source = tokens[i++];
+        }
+        if (i < tokens.size() && tokens[i] == "selected") {
+            out->selected = true;
+            ++i;
+        }
+        if (i >= tokens.size()) return "missing operator";
+        out->op = tokens[i++];
+        for (; i < tokens.size(); ++i) out->arg += (out->arg.empty() ? "" : " ") + tokens[i];
+
+        double number;
+        const std::string& op = out->op;
+        if (op == "present") return out->arg.empty() ? std::string() : "present takes no argument";
+        if (op == "min" || op == "max" || op == "distinct-min") {
+            return ParseNumber(out->arg, &number) ? std::string() : op + " needs a number";
+        }
+        if (op == "equals" || op == "not-equals" || op == "one-of" || op == "none-of" || op == "min-fact") {
+            return out->arg.empty() ? op + " needs an argument" : std::string();
+        }
+        return "unknown operator '" + op + "'";
+    }
+
+    bool ValidId(const std::string& id)
+    {
+        if (id.empty() || id.size() > 64) return false;
+        for (char c : id) {
+            bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.';
+            if (!ok) return false;
+        }
+        return true;
+    }
+}
+
+void ParseRules(const std::string& text, const std::string& origin, std::vector<Rule>* rules,
+                std::vector<std::string>* errors)
+{
+    Rule rule;
+    bool open = false;
+    bool broken = false;
+    bool hasExpect = false;
+    size_t ruleLine = 0;
+
+    auto error = [&](size_t line, const std::string& message) {
+        errors->push_back(origin + ":" + std::to_string(line) + ": " + message);
+    };
+    auto finish = [&] {
+        if (!open) return;
+        if (!broken && (rule.source.empty() || !hasExpect)) {
+            error(ruleLine, "rule " + rule.id + " needs source and expect");
+            broken = true;
+        }
+        if (!broken) {
+            if (rule.title.empty()) rule.title = rule.id;
+            auto it = std::find_if(rules->begin(), rules->end(), [&](const Rule& r) { return r.id == rule.id; });
+            if (it != rules->end()) *it = std::move(rule);
+            else rules->push_back(std::move(rule));
+        }
+        rule = Rule();
+        open = broken = hasExpect = false;
+    };
+
+    size_t lineNo = 0;
+    size_t pos = 0;
+    while (pos <= text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string::npos) end = text.size();
+        std::string line = Trim(text.substr(pos, end - pos));
+        pos = end + 1;
+        ++lineNo;
+        if (line.empty() || line[0] == '#') continue;
+
+        if (line.front() == '[') {
+            finish();
+            open = true;
+            ruleLine = lineNo;
+            rule.id = line.back() == ']' ? Trim(line.substr(1, line.size() - 2)) : std::string();
+            if (!ValidId(rule.id)) {
+                error(lineNo, "invalid rule id " + line);
+                broken = true;
+            }
+            continue;
+        }
+        size_t eq = line.find('=');
+        if (!open || eq == std::string::npos) {
+            error(lineNo, "expected [rule-id] or key = value");
+            continue;
+        }
+        std::string key = Trim(line.substr(0, eq));
+        std::string value = Trim(line.substr(eq + 1));
+        std::string problem;
+        if (key == "severity") {
+            if (!ParseSeverity(value, &rule.severity)) problem = "unknown severity '" + value + "'";
+        } else if (key == "title") {
+            rule.title = value;
+        } else if (key == "source") {
+            rule.source = value;
+        } else if (key == "expect") {
+            problem = ParseExpect(value, false, &rule.expect);
+            hasExpect = problem.empty();
+        } else if (key == "when") {
+            Expect when;
+            problem = ParseExpect(value, true, &when);
+            if (problem.empty()) rule.when = when;
+        } else if (key == "advice") {
+            rule.advice = value;
+        } else {
+            problem = "unknown key '" + key + "'";
+        }
+        if (!problem.empty()) {
+            error(lineNo, rule.id + ": " + problem);
+            broken = true;
+        }
+    }
+    finish();
+}
+
+bool LoadRuleFile(const std::string& path, std::vector<Rule>* rules, std::vector<std::string>* errors)
+{
+#ifdef _WIN32
+    FILE* f = _wfopen(Widen(path).c_str(), L"rb");
+#else
+    FILE* f = fopen(path.c_str(), "rbe");
+#endif
+    if (!f) return false;
+    std::string text;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0 && text.size() < (1u << 20)) text.append(buf, n);
+    bool failed = ferror(f) != 0;
+    fclose(f);
+    if (failed) {
+        errors->push_back(path + ": read failed");
+        return true;
+    }
+    ParseRules(text, path, rules, errors);
+    return true;
+}
+
+// ========== 批量读取 ==========
+void Facts::Add(const std::string& source, std::string name, std::string value)
+{
+    m_sources[source].push_back(Item{ std::move(name), std::move(value) });
+}
+
+const std::vector<Item>* Facts::Find(const std::string& source) const
+{
+    auto it = m_sources.find(source);
+    return it == m_sources.end() ? nullptr : &it->second;
+}
+
+void Facts::Load(const std::vector<Rule>& rules)
+{
+    std::set<std::string> sources;
+    for (const Rule& rule : rules) {
+        sources.insert(rule.source);
+        if (rule.expect.op == "min-fact") sources.insert(rule.expect.arg);
+        if (rule.when) {
+            sources.insert(rule.when->source);
+            if (rule.when->op == "min-fact") sources.insert(rule.when->arg);
+        }
+    }
+    for (const std::string& source : sources) {
+        if (source.compare(0, 9, "snapshot:") == 0 || m_sources.count(source)) continue;
+        m_sources[source];   // 读不到也记为已读：同一来源不再重试
+        loadSource(source);
+    }
+}
+
+#ifdef _WIN32
+
+namespace
+{
+    // "reg:HKLM\路径\值名"：字符串取原文，DWORD 取十进制
+    bool ReadRegistry(const std::string& spec, std::string* out)
+    {
+        std::wstring path = Widen(spec.substr(4));
+        HKEY root;
+        if (path.compare(0, 5, L"HKLM\\") == 0) root = HKEY_LOCAL_MACHINE;
+        else if (path.compare(0, 5, L"HKCU\\") == 0) root = HKEY_CURRENT_USER;
+        else return false;
+        size_t slash = path.find_last_of(L'\\');
+        if (slash <= 4) return false;
+        std::wstring subkey = path.substr(5, slash - 5);
+        std::wstring name = path.substr(slash + 1);
+
+        wchar_t text[512];
+        DWORD size = sizeof(text);
+        DWORD type = 0;
+        if (RegGetValueW(root, subkey.c_str(), name.c_str(), RRF_RT_REG_SZ | RRF_RT_REG_DWORD, &type, text, &size) != ERROR_SUCCESS) {
+            return false;
+        }
+        if (type == REG_DWORD) {
+            DWORD value;
+            memcpy(&value, text, sizeof(value));
+            *out = std::to_string(value);
+        } else {
+            *out = Narrow(std::wstring(text, wcsnlen(text, size / sizeof(wchar_t))));
+        }
+        return true;
+    }
+}
+
+void Facts::loadSource(const std::string& source)
+{
+    std::string value;
+    if (source.compare(0, 4, "reg:") == 0 && ReadRegistry(source, &value)) Add(source, source.substr(4), Trim(value));
+}
+
+std::string DefaultRuleFile()
+{
+    wchar_t module[MAX_PATH];
+    DWORD n = GetModuleFileNameW(nullptr, module, MAX_PATH);
+    if (n == 0 || n == MAX_PATH) return "audit.rules";
+    std::wstring path(module, n);
+    size_t slash = path.find_last_of(L"\\/");
+    return Narrow((slash == std::wstring::npos ? std::wstring() : path.substr(0, slash + 1)) + L"audit.rules");
+}
+
+#else
+
+namespace
+{
+    bool ReadText(const std::string& path, std::string* out)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        char buf[4096];
+        ssize_t n = read(fd, buf, sizeof(buf));
+        close(fd);
+        if (n < 0) return false;
+        *out = Trim(std::string(buf, (size_t)n));
+        return true;
+    }
+
+    // 有 device 链接的才是物理网卡（排除 lo、网桥、veth）
+    std::vector<std::string> PhysicalInterfaces()
+    {
+        std::vector<std::string> names;
+        DIR* d = opendir("/sys/class/net");
+        if (!d) return names;
+        while (dirent* entry = readdir(d)) {
+            if (entry->d_name[0] == '.') continue;
+            std::string device = std::string("/sys/class/net/") + entry->d_name + "/device";
+            if (access(device.c_str(), F_OK) == 0) names.push_back(entry->d_name);
+        }
+        closedir(d);
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+}
+
+void Facts::loadSource(const std::string& source)
+{
+    if (!source.empty() && source[0] == '/') {
+        glob_t matches;
+        if (glob(source.c_str(), 0, nullptr, &matches) == 0) {
+            std::string value;
+            for (size_t i = 0; i < matches.gl_pathc; ++i) {
+                if (ReadText(matches.gl_pathv[i], &value)) Add(source, matches.gl_pathv[i], value);
+            }
+        }
+        globfree(&matches);
+        return;
+    }
+
+    if (source == "net:rx-ring" || source == "net:rx-ring-max") {
+        // 两个来源一次 ioctl 取得
+        m_sources["net:rx-ring"];
+        m_sources["net:rx-ring-max"];
+        int sock = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (sock < 0) return;
+        for (const std::string& name : PhysicalInterfaces()) {
+            ethtool_ringparam ring = {};
+            ring.cmd = ETHTOOL_GRINGPARAM;
+            ifreq req = {};
+            strncpy(req.ifr_name, name.c_str(), IFNAMSIZ - 1);
+            req.ifr_data = reinterpret_cast<char*>(&ring);
+            if (ioctl(sock, SIOCETHTOOL, &req) != 0 || ring.rx_max_pending == 0) continue;
+            Add("net:rx-ring", name, std::to_string(ring.rx_pending));
+            Add("net:rx-ring-max", name, std::to_string(ring.rx_max_pending));
+        }
+        close(sock);
+        return;
+    }
+
+    if (source == "net:irq-affinity") {
+        // 网卡的 MSI/MSI-X 中断号在 device/msi_irqs 下，实际生效的亲和性在 /proc/irq/<n>/effective_affinity_list。
+        // smp_affinity_list 只是允许的范围（默认全部 CPU），不能代替：内核不提供生效值（4.15 之前，
+        // 或中断控制器不支持）时整个来源留空，规则随之跳过，而不是按允许范围误判为已分散
+        std::vector<std::pair<std::string, std::string>> found;
+        for (const std::string& name : PhysicalInterfaces()) {
+            DIR* d = opendir(("/sys/class/net/" + name + "/device/msi_irqs").c_str());
+            if (!d) continue;
+            std::vector<int> irqs;
+            while (dirent* entry = readdir(d)) {
+                if (entry->d_name[0] >= '0' && entry->d_name[0] <= '9') irqs.push_back(atoi(entry->d_name));
+            }
+            closedir(d);
+            std::sort(irqs.begin(), irqs.end());
+            for (int irq : irqs) {
+                std::string base = "/proc/irq/" + std::to_string(irq) + "/";
+                std::string value;
+                if (!ReadText(base + "effective_affinity_list", &value)) return;
+                found.emplace_back(name + " irq " + std::to_string(irq), value);
+            }
+        }
+        for (auto& item : found) Add(source, item.first, item.second);
+    }
+}
+
+std::string DefaultRuleFile()
+{
+    char exe[4096];
+    ssize_t n = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    if (n <= 0) return "audit.rules";
+    std::string path(exe, (size_t)n);
+    size_t slash = path.rfind('/');
+    return (slash == std::string::npos ? std::string() : path.substr(0, slash + 1)) + "audit.rules";
+}
+
+#endif
+
+// ========== 求值 ==========
+namespace
+{
+    // "always [madvise] never" → "madvise"；没有方括号时原样返回
+    std::string Selected(const std::string& value)
+    {
+        size_t open = value.find('[');
+        size_t close = open == std::string::npos ? open : value.find(']', open);
+        return close == std::string::npos ? value : value.substr(open + 1, close - open - 1);
+    }
+
+    const Item* Counterpart(const std::vector<Item>* items, const std::string& name)
+    {
+        if (!items || items->empty()) return nullptr;
+        for (const Item& item : *items) {
+            if (item.name == name) return &item;
+        }
+        return items->size() == 1 ? &items->front() : nullptr;
+    }
+
+    // 各项是否满足期望；不满足的项写入 violations（可为 nullptr）
+    bool Holds(const Expect& expect, const std::vector<Item>& items, const Facts& facts,
+               std::vector<std::string>* violations)
+    {
+        const std::string& op = expect.op;
+        if (op == "present") return !items.empty();
+
+        if (op == "distinct-min") {
+            std::set<std::string> values;
+            for (const Item& item : items) values.insert(expect.selected ? Selected(item.value) : item.value);
+            double need = 0;
+            ParseNumber(expect.arg, &need);
+            if ((double)values.size() >= need) return true;
+            if (violations) {
+                std::string list;
+                for (const std::string& value : values) list += (list.empty() ? "" : ", ") + value;
+                violations->push_back(std::to_string(items.size()) + " items, distinct values: " + list);
+            }
+            return false;
+        }
+
+        std::vector<std::string> list = (op == "one-of" || op == "none-of") ? Split(expect.arg, ',') : std::vector<std::string>();
+        double limit = 0;
+        bool numeric = (op == "min" || op == "max") && ParseNumber(expect.arg, &limit);
+        const std::vector<Item>* reference = op == "min-fact" ? facts.Find(expect.arg) : nullptr;
+
+        bool ok = true;
+        for (const Item& item : items) {
+            std::string value = expect.selected ? Selected(item.value) : item.value;
+            std::string shown = item.name + "=" + value;
+            bool pass = true;
+            double number;
+            if (op == "equals") {
+                pass = value == expect.arg;
+            } else if (op == "not-equals") {
+                pass = value != expect.arg;
+            } else if (op == "one-of") {
+                pass = std::find(list.begin(), list.end(), value) != list.end();
+            } else if (op == "none-of") {
+                pass = std::find(list.begin(), list.end(), value) == list.end();
+            } else if (numeric) {
+                // 不是数值的项不参与判断
+                if (!ParseNumber(value, &number)) continue;
+                pass = op == "min" ? number >= limit : number <= limit;
+            } else if (op == "min-fact") {
+                const Item* other = Counterpart(reference, item.name);
+                double bound;
+                if (!other || !ParseNumber(value, &number) || !ParseNumber(other->value, &bound)) continue;
+                pass = number >= bound;
+                shown += " < " + other->value;
+            }
+            if (!pass) {
+                ok = false;
+                if (violations) violations->push_back(std::move(shown));
+            }
+        }
+        return ok;
+    }
+
+    std::string JoinViolations(const std::vector<std::string>& violations)
+    {
+        const size_t shown = 4;
+        std::string detail;
+        for (size_t i = 0; i < violations.size() && i < shown; ++i) {
+            if (!detail.empty()) detail += "; ";
+            detail += violations[i];
+        }
+        if (violations.size() > shown) detail += "; (+" + std::to_string(violations.size() - shown) + " more)";
+        return detail;
+    }
+
+    mt::Task<std::optional<Finding>> EvaluateTask(mt::Scheduler& scheduler, const Rule& rule, const Facts& facts)
+    {
+        co_await scheduler.Schedule();
+        co_return Evaluate(rule, facts);
+    }
+}
+
+std::optional<Finding> Evaluate(const Rule& rule, const Facts& facts)
+{
+    if (rule.when) {
+        const std::vector<Item>* items = facts.Find(rule.when->source);
+        if (!items || items->empty() || !Holds(*rule.when, *items, facts, nullptr)) return std::nullopt;
+    }
+    const std::vector<Item>* items = facts.Find(rule.source);
+    if (!items || items->empty()) return std::nullopt;
+
+    std::vector<std::string> violations;
+    if (Holds(rule.expect, *items, facts, &violations)) return std::nullopt;
+
+    Finding finding;
+    finding.rule = rule.id;
+    finding.severity = rule.severity;
+    finding.title = rule.title;
+    finding.detail = JoinViolations(violations);
+    finding.advice = rule.advice;
+    return finding;
+}
+
+mt::Task<std::vector<Finding>> EvaluateAll(mt::Scheduler& scheduler, const std::vector<Rule>& rules, const Facts& facts)
+{
+    std::vector<mt::Task<std::optional<Finding>>> tasks;
+    for (const Rule& rule : rules) tasks.push_back(EvaluateTask(scheduler, rule, facts));
+    std::vector<std::optional<Finding>> results = co_await mt::WhenAll(std::move(tasks));
+
+    std::vector<Finding> findings;
+    for (std::optional<Finding>& result : results) {
+        if (result) findings.push_back(std::move(*result));
+    }
+    co_return findings;
+}
+
+} // namespace audit
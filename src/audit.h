@@ -0,0 +1,110 @@
+#ifndef AUDIT_H
+#define AUDIT_H
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+#include "async.h"
+
+// ========== 调优检查 ==========
+// 采集之后的审计阶段：硬件是什么之外，再看主机是否配置得能用好它。
+// 规则是声明式的文本（内置规则包见 DefaultRules()，站点可在可执行文件旁放 audit.rules 追加或覆盖）：
+//
+//   [cpu-governor]                   # 规则 ID；同 ID 的后出现者覆盖先出现者
+//   severity = warning               # info / warning / critical
+//   title = CPU 频率调节器不是 performance
+//   source = /sys/devices/system/cpu/cpu*/cpufreq/scaling_governor
+//   expect = equals performance      # 每一项都须满足，否则产生一条发现
+//   when = snapshot:LogicalProcessors min 2   # 可选：前提不成立时规则不适用
+//   advice = cpupower frequency-set -g performance
+//
+// 来源：文件路径（可含 * 通配符，每个文件一项）、"snapshot:<键>"（快照字段，由调用方加入）、
+// "reg:HKLM\<路径>\<值名>"（Windows 注册表）、"net:rx-ring" / "net:rx-ring-max" / "net:irq-affinity"
+// （各物理网卡的 RX 环大小、其最大值与中断的有效亲和性）。来源没有任何项时规则不适用。
+// 期望：[selected] <op> <参数>；selected 表示先取值中方括号内的部分（如 "always [madvise] never"）。
+// op 为 equals、not-equals、one-of、none-of（逗号分隔）、min、max（数值）、
+// min-fact <来源>（不低于另一来源中同名的项，或其唯一一项）、distinct-min N（不同取值至少 N 个）、present。
+//
+// 全部规则引用的来源先去重、一次读完（Facts::Load），之后各规则在调度器上并发求值，只读共享的 Facts。
+// 不依赖 wxWidgets；字符串为 UTF-8。
+namespace audit
+{
+
+enum class Severity
+{
+    Info,
+    Warning,
+    Critical,
+};
+
+const char* SeverityName(Severity severity);   // "info"、"warning"、"critical"
+
+struct Expect
+{
+    std::string source;     // 只用于 when 与 min-fact
+    bool selected = false;
+    std::string op;
+    std::string arg;
+};
+
+struct Rule
+{
+    std::string id;
+    Severity severity = Severity::Warning;
+    std::string title;
+    std::string source;
+    Expect expect;
+    std::optional<Expect> when;
+    std::string advice;
+};
+
+// 解析规则文本并合并进 *rules（同 ID 覆盖）；origin 只用于错误信息。有错误的规则跳过
+void ParseRules(const std::string& text, const std::string& origin, std::vector<Rule>* rules,
+                std::vector<std::string>* errors);
+
+const char* DefaultRules();
+std::string DefaultRuleFile();   // 可执行文件所在目录下的 audit.rules
+
+// 读取规则文件并合并；文件不存在时返回 false（不算错误）
+bool LoadRuleFile(const std::string& path, std::vector<Rule>* rules, std::vector<std::string>* errors);
+
+struct Item
+{
+    std::string name;       // 文件路径、快照键、网卡名 ...
+    std::string value;      // 去掉首尾空白
+};
+
+class Facts
+{
+public:
+    void Add(const std::string& source, std::string name, std::string value);
+    const std::vector<Item>* Find(const std::string& source) const;
+
+    // 读取规则引用的全部来源（"snapshot:" 除外，须事先 Add）；每个来源只读一次
+    void Load(const std::vector<Rule>& rules);
+
+private:
+    void loadSource(const std::string& source);
+
+    std::map<std::string, std::vector<Item>> m_sources;
+};
+
+struct Finding
+{
+    std::string rule;
+    Severity severity = Severity::Warning;
+    std::string title;
+    std::string detail;     // 不满足期望的项，如 "/sys/.../cpu0/cpufreq/scaling_governor=powersave"
+    std::string advice;
+};
+
+// 不适用或满足期望时返回 std::nullopt
+std::optional<Finding> Evaluate(const Rule& rule, const Facts& facts);
+
+// 各规则并发求值，结果按规则顺序；facts 须在任务完成前保持有效
+mt::Task<std::vector<Finding>> EvaluateAll(mt::Scheduler& scheduler, const std::vector<Rule>& rules, const Facts& facts);
+
+} // namespace audit
+
+#endif // AUDIT_H
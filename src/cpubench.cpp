@@ -0,0 +1,1069 @@
+#include "cpubench.h"
+#include "numa.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <system_error>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define CPUBENCH_X86 1
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #define CPUBENCH_TARGET(isa)
+    #else
+        #include <cpuid.h>
+        #define CPUBENCH_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#endif
+
+// 标量版本禁止自动向量化，否则测到的是编译器生成的 SSE 代码
+#if defined(__GNUC__) && !defined(__clang__)
+    #define CPUBENCH_SCALAR __attribute__((noinline, optimize("no-tree-vectorize", "no-tree-slp-vectorize")))
+#elif defined(__GNUC__)
+    #define CPUBENCH_SCALAR __attribute__((noinline))
+#else
+    #define CPUBENCH_SCALAR
+#endif
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sched.h>
+    #include <unistd.h>
+#endif
+
+namespace cpubench
+{
+
+using Clock = std::chrono::steady_clock;
+
+const char* KernelName(Kernel kernel)
+{
+    switch (kernel) {
+        case Kernel::Integer: return "integer";
+        case Kernel::Float: return "float";
+        case Kernel::Hash: return "hash";
+        case Kernel::Compress: return "compress";
+    }
+    return "unknown";
+}
+
+const char* KernelUnit(Kernel kernel)
+{
+    switch (kernel) {
+        case Kernel::Integer: return "Mop/s";
+        case Kernel::Float: return "MFLOP/s";
+        default: return "MB/s";
+    }
+}
+
+const char* IsaName(Isa isa)
+{
+    switch (isa) {
+        case Isa::Scalar: return "scalar";
+        case Isa::Sse41: return "sse4.1";
+        case Isa::Avx2: return "avx2";
+        case Isa::Avx512: return "avx512";
+    }
+    return "unknown";
+}
+
+const char* ModeName(Mode mode)
+{
+    return mode == Mode::Soak ? "soak" : "quick";
+}
+
+// ========== 指令集检测 ==========
+// 处理器支持之外还要看 XCR0：操作系统不保存 YMM / ZMM 状态时不能使用 AVX / AVX-512
+std::vector<Isa> SupportedIsas()
+{
+    std::vector<Isa> isas = { Isa::Scalar };
+#ifdef CPUBENCH_X86
+    unsigned r[4] = {};
+    auto cpuid = [&](unsigned leaf, unsigned sub) {
+#ifdef _MSC_VER
+        __cpuidex((int*)r, (int)leaf, (int)sub);
+#else
+        __cpuid_count(leaf, sub, r[0], r[1], r[2], r[3]);
+#endif
+    };
+    cpuid(0, 0);
+    unsigned maxLeaf = r[0];
+    if (maxLeaf < 1) return isas;
+    cpuid(1, 0);
+    bool sse41 = r[2] & (1u << 19);
+    bool osxsave = r[2] & (1u << 27);
+    bool avx = r[2] & (1u << 28);
+    bool fma = r[2] & (1u << 12);
+    if (sse41) isas.push_back(Isa::Sse41);
+    if (!osxsave || !avx || maxLeaf < 7) return isas;
+
+    uint64_t xcr0;
+#ifdef _MSC_VER
+    xcr0 = _xgetbv(0);
+#else
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    xcr0 = ((uint64_t)hi << 32) | lo;
+#endif
+    cpuid(7, 0);
+    bool avx2 = r[1] & (1u << 5);
+    bool avx512 = (r[1] & (1u << 16)) && (r[1] & (1u << 30));   // F + BW
+    if (avx2 && fma && (xcr0 & 0x6) == 0x6) isas.push_back(Isa::Avx2);
+    if (avx512 && (xcr0 & 0xE6) == 0xE6) isas.push_back(Isa::Avx512);
+#endif
+    return isas;
+}
+
+namespace
+{
+    constexpr size_t kKernelCount = 4;
+    constexpr Kernel kKernels[kKernelCount] = { Kernel::Integer, Kernel::Float, Kernel::Hash, Kernel::Compress };
+
+    // 每个内核一次调用的数据量；都落在 L2 之内，测的是核心本身而不是内存
+    constexpr size_t kIntCount = 16384;
+    constexpr int kIntRounds = 16;
+    constexpr size_t kPolyCount = 2048;
+    constexpr int kPolyDegree = 16;
+    constexpr size_t kTextBytes = 64 << 10;
+    constexpr size_t kLzTableSize = 1 << 12;
+
+    // 每项测量调用的次数：固定不变，快速模式的工作量与机器无关、结果可复现。
+    // 取值使最快的版本在当前台式机单核上约 40 ms
+    constexpr unsigned kBlocks[kKernelCount] = { 1200, 20000, 24000, 1600 };
+
+    double UnitsPerBlock(Kernel kernel)
+    {
+        switch (kernel) {
+            case Kernel::Integer: return (double)kIntCount * kIntRounds;
+            case Kernel::Float: return (double)kPolyCount * kPolyDegree * 2;
+            default: return (double)kTextBytes;
+        }
+    }
+
+    uint64_t SplitMix64(uint64_t& state)
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    struct PolyTable
+    {
+        double c[kPolyDegree + 1];
+
+        PolyTable()
+        {
+            for (int k = 0; k <= kPolyDegree; ++k) c[k] = (k & 1 ? -1.0 : 1.0) / (k + 1);
+        }
+    };
+    const PolyTable kPoly;
+
+    constexpr uint64_t kHashKey[8] = {
+        0xBE4BA423396CFEB8ull, 0x1CAD21F72C81017Cull, 0xDB979083E96DD4DEull, 0x1F67B3B7A4A44072ull,
+        0x78E5C0CC4EE679CBull, 0x2172FFCC7DD05A82ull, 0x8E2443F7744608B8ull, 0x4C263A81E69035E0ull,
+    };
+    constexpr uint64_t kHashPrime = 0x9E3779B1ull;
+
+    // 每个线程一份：输入由固定种子生成，各版本、各次运行完全相同
+    struct Workspace
+    {
+        std::vector<uint32_t> ints;
+        std::vector<double> xs, ys;
+        std::vector<uint8_t> text;       // 哈希与压缩共用的输入：短语重复拼接的伪文本，可压缩
+        std::vector<uint8_t> packed;
+        std::vector<uint32_t> table;
+        uint64_t acc[8];
+        double polySum = 0;
+        uint64_t packedBytes = 0;
+
+        Workspace()
+            : ints(kIntCount), xs(kPolyCount), ys(kPolyCount), text(kTextBytes), packed(kTextBytes * 2 + 64),
+              table(kLzTableSize)
+        {
+            uint64_t seed = 0x5EED;
+            for (uint32_t& v : ints) v = (uint32_t)SplitMix64(seed) | 1;
+            for (double& x : xs) x = (double)(SplitMix64(seed) >> 11) / (double)(1ull << 53) * 2 - 1;
+
+            std::vector<std::string> phrases(48);
+            static const char letters[] = "etaoin shrdlucmfwypvbgkqjxz ETAOIN,.";
+            for (std::string& phrase : phrases) {
+                size_t length = 16 + SplitMix64(seed) % 80;
+                for (size_t i = 0; i < length; ++i) phrase += letters[SplitMix64(seed) % (sizeof(letters) - 1)];
+            }
+            for (size_t pos = 0; pos < text.size();) {
+                const std::string& phrase = phrases[SplitMix64(seed) % phrases.size()];
+                size_t n = std::min(phrase.size(), text.size() - pos);
+                memcpy(&text[pos], phrase.data(), n);
+                pos += n;
+                if (pos < text.size() && SplitMix64(seed) % 4 == 0) text[pos++] = (uint8_t)SplitMix64(seed);
+            }
+            static constexpr uint64_t init[8] = {
+                0xC2B2AE3Dull, 0x9E3779B185EBCA87ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull,
+                0x85EBCA77C2B2AE63ull, 0x85EBCA77ull, 0x27D4EB2F165667C5ull, 0x9E3779B1ull,
+            };
+            memcpy(acc, init, sizeof(acc));
+        }
+    };
+
+    // ========== 整数：每个元素独立做 16 轮 xorshift32 + 乘法 ==========
+    CPUBENCH_SCALAR void IntegerScalar(uint32_t* v, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t x = v[i];
+            for (int r = 0; r < kIntRounds; ++r) {
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                x *= 0x9E3779B1u;
+            }
+            v[i] = x;
+        }
+    }
+
+    // ========== 浮点：16 次 Horner 迭代的多项式，y[i] = p(x[i])，返回 Σy ==========
+    CPUBENCH_SCALAR double PolyScalar(const double* x, double* y, size_t n)
+    {
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            double v = kPoly.c[kPolyDegree];
+            for (int k = kPolyDegree - 1; k >= 0; --k) v = v * x[i] + kPoly.c[k];
+            y[i] = v;
+            sum += v;
+        }
+        return sum;
+    }
+
+    // ========== 哈希：XXH3 式 8 路 64 位累加，每 64 字节一条；末尾打散一次 ==========
+    CPUBENCH_SCALAR void HashScalar(const uint8_t* p, size_t bytes, uint64_t* acc)
+    {
+        for (size_t s = 0; s < bytes; s += 64) {
+            for (int j = 0; j < 8; ++j) {
+                uint64_t d;
+                memcpy(&d, p + s + j * 8, 8);
+                uint64_t dk = d ^ kHashKey[j];
+                acc[j ^ 1] += d;
+                acc[j] += (dk & 0xFFFFFFFF) * (dk >> 32);
+            }
+        }
+        for (int j = 0; j < 8; ++j) {
+            acc[j] ^= acc[j] >> 47;
+            acc[j] ^= kHashKey[j];
+            acc[j] *= kHashPrime;
+        }
+    }
+
+    // ========== 压缩：4 字节哈希找候选，匹配长度的延伸按指令集逐 8/16/32/64 字节比较 ==========
+    // 各版本的匹配长度相同，输出逐字节一致
+    size_t MatchScalar(const uint8_t* a, const uint8_t* b, const uint8_t* end)
+    {
+        const uint8_t* start = b;
+        while (b + 8 <= end) {
+            uint64_t x, y;
+            memcpy(&x, a, 8);
+            memcpy(&y, b, 8);
+            if (x != y) return (size_t)(b - start) + std::countr_zero(x ^ y) / 8;
+            a += 8;
+            b += 8;
+        }
+        while (b < end && *a == *b) {
+            ++a;
+            ++b;
+        }
+        return (size_t)(b - start);
+    }
+
+    uint8_t* PutVarint(uint8_t* out, size_t v)
+    {
+        while (v >= 0x80) {
+            *out++ = (uint8_t)(v | 0x80);
+            v >>= 7;
+        }
+        *out++ = (uint8_t)v;
+        return out;
+    }
+
+    // 输出格式：[字面量长度][字面量][偏移 2 字节][匹配长度 − 4] 重复，末尾为剩余字面量
+    template <size_t (*Match)(const uint8_t*, const uint8_t*, const uint8_t*)>
+    size_t Compress(const uint8_t* in, size_t n, uint8_t* out, uint32_t* table)
+    {
+        memset(table, 0xFF, kLzTableSize * sizeof(uint32_t));
+        uint8_t* begin = out;
+        size_t anchor = 0;
+        for (size_t pos = 0; pos + 8 <= n;) {
+            uint32_t v;
+            memcpy(&v, in + pos, 4);
+            uint32_t h = (v * 2654435761u) >> 20;
+            uint32_t candidate = table[h];
+            table[h] = (uint32_t)pos;
+            uint32_t c;
+            if (candidate >= pos || pos - candidate > 0xFFFF || (memcpy(&c, in + candidate, 4), c != v)) {
+                ++pos;
+                continue;
+            }
+            size_t length = 4 + Match(in + candidate + 4, in + pos + 4, in + n);
+            out = PutVarint(out, pos - anchor);
+            memcpy(out, in + anchor, pos - anchor);
+            out += pos - anchor;
+            *out++ = (uint8_t)(pos - candidate);
+            *out++ = (uint8_t)((pos - candidate) >> 8);
+            out = PutVarint(out, length - 4);
+            pos += length;
+            anchor = pos;
+        }
+        out = PutVarint(out, n - anchor);
+        memcpy(out, in + anchor, n - anchor);
+        out += n - anchor;
+        return (size_t)(out - begin);
+    }
+
+#ifdef CPUBENCH_X86
+    // ========== SIMD 版本 ==========
+    // 每次处理 4 个向量，使相互独立的依赖链足以填满流水线。
+    // MinGW 的 GCC 不能把栈按 32/64 字节对齐（GCC bug 54412），向量只在寄存器中，不取地址、不跨调用
+
+    // ---------- SSE4.1 ----------
+    CPUBENCH_TARGET("sse4.1") inline __m128i Mix128(__m128i x, __m128i k)
+    {
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+        return _mm_mullo_epi32(x, k);
+    }
+
+    CPUBENCH_TARGET("sse4.1") void IntegerSse41(uint32_t* v, size_t n)
+    {
+        const __m128i k = _mm_set1_epi32((int)0x9E3779B1u);
+        for (size_t i = 0; i < n; i += 16) {
+            __m128i x0 = _mm_loadu_si128((const __m128i*)(v + i));
+            __m128i x1 = _mm_loadu_si128((const __m128i*)(v + i + 4));
+            __m128i x2 = _mm_loadu_si128((const __m128i*)(v + i + 8));
+            __m128i x3 = _mm_loadu_si128((const __m128i*)(v + i + 12));
+            for (int r = 0; r < kIntRounds; ++r) {
+                x0 = Mix128(x0, k);
+                x1 = Mix128(x1, k);
+                x2 = Mix128(x2, k);
+                x3 = Mix128(x3, k);
+            }
+            _mm_storeu_si128((__m128i*)(v + i), x0);
+            _mm_storeu_si128((__m128i*)(v + i + 4), x1);
+            _mm_storeu_si128((__m128i*)(v + i + 8), x2);
+            _mm_storeu_si128((__m128i*)(v + i + 12), x3);
+        }
+    }
+
+    CPUBENCH_TARGET("sse4.1") double PolySse41(const double* x, double* y, size_t n)
+    {
+        __m128d sum = _mm_setzero_pd();
+        for (size_t i = 0; i < n; i += 8) {
+            __m128d x0 = _mm_loadu_pd(x + i), x1 = _mm_loadu_pd(x + i + 2);
+            __m128d x2 = _mm_loadu_pd(x + i + 4), x3 = _mm_loadu_pd(x + i + 6);
+            __m128d c = _mm_set1_pd(kPoly.c[kPolyDegree]);
+            __m128d v0 = c, v1 = c, v2 = c, v3 = c;
+            for (int k = kPolyDegree - 1; k >= 0; --k) {
+                c = _mm_set1_pd(kPoly.c[k]);
+                v0 = _mm_add_pd(_mm_mul_pd(v0, x0), c);
+                v1 = _mm_add_pd(_mm_mul_pd(v1, x1), c);
+                v2 = _mm_add_pd(_mm_mul_pd(v2, x2), c);
+                v3 = _mm_add_pd(_mm_mul_pd(v3, x3), c);
+            }
+            _mm_storeu_pd(y + i, v0);
+            _mm_storeu_pd(y + i + 2, v1);
+            _mm_storeu_pd(y + i + 4, v2);
+            _mm_storeu_pd(y + i + 6, v3);
+            sum = _mm_add_pd(sum, _mm_add_pd(_mm_add_pd(v0, v1), _mm_add_pd(v2, v3)));
+        }
+        return _mm_cvtsd_f64(_mm_add_pd(sum, _mm_unpackhi_pd(sum, sum)));
+    }
+
+    CPUBENCH_TARGET("sse4.1") inline __m128i Scramble128(__m128i acc, __m128i key, __m128i prime)
+    {
+        acc = _mm_xor_si128(_mm_xor_si128(acc, _mm_srli_epi64(acc, 47)), key);
+        __m128i lo = _mm_mul_epu32(acc, prime);
+        __m128i hi = _mm_mul_epu32(_mm_srli_epi64(acc, 32), prime);
+        return _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+    }
+
+    CPUBENCH_TARGET("sse4.1") void HashSse41(const uint8_t* p, size_t bytes, uint64_t* acc)
+    {
+        __m128i a[4], key[4];
+        for (int r = 0; r < 4; ++r) {
+            a[r] = _mm_loadu_si128((const __m128i*)(acc + r * 2));
+            key[r] = _mm_loadu_si128((const __m128i*)(kHashKey + r * 2));
+        }
+        for (size_t s = 0; s < bytes; s += 64) {
+            for (int r = 0; r < 4; ++r) {
+                __m128i d = _mm_loadu_si128((const __m128i*)(p + s + r * 16));
+                __m128i dk = _mm_xor_si128(d, key[r]);
+                __m128i product = _mm_mul_epu32(dk, _mm_srli_epi64(dk, 32));
+                a[r] = _mm_add_epi64(a[r], _mm_add_epi64(_mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2)), product));
+            }
+        }
+        const __m128i prime = _mm_set1_epi64x((long long)kHashPrime);
+        for (int r = 0; r < 4; ++r) _mm_storeu_si128((__m128i*)(acc + r * 2), Scramble128(a[r], key[r], prime));
+    }
+
+    CPUBENCH_TARGET("sse4.1") size_t MatchSse41(const uint8_t* a, const uint8_t* b, const uint8_t* end)
+    {
+        const uint8_t* start = b;
+        while (b + 16 <= end) {
+            __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)a), _mm_loadu_si128((const __m128i*)b));
+            unsigned mask = (unsigned)_mm_movemask_epi8(eq);
+            if (mask != 0xFFFF) return (size_t)(b - start) + std::countr_zero(~mask);
+            a += 16;
+            b += 16;
+        }
+        return (size_t)(b - start) + MatchScalar(a, b, end);
+    }
+
+    // ---------- AVX2 + FMA ----------
+    CPUBENCH_TARGET("avx2") inline __m256i Mix256(__m256i x, __m256i k)
+    {
+        x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 13));
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 17));
+        x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 5));
+        return _mm256_mullo_epi32(x, k);
+    }
+
+    CPUBENCH_TARGET("avx2") void IntegerAvx2(uint32_t* v, size_t n)
+    {
+        const __m256i k = _mm256_set1_epi32((int)0x9E3779B1u);
+        for (size_t i = 0; i < n; i += 32) {
+            __m256i x0 = _mm256_loadu_si256((const __m256i*)(v + i));
+            __m256i x1 = _mm256_loadu_si256((const __m256i*)(v + i + 8));
+            __m256i x2 = _mm256_loadu_si256((const __m256i*)(v + i + 16));
+            __m256i x3 = _mm256_loadu_si256((const __m256i*)(v + i + 24));
+            for (int r = 0; r < kIntRounds; ++r) {
+                x0 = Mix256(x0, k);
+                x1 = Mix256(x1, k);
+                x2 = Mix256(x2, k);
+                x3 = Mix256(x3, k);
+            }
+            _mm256_storeu_si256((__m256i*)(v + i), x0);
+            _mm256_storeu_si256((__m256i*)(v + i + 8), x1);
+            _mm256_storeu_si256((__m256i*)(v + i + 16), x2);
+            _mm256_storeu_si256((__m256i*)(v + i + 24), x3);
+        }
+    }
+
+    CPUBENCH_TARGET("avx2,fma") double PolyAvx2(const double* x, double* y, size_t n)
+    {
+        __m256d sum = _mm256_setzero_pd();
+        for (size_t i = 0; i < n; i += 16) {
+            __m256d x0 = _mm256_loadu_pd(x + i), x1 = _mm256_loadu_pd(x + i + 4);
+            __m256d x2 = _mm256_loadu_pd(x + i + 8), x3 = _mm256_loadu_pd(x + i + 12);
+            __m256d c = _mm256_set1_pd(kPoly.c[kPolyDegree]);
+            __m256d v0 = c, v1 = c, v2 = c, v3 = c;
+            for (int k = kPolyDegree - 1; k >= 0; --k) {
+                c = _mm256_set1_pd(kPoly.c[k]);
+                v0 = _mm256_fmadd_pd(v0, x0, c);
+                v1 = _mm256_fmadd_pd(v1, x1, c);
+                v2 = _mm256_fmadd_pd(v2, x2, c);
+                v3 = _mm256_fmadd_pd(v3, x3, c);
+            }
+            _mm256_storeu_pd(y + i, v0);
+            _mm256_storeu_pd(y + i + 4, v1);
+            _mm256_storeu_pd(y + i + 8, v2);
+            _mm256_storeu_pd(y + i + 12, v3);
+            sum = _mm256_add_pd(sum, _mm256_add_pd(_mm256_add_pd(v0, v1), _mm256_add_pd(v2, v3)));
+        }
+        __m128d half = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+        return _mm_cvtsd_f64(_mm_add_pd(half, _mm_unpackhi_pd(half, half)));
+    }
+
+    CPUBENCH_TARGET("avx2") void HashAvx2(const uint8_t* p, size_t bytes, uint64_t* acc)
+    {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)acc);
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(acc + 4));
+        const __m256i key0 = _mm256_loadu_si256((const __m256i*)kHashKey);
+        const __m256i key1 = _mm256_loadu_si256((const __m256i*)(kHashKey + 4));
+        for (size_t s = 0; s < bytes; s += 64) {
+            __m256i d0 = _mm256_loadu_si256((const __m256i*)(p + s));
+            __m256i d1 = _mm256_loadu_si256((const __m256i*)(p + s + 32));
+            __m256i dk0 = _mm256_xor_si256(d0, key0);
+            __m256i dk1 = _mm256_xor_si256(d1, key1);
+            a0 = _mm256_add_epi64(a0, _mm256_add_epi64(_mm256_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2)),
+                                                       _mm256_mul_epu32(dk0, _mm256_srli_epi64(dk0, 32))));
+            a1 = _mm256_add_epi64(a1, _mm256_add_epi64(_mm256_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2)),
+                                                       _mm256_mul_epu32(dk1, _mm256_srli_epi64(dk1, 32))));
+        }
+        const __m256i prime = _mm256_set1_epi64x((long long)kHashPrime);
+        a0 = _mm256_xor_si256(_mm256_xor_si256(a0, _mm256_srli_epi64(a0, 47)), key0);
+        a1 = _mm256_xor_si256(_mm256_xor_si256(a1, _mm256_srli_epi64(a1, 47)), key1);
+        a0 = _mm256_add_epi64(_mm256_mul_epu32(a0, prime), _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a0, 32), prime), 32));
+        a1 = _mm256_add_epi64(_mm256_mul_epu32(a1, prime), _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a1, 32), prime), 32));
+        _mm256_storeu_si256((__m256i*)acc, a0);
+        _mm256_storeu_si256((__m256i*)(acc + 4), a1);
+    }
+
+    CPUBENCH_TARGET("avx2") size_t MatchAvx2(const uint8_t* a, const uint8_t* b, const uint8_t* end)
+    {
+        const uint8_t* start = b;
+        while (b + 32 <= end) {
+            __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)a), _mm256_loadu_si256((const __m256i*)b));
+            unsigned mask = (unsigned)_mm256_movemask_epi8(eq);
+            if (mask != 0xFFFFFFFFu) return (size_t)(b - start) + std::countr_zero(~mask);
+            a += 32;
+            b += 32;
+        }
+        return (size_t)(b - start) + MatchScalar(a, b, end);
+    }
+
+    // ---------- AVX-512 F + BW ----------
+    // GCC 12 的移位、_mm512_mul_epu32、_mm512_shuffle_epi32、_mm512_extractf64x4_pd 等非掩码形式以未初始化的
+    // _mm512_undefined_*() 作直通源，-Wall 下报 "'__Y' may be used uninitialized"（GCC PR 105593）。
+    // 本节改用直通源显式为零的 maskz 形式：全掩码时结果与生成的指令都与非掩码形式相同
+    const __mmask8 kAll64 = 0xFF;
+    const __mmask16 kAll32 = 0xFFFF;
+
+    CPUBENCH_TARGET("avx512f,avx512bw") inline __m512i Mix512(__m512i x, __m512i k)
+    {
+        x = _mm512_xor_si512(x, _mm512_maskz_slli_epi32(kAll32, x, 13));
+        x = _mm512_xor_si512(x, _mm512_maskz_srli_epi32(kAll32, x, 17));
+        x = _mm512_xor_si512(x, _mm512_maskz_slli_epi32(kAll32, x, 5));
+        return _mm512_mullo_epi32(x, k);
+    }
+
+    CPUBENCH_TARGET("avx512f,avx512bw") void IntegerAvx512(uint32_t* v, size_t n)
+    {
+        const __m512i k = _mm512_set1_epi32((int)0x9E3779B1u);
+        for (size_t i = 0; i < n; i += 64) {
+            __m512i x0 = _mm512_loadu_si512(v + i);
+            __m512i x1 = _mm512_loadu_si512(v + i + 16);
+            __m512i x2 = _mm512_loadu_si512(v + i + 32);
+            __m512i x3 = _mm512_loadu_si512(v + i + 48);
+            for (int r = 0; r < kIntRounds; ++r) {
+                x0 = Mix512(x0, k);
+                x1 = Mix512(x1, k);
+                x2 = Mix512(x2, k);
+                x3 = Mix512(x3, k);
+            }
+            _mm512_storeu_si512(v + i, x0);
+            _mm512_storeu_si512(v + i + 16, x1);
+            _mm512_storeu_si512(v + i + 32, x2);
+            _mm512_storeu_si512(v + i + 48, x3);
+        }
+    }
+
+    CPUBENCH_TARGET("avx512f,avx512bw") double PolyAvx512(const double* x, double* y, size_t n)
+    {
+        __m512d sum = _mm512_setzero_pd();
+        for (size_t i = 0; i < n; i += 32) {
+            __m512d x0 = _mm512_loadu_pd(x + i), x1 = _mm512_loadu_pd(x + i + 8);
+            __m512d x2 = _mm512_loadu_pd(x + i + 16), x3 = _mm512_loadu_pd(x + i + 24);
+            __m512d c = _mm512_set1_pd(kPoly.c[kPolyDegree]);
+            __m512d v0 = c, v1 = c, v2 = c, v3 = c;
+            for (int k = kPolyDegree - 1; k >= 0; --k) {
+                c = _mm512_set1_pd(kPoly.c[k]);
+                v0 = _mm512_fmadd_pd(v0, x0, c);
+                v1 = _mm512_fmadd_pd(v1, x1, c);
+                v2 = _mm512_fmadd_pd(v2, x2, c);
+                v3 = _mm512_fmadd_pd(v3, x3, c);
+            }
+            _mm512_storeu_pd(y + i, v0);
+            _mm512_storeu_pd(y + i + 8, v1);
+            _mm512_storeu_pd(y + i + 16, v2);
+            _mm512_storeu_pd(y + i + 24, v3);
+            sum = _mm512_add_pd(sum, _mm512_add_pd(_mm512_add_pd(v0, v1), _mm512_add_pd(v2, v3)));
+        }
+        // 与 _mm512_reduce_add_pd 相同的归约次序：高低 256 位相加，再 128 位，再两个元素
+        __m256d half = _mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xF, sum, 0), _mm512_maskz_extractf64x4_pd(0xF, sum, 1));
+        __m128d quarter = _mm_add_pd(_mm256_castpd256_pd128(half), _mm256_extractf128_pd(half, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(quarter, _mm_unpackhi_pd(quarter, quarter)));
+    }
+
+    CPUBENCH_TARGET("avx512f,avx512bw") void HashAvx512(const uint8_t* p, size_t bytes, uint64_t* acc)
+    {
+        __m512i a = _mm512_loadu_si512(acc);
+        const __m512i key = _mm512_loadu_si512(kHashKey);
+        for (size_t s = 0; s < bytes; s += 64) {
+            __m512i d = _mm512_loadu_si512(p + s);
+            __m512i dk = _mm512_xor_si512(d, key);
+            __m512i mixed = _mm512_maskz_mul_epu32(kAll64, dk, _mm512_maskz_srli_epi64(kAll64, dk, 32));
+            a = _mm512_add_epi64(a, _mm512_add_epi64(_mm512_maskz_shuffle_epi32(kAll32, d, _MM_PERM_BADC), mixed));
+        }
+        const __m512i prime = _mm512_set1_epi64((long long)kHashPrime);
+        a = _mm512_xor_si512(_mm512_xor_si512(a, _mm512_maskz_srli_epi64(kAll64, a, 47)), key);
+        __m512i high = _mm512_maskz_mul_epu32(kAll64, _mm512_maskz_srli_epi64(kAll64, a, 32), prime);
+        a = _mm512_add_epi64(_mm512_maskz_mul_epu32(kAll64, a, prime), _mm512_maskz_slli_epi64(kAll64, high, 32));
+        _mm512_storeu_si512(acc, a);
+    }
+
+    CPUBENCH_TARGET("avx512f,avx512bw") size_t MatchAvx512(const uint8_t* a, const uint8_t* b, const uint8_t* end)
+    {
+        const uint8_t* start = b;
+        while (b + 64 <= end) {
+            uint64_t mask = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(a), _mm512_loadu_si512(b));
+            if (mask != ~0ull) return (size_t)(b - start) + std::countr_zero(~mask);
+            a += 64;
+            b += 64;
+        }
+        return (size_t)(b - start) + MatchScalar(a, b, end);
+    }
+#endif
+
+    // ========== 版本表 ==========
+    struct Variant
+    {
+        void (*integer)(uint32_t* v, size_t n);
+        double (*poly)(const double* x, double* y, size_t n);
+        void (*hash)(const uint8_t* p, size_t bytes, uint64_t* acc);
+        size_t (*compress)(const uint8_t* in, size_t n, uint8_t* out, uint32_t* table);
+    };
+
+    const Variant& VariantOf(Isa isa)
+    {
+        static const Variant scalar = { IntegerScalar, PolyScalar, HashScalar, Compress<MatchScalar> };
+#ifdef CPUBENCH_X86
+        static const Variant sse41 = { IntegerSse41, PolySse41, HashSse41, Compress<MatchSse41> };
+        static const Variant avx2 = { IntegerAvx2, PolyAvx2, HashAvx2, Compress<MatchAvx2> };
+        static const Variant avx512 = { IntegerAvx512, PolyAvx512, HashAvx512, Compress<MatchAvx512> };
+        switch (isa) {
+            case Isa::Sse41: return sse41;
+            case Isa::Avx2: return avx2;
+            case Isa::Avx512: return avx512;
+            default: break;
+        }
+#endif
+        return scalar;
+    }
+
+    void RunBlocks(Kernel kernel, const Variant& variant, Workspace& ws, unsigned blocks)
+    {
+        for (unsigned b = 0; b < blocks; ++b) {
+            switch (kernel) {
+                case Kernel::Integer: variant.integer(ws.ints.data(), ws.ints.size()); break;
+                case Kernel::Float: ws.polySum += variant.poly(ws.xs.data(), ws.ys.data(), ws.xs.size()); break;
+                case Kernel::Hash: variant.hash(ws.text.data(), ws.text.size(), ws.acc); break;
+                case Kernel::Compress:
+                    ws.packedBytes += variant.compress(ws.text.data(), ws.text.size(), ws.packed.data(), ws.table.data());
+                    break;
+            }
+        }
+    }
+
+    // 各版本在同一输入上各跑两次，结果须与标量版一致；浮点版 FMA 的舍入不同，按相对误差比较
+    bool Matches(const Workspace& a, const Workspace& b)
+    {
+        return a.ints == b.ints && memcmp(a.acc, b.acc, sizeof(a.acc)) == 0 && a.packedBytes == b.packedBytes &&
+               memcmp(a.packed.data(), b.packed.data(), (size_t)a.packedBytes / 2) == 0 &&
+               std::fabs(a.polySum - b.polySum) <= 1e-9 * std::max(1.0, std::fabs(a.polySum));
+    }
+
+    std::unique_ptr<Workspace> Verify(Isa isa)
+    {
+        auto ws = std::make_unique<Workspace>();
+        for (Kernel kernel : kKernels) RunBlocks(kernel, VariantOf(isa), *ws, 2);
+        return ws;
+    }
+
+    // ========== 频率 ==========
+    // 每次迭代 8 条相互依赖的加法，每条延迟 1 个周期；循环计数在另一条依赖链上，与之并行
+    double MeasureMHz()
+    {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__) || defined(__aarch64__))
+        constexpr uint64_t kIterations = 1 << 18;
+        uintptr_t x = 0, y = 1;
+        Clock::time_point start = Clock::now();
+        for (uint64_t i = 0; i < kIterations; ++i) {
+#if defined(__aarch64__)
+            __asm__ volatile("add %0, %0, %1\n\tadd %0, %0, %1\n\tadd %0, %0, %1\n\tadd %0, %0, %1\n\t"
+                             "add %0, %0, %1\n\tadd %0, %0, %1\n\tadd %0, %0, %1\n\tadd %0, %0, %1"
+                             : "+r"(x) : "r"(y));
+#else
+            __asm__ volatile("add %1, %0\n\tadd %1, %0\n\tadd %1, %0\n\tadd %1, %0\n\t"
+                             "add %1, %0\n\tadd %1, %0\n\tadd %1, %0\n\tadd %1, %0"
+                             : "+r"(x) : "r"(y));
+#endif
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return seconds > 0 ? kIterations * 8 / seconds / 1e6 : 0;
+#else
+        return 0;
+#endif
+    }
+
+    double Median(std::vector<double> values)
+    {
+        values.erase(std::remove(values.begin(), values.end(), 0.0), values.end());
+        if (values.empty()) return 0;
+        std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        return values[values.size() / 2];
+    }
+
+    double GeometricMean(const double* rates, size_t n)
+    {
+        double logSum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (rates[i] <= 0) return 0;
+            logSum += std::log(rates[i]);
+        }
+        return std::exp(logSum / n);
+    }
+}
+
+#ifdef _WIN32
+
+// ========== Windows：处理器组亲和性 ==========
+namespace
+{
+    // 逻辑处理器编号与 numa.cpp 一致：处理器组 × 64 + 组内位号
+    void Pin(int cpu)
+    {
+        GROUP_AFFINITY affinity = {};
+        affinity.Group = (WORD)(cpu / 64);
+        affinity.Mask = (KAFFINITY)1 << (cpu % 64);
+        SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr);
+    }
+
+    // 每个物理核编号最小的逻辑处理器
+    std::vector<int> PrimaryThreads()
+    {
+        std::vector<int> primary;
+        DWORD size = 0;
+        GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &size);
+        std::vector<uint8_t> buf(size);
+        if (size == 0 || !GetLogicalProcessorInformationEx(RelationProcessorCore,
+                (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)buf.data(), &size)) {
+            return primary;
+        }
+        for (DWORD pos = 0; pos < size;) {
+            const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info = (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)&buf[pos];
+            const GROUP_AFFINITY& mask = info->Processor.GroupMask[0];
+            if (mask.Mask) primary.push_back(mask.Group * 64 + std::countr_zero((uint64_t)mask.Mask));
+            pos += info->Size;
+        }
+        return primary;
+    }
+}
+
+#else
+
+// ========== 其它平台：sched_setaffinity + sysfs ==========
+namespace
+{
+    void Pin(int cpu)
+    {
+        cpu_set_t* set = CPU_ALLOC(cpu + 1);
+        if (!set) return;
+        size_t size = CPU_ALLOC_SIZE(cpu + 1);
+        CPU_ZERO_S(size, set);
+        CPU_SET_S(cpu, size, set);
+        sched_setaffinity(0, size, set);
+        CPU_FREE(set);
+    }
+
+    // thread_siblings_list 的第一个编号为该核编号最小的逻辑处理器
+    std::vector<int> PrimaryThreads()
+    {
+        std::vector<int> primary;
+        for (int cpu = 0;; ++cpu) {
+            std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/thread_siblings_list";
+            int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                if (access(("/sys/devices/system/cpu/cpu" + std::to_string(cpu)).c_str(), F_OK) != 0) break;
+                continue;   // 离线的处理器没有拓扑目录
+            }
+            char buf[64] = {};
+            ssize_t n = read(fd, buf, sizeof(buf) - 1);
+            close(fd);
+            if (n > 0 && atoi(buf) == cpu) primary.push_back(cpu);
+        }
+        return primary;
+    }
+}
+
+#endif
+
+namespace
+{
+    // ========== 多线程测量 ==========
+    class SpinBarrier
+    {
+    public:
+        explicit SpinBarrier(unsigned count) : m_count(count) {}
+
+        void Wait()
+        {
+            unsigned generation = m_generation.load(std::memory_order_acquire);
+            if (m_arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == m_count) {
+                m_arrived.store(0, std::memory_order_relaxed);
+                m_generation.fetch_add(1, std::memory_order_release);
+                return;
+            }
+            while (m_generation.load(std::memory_order_acquire) == generation) std::this_thread::yield();
+        }
+
+    private:
+        const unsigned m_count;
+        std::atomic<unsigned> m_arrived{ 0 };
+        std::atomic<unsigned> m_generation{ 0 };
+    };
+
+    struct PointResult
+    {
+        double rates[kKernelCount] = {};
+        std::vector<double> mhz;
+    };
+
+    // 各线程对每个内核完成固定工作量。同一内核在屏障后同时开始，先各测一次频率（此时全部线程都在跑），
+    // 速率 = 全部线程的工作量 / (最晚结束 − 最早开始)。cpus 为空时不绑核，由系统调度
+    bool RunPoint(const std::vector<int>& cpus, unsigned threads, Isa isa, std::stop_token stop, PointResult* out)
+    {
+        const Variant& variant = VariantOf(isa);
+        SpinBarrier barrier(threads);
+        std::atomic<int> go{ 0 };                            // 0 等待、1 开始、2 放弃（线程未能全部创建）
+        std::atomic<bool> abort[kKernelCount] = {};          // 每轮一个，屏障前写、屏障后读，各线程看到同一个值
+        std::vector<Clock::time_point> starts(threads * kKernelCount), ends(threads * kKernelCount);
+        std::vector<double> mhz(threads * kKernelCount);
+
+        auto work = [&](unsigned t) {
+            if (!cpus.empty()) Pin(cpus[t]);
+            while (go.load(std::memory_order_acquire) == 0) std::this_thread::yield();
+            if (go.load(std::memory_order_acquire) == 2) return;
+            std::unique_ptr<Workspace> ws;
+            try {
+                ws = std::make_unique<Workspace>();
+            } catch (const std::bad_alloc&) {
+                abort[0] = true;
+            }
+            for (size_t k = 0; k < kKernelCount; ++k) {
+                if (stop.stop_requested()) abort[k] = true;
+                barrier.Wait();
+                if (abort[k]) return;
+                mhz[t * kKernelCount + k] = MeasureMHz();
+                starts[t * kKernelCount + k] = Clock::now();
+                RunBlocks(kKernels[k], variant, *ws, kBlocks[k]);
+                ends[t * kKernelCount + k] = Clock::now();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        try {
+            for (unsigned t = 0; t < threads; ++t) workers.emplace_back(work, t);
+        } catch (const std::system_error&) {
+            go = 2;
+            for (std::thread& worker : workers) worker.join();
+            throw;
+        }
+        go = 1;
+        for (std::thread& worker : workers) worker.join();
+
+        for (size_t k = 0; k < kKernelCount; ++k) {
+            if (abort[k]) return false;
+            Clock::time_point start = starts[k], end = ends[k];
+            for (unsigned t = 1; t < threads; ++t) {
+                start = std::min(start, starts[t * kKernelCount + k]);
+                end = std::max(end, ends[t * kKernelCount + k]);
+            }
+            double seconds = std::chrono::duration<double>(end - start).count();
+            out->rates[k] = seconds > 0 ? threads * kBlocks[k] * UnitsPerBlock(kKernels[k]) / seconds / 1e6 : 0;
+        }
+        out->mhz = std::move(mhz);
+        return true;
+    }
+
+    // 1、2、4 … 直到 n，另加物理核数（超线程的分界）
+    std::vector<unsigned> ThreadCounts(unsigned n, unsigned cores)
+    {
+        std::vector<unsigned> counts;
+        for (unsigned t = 1; t < n; t *= 2) counts.push_back(t);
+        if (cores > 0 && cores < n) counts.push_back(cores);
+        counts.push_back(n);
+        std::sort(counts.begin(), counts.end());
+        counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+        return counts;
+    }
+
+    struct Progress
+    {
+        const ProgressFn* fn = nullptr;
+        double done = 0;
+        double total = 1;
+        double quickShare = 1;     // 长时间模式中快速部分所占的比例
+
+        void Step()
+        {
+            done += 1;
+            Update(done / total * quickShare);
+        }
+
+        void Update(double fraction)
+        {
+            if (fn && *fn) (*fn)(std::min(fraction, 1.0));
+        }
+    };
+
+    bool Measure(const Options& options, const std::vector<int>& cpus, unsigned cores, std::stop_token stop,
+                 Progress& progress, Report* report)
+    {
+        // 校验各版本：以标量版为准
+        std::vector<Isa> isas;
+        std::unique_ptr<Workspace> reference = Verify(Isa::Scalar);
+        for (Isa isa : SupportedIsas()) {
+            if (isa == Isa::Scalar || Matches(*reference, *Verify(isa))) isas.push_back(isa);
+            else report->rejected.push_back(isa);
+        }
+        report->bestIsa = isas.back();
+
+        unsigned reps = std::max(1u, options.repetitions);
+        std::vector<unsigned> counts = ThreadCounts((unsigned)cpus.size(), cores);
+        progress.total = (double)isas.size() * kKernelCount * reps + (double)counts.size() * 2 * reps;
+
+        // 单线程：瞬时频率与各版本速率，在绑到第一个处理器的线程上测
+        bool ok = true;
+        bool failed = false;
+        auto measureSingle = [&] {
+            Pin(cpus.front());
+            Clock::time_point warm = Clock::now() + std::chrono::milliseconds(100);   // 先让处理器离开低功耗状态
+            while (Clock::now() < warm) MeasureMHz();
+            for (int i = 0; i < 5; ++i) report->burstMHz = std::max(report->burstMHz, MeasureMHz());
+
+            Workspace ws;
+            for (size_t k = 0; k < kKernelCount; ++k) {
+                for (Isa isa : isas) {
+                    double best = 0;
+                    for (unsigned rep = 0; rep < reps; ++rep) {
+                        if (stop.stop_requested()) {
+                            ok = false;
+                            return;
+                        }
+                        Clock::time_point start = Clock::now();
+                        RunBlocks(kKernels[k], VariantOf(isa), ws, kBlocks[k]);
+                        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+                        if (seconds > 0) best = std::max(best, kBlocks[k] * UnitsPerBlock(kKernels[k]) / seconds / 1e6);
+                        progress.Step();
+                    }
+                    KernelRate rate;
+                    rate.kernel = kKernels[k];
+                    rate.isa = isa;
+                    rate.rate = best;
+                    report->kernels.push_back(rate);
+                }
+            }
+        };
+        std::thread single([&] {
+            try {
+                measureSingle();
+            } catch (const std::bad_alloc&) {
+                failed = true;
+            }
+        });
+        single.join();
+        if (failed) throw std::bad_alloc();
+        if (!ok) return false;
+
+        // 扩展曲线：每个线程数先绑核（物理核优先，之后才用超线程）再不绑核
+        for (unsigned threads : counts) {
+            for (bool pinned : { true, false }) {
+                PointResult best;
+                std::vector<double> samples;
+                for (unsigned rep = 0; rep < reps; ++rep) {
+                    PointResult point;
+                    if (!RunPoint(pinned ? cpus : std::vector<int>(), threads, report->bestIsa, stop, &point)) return false;
+                    for (size_t k = 0; k < kKernelCount; ++k) best.rates[k] = std::max(best.rates[k], point.rates[k]);
+                    samples.insert(samples.end(), point.mhz.begin(), point.mhz.end());
+                    progress.Step();
+                }
+                ScalingPoint result;
+                result.threads = threads;
+                result.pinned = pinned;
+                result.score = GeometricMean(best.rates, kKernelCount);
+                result.mhz = Median(samples);
+                report->scaling.push_back(result);
+            }
+        }
+        report->threads = counts.back();
+        for (ScalingPoint& point : report->scaling) {
+            if (point.threads == 1 && point.pinned) report->singleCoreScore = point.score;
+            if (point.threads == report->threads && point.pinned) {
+                report->allCoreScore = point.score;
+                report->sustainedMHz = point.mhz;
+            }
+        }
+        for (ScalingPoint& point : report->scaling) {
+            if (report->singleCoreScore > 0) point.efficiency = point.score / (point.threads * report->singleCoreScore);
+        }
+        if (report->singleCoreScore > 0) {
+            report->scalingEfficiency = report->allCoreScore / (report->threads * report->singleCoreScore);
+        }
+        if (options.mode != Mode::Soak) return true;
+
+        // 长时间满载：反复运行全核测试，记录分数与频率随时间的变化
+        Clock::time_point begin = Clock::now();
+        double duration = (double)options.soakDuration.count();
+        for (;;) {
+            double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+            if (elapsed >= duration) break;
+            progress.Update(progress.quickShare + (1 - progress.quickShare) * elapsed / duration);
+            PointResult point;
+            if (!RunPoint(cpus, report->threads, report->bestIsa, stop, &point)) break;
+            SoakSample sample;
+            sample.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+            sample.score = GeometricMean(point.rates, kKernelCount);
+            sample.mhz = Median(point.mhz);
+            report->soak.push_back(sample);
+        }
+        if (!report->soak.empty()) {
+            std::vector<double> tail;
+            for (size_t i = report->soak.size() * 3 / 4; i < report->soak.size(); ++i) tail.push_back(report->soak[i].mhz);
+            report->sustainedMHz = Median(tail);
+        }
+        return !stop.stop_requested();
+    }
+}
+
+bool Run(const Options& options, Report* report, std::stop_token stop, const ProgressFn& progress)
+{
+    *report = Report();
+
+    // 处理器顺序：先每个物理核一个，再是超线程的另一半，前 k 个线程总是尽量占满 k 个物理核
+    std::vector<int> all;
+    std::vector<numa::NodeInfo> nodes;
+    if (numa::Enumerate(&nodes, stop)) {
+        for (const numa::NodeInfo& node : nodes) all.insert(all.end(), node.cpus.begin(), node.cpus.end());
+    }
+    if (all.empty()) {
+        for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) all.push_back((int)cpu);
+    }
+    std::sort(all.begin(), all.end());
+    std::vector<int> primary = PrimaryThreads();
+    std::vector<int> cpus;
+    for (int cpu : all) {
+        if (primary.empty() || std::find(primary.begin(), primary.end(), cpu) != primary.end()) cpus.push_back(cpu);
+    }
+    report->cores = (unsigned)cpus.size();
+    for (int cpu : all) {
+        if (std::find(cpus.begin(), cpus.end(), cpu) == cpus.end()) cpus.push_back(cpu);
+    }
+    if (options.maxThreads > 0 && cpus.size() > options.maxThreads) cpus.resize(options.maxThreads);
+    report->cores = std::min(report->cores, (unsigned)cpus.size());
+
+    Progress steps;
+    steps.fn = &progress;
+    if (options.mode == Mode::Soak) steps.quickShare = 10.0 / (10.0 + (double)options.soakDuration.count());
+
+    try {
+        if (!Measure(options, cpus, report->cores, stop, steps, report)) {
+            report->cancelled = true;
+            return false;
+        }
+    } catch (const std::bad_alloc&) {
+        report->error = "内存不足";
+        return false;
+    } catch (const std::system_error&) {
+        report->error = "无法创建测试线程";
+        return false;
+    }
+    return true;
+}
+
+} // namespace cpubench
@@ -0,0 +1,111 @@
+#ifndef CPUBENCH_H
+#define CPUBENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+// ========== CPU 性能测试 ==========
+// 四个固定内核：整数（xorshift + 乘法）、浮点（多项式求值）、哈希（XXH3 式 64 位累加）、压缩（LZ77 贪心匹配）。
+// 每个内核有标量、SSE4.1、AVX2、AVX-512 四个版本，按 cpuid 与操作系统保存的寄存器状态在运行时选择；
+// 各版本先用同一输入校验结果与标量版一致，不一致的版本不参与评分。
+// 之后用最快的版本在 1..N 个线程上各跑一遍（先绑核、再不绑核），每个线程的工作量固定（弱扩展），
+// 得到单核分数、全核分数与扩展效率。频率用相互依赖的整数加法链测：空闲单核为瞬时频率，全核满载时为持续频率。
+// 快速模式工作量固定、结果可复现（约 10 秒）；长时间模式之后再持续满载，观察功耗墙与温度墙造成的降频。
+// 不依赖 wxWidgets。
+namespace cpubench
+{
+
+enum class Kernel
+{
+    Integer,      // 百万次元素更新/秒
+    Float,        // 百万次浮点运算/秒（乘、加各计一次，FMA 计两次）
+    Hash,         // MB/s
+    Compress,     // MB/s（输入）
+};
+
+enum class Isa
+{
+    Scalar,
+    Sse41,
+    Avx2,         // 含 FMA
+    Avx512,       // F + BW
+};
+
+const char* KernelName(Kernel kernel);   // "integer"、"float"、"hash"、"compress"
+const char* KernelUnit(Kernel kernel);   // "Mop/s"、"MFLOP/s"、"MB/s"
+const char* IsaName(Isa isa);            // "scalar"、"sse4.1"、"avx2"、"avx512"
+
+// 本机处理器与操作系统都支持的指令集，升序；非 x86 平台只有 Scalar
+std::vector<Isa> SupportedIsas();
+
+enum class Mode
+{
+    Quick,        // 固定工作量，约 10 秒
+    Soak,         // 快速模式之后全核持续满载 soakDuration
+};
+
+const char* ModeName(Mode mode);         // "quick"、"soak"
+
+struct Options
+{
+    Mode mode = Mode::Quick;
+    std::chrono::seconds soakDuration{ 600 };
+    unsigned repetitions = 2;            // 每项测量重复次数，取最快一次
+    unsigned maxThreads = 0;             // 0 表示全部逻辑处理器
+};
+
+struct KernelRate
+{
+    Kernel kernel = Kernel::Integer;
+    Isa isa = Isa::Scalar;
+    double rate = 0;                     // 单线程，单位见 KernelUnit
+};
+
+struct ScalingPoint
+{
+    unsigned threads = 0;
+    bool pinned = false;
+    double score = 0;
+    double efficiency = 0;               // score / (threads × 单核分数)
+    double mhz = 0;                      // 该点满载时各线程测得频率的中位数；0 表示无法测量
+};
+
+struct SoakSample
+{
+    double seconds = 0;                  // 自满载开始
+    double score = 0;
+    double mhz = 0;
+};
+
+// 分数为四个内核速率的几何平均（各自的单位，百万/秒），只在同一版本的测试之间可比
+struct Report
+{
+    Isa bestIsa = Isa::Scalar;           // 评分所用的指令集：通过校验的最高一级
+    std::vector<KernelRate> kernels;     // 每个内核 × 每个支持的指令集
+    std::vector<ScalingPoint> scaling;   // 按线程数升序，同一线程数先绑核后不绑核
+    std::vector<SoakSample> soak;        // 仅长时间模式
+    unsigned threads = 0;                // 全核测试的线程数
+    unsigned cores = 0;                  // 物理核数
+    double singleCoreScore = 0;
+    double allCoreScore = 0;
+    double scalingEfficiency = 0;        // allCoreScore / (threads × singleCoreScore)
+    double burstMHz = 0;                 // 空闲时单核
+    double sustainedMHz = 0;             // 全核满载（长时间模式取最后四分之一）
+    std::vector<Isa> rejected;           // 结果与标量版不一致而弃用的指令集
+    bool cancelled = false;              // 长时间模式中途停止时，已有的满载样本照常计入
+    std::string error;
+};
+
+// 进度回调在测试线程上调用，fraction 为整体完成比例
+using ProgressFn = std::function<void(double fraction)>;
+
+// 阻塞运行；测试线程各自绑核，调用线程的亲和性不变
+bool Run(const Options& options, Report* report, std::stop_token stop = {}, const ProgressFn& progress = {});
+
+} // namespace cpubench
+
+#endif // CPUBENCH_H
@@ -0,0 +1,342 @@
+#include "daemon.h"
+#include "lowimpact.h"
+#include <wx/log.h>
+#include <unordered_map>
+#include <vector>
+
+// ========== 已发布的快照 ==========
+// 不可变；各种响应的负载在发布时编码一次，处理请求时只需追加到发送缓冲
+struct Daemon::Published
+{
+    uint64_t generation = 0;
+    std::string snapshotPayload;     // u64 代号 + 二进制快照
+    std::string generationPayload;   // u64 代号
+    std::string fingerprint;
+    std::unordered_map<std::string, std::string> fields;
+};
+
+// ========== 客户端会话 ==========
+// 每个连接一个线程，所有读写都在该线程上进行；
+// 发布线程只把推送帧放进 outbox 并唤醒它
+struct Daemon::Session
+{
+    std::unique_ptr<ipc::Connection> conn;
+    std::thread thread;
+    std::atomic<bool> done{false};
+
+    std::mutex mutex;                // 保护以下字段
+    std::string outbox;              // 待写出的推送帧
+    bool subscribed = false;
+    uint32_t subscriptionId = 0;
+};
+
+Daemon::Daemon(const DaemonOptions& options)
+    : m_options(options)
+{
+    if (m_options.endpoint.empty()) m_options.endpoint = ipc::DefaultEndpoint();
+    if (m_options.sharedName.empty()) m_options.sharedName = ipc::DefaultSharedName();
+}
+
+Daemon::~Daemon()
+{
+    RequestStop();
+    shutdown();
+}
+
+bool Daemon::Start(std::string* error)
+{
+    m_listener = ipc::Listener::Listen(m_options.endpoint, error);
+    if (!m_listener) return false;
+
+    // 共享内存只是加速路径：创建失败时照常提供管道/套接字服务
+    std::string shmError;
+    m_shared = ipc::SharedSnapshotWriter::Create(m_options.sharedName, m_options.sharedCapacity, &shmError);
+    if (!m_shared) wxLogWarning("shared snapshot unavailable: %s", shmError);
+
+    m_collector = std::thread([this] { collectLoop(); });
+    m_acceptor = std::thread([this] { acceptLoop(); });
+    wxLogMessage("daemon listening on %s", m_options.endpoint);
+    return true;
+}
+
+void Daemon::Run()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond.wait(lock, [this] { return m_stopping; });
+    }
+    shutdown();
+}
+
+// 停止监听、等待采集结束，再唤醒并等待所有会话线程；可重复调用
+void Daemon::shutdown()
+{
+    if (m_listener) m_listener->Stop();
+    if (m_acceptor.joinable()) m_acceptor.join();
+    if (m_collector.joinable()) m_collector.join();
+
+    std::list<std::shared_ptr<Session>> sessions;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        sessions.swap(m_sessions);
+    }
+    for (auto& session : sessions) {
+        session->conn->Wake();
+        if (session->thread.joinable()) session->thread.join();
+    }
+}
+
+void Daemon::RequestStop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_stop.request_stop();
+    m_cond.notify_all();
+}
+
+void Daemon::RequestRefresh()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_refreshRequested = true;
+    }
+    m_cond.notify_all();
+}
+
+// ========== 采集 ==========
+void Daemon::collectLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    bool first = true;
+    std::chrono::milliseconds phase = lowimpact::StartJitter(m_options.startJitter);
+    if (phase.count() > 0) {
+        m_cond.wait_for(lock, phase, [this] { return m_stopping || m_refreshRequested; });
+    }
+    std::chrono::steady_clock::time_point lastStart;
+    while (!m_stopping) {
+        if (!first) {
+            m_cond.wait_for(lock, m_options.refreshInterval,
+                            [this] { return m_stopping || m_refreshRequested; });
+            if (m_stopping) break;
+            // 请求来得太密：等到最小间隔结束，期间的其它请求只是再次置位同一标志
+            auto earliest = lastStart + m_options.minRefreshInterval;
+            if (m_refreshRequested && std::chrono::steady_clock::now() < earliest) {
+                m_cond.wait_until(lock, earliest, [this] { return m_stopping; });
+                if (m_stopping) break;
+            }
+        }
+        first = false;
+        m_refreshRequested = false;
+        lastStart = std::chrono::steady_clock::now();
+
+        lock.unlock();
+        Hardware hw = mt::SyncWait(Hardware::CollectAsync(Hardware::SharedPool(), m_stop.get_token(), m_options.collect));
+        if (!m_stop.stop_requested()) publish(std::move(hw));
+        lock.lock();
+    }
+}
+
+void Daemon::publish(Hardware&& hw)
+{
+    // m_last、m_generation 只由采集线程写入
+    std::vector<schema::FieldChange> changes;
+    if (m_generation != 0) {
+        changes = schema::Diff(m_last, hw);
+        if (changes.empty()) return;   // 内容未变：代号不变，也不打扰订阅者
+    }
+
+    uint64_t generation = m_generation + 1;
+    auto pub = std::make_shared<Published>();
+    pub->generation = generation;
+    std::string blob = schema::ToBinary(hw);
+    ipc::AppendU64(pub->snapshotPayload, generation);
+    pub->snapshotPayload += blob;
+    ipc::AppendU64(pub->generationPayload, generation);
+    pub->fingerprint = Hardware::ToUtf8(hw.MachineFingerprint);
+    schema::ForEachKeyValue(hw, [&pub](const std::string& key, const std::string& value) {
+        pub->fields.emplace(key, value);
+    });
+
+    if (m_shared && !m_shared->Publish(generation, blob.data(), blob.size())) {
+        wxLogWarning("snapshot (%zu bytes) exceeds shared memory capacity", blob.size());
+    }
+
+    // 推送：u64 代号 + 变化的字段名（首个快照为空列表）
+    std::string event;
+    ipc::AppendU64(event, generation);
+    for (size_t i = 0; i < changes.size(); ++i) {
+        if (i > 0) event += '\n';
+        event += changes[i].name;
+    }
+
+    m_last = std::move(hw);
+
+    std::vector<std::shared_ptr<Session>> subscribers;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_generation = generation;
+        m_current = std::move(pub);
+        subscribers.assign(m_sessions.begin(), m_sessions.end());
+    }
+    for (auto& session : subscribers) {
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            if (!session->subscribed) continue;
+            ipc::AppendFrame(session->outbox, ipc::OpChanged, ipc::StatusOk, session->subscriptionId,
+                             event.data(), event.size());
+        }
+        session->conn->Wake();
+    }
+}
+
+// ========== 连接 ==========
+void Daemon::acceptLoop()
+{
+    while (std::unique_ptr<ipc::Connection> conn = m_listener->Accept()) {
+        auto session = std::make_shared<Session>();
+        session->conn = std::move(conn);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) break;
+        // 顺便回收已结束的会话
+        for (auto it = m_sessions.begin(); it != m_sessions.end();) {
+            if ((*it)->done.load()) {
+                (*it)->thread.join();
+                it = m_sessions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        session->thread = std::thread([this, session] { serveSession(session); });
+        m_sessions.push_back(std::move(session));
+    }
+}
+
+void Daemon::serveSession(std::shared_ptr<Session> session)
+{
+    std::vector<char> buf(64 * 1024);
+    std::string in;
+    std::string out;
+    size_t pos = 0;
+
+    for (;;) {
+        long n = session->conn->Read(buf.data(), buf.size());
+        if (n == 0 || n == -1) break;
+        if (n > 0) in.append(buf.data(), (size_t)n);
+
+        // 每批请求只取一次当前快照（一次加锁），批内所有请求看到同一代号
+        std::shared_ptr<const Published> current;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping) break;
+            current = m_current;
+        }
+
+        // 流水线：处理缓冲区中所有完整的帧，响应合并为一次写出
+        bool malformed = false;
+        for (;;) {
+            ipc::FrameView frame;
+            size_t consumed = 0;
+            ipc::ParseResult r = ipc::ParseFrame(in.data() + pos, in.size() - pos, &frame, &consumed);
+            if (r == ipc::ParseResult::Incomplete) break;
+            if (r == ipc::ParseResult::Malformed) {
+                malformed = true;
+                break;
+            }
+            handleFrame(*session, frame, current, out);
+            pos += consumed;
+        }
+        if (malformed) break;
+        if (pos == in.size()) {
+            in.clear();
+            pos = 0;
+        } else if (pos > in.size() / 2) {
+            in.erase(0, pos);
+            pos = 0;
+        }
+
+        // 推送帧排在本批响应之后
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            if (!session->outbox.empty()) {
+                out += session->outbox;
+                session->outbox.clear();
+            }
+        }
+        if (!out.empty()) {
+            if (!session->conn->Write(out.data(), out.size())) break;
+            out.clear();
+        }
+    }
+    session->done = true;
+}
+
+void Daemon::handleFrame(Session& session, const ipc::FrameView& frame,
+                         const std::shared_ptr<const Published>& current, std::string& out)
+{
+    uint8_t op = frame.op | ipc::ResponseFlag;
+    auto reply = [&](uint8_t status, const std::string& payload) {
+        ipc::AppendFrame(out, op, status, frame.id, payload.data(), payload.size());
+    };
+    auto empty = [&](uint8_t status) {
+        ipc::AppendFrame(out, op, status, frame.id, nullptr, 0);
+    };
+
+    switch (frame.op) {
+        case ipc::OpPing:
+            empty(ipc::StatusOk);
+            return;
+        case ipc::OpSubscribe: {
+            std::lock_guard<std::mutex> lock(session.mutex);
+            session.subscribed = true;
+            session.subscriptionId = frame.id;
+            empty(ipc::StatusOk);
+            return;
+        }
+        case ipc::OpUnsubscribe: {
+            std::lock_guard<std::mutex> lock(session.mutex);
+            session.subscribed = false;
+            empty(ipc::StatusOk);
+            return;
+        }
+        case ipc::OpRefresh:
+            RequestRefresh();
+            empty(ipc::StatusOk);
+            return;
+        case ipc::OpGetSnapshot:
+        case ipc::OpGetField:
+        case ipc::OpGetFingerprint:
+        case ipc::OpGetGeneration:
+            break;
+        default:
+            empty(ipc::StatusBadRequest);
+            return;
+    }
+
+    if (!current) {
+        empty(ipc::StatusUnavailable);
+        return;
+    }
+    switch (frame.op) {
+        case ipc::OpGetSnapshot:
+            reply(ipc::StatusOk, current->snapshotPayload);
+            break;
+        case ipc::OpGetFingerprint:
+            reply(ipc::StatusOk, current->fingerprint);
+            break;
+        case ipc::OpGetGeneration:
+            reply(ipc::StatusOk, current->generationPayload);
+            break;
+        case ipc::OpGetField: {
+            auto it = current->fields.find(std::string(frame.payload, frame.size));
+            if (it == current->fields.end()) {
+                empty(ipc::StatusNotFound);
+            } else {
+                reply(ipc::StatusOk, it->second);
+            }
+            break;
+        }
+    }
+}
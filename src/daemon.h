@@ -0,0 +1,74 @@
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "hardware.h"
+#include "ipc.h"
+
+// ========== 常驻守护进程 ==========
+// 在内存中保存最新快照，经命名管道 / Unix 域套接字按 ipc.h 的协议提供查询，
+// 同时把快照写入共享内存供只读客户端直接映射。快照按周期或按 OpRefresh 请求重新采集，
+// 内容变化时代号加一并推送给订阅者。
+struct DaemonOptions
+{
+    std::string endpoint;                          // 空 = ipc::DefaultEndpoint()
+    std::string sharedName;                        // 空 = ipc::DefaultSharedName()
+    size_t sharedCapacity = 256 * 1024;            // 共享内存数据区大小
+    std::chrono::seconds refreshInterval{60};      // 周期性重新采集
+    // OpRefresh 触发的采集之间的最小间隔：间隔内到达的请求并入间隔结束时的一次采集，
+    // 任意客户端都无法借此让守护进程连续满负荷采集
+    std::chrono::seconds minRefreshInterval{10};
+    CollectOptions collect;                        // 每次采集的预算
+    // 首次采集前的延迟上限：按主机散列（见 lowimpact.h）得到固定偏移，此后各周期保持该相位，
+    // 同时启动的机群不会在同一时刻一起采集。OpRefresh 不受影响
+    std::chrono::milliseconds startJitter{0};
+};
+
+class Daemon
+{
+public:
+    explicit Daemon(const DaemonOptions& options);
+    ~Daemon();
+
+    bool Start(std::string* error);   // 监听端点、创建共享内存、开始首次采集
+    void Run();                       // 阻塞直到 RequestStop()，返回前关闭所有连接
+    void RequestStop();               // 线程安全
+    void RequestRefresh();            // 线程安全
+
+private:
+    struct Published;
+    struct Session;
+
+    void collectLoop();
+    void acceptLoop();
+    void serveSession(std::shared_ptr<Session> session);
+    void handleFrame(Session& session, const ipc::FrameView& frame,
+                     const std::shared_ptr<const Published>& current, std::string& out);
+    void publish(Hardware&& hw);
+    void shutdown();
+
+    DaemonOptions m_options;
+    std::unique_ptr<ipc::Listener> m_listener;
+    std::unique_ptr<ipc::SharedSnapshotWriter> m_shared;
+    std::stop_source m_stop;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::shared_ptr<const Published> m_current;    // 读者每批请求取一次
+    HardwareSnapshot m_last;                       // 上次发布的内容，用于比较
+    uint64_t m_generation = 0;
+    bool m_refreshRequested = false;
+    bool m_stopping = false;
+    std::list<std::shared_ptr<Session>> m_sessions;
+
+    std::thread m_collector;
+    std::thread m_acceptor;
+};
+
+#endif // DAEMON_H
@@ -0,0 +1,946 @@
+#include "diskbench.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <winioctl.h>
+    #include <map>
+#else
+    #include <cerrno>
+    #include <cstdlib>
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/statvfs.h>
+    #include <sys/syscall.h>
+    #if __has_include(<linux/io_uring.h>)
+        #include <linux/io_uring.h>
+        #define DISKBENCH_IO_URING 1
+    #endif
+#endif
+
+namespace diskbench
+{
+
+using Clock = std::chrono::steady_clock;
+
+const char* PatternName(Pattern pattern)
+{
+    switch (pattern) {
+        case Pattern::SequentialWrite: return "seq-write";
+        case Pattern::SequentialRead: return "seq-read";
+        case Pattern::RandomRead: return "rand-read";
+    }
+    return "unknown";
+}
+
+std::vector<Spec> DefaultSpecs()
+{
+    return {
+        { Pattern::SequentialWrite, 1u << 20, 8 },
+        { Pattern::SequentialRead, 1u << 20, 8 },
+        { Pattern::RandomRead, 4096, 1 },
+        { Pattern::RandomRead, 4096, 32 },
+    };
+}
+
+namespace
+{
+    constexpr size_t kAlignment = 4096;            // 覆盖 512 字节与 4K 扇区
+    constexpr uint64_t kMinFileBytes = 64ull << 20;
+    constexpr uint32_t kMaxQueueDepth = 256;
+
+    // ========== 延迟直方图 ==========
+    // 对数分桶：每个 2 的幂区间再分 16 个子桶（相对误差约 3%），记录一次样本只是一次自增，
+    // 高队列深度下几百万次请求也不需要保存原始样本
+    class Histogram
+    {
+    public:
+        void Add(uint64_t ns)
+        {
+            ++m_counts[Bucket(ns)];
+            ++m_count;
+            m_sum += ns;
+            m_max = std::max(m_max, ns);
+        }
+
+        void Merge(const Histogram& other)
+        {
+            for (size_t i = 0; i < kBuckets; ++i) m_counts[i] += other.m_counts[i];
+            m_count += other.m_count;
+            m_sum += other.m_sum;
+            m_max = std::max(m_max, other.m_max);
+        }
+
+        uint64_t Count() const { return m_count; }
+        double MeanNs() const { return m_count ? (double)m_sum / m_count : 0; }
+        double MaxNs() const { return (double)m_max; }
+
+        // 取包含第 ceil(q × 样本数) 个样本的桶的中点，不超过实测最大值
+        double PercentileNs(double q) const
+        {
+            if (m_count == 0) return 0;
+            uint64_t rank = std::max<uint64_t>(1, (uint64_t)std::ceil(q * m_count));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < kBuckets; ++i) {
+                seen += m_counts[i];
+                if (seen >= rank) return std::min(Midpoint(i), (double)m_max);
+            }
+            return (double)m_max;
+        }
+
+    private:
+        static constexpr uint64_t kSub = 16;
+        static constexpr size_t kBuckets = 61 * kSub;
+
+        // [0,16) 每个值一个桶；之后 [2^e, 2^(e+1)) 分成 16 个等宽子桶
+        static size_t Bucket(uint64_t ns)
+        {
+            if (ns < kSub) return (size_t)ns;
+            int e = 63 - std::countl_zero(ns);
+            return (size_t)(e - 3) * kSub + ((ns >> (e - 4)) & (kSub - 1));
+        }
+
+        static double Midpoint(size_t index)
+        {
+            if (index < kSub) return (double)index;
+            int e = (int)(index / kSub) + 3;
+            uint64_t width = 1ull << (e - 4);
+            return (double)((kSub + index % kSub) * width) + width / 2.0;
+        }
+
+        uint64_t m_counts[kBuckets] = {};
+        uint64_t m_count = 0;
+        uint64_t m_sum = 0;
+        uint64_t m_max = 0;
+    };
+
+    uint64_t XorShift(uint64_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    uint64_t Seed(uint32_t slot)
+    {
+        return 0x9E3779B97F4A7C15ull * (slot + 1) ^ (uint64_t)Clock::now().time_since_epoch().count();
+    }
+
+    // 按扇区对齐的缓冲区：每个队列槽一块，写测试填入随机数据，避免主控压缩或去重
+    class Buffers
+    {
+    public:
+        Buffers(uint32_t count, uint32_t size, bool fill)
+            : m_size(size),
+              m_data((uint8_t*)::operator new((size_t)count * size, std::align_val_t(kAlignment)))
+        {
+            uint64_t state = Seed(count);
+            if (fill) {
+                for (size_t i = 0; i + 8 <= (size_t)count * size; i += 8) {
+                    uint64_t v = XorShift(state);
+                    memcpy(m_data + i, &v, 8);
+                }
+            }
+        }
+
+        ~Buffers()
+        {
+            ::operator delete(m_data, std::align_val_t(kAlignment));
+        }
+
+        Buffers(const Buffers&) = delete;
+        Buffers& operator=(const Buffers&) = delete;
+
+        uint8_t* Slot(uint32_t slot) const { return m_data + (size_t)slot * m_size; }
+
+    private:
+        uint32_t m_size;
+        uint8_t* m_data;
+    };
+
+    // ========== 单项测试的请求来源 ==========
+    // 各引擎只负责提交与等待完成；偏移、截止时间与取消都在这里判断，保证口径一致
+    struct Workload
+    {
+        Spec spec;
+        uint64_t extent = 0;                   // 可访问的文件范围（字节）
+        Clock::time_point start;
+        Clock::time_point deadline;
+        std::stop_token stop;
+        const Buffers* buffers = nullptr;
+        const ProgressFn* progress = nullptr;
+        size_t index = 0;                      // 在 specs 中的下标，用于进度回调
+        std::atomic<uint64_t> nextBlock{ 0 };   // 顺序测试的下一块
+        std::atomic<int64_t> lastReport{ 0 };   // 上次进度回调，距 start 的毫秒数
+
+        bool IsWrite() const { return spec.pattern == Pattern::SequentialWrite; }
+        uint64_t Blocks() const { return extent / spec.blockSize; }
+
+        // 取下一次请求的偏移；返回 false 表示本项测试结束（到时、取消或顺序测试走完）
+        bool Next(uint64_t& rng, uint64_t* offset)
+        {
+            Clock::time_point now = Clock::now();
+            if (stop.stop_requested() || now >= deadline) return false;
+            reportProgress(now);
+            if (spec.pattern == Pattern::RandomRead) {
+                *offset = XorShift(rng) % Blocks() * spec.blockSize;
+                return true;
+            }
+            uint64_t block = nextBlock.fetch_add(1, std::memory_order_relaxed);
+            if (block >= Blocks()) return false;
+            *offset = block * spec.blockSize;
+            return true;
+        }
+
+        // 顺序测试取已提交块数与时间两者中较大的比例；约每 100 ms 回调一次
+        void reportProgress(Clock::time_point now)
+        {
+            if (!progress || !*progress) return;
+            int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
+            int64_t last = lastReport.load(std::memory_order_relaxed);
+            if (elapsed - last < 100 || !lastReport.compare_exchange_strong(last, elapsed)) return;
+            int64_t total = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - start).count();
+            double fraction = (double)elapsed / std::max<int64_t>(total, 1);
+            if (spec.pattern != Pattern::RandomRead) {
+                fraction = std::max(fraction, (double)nextBlock.load(std::memory_order_relaxed) / Blocks());
+            }
+            (*progress)(index, std::min(fraction, 1.0));
+        }
+    };
+
+    // 每种提交方式一个引擎；Execute 跑完一项测试并等待在途请求全部完成后返回
+    class Engine
+    {
+    public:
+        virtual ~Engine() = default;
+        virtual const char* Name() const = 0;
+        virtual bool Execute(Workload& work, Histogram* hist, uint64_t* bytes, std::string* error) = 0;
+    };
+
+    // 异步引擎共用的调度：某个队列槽完成后立即为它补交下一次请求，保持队列深度
+    template <typename Queue>
+    bool Pump(Queue& queue, Workload& work, Histogram* hist, uint64_t* bytes, std::string* error)
+    {
+        uint32_t depth = work.spec.queueDepth;
+        std::vector<Clock::time_point> issued(depth);
+        std::vector<uint64_t> rng(depth);
+        uint32_t inflight = 0;
+        bool failed = false;
+
+        auto issue = [&](uint32_t slot) {
+            uint64_t offset;
+            if (failed || !work.Next(rng[slot], &offset)) return;
+            issued[slot] = Clock::now();
+            if (!queue.Submit(work, slot, offset, error)) {
+                failed = true;
+                return;
+            }
+            ++inflight;
+        };
+        auto complete = [&](uint32_t slot, int64_t result) {
+            Clock::time_point now = Clock::now();
+            --inflight;
+            if (result != (int64_t)work.spec.blockSize) {
+                if (!failed) *error = "I/O 请求失败（返回 " + std::to_string(result) + "）";
+                failed = true;
+                return;
+            }
+            hist->Add((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now - issued[slot]).count());
+            *bytes += work.spec.blockSize;
+            issue(slot);
+        };
+
+        for (uint32_t slot = 0; slot < depth; ++slot) {
+            rng[slot] = Seed(slot);
+            issue(slot);
+        }
+        // 出错后不再补交，但仍要等在途请求完成：缓冲区在它们完成前不能释放
+        while (inflight > 0) {
+            if (!queue.Reap(complete, error)) return false;
+        }
+        return !failed;
+    }
+
+    std::string DescribeSize(uint64_t bytes)
+    {
+        return std::to_string(bytes >> 20) + " MB";
+    }
+}
+
+#ifdef _WIN32
+
+// ========== Windows：重叠 I/O + 完成端口 ==========
+namespace
+{
+    std::wstring Widen(const std::string& str)
+    {
+        int n = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0);
+        if (n <= 1) return std::wstring();
+        std::wstring out(n - 1, L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, &out[0], n);
+        return out;
+    }
+
+    std::string ToUtf8(const wchar_t* str)
+    {
+        int n = WideCharToMultiByte(CP_UTF8, 0, str, -1, nullptr, 0, nullptr, nullptr);
+        if (n <= 1) return std::string();
+        std::string out(n - 1, '\0');
+        WideCharToMultiByte(CP_UTF8, 0, str, -1, &out[0], n, nullptr, nullptr);
+        return out;
+    }
+
+    std::string LastError(const char* what)
+    {
+        return std::string(what) + " 失败（错误 " + std::to_string(GetLastError()) + "）";
+    }
+
+    class IocpEngine : public Engine
+    {
+    public:
+        IocpEngine(HANDLE file, HANDLE port) : m_file(file), m_port(port), m_overlapped(kMaxQueueDepth) {}
+        ~IocpEngine() override { CloseHandle(m_port); }
+
+        const char* Name() const override { return "iocp"; }
+
+        bool Execute(Workload& work, Histogram* hist, uint64_t* bytes, std::string* error) override
+        {
+            return Pump(*this, work, hist, bytes, error);
+        }
+
+        bool Submit(const Workload& work, uint32_t slot, uint64_t offset, std::string* error)
+        {
+            OVERLAPPED& ov = m_overlapped[slot];
+            ZeroMemory(&ov, sizeof(ov));
+            ov.Offset = (DWORD)offset;
+            ov.OffsetHigh = (DWORD)(offset >> 32);
+            BOOL ok = work.IsWrite()
+                ? WriteFile(m_file, work.buffers->Slot(slot), work.spec.blockSize, nullptr, &ov)
+                : ReadFile(m_file, work.buffers->Slot(slot), work.spec.blockSize, nullptr, &ov);
+            // 同步完成的请求同样会投递到完成端口，统一在 Reap 中处理
+            if (!ok && GetLastError() != ERROR_IO_PENDING) {
+                *error = LastError(work.IsWrite() ? "WriteFile" : "ReadFile");
+                return false;
+            }
+            return true;
+        }
+
+        template <typename Fn>
+        bool Reap(Fn&& complete, std::string* error)
+        {
+            OVERLAPPED_ENTRY entries[64];
+            ULONG count = 0;
+            if (!GetQueuedCompletionStatusEx(m_port, entries, 64, &count, INFINITE, FALSE)) {
+                *error = LastError("GetQueuedCompletionStatusEx");
+                return false;
+            }
+            for (ULONG i = 0; i < count; ++i) {
+                OVERLAPPED* ov = entries[i].lpOverlapped;
+                bool ok = ov->Internal == 0;   // NTSTATUS，STATUS_SUCCESS 为 0
+                complete((uint32_t)(ov - m_overlapped.data()), ok ? (int64_t)entries[i].dwNumberOfBytesTransferred : -1);
+            }
+            return true;
+        }
+
+    private:
+        HANDLE m_file;
+        HANDLE m_port;
+        std::vector<OVERLAPPED> m_overlapped;
+    };
+
+    // 关闭即删除；无缓存 + 直写，读写都落到设备
+    struct TempFile
+    {
+        HANDLE handle = INVALID_HANDLE_VALUE;
+        ~TempFile() { if (handle != INVALID_HANDLE_VALUE) CloseHandle(handle); }
+    };
+
+    bool OpenTemp(const std::string& directory, TempFile* file, bool* direct, std::string* error)
+    {
+        std::wstring dir = Widen(directory);
+        wchar_t path[MAX_PATH];
+        if (!GetTempFileNameW(dir.c_str(), L"mtb", 0, path)) {
+            *error = LastError("GetTempFileName");
+            return false;
+        }
+        file->handle = CreateFileW(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                                   FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH | FILE_FLAG_OVERLAPPED |
+                                   FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+        if (file->handle == INVALID_HANDLE_VALUE) {
+            *error = LastError("CreateFile");
+            DeleteFileW(path);
+            return false;
+        }
+        *direct = true;
+        return true;
+    }
+
+    uint64_t FreeBytes(const std::string& directory)
+    {
+        ULARGE_INTEGER available;
+        return GetDiskFreeSpaceExW(Widen(directory).c_str(), &available, nullptr, nullptr) ? available.QuadPart : 0;
+    }
+
+    // 只设文件大小；有效数据长度之外的写入由 NTFS 同步补零，顺序写测试即由此首次写满文件
+    bool Preallocate(const TempFile& file, uint64_t size)
+    {
+        LARGE_INTEGER end;
+        end.QuadPart = (LONGLONG)size;
+        return SetFilePointerEx(file.handle, end, nullptr, FILE_BEGIN) && SetEndOfFile(file.handle);
+    }
+
+    // 直写文件没有系统缓存，读测试前无需处理
+    void DropCache(const TempFile&) {}
+
+    std::unique_ptr<Engine> MakeEngine(const TempFile& file)
+    {
+        HANDLE port = CreateIoCompletionPort(file.handle, nullptr, 0, 1);
+        if (!port) return nullptr;
+        return std::make_unique<IocpEngine>(file.handle, port);
+    }
+
+    // \\.\PhysicalDriveN 的产品名（STORAGE_DEVICE_DESCRIPTOR）
+    std::string DiskProduct(DWORD number)
+    {
+        std::wstring path = L"\\\\.\\PhysicalDrive" + std::to_wstring(number);
+        HANDLE disk = CreateFileW(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+        if (disk == INVALID_HANDLE_VALUE) return std::string();
+        STORAGE_PROPERTY_QUERY query = {};
+        query.PropertyId = StorageDeviceProperty;
+        query.QueryType = PropertyStandardQuery;
+        std::vector<uint8_t> buf(1024);
+        DWORD size = 0;
+        std::string product;
+        if (DeviceIoControl(disk, IOCTL_STORAGE_QUERY_PROPERTY, &query, sizeof(query), buf.data(), (DWORD)buf.size(),
+                            &size, nullptr) && size >= sizeof(STORAGE_DEVICE_DESCRIPTOR)) {
+            const STORAGE_DEVICE_DESCRIPTOR* desc = (const STORAGE_DEVICE_DESCRIPTOR*)buf.data();
+            if (desc->ProductIdOffset && desc->ProductIdOffset < size) {
+                const char* p = (const char*)buf.data() + desc->ProductIdOffset;
+                product.assign(p, strnlen(p, size - desc->ProductIdOffset));
+            }
+        }
+        CloseHandle(disk);
+        return product;
+    }
+
+    // 卷所在的物理磁盘号（跨盘的动态卷有多个）
+    std::vector<DWORD> VolumeDisks(const wchar_t* volume)
+    {
+        std::wstring device(volume);
+        if (!device.empty() && device.back() == L'\\') device.pop_back();   // CreateFile 打开卷时不带结尾 '\'
+        std::vector<DWORD> disks;
+        HANDLE handle = CreateFileW(device.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) return disks;
+        std::vector<uint8_t> buf(sizeof(VOLUME_DISK_EXTENTS) + 15 * sizeof(DISK_EXTENT));
+        DWORD size = 0;
+        if (DeviceIoControl(handle, IOCTL_VOLUME_GET_VOLUME_DISK_EXTENTS, nullptr, 0, buf.data(), (DWORD)buf.size(),
+                            &size, nullptr)) {
+            const VOLUME_DISK_EXTENTS* extents = (const VOLUME_DISK_EXTENTS*)buf.data();
+            for (DWORD i = 0; i < extents->NumberOfDiskExtents && i < 16; ++i) {
+                disks.push_back(extents->Extents[i].DiskNumber);
+            }
+        }
+        CloseHandle(handle);
+        return disks;
+    }
+}
+
+#else
+
+// ========== 其它平台：io_uring，或每个队列槽一个线程 ==========
+namespace
+{
+    std::string Errno(const char* what)
+    {
+        return std::string(what) + " 失败（" + strerror(errno) + "）";
+    }
+
+#ifdef DISKBENCH_IO_URING
+    // 直接使用系统调用与共享环，不依赖 liburing
+    class UringEngine : public Engine
+    {
+    public:
+        static std::unique_ptr<UringEngine> Create(int fd)
+        {
+            std::unique_ptr<UringEngine> engine(new UringEngine(fd));
+            return engine->setup() ? std::move(engine) : nullptr;
+        }
+
+        ~UringEngine() override
+        {
+            if (m_sqes) munmap(m_sqes, m_sqesSize);
+            if (m_cq && m_cq != m_sq) munmap(m_cq, m_cqSize);
+            if (m_sq) munmap(m_sq, m_sqSize);
+            if (m_ring >= 0) close(m_ring);
+        }
+
+        const char* Name() const override { return "io_uring"; }
+
+        bool Execute(Workload& work, Histogram* hist, uint64_t* bytes, std::string* error) override
+        {
+            return Pump(*this, work, hist, bytes, error);
+        }
+
+        // 只填 SQE，真正提交在 Reap 的 io_uring_enter 中批量完成
+        bool Submit(const Workload& work, uint32_t slot, uint64_t offset, std::string*)
+        {
+            unsigned tail = *m_sqTail;
+            unsigned index = tail & *m_sqMask;
+            io_uring_sqe* sqe = &m_sqes[index];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = work.IsWrite() ? IORING_OP_WRITE : IORING_OP_READ;
+            sqe->fd = m_fd;
+            sqe->off = offset;
+            sqe->addr = (uint64_t)(uintptr_t)work.buffers->Slot(slot);
+            sqe->len = work.spec.blockSize;
+            sqe->user_data = slot;
+            m_sqArray[index] = index;
+            std::atomic_ref<unsigned>(*m_sqTail).store(tail + 1, std::memory_order_release);
+            ++m_pending;
+            return true;
+        }
+
+        template <typename Fn>
+        bool Reap(Fn&& complete, std::string* error)
+        {
+            for (;;) {
+                int submitted = (int)syscall(__NR_io_uring_enter, m_ring, m_pending, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                if (submitted >= 0) {
+                    m_pending -= (unsigned)submitted;
+                    break;
+                }
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EBUSY) break;   // 完成队列将满：先收割，下次再提交
+                *error = Errno("io_uring_enter");
+                return false;
+            }
+            unsigned head = *m_cqHead;
+            unsigned tail = std::atomic_ref<unsigned>(*m_cqTail).load(std::memory_order_acquire);
+            for (; head != tail; ++head) {
+                const io_uring_cqe& cqe = m_cqes[head & *m_cqMask];
+                complete((uint32_t)cqe.user_data, (int64_t)cqe.res);
+            }
+            std::atomic_ref<unsigned>(*m_cqHead).store(head, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        explicit UringEngine(int fd) : m_fd(fd) {}
+
+        bool setup()
+        {
+            io_uring_params params = {};
+            m_ring = (int)syscall(__NR_io_uring_setup, kMaxQueueDepth, &params);
+            if (m_ring < 0) return false;   // 内核过旧，或被容器的 seccomp 策略禁止
+
+            // IORING_OP_READ/WRITE 需要 5.6+，与 IORING_REGISTER_PROBE 同时引入
+            std::vector<uint8_t> probeBuf(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op));
+            io_uring_probe* probe = (io_uring_probe*)probeBuf.data();
+            if (syscall(__NR_io_uring_register, m_ring, IORING_REGISTER_PROBE, probe, 256) < 0) return false;
+            for (int op : { IORING_OP_READ, IORING_OP_WRITE }) {
+                if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
+            }
+
+            m_sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            m_cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (single) m_sqSize = m_cqSize = std::max(m_sqSize, m_cqSize);
+            m_sq = mapRing(m_sqSize, IORING_OFF_SQ_RING);
+            if (!m_sq) return false;
+            m_cq = single ? m_sq : mapRing(m_cqSize, IORING_OFF_CQ_RING);
+            if (!m_cq) return false;
+            m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            m_sqes = (io_uring_sqe*)mapRing(m_sqesSize, IORING_OFF_SQES);
+            if (!m_sqes) return false;
+
+            uint8_t* sq = (uint8_t*)m_sq;
+            uint8_t* cq = (uint8_t*)m_cq;
+            m_sqTail = (unsigned*)(sq + params.sq_off.tail);
+            m_sqMask = (unsigned*)(sq + params.sq_off.ring_mask);
+            m_sqArray = (unsigned*)(sq + params.sq_off.array);
+            m_cqHead = (unsigned*)(cq + params.cq_off.head);
+            m_cqTail = (unsigned*)(cq + params.cq_off.tail);
+            m_cqMask = (unsigned*)(cq + params.cq_off.ring_mask);
+            m_cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+            return true;
+        }
+
+        void* mapRing(size_t size, off_t offset)
+        {
+            void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, offset);
+            return p == MAP_FAILED ? nullptr : p;
+        }
+
+        int m_fd;
+        int m_ring = -1;
+        void* m_sq = nullptr;
+        void* m_cq = nullptr;
+        size_t m_sqSize = 0;
+        size_t m_cqSize = 0;
+        io_uring_sqe* m_sqes = nullptr;
+        size_t m_sqesSize = 0;
+        unsigned* m_sqTail = nullptr;
+        unsigned* m_sqMask = nullptr;
+        unsigned* m_sqArray = nullptr;
+        unsigned* m_cqHead = nullptr;
+        unsigned* m_cqTail = nullptr;
+        unsigned* m_cqMask = nullptr;
+        io_uring_cqe* m_cqes = nullptr;
+        unsigned m_pending = 0;   // 已填写、尚未交给内核的 SQE
+    };
+#endif
+
+    // 每个队列槽一个线程做同步 pread/pwrite，队列深度即并发线程数；直方图各线程各记一份，结束时合并
+    class ThreadEngine : public Engine
+    {
+    public:
+        explicit ThreadEngine(int fd) : m_fd(fd) {}
+
+        const char* Name() const override { return "threads"; }
+
+        bool Execute(Workload& work, Histogram* hist, uint64_t* bytes, std::string* error) override
+        {
+            std::mutex mutex;
+            std::atomic<bool> failed{ false };
+            std::vector<std::thread> threads;
+            for (uint32_t slot = 0; slot < work.spec.queueDepth; ++slot) {
+                threads.emplace_back([&, slot] {
+                    auto local = std::make_unique<Histogram>();
+                    uint64_t done = 0;
+                    uint64_t rng = Seed(slot);
+                    uint64_t offset;
+                    uint8_t* buf = work.buffers->Slot(slot);
+                    while (!failed.load(std::memory_order_relaxed) && work.Next(rng, &offset)) {
+                        Clock::time_point t0 = Clock::now();
+                        ssize_t n = work.IsWrite() ? pwrite(m_fd, buf, work.spec.blockSize, (off_t)offset)
+                                                   : pread(m_fd, buf, work.spec.blockSize, (off_t)offset);
+                        Clock::time_point t1 = Clock::now();
+                        if (n != (ssize_t)work.spec.blockSize) {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            if (!failed.exchange(true)) *error = Errno(work.IsWrite() ? "pwrite" : "pread");
+                            break;
+                        }
+                        local->Add((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+                        done += work.spec.blockSize;
+                    }
+                    std::lock_guard<std::mutex> lock(mutex);
+                    hist->Merge(*local);
+                    *bytes += done;
+                });
+            }
+            for (std::thread& thread : threads) thread.join();
+            return !failed.load();
+        }
+
+    private:
+        int m_fd;
+    };
+
+    // 无名临时文件（O_TMPFILE），不支持时建文件后立即 unlink：进程异常退出也不留下文件
+    struct TempFile
+    {
+        int fd = -1;
+        ~TempFile() { if (fd >= 0) close(fd); }
+    };
+
+    int OpenTempFd(const std::string& directory, bool direct)
+    {
+        int flags = O_RDWR | O_CLOEXEC | (direct ? O_DIRECT : 0);
+#ifdef O_TMPFILE
+        int fd = open(directory.c_str(), O_TMPFILE | flags, 0600);
+        if (fd >= 0 || errno == EINVAL) return fd;   // EINVAL：文件系统不接受 O_DIRECT
+#endif
+        std::string path = directory + "/.minitool-bench-XXXXXX";
+        fd = mkostemp(&path[0], O_CLOEXEC);
+        if (fd < 0) return -1;
+        unlink(path.c_str());
+        if (direct && fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_DIRECT) != 0) {
+            int saved = errno;
+            close(fd);
+            errno = saved;
+            return -1;
+        }
+        return fd;
+    }
+
+    bool OpenTemp(const std::string& directory, TempFile* file, bool* direct, std::string* error)
+    {
+        file->fd = OpenTempFd(directory, true);
+        *direct = file->fd >= 0;
+        if (file->fd < 0 && errno == EINVAL) file->fd = OpenTempFd(directory, false);   // 如 tmpfs
+        if (file->fd < 0) {
+            *error = Errno("创建测试文件");
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t FreeBytes(const std::string& directory)
+    {
+        struct statvfs st;
+        return statvfs(directory.c_str(), &st) == 0 ? (uint64_t)st.f_bavail * st.f_frsize : 0;
+    }
+
+    bool Preallocate(const TempFile& file, uint64_t size)
+    {
+        return posix_fallocate(file.fd, 0, (off_t)size) == 0 || ftruncate(file.fd, (off_t)size) == 0;
+    }
+
+    // 退回带缓存的 I/O 时，读测试前把写入的数据刷出并丢弃页缓存
+    void DropCache(const TempFile& file)
+    {
+        fdatasync(file.fd);
+        posix_fadvise(file.fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+
+    std::unique_ptr<Engine> MakeEngine(const TempFile& file)
+    {
+#ifdef DISKBENCH_IO_URING
+        if (std::unique_ptr<UringEngine> uring = UringEngine::Create(file.fd)) return uring;
+#endif
+        return std::make_unique<ThreadEngine>(file.fd);
+    }
+
+    std::string ReadSmall(const std::string& path)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return std::string();
+        char buf[256];
+        ssize_t n = read(fd, buf, sizeof(buf));
+        close(fd);
+        std::string text(buf, n > 0 ? (size_t)n : 0);
+        while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) text.pop_back();
+        return text;
+    }
+
+    // mountinfo 中挂载点的空格等字符写作 "\040"
+    std::string Unescape(const std::string& field)
+    {
+        std::string out;
+        for (size_t i = 0; i < field.size(); ++i) {
+            if (field[i] == '\\' && i + 3 < field.size() && isdigit((unsigned char)field[i + 1])) {
+                out += (char)strtol(field.substr(i + 1, 3).c_str(), nullptr, 8);
+                i += 3;
+            } else {
+                out += field[i];
+            }
+        }
+        return out;
+    }
+}
+
+#endif
+
+namespace
+{
+    // 小写、合并空白、去首尾空白，用于型号比较
+    std::string NormalizeModel(const std::string& text)
+    {
+        std::string out;
+        for (char c : text) {
+            if (isspace((unsigned char)c)) {
+                if (!out.empty() && out.back() != ' ') out += ' ';
+            } else {
+                out += (char)tolower((unsigned char)c);
+            }
+        }
+        if (!out.empty() && out.back() == ' ') out.pop_back();
+        return out;
+    }
+
+    // 注册表的友好名称与设备上报的产品名写法略有差异（厂商前缀、容量后缀），取包含关系
+    bool ModelMatches(const std::string& model, const std::string& product)
+    {
+        std::string a = NormalizeModel(model), b = NormalizeModel(product);
+        if (a.empty() || b.empty()) return false;
+        return a.find(b) != std::string::npos || b.find(a) != std::string::npos;
+    }
+}
+
+bool Run(const Options& options, Report* report, std::stop_token stop, const ProgressFn& progress)
+{
+    *report = Report();
+    for (const Spec& spec : options.specs) {
+        if (spec.blockSize == 0 || spec.blockSize % kAlignment != 0 || spec.queueDepth == 0 ||
+            spec.queueDepth > kMaxQueueDepth) {
+            report->error = "测试参数无效：块大小须为 4K 的倍数，队列深度 1~256";
+            return false;
+        }
+    }
+
+    // 文件大小：不超过写入上限与剩余空间的一半，按 1M 取整
+    uint64_t fileBytes = std::min(options.maxBytesWritten, FreeBytes(options.directory) / 2) & ~((1ull << 20) - 1);
+    if (fileBytes < kMinFileBytes) {
+        report->error = "剩余空间或写入上限不足 " + DescribeSize(kMinFileBytes * 2);
+        return false;
+    }
+
+    TempFile file;
+    if (!OpenTemp(options.directory, &file, &report->direct, &report->error)) return false;
+    Preallocate(file, fileBytes);   // 失败时由写测试扩展文件
+    std::unique_ptr<Engine> engine = MakeEngine(file);
+    if (!engine) {
+        report->error = "无法创建 I/O 队列";
+        return false;
+    }
+    report->engine = engine->Name();
+    report->fileBytes = fileBytes;
+
+    uint64_t filled = 0;   // 自文件头起已写入的字节数，读测试只访问这一段
+    for (size_t i = 0; i < options.specs.size(); ++i) {
+        const Spec& spec = options.specs[i];
+        if (stop.stop_requested()) {
+            report->cancelled = true;
+            break;
+        }
+
+        Workload work;
+        work.spec = spec;
+        work.stop = stop;
+        work.progress = &progress;
+        work.index = i;
+        if (work.IsWrite()) {
+            work.extent = std::min(fileBytes, options.maxBytesWritten - report->bytesWritten);
+        } else {
+            if (filled < spec.blockSize) {
+                report->error = "读测试之前需要先完成顺序写";
+                return false;
+            }
+            if (!report->direct) DropCache(file);
+            work.extent = filled;
+        }
+        if (work.Blocks() == 0) continue;   // 写入额度已用完
+
+        Buffers buffers(spec.queueDepth, spec.blockSize, work.IsWrite());
+        work.buffers = &buffers;
+        Histogram hist;
+        uint64_t bytes = 0;
+        work.start = Clock::now();
+        work.deadline = work.start + options.testDuration;
+        bool ok = engine->Execute(work, &hist, &bytes, &report->error);
+        double seconds = std::chrono::duration<double>(Clock::now() - work.start).count();
+
+        if (work.IsWrite()) {
+            report->bytesWritten += bytes;
+            // 出错时在途请求也已结束，但不保证成功的块是连续的，只在成功时更新
+            if (ok) filled = std::max(filled, std::min(work.nextBlock.load(), work.Blocks()) * spec.blockSize);
+        }
+        if (!ok) return false;
+        if (stop.stop_requested()) {
+            report->cancelled = true;   // 本项被中途取消，结果不完整，不记录
+            break;
+        }
+
+        Result result;
+        result.spec = spec;
+        result.operations = hist.Count();
+        result.bytes = bytes;
+        result.seconds = seconds;
+        result.throughputMBps = seconds > 0 ? bytes / seconds / 1e6 : 0;
+        result.iops = seconds > 0 ? hist.Count() / seconds : 0;
+        result.latencyAvgUs = hist.MeanNs() / 1000;
+        result.latencyP50Us = hist.PercentileNs(0.50) / 1000;
+        result.latencyP99Us = hist.PercentileNs(0.99) / 1000;
+        result.latencyP999Us = hist.PercentileNs(0.999) / 1000;
+        result.latencyMaxUs = hist.MaxNs() / 1000;
+        report->results.push_back(result);
+        if (progress) progress(i, 1.0);
+    }
+    return !report->cancelled;
+}
+
+#ifdef _WIN32
+
+std::vector<std::string> MountPoints(const std::string& model)
+{
+    std::vector<std::string> out;
+    std::map<DWORD, bool> matches;   // 磁盘号 → 产品名是否与型号一致
+    wchar_t volume[MAX_PATH];
+    HANDLE find = FindFirstVolumeW(volume, MAX_PATH);
+    if (find == INVALID_HANDLE_VALUE) return out;
+    do {
+        bool onDisk = false;
+        for (DWORD disk : VolumeDisks(volume)) {
+            auto it = matches.find(disk);
+            if (it == matches.end()) it = matches.emplace(disk, ModelMatches(model, DiskProduct(disk))).first;
+            onDisk = onDisk || it->second;
+        }
+        if (!onDisk) continue;
+
+        DWORD flags = 0;
+        if (GetVolumeInformationW(volume, nullptr, 0, nullptr, nullptr, &flags, nullptr, 0) &&
+            (flags & FILE_READ_ONLY_VOLUME)) continue;
+
+        // 一个卷可以挂在多个位置（盘符与 NTFS 挂载目录），名称以双 '\0' 结尾
+        std::vector<wchar_t> names(MAX_PATH);
+        DWORD length = 0;
+        if (!GetVolumePathNamesForVolumeNameW(volume, names.data(), (DWORD)names.size(), &length)) {
+            if (GetLastError() != ERROR_MORE_DATA) continue;
+            names.resize(length);
+            if (!GetVolumePathNamesForVolumeNameW(volume, names.data(), (DWORD)names.size(), &length)) continue;
+        }
+        for (const wchar_t* name = names.data(); *name; name += wcslen(name) + 1) out.push_back(ToUtf8(name));
+    } while (FindNextVolumeW(find, volume, MAX_PATH));
+    FindVolumeClose(find);
+    return out;
+}
+
+#else
+
+std::vector<std::string> MountPoints(const std::string& model)
+{
+    // /sys/block/<盘>/device/model 与型号一致的盘，收集它与各分区的 "主:次" 设备号
+    std::vector<std::string> devices;
+    if (DIR* dir = opendir("/sys/block")) {
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] == '.') continue;
+            std::string base = std::string("/sys/block/") + entry->d_name;
+            if (!ModelMatches(model, ReadSmall(base + "/device/model"))) continue;
+            devices.push_back(ReadSmall(base + "/dev"));
+            if (DIR* parts = opendir(base.c_str())) {
+                size_t nameLen = strlen(entry->d_name);
+                while (dirent* part = readdir(parts)) {
+                    if (strncmp(part->d_name, entry->d_name, nameLen) == 0) {
+                        devices.push_back(ReadSmall(base + "/" + part->d_name + "/dev"));
+                    }
+                }
+                closedir(parts);
+            }
+        }
+        closedir(dir);
+    }
+
+    // mountinfo：挂载号 父挂载号 主:次 根 挂载点 ...
+    std::vector<std::string> out;
+    if (devices.empty()) return out;
+    FILE* mounts = fopen("/proc/self/mountinfo", "re");
+    if (!mounts) return out;
+    char line[4096];
+    while (fgets(line, sizeof(line), mounts)) {
+        char device[64], mountPoint[4096];
+        if (sscanf(line, "%*s %*s %63s %*s %4095s", device, mountPoint) != 2) continue;
+        if (std::find(devices.begin(), devices.end(), device) == devices.end()) continue;
+        std::string path = Unescape(mountPoint);
+        if (access(path.c_str(), W_OK) != 0) continue;
+        if (std::find(out.begin(), out.end(), path) == out.end()) out.push_back(path);
+    }
+    fclose(mounts);
+    return out;
+}
+
+#endif
+
+} // namespace diskbench
@@ -0,0 +1,83 @@
+#ifndef DISKBENCH_H
+#define DISKBENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+// ========== 硬盘性能测试 ==========
+// 在指定目录建临时文件，依次测顺序写、顺序读、4K 随机读（队列深度 1 与 32），
+// 给出吞吐量与延迟分位数。绕过系统缓存（O_DIRECT / FILE_FLAG_NO_BUFFERING），缓冲区按 4K 对齐。
+// 提交方式：Windows 用重叠 I/O + 完成端口；其它平台优先 io_uring，不可用时每个队列槽一个线程 pread/pwrite。
+// 写入总量不超过 Options::maxBytesWritten；临时文件在结束或取消时删除。不依赖 wxWidgets；字符串为 UTF-8。
+namespace diskbench
+{
+
+enum class Pattern
+{
+    SequentialWrite,   // 同时生成后续读测试用的文件内容
+    SequentialRead,
+    RandomRead,
+};
+
+const char* PatternName(Pattern pattern);   // "seq-write"、"seq-read"、"rand-read"
+
+struct Spec
+{
+    Pattern pattern = Pattern::SequentialRead;
+    uint32_t blockSize = 0;
+    uint32_t queueDepth = 0;
+};
+
+// 默认测试序列：1M 顺序写/读（QD8）、4K 随机读 QD1、QD32
+std::vector<Spec> DefaultSpecs();
+
+struct Options
+{
+    std::string directory;                          // 临时文件所在目录
+    uint64_t maxBytesWritten = 1ull << 30;          // 写入上限，测试文件不超过它（也不超过剩余空间的一半）
+    std::chrono::milliseconds testDuration{5000};   // 每项测试的时长上限
+    std::vector<Spec> specs = DefaultSpecs();
+};
+
+struct Result
+{
+    Spec spec;
+    uint64_t operations = 0;
+    uint64_t bytes = 0;
+    double seconds = 0;
+    double throughputMBps = 0;     // 10^6 字节/秒
+    double iops = 0;
+    double latencyAvgUs = 0;       // 单次请求从提交到完成
+    double latencyP50Us = 0;
+    double latencyP99Us = 0;
+    double latencyP999Us = 0;
+    double latencyMaxUs = 0;
+};
+
+struct Report
+{
+    std::string engine;            // "io_uring"、"iocp"、"threads"
+    bool direct = false;           // 文件系统不支持时退回带缓存的 I/O（如 tmpfs）
+    uint64_t fileBytes = 0;
+    uint64_t bytesWritten = 0;
+    bool cancelled = false;
+    std::string error;             // 失败原因；已完成的测试仍在 results 中
+    std::vector<Result> results;   // 按 specs 顺序，只含完整跑完的测试
+};
+
+// 进度回调在执行 I/O 的线程上调用，约每 100 ms 一次：test 为 specs 下标，fraction 为该项的完成比例
+using ProgressFn = std::function<void(size_t test, double fraction)>;
+
+// 阻塞运行全部测试；stop 请求后等待在途请求完成即返回（report->cancelled = true）
+bool Run(const Options& options, Report* report, std::stop_token stop = {}, const ProgressFn& progress = {});
+
+// 型号对应硬盘上的挂载点（Windows 为卷根目录，如 "D:\"），只列出可写的；型号按不区分大小写的包含关系匹配
+std::vector<std::string> MountPoints(const std::string& model);
+
+} // namespace diskbench
+
+#endif // DISKBENCH_H
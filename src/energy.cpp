@@ -0,0 +1,551 @@
+#include "energy.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <winioctl.h>
+    #include <setupapi.h>
+#else
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <time.h>
+    #include <unistd.h>
+#endif
+
+namespace energy
+{
+
+const char* DomainName(Domain domain)
+{
+    switch (domain) {
+        case Domain::Package: return "package";
+        case Domain::Core: return "core";
+        case Domain::Uncore: return "uncore";
+        case Domain::Dram: return "dram";
+        case Domain::Platform: return "psys";
+    }
+    return "";
+}
+
+namespace
+{
+    // 计数器从 prev 走到 cur 的增量；range 为回绕模数，0 表示 64 位自然回绕
+    uint64_t Advance(uint64_t prev, uint64_t cur, uint64_t range)
+    {
+        if (range == 0 || cur >= prev) return cur - prev;
+        return cur + (range - prev);
+    }
+}
+
+#ifdef _WIN32
+
+// ========== Windows：能量计量接口（EMI）==========
+namespace
+{
+    // emi.h 中的定义；旧版 MinGW 没有此头文件，按 Windows SDK 在此声明
+    const GUID kEnergyMeterInterface = { 0x45bd8344, 0x7ed6, 0x49cf, { 0xa4, 0x40, 0xc2, 0x76, 0xc9, 0x33, 0xb0, 0x53 } };
+    const DWORD kIoctlEmiGetVersion = CTL_CODE(FILE_DEVICE_UNKNOWN, 0, METHOD_BUFFERED, FILE_READ_ACCESS);
+    const DWORD kIoctlEmiGetMetadataSize = CTL_CODE(FILE_DEVICE_UNKNOWN, 1, METHOD_BUFFERED, FILE_READ_ACCESS);
+    const DWORD kIoctlEmiGetMetadata = CTL_CODE(FILE_DEVICE_UNKNOWN, 2, METHOD_BUFFERED, FILE_READ_ACCESS);
+    const DWORD kIoctlEmiGetMeasurement = CTL_CODE(FILE_DEVICE_UNKNOWN, 3, METHOD_BUFFERED, FILE_READ_ACCESS);
+    const USHORT kEmiVersion2 = 2;
+
+    // EMI_METADATA_V2：两个 16 字符的名称、修订号、通道数，之后是变长的通道描述
+    const size_t kMetadataChannelsOffset = 16 * sizeof(WCHAR) * 2 + sizeof(USHORT) * 2;
+    // EMI_CHANNEL_V2：测量单位（枚举）、名称字节数、名称（不以 NUL 结尾）
+    const size_t kChannelNameOffset = sizeof(int32_t) + sizeof(USHORT);
+
+    struct ChannelMeasurement
+    {
+        ULONGLONG absoluteEnergy;   // 皮瓦时
+        ULONGLONG absoluteTime;     // 100 ns
+    };
+
+    const double kJoulesPerPicowattHour = 3.6e-9;
+
+    std::string ToUtf8(const wchar_t* str, size_t len)
+    {
+        int n = WideCharToMultiByte(CP_UTF8, 0, str, (int)len, nullptr, 0, nullptr, nullptr);
+        std::string out(n > 0 ? n : 0, '\0');
+        if (n > 0) WideCharToMultiByte(CP_UTF8, 0, str, (int)len, &out[0], n, nullptr, nullptr);
+        return out;
+    }
+
+    // 系统 RAPL 驱动的通道名："RAPL_Package0_PKG"、"RAPL_Package0_PP0"、"RAPL_Package0_DRAM"、"RAPL_Package0_PSYS"
+    bool ParseChannel(const std::string& name, Counter* out)
+    {
+        struct Suffix
+        {
+            const char* text;
+            Domain domain;
+        };
+        const Suffix suffixes[] = {
+            { "_PKG", Domain::Package }, { "_PP0", Domain::Core }, { "_PP1", Domain::Uncore },
+            { "_DRAM", Domain::Dram }, { "_PSYS", Domain::Platform },
+        };
+        for (const Suffix& suffix : suffixes) {
+            size_t len = strlen(suffix.text);
+            if (name.size() < len || name.compare(name.size() - len, len, suffix.text) != 0) continue;
+            out->domain = suffix.domain;
+            size_t pos = name.find("Package");
+            out->package = pos == std::string::npos ? -1 : atoi(name.c_str() + pos + 7);
+            std::string package = "package-" + std::to_string(out->package);
+            out->name = suffix.domain == Domain::Platform ? std::string("psys")
+                      : suffix.domain == Domain::Package ? package
+                      : package + "/" + DomainName(suffix.domain);
+            out->source = "emi";
+            return true;
+        }
+        return false;
+    }
+}
+
+struct Meter::Impl
+{
+    struct Device
+    {
+        HANDLE handle = INVALID_HANDLE_VALUE;
+        size_t channels = 0;                  // 设备的全部通道数（测量结果按此排列）
+        std::vector<int> counters;            // 通道 → 计数器下标，未识别的通道为 -1
+        std::vector<ChannelMeasurement> buffer;
+    };
+    std::vector<Device> devices;
+    std::vector<double> units;
+    std::vector<uint64_t> ranges;
+
+    ~Impl()
+    {
+        for (Device& device : devices) {
+            if (device.handle != INVALID_HANDLE_VALUE) CloseHandle(device.handle);
+        }
+    }
+
+    void ReadRaw(std::vector<uint64_t>& raw, std::vector<uint8_t>& valid)
+    {
+        for (Device& device : devices) {
+            DWORD bytes = 0;
+            if (!DeviceIoControl(device.handle, kIoctlEmiGetMeasurement, nullptr, 0, device.buffer.data(),
+                                 (DWORD)(device.buffer.size() * sizeof(ChannelMeasurement)), &bytes, nullptr)) {
+                continue;
+            }
+            size_t count = std::min<size_t>(bytes / sizeof(ChannelMeasurement), device.channels);
+            for (size_t c = 0; c < count; ++c) {
+                if (device.counters[c] < 0) continue;
+                raw[device.counters[c]] = device.buffer[c].absoluteEnergy;
+                valid[device.counters[c]] = 1;
+            }
+        }
+    }
+};
+
+std::string Meter::DefaultRoot()
+{
+    return std::string();
+}
+
+size_t Meter::Discover()
+{
+    m_impl = std::make_unique<Impl>();
+    m_counters.clear();
+
+    HDEVINFO set = SetupDiGetClassDevsW(&kEnergyMeterInterface, nullptr, nullptr, DIGCF_PRESENT | DIGCF_DEVICEINTERFACE);
+    if (set != INVALID_HANDLE_VALUE) {
+        SP_DEVICE_INTERFACE_DATA iface;
+        iface.cbSize = sizeof(iface);
+        for (DWORD i = 0; SetupDiEnumDeviceInterfaces(set, nullptr, &kEnergyMeterInterface, i, &iface); ++i) {
+            DWORD size = 0;
+            SetupDiGetDeviceInterfaceDetailW(set, &iface, nullptr, 0, &size, nullptr);
+            if (size == 0) continue;
+            std::vector<BYTE> detailBuf(size);
+            auto* detail = reinterpret_cast<SP_DEVICE_INTERFACE_DETAIL_DATA_W*>(detailBuf.data());
+            detail->cbSize = sizeof(SP_DEVICE_INTERFACE_DETAIL_DATA_W);
+            if (!SetupDiGetDeviceInterfaceDetailW(set, &iface, detail, size, nullptr, nullptr)) continue;
+
+            Impl::Device device;
+            device.handle = CreateFileW(detail->DevicePath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (device.handle == INVALID_HANDLE_VALUE) continue;
+
+            // 只支持多通道的 V2（Windows 10 1809 起的 RAPL 驱动）
+            USHORT version = 0;
+            ULONG metadataSize = 0;
+            DWORD bytes = 0;
+            std::vector<BYTE> metadata;
+            bool ok = DeviceIoControl(device.handle, kIoctlEmiGetVersion, nullptr, 0, &version, sizeof(version), &bytes, nullptr) &&
+                      version == kEmiVersion2 &&
+                      DeviceIoControl(device.handle, kIoctlEmiGetMetadataSize, nullptr, 0, &metadataSize,
+                                      sizeof(metadataSize), &bytes, nullptr) &&
+                      metadataSize >= kMetadataChannelsOffset;
+            if (ok) {
+                metadata.resize(metadataSize);
+                ok = DeviceIoControl(device.handle, kIoctlEmiGetMetadata, nullptr, 0, metadata.data(), metadataSize,
+                                     &bytes, nullptr) && bytes >= kMetadataChannelsOffset;
+            }
+            if (!ok) {
+                CloseHandle(device.handle);
+                continue;
+            }
+
+            USHORT channelCount;
+            memcpy(&channelCount, metadata.data() + kMetadataChannelsOffset - sizeof(USHORT), sizeof(channelCount));
+            size_t pos = kMetadataChannelsOffset;
+            for (USHORT c = 0; c < channelCount && pos + kChannelNameOffset <= bytes; ++c) {
+                USHORT nameBytes;
+                memcpy(&nameBytes, metadata.data() + pos + sizeof(int32_t), sizeof(nameBytes));
+                if (pos + kChannelNameOffset + nameBytes > bytes) break;
+                std::wstring wname(nameBytes / sizeof(WCHAR), L'\0');
+                memcpy(&wname[0], metadata.data() + pos + kChannelNameOffset, wname.size() * sizeof(WCHAR));
+                pos += kChannelNameOffset + nameBytes;
+
+                Counter counter;
+                bool known = ParseChannel(ToUtf8(wname.c_str(), wcsnlen(wname.c_str(), wname.size())), &counter);
+                device.counters.push_back(known ? (int)m_counters.size() : -1);
+                if (!known) continue;
+                m_counters.push_back(std::move(counter));
+                m_impl->units.push_back(kJoulesPerPicowattHour);
+                m_impl->ranges.push_back(0);
+            }
+            device.channels = device.counters.size();
+            device.buffer.resize(device.channels);
+            m_impl->devices.push_back(std::move(device));
+        }
+        SetupDiDestroyDeviceInfoList(set);
+    }
+
+    std::vector<uint64_t> raw(m_counters.size(), 0);
+    std::vector<uint8_t> valid(m_counters.size(), 0);
+    m_impl->ReadRaw(raw, valid);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_last = raw;
+    m_total.assign(m_counters.size(), 0);
+    return m_counters.size();
+}
+
+namespace
+{
+    double Seconds(const FILETIME& ft)
+    {
+        return (double)(((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime) * 1e-7;
+    }
+
+    bool SystemCpuTime(double* system)
+    {
+        // 系统内核时间包含空闲时间
+        FILETIME idle, kernel, user;
+        if (!GetSystemTimes(&idle, &kernel, &user)) return false;
+        *system = Seconds(kernel) + Seconds(user) - Seconds(idle);
+        return true;
+    }
+}
+
+double ThreadCpuSeconds()
+{
+    FILETIME created, exited, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user)) return 0;
+    return Seconds(kernel) + Seconds(user);
+}
+
+#else
+
+// ========== 其它平台：powercap，MSR 备用 ==========
+struct Meter::Impl
+{
+    std::vector<int> fds;          // 与计数器一一对应（MSR 时同一封装的计数器共用）
+    std::vector<uint32_t> msrs;    // MSR 地址；powercap 为 0
+    std::vector<double> units;     // 原始值 → 焦耳
+    std::vector<uint64_t> ranges;
+    std::vector<int> owned;
+
+    ~Impl()
+    {
+        for (int fd : owned) close(fd);
+    }
+
+    void ReadRaw(std::vector<uint64_t>& raw, std::vector<uint8_t>& valid)
+    {
+        for (size_t i = 0; i < fds.size(); ++i) {
+            if (msrs[i] != 0) {
+                uint64_t value;
+                valid[i] = pread(fds[i], &value, sizeof(value), msrs[i]) == (ssize_t)sizeof(value);
+                raw[i] = value & 0xFFFFFFFFULL;   // 能量状态寄存器只有低 32 位有效
+                continue;
+            }
+            char buf[32];
+            ssize_t n = pread(fds[i], buf, sizeof(buf), 0);
+            uint64_t value = 0;
+            ssize_t k = 0;
+            for (; k < n && buf[k] >= '0' && buf[k] <= '9'; ++k) value = value * 10 + (uint64_t)(buf[k] - '0');
+            valid[i] = k > 0;
+            raw[i] = value;
+        }
+    }
+};
+
+namespace
+{
+    bool ReadText(const std::string& path, std::string* out)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        char buf[256];
+        ssize_t n = read(fd, buf, sizeof(buf));
+        close(fd);
+        if (n < 0) return false;
+        while (n > 0 && (buf[n - 1] == '\n' || buf[n - 1] == ' ')) --n;
+        out->assign(buf, (size_t)n);
+        return true;
+    }
+
+    // powercap 区域 "intel-rapl:0" / "intel-rapl:0:1"；intel-rapl-mmio 与 MSR 区域重复，不读
+    struct Zone
+    {
+        int package;
+        int sub;           // 顶层区域为 -1
+        std::string dir;
+    };
+
+    bool ParseZone(const char* name, Zone* out)
+    {
+        const char* prefix = "intel-rapl:";
+        size_t len = strlen(prefix);
+        if (strncmp(name, prefix, len) != 0) return false;
+        char* end;
+        out->package = (int)strtol(name + len, &end, 10);
+        if (end == name + len) return false;
+        out->sub = -1;
+        if (*end == ':') {
+            const char* p = end + 1;
+            out->sub = (int)strtol(p, &end, 10);
+            if (end == p) return false;
+        }
+        return *end == '\0';
+    }
+
+    Domain DomainOf(const std::string& name)
+    {
+        if (name.compare(0, 7, "package") == 0) return Domain::Package;
+        if (name == "core") return Domain::Core;
+        if (name == "uncore") return Domain::Uncore;
+        if (name == "dram") return Domain::Dram;
+        return Domain::Platform;
+    }
+
+    // 每个封装取一个逻辑处理器，按封装号排序
+    std::vector<std::pair<int, int>> PackageCpus()
+    {
+        std::vector<std::pair<int, int>> packages;
+        DIR* d = opendir("/sys/devices/system/cpu");
+        if (!d) return packages;
+        while (dirent* entry = readdir(d)) {
+            if (strncmp(entry->d_name, "cpu", 3) != 0 || entry->d_name[3] < '0' || entry->d_name[3] > '9') continue;
+            int cpu = atoi(entry->d_name + 3);
+            std::string text;
+            if (!ReadText(std::string("/sys/devices/system/cpu/") + entry->d_name + "/topology/physical_package_id", &text)) continue;
+            int package = atoi(text.c_str());
+            auto it = std::find_if(packages.begin(), packages.end(), [package](const auto& p) { return p.first == package; });
+            if (it == packages.end()) packages.emplace_back(package, cpu);
+            else it->second = std::min(it->second, cpu);
+        }
+        closedir(d);
+        std::sort(packages.begin(), packages.end());
+        return packages;
+    }
+
+    bool IsAmd()
+    {
+        int fd = open("/proc/cpuinfo", O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        char buf[512];
+        ssize_t n = read(fd, buf, sizeof(buf) - 1);
+        close(fd);
+        if (n <= 0) return false;
+        buf[n] = '\0';
+        return strstr(buf, "AuthenticAMD") || strstr(buf, "HygonGenuine");
+    }
+
+    // MSR 地址（Intel SDM 卷 4 / AMD PPR）
+    const uint32_t kIntelPowerUnit = 0x606;
+    const uint32_t kIntelPackageEnergy = 0x611;
+    const uint32_t kIntelPp0Energy = 0x639;
+    const uint32_t kIntelPp1Energy = 0x641;
+    const uint32_t kAmdPowerUnit = 0xC0010299;
+    const uint32_t kAmdPackageEnergy = 0xC001029B;
+
+    bool SystemCpuTime(double* system)
+    {
+        // /proc/stat 首行：user nice system idle iowait irq softirq steal ...，单位为时钟滴答
+        int fd = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        char buf[256];
+        ssize_t n = read(fd, buf, sizeof(buf) - 1);
+        close(fd);
+        if (n <= 4 || strncmp(buf, "cpu ", 4) != 0) return false;
+        buf[n] = '\0';
+        unsigned long long v[8] = {};
+        char* p = buf + 4;
+        for (int i = 0; i < 8; ++i) v[i] = strtoull(p, &p, 10);
+        unsigned long long busy = v[0] + v[1] + v[2] + v[5] + v[6] + v[7];
+        long hz = sysconf(_SC_CLK_TCK);
+        *system = (double)busy / (double)(hz > 0 ? hz : 100);
+        return true;
+    }
+}
+
+double ThreadCpuSeconds()
+{
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0;
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+std::string Meter::DefaultRoot()
+{
+    return "/sys/class/powercap";
+}
+
+size_t Meter::Discover()
+{
+    m_impl = std::make_unique<Impl>();
+    m_counters.clear();
+
+    std::vector<Zone> zones;
+    if (DIR* root = opendir(m_root.c_str())) {
+        while (dirent* entry = readdir(root)) {
+            Zone zone;
+            if (!ParseZone(entry->d_name, &zone)) continue;
+            zone.dir = m_root + "/" + entry->d_name + "/";
+            zones.push_back(std::move(zone));
+        }
+        closedir(root);
+    }
+    std::sort(zones.begin(), zones.end(), [](const Zone& a, const Zone& b) {
+        return a.package != b.package ? a.package < b.package : a.sub < b.sub;
+    });
+
+    // 自 2020 年起 energy_uj 默认只有 root 可读，打不开时整体改用 MSR
+    for (const Zone& zone : zones) {
+        std::string name, range;
+        if (!ReadText(zone.dir + "name", &name) || !ReadText(zone.dir + "max_energy_range_uj", &range)) continue;
+        int fd = open((zone.dir + "energy_uj").c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+
+        Counter counter;
+        counter.domain = DomainOf(name);
+        counter.package = counter.domain == Domain::Platform ? -1 : zone.package;
+        counter.name = name;
+        if (zone.sub >= 0) {
+            std::string parent;
+            if (!ReadText(m_root + "/intel-rapl:" + std::to_string(zone.package) + "/name", &parent)) {
+                parent = "package-" + std::to_string(zone.package);
+            }
+            counter.name = parent + "/" + name;
+        }
+        counter.source = "powercap";
+        m_counters.push_back(std::move(counter));
+        m_impl->owned.push_back(fd);
+        m_impl->fds.push_back(fd);
+        m_impl->msrs.push_back(0);
+        m_impl->units.push_back(1e-6);
+        m_impl->ranges.push_back(strtoull(range.c_str(), nullptr, 10) + 1);
+    }
+
+    if (m_counters.empty()) {
+        // DRAM 在部分服务器处理器上的能量单位固定为 15.3 µJ，与 ESU 不同，MSR 路径不读
+        bool amd = IsAmd();
+        for (const auto& [package, cpu] : PackageCpus()) {
+            int fd = open(("/dev/cpu/" + std::to_string(cpu) + "/msr").c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) break;   // 没有 msr 模块或权限：其它封装也一样
+            uint64_t unit;
+            if (pread(fd, &unit, sizeof(unit), amd ? kAmdPowerUnit : kIntelPowerUnit) != (ssize_t)sizeof(unit)) {
+                close(fd);
+                continue;
+            }
+            m_impl->owned.push_back(fd);
+            double joules = std::ldexp(1.0, -(int)((unit >> 8) & 0x1F));
+
+            struct Register
+            {
+                uint32_t msr;
+                Domain domain;
+            };
+            std::vector<Register> registers = { { amd ? kAmdPackageEnergy : kIntelPackageEnergy, Domain::Package } };
+            if (!amd) {
+                registers.push_back({ kIntelPp0Energy, Domain::Core });
+                registers.push_back({ kIntelPp1Energy, Domain::Uncore });
+            }
+            std::string prefix = "package-" + std::to_string(package);
+            for (const Register& reg : registers) {
+                uint64_t value;
+                if (pread(fd, &value, sizeof(value), reg.msr) != (ssize_t)sizeof(value)) continue;   // 型号不支持此域
+                Counter counter;
+                counter.domain = reg.domain;
+                counter.package = package;
+                counter.name = reg.domain == Domain::Package ? prefix : prefix + "/" + DomainName(reg.domain);
+                counter.source = "msr";
+                m_counters.push_back(std::move(counter));
+                m_impl->fds.push_back(fd);
+                m_impl->msrs.push_back(reg.msr);
+                m_impl->units.push_back(joules);
+                m_impl->ranges.push_back(1ULL << 32);
+            }
+        }
+    }
+
+    std::vector<uint64_t> raw(m_counters.size(), 0);
+    std::vector<uint8_t> valid(m_counters.size(), 0);
+    m_impl->ReadRaw(raw, valid);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_last = raw;
+    m_total.assign(m_counters.size(), 0);
+    return m_counters.size();
+}
+
+#endif
+
+// ========== 通用部分 ==========
+Meter::Meter(std::string root)
+    : m_root(std::move(root))
+{
+}
+
+Meter::~Meter() = default;
+
+bool Meter::Read(std::vector<double>* joules)
+{
+    if (!m_impl || m_counters.empty()) return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<uint64_t>& raw = m_raw;
+    std::vector<uint8_t>& valid = m_rawValid;
+    raw.assign(m_counters.size(), 0);
+    valid.assign(m_counters.size(), 0);
+    m_impl->ReadRaw(raw, valid);
+    for (size_t i = 0; i < raw.size(); ++i) {
+        // 读取失败的计数器保持上次的累计值，下次成功时补上中间的增量
+        if (!valid[i]) continue;
+        m_total[i] += (double)Advance(m_last[i], raw[i], m_impl->ranges[i]) * m_impl->units[i];
+        m_last[i] = raw[i];
+    }
+    *joules = m_total;
+    return true;
+}
+
+bool Take(Meter& meter, Mark* out)
+{
+    out->time = std::chrono::steady_clock::now();
+    if (!SystemCpuTime(&out->systemCpuSeconds)) out->systemCpuSeconds = 0;
+    return meter.Read(&out->joules);
+}
+
+double Share(double cpuSeconds, const Mark& from, const Mark& to)
+{
+    double system = to.systemCpuSeconds - from.systemCpuSeconds;
+    if (cpuSeconds <= 0 || system <= 0) return system > 0 ? 0.0 : 1.0;
+    // 两者的计时粒度不同（/proc/stat 为时钟滴答），短区间内线程时间可能略大于整机
+    return std::min(1.0, cpuSeconds / system);
+}
+
+} // namespace energy
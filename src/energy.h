@@ -0,0 +1,92 @@
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ========== 能耗计数（RAPL）==========
+// 其它平台读取 /sys/class/powercap/intel-rapl:*（AMD 同样挂在此处）的 energy_uj，
+// 无权限或没有 powercap 时退回 /dev/cpu/N/msr（每个封装一个 CPU，需要 msr 模块与 root）。
+// Windows 经能量计量接口（EMI，GUID_DEVICE_ENERGY_METER）读取系统自带 RAPL 驱动给出的通道。
+// 计数器是会回绕的原始整数，Meter 在每次读取时按回绕周期取差并累计为焦耳。不依赖 wxWidgets；字符串为 UTF-8。
+namespace energy
+{
+
+enum class Domain
+{
+    Package,    // 整个 CPU 封装
+    Core,       // 全部核心（PP0）
+    Uncore,     // 核显等（PP1）
+    Dram,
+    Platform,   // 整个 SoC 平台（psys）
+};
+
+const char* DomainName(Domain domain);   // "package"、"core"、"uncore"、"dram"、"psys"
+
+struct Counter
+{
+    std::string name;       // "package-0"、"package-0/core"、"package-0/dram"、"psys"
+    Domain domain;
+    int package = -1;       // CPU 封装号；平台域为 -1
+    std::string source;     // "powercap"、"msr"、"emi"
+};
+
+class Meter
+{
+public:
+    // root 为 powercap 目录（测试时可指向伪造的目录树）；Windows 上忽略
+    explicit Meter(std::string root = DefaultRoot());
+    ~Meter();
+    Meter(const Meter&) = delete;
+    Meter& operator=(const Meter&) = delete;
+
+    static std::string DefaultRoot();
+
+    // 枚举计数器并打开，返回数量
+    size_t Discover();
+    const std::vector<Counter>& Counters() const { return m_counters; }
+
+    // 自 Discover 以来各计数器的累计能量（焦耳），与 Counters() 一一对应；可多线程调用。
+    // 两次读取的间隔须短于回绕周期：powercap 按 max_energy_range_uj，MSR 为 32 位，满载时约数分钟
+    bool Read(std::vector<double>* joules);
+
+private:
+    struct Impl;
+
+    std::string m_root;
+    std::unique_ptr<Impl> m_impl;
+    std::vector<Counter> m_counters;
+
+    std::mutex m_mutex;                // 保护以下累计状态
+    std::vector<uint64_t> m_last;      // 上次的原始值
+    std::vector<double> m_total;       // 累计焦耳
+    std::vector<uint64_t> m_raw;       // Read 的读取缓冲，复用以免每次分配
+    std::vector<uint8_t> m_rawValid;
+};
+
+// ========== 区间计量 ==========
+// 一个时刻的能量读数与整机 CPU 时间；两个 Mark 之差即区间内的能耗。
+// RAPL 只有整机/封装粒度：调用方在区间内实际消耗的 CPU 时间占整机繁忙时间的份额，用来把封装能耗归给它
+struct Mark
+{
+    std::chrono::steady_clock::time_point time;
+    std::vector<double> joules;         // 与 Meter::Counters() 一一对应
+    double systemCpuSeconds = 0;        // 全部逻辑处理器的非空闲时间
+};
+
+bool Take(Meter& meter, Mark* out);
+
+// 调用线程至今的用户 + 内核时间（秒）；取不到时为 0。在工作的前后各取一次，差值即这段工作的 CPU 时间，
+// 不含进程内其它线程（界面、传感器采样等）
+double ThreadCpuSeconds();
+
+// 区间内 cpuSeconds 占整机繁忙 CPU 时间的份额 [0, 1]；取不到整机时间时为 1
+double Share(double cpuSeconds, const Mark& from, const Mark& to);
+
+} // namespace energy
+
+#endif // ENERGY_H
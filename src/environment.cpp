@@ -0,0 +1,421 @@
+#include "environment.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__i386__) || defined(__x86_64__)
+    #include <cpuid.h>
+#endif
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sched.h>
+    #include <unistd.h>
+#endif
+
+namespace environment
+{
+
+double Info::EffectiveCpus() const
+{
+    double cpus = !allowedCpus.empty() ? (double)allowedCpus.size() : (double)logicalProcessors;
+    return cpuQuota > 0 && (cpus <= 0 || cpuQuota < cpus) ? cpuQuota : cpus;
+}
+
+uint64_t Info::EffectiveMemory() const
+{
+    return memoryLimit > 0 && (physicalMemory == 0 || memoryLimit < physicalMemory) ? memoryLimit : physicalMemory;
+}
+
+std::string HypervisorName(const char signature[12])
+{
+    struct Vendor
+    {
+        const char* signature;
+        const char* name;
+    };
+    static const Vendor vendors[] = {
+        { "KVMKVMKVM\0\0\0", "KVM" },
+        { "Linux KVM Hv", "KVM" },          // 带 Hyper-V 兼容接口的 KVM
+        { "Microsoft Hv", "Hyper-V" },
+        { "VMwareVMware", "VMware" },
+        { "XenVMMXenVMM", "Xen" },
+        { "VBoxVBoxVBox", "VirtualBox" },
+        { "TCGTCGTCGTCG", "QEMU" },
+        { "bhyve bhyve ", "bhyve" },
+        { " lrpepyh  vr", "Parallels" },
+        { "ACRNACRNACRN", "ACRN" },
+        { "QNXQVMBSQG\0\0", "QNX" },
+        { "SRESRESRESRE", "Apple Virtualization" },
+    };
+    for (const Vendor& vendor : vendors) {
+        if (memcmp(signature, vendor.signature, 12) == 0) return vendor.name;
+    }
+    std::string raw(signature, 12);
+    while (!raw.empty() && (raw.back() == '\0' || raw.back() == ' ')) raw.pop_back();
+    for (char& c : raw) {
+        if ((unsigned char)c < 0x20 || (unsigned char)c >= 0x7F) c = '?';
+    }
+    return raw;
+}
+
+namespace
+{
+    void Cpuid(unsigned int leaf, unsigned int regs[4])
+    {
+#if defined(__i386__) || defined(__x86_64__)
+        __cpuid(leaf, regs[0], regs[1], regs[2], regs[3]);
+#else
+        (void)leaf;
+        regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#endif
+    }
+
+    void DetectHypervisor(Info* out)
+    {
+        unsigned int regs[4];
+        Cpuid(1, regs);
+        if (!(regs[2] & (1u << 31))) return;   // 虚拟机监控程序存在位
+
+        Cpuid(0x40000000, regs);
+        unsigned int maxLeaf = regs[0];
+        char signature[12];
+        memcpy(&signature[0], &regs[1], 4);   // ebx
+        memcpy(&signature[4], &regs[2], 4);   // ecx
+        memcpy(&signature[8], &regs[3], 4);   // edx
+        out->hypervisor = HypervisorName(signature);
+        if (out->hypervisor.empty()) out->hypervisor = "unknown";
+
+        // 开启 Hyper-V（WSL2、VBS）的 Windows 宿主同样带此签名；
+        // 只有根分区拥有 CreatePartitions 权限（0x40000003 叶 EBX 位 0）
+        if (out->hypervisor == "Hyper-V" && maxLeaf >= 0x40000003) {
+            Cpuid(0x40000003, regs);
+            out->hypervisorRoot = (regs[1] & 1u) != 0;
+        }
+    }
+}
+
+#ifdef _WIN32
+
+// ========== Windows：作业对象 ==========
+namespace
+{
+    // Windows 容器（进程隔离与 Hyper-V 隔离）在此键下写入 ContainerType
+    bool InWindowsContainer()
+    {
+        HKEY key;
+        if (RegOpenKeyExW(HKEY_LOCAL_MACHINE, L"SYSTEM\\CurrentControlSet\\Control", 0, KEY_READ, &key) != ERROR_SUCCESS) {
+            return false;
+        }
+        DWORD type = 0;
+        DWORD size = sizeof(DWORD);
+        DWORD value = 0;
+        bool found = RegQueryValueExW(key, L"ContainerType", nullptr, &type, (LPBYTE)&value, &size) == ERROR_SUCCESS;
+        RegCloseKey(key);
+        return found;
+    }
+}
+
+bool Detect(Info* out)
+{
+    *out = Info();
+    DetectHypervisor(out);
+    if (InWindowsContainer()) out->container = "windows";
+
+    out->logicalProcessors = (int)GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+    MEMORYSTATUSEX mem;
+    mem.dwLength = sizeof(mem);
+    if (GlobalMemoryStatusEx(&mem)) out->physicalMemory = mem.ullTotalPhys;
+
+    // 亲和性掩码只覆盖当前处理器组（最多 64 个）
+    DWORD_PTR processMask = 0, systemMask = 0;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+        WORD group = 0;
+        USHORT groupCount = 1;
+        GetProcessGroupAffinity(GetCurrentProcess(), &groupCount, &group);
+        int base = 0;
+        for (WORD g = 0; g < group; ++g) base += (int)GetActiveProcessorCount(g);
+        for (int bit = 0; bit < (int)(sizeof(DWORD_PTR) * 8); ++bit) {
+            if (processMask & ((DWORD_PTR)1 << bit)) out->allowedCpus.push_back(base + bit);
+        }
+    }
+
+    // 不在作业中时查询返回全零
+    JOBOBJECT_CPU_RATE_CONTROL_INFORMATION rate = {};
+    if (QueryInformationJobObject(nullptr, JobObjectCpuRateControlInformation, &rate, sizeof(rate), nullptr) &&
+        (rate.ControlFlags & JOB_OBJECT_CPU_RATE_CONTROL_ENABLE) && (rate.ControlFlags & JOB_OBJECT_CPU_RATE_CONTROL_HARD_CAP)) {
+        // CpuRate 以全部处理器的万分之一为单位
+        out->cpuQuota = rate.CpuRate / 10000.0 * out->logicalProcessors;
+        out->limitSource = "job";
+    }
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits = {};
+    if (QueryInformationJobObject(nullptr, JobObjectExtendedLimitInformation, &limits, sizeof(limits), nullptr)) {
+        DWORD flags = limits.BasicLimitInformation.LimitFlags;
+        uint64_t limit = 0;
+        if (flags & JOB_OBJECT_LIMIT_JOB_MEMORY) limit = limits.JobMemoryLimit;
+        if ((flags & JOB_OBJECT_LIMIT_PROCESS_MEMORY) && (limit == 0 || limits.ProcessMemoryLimit < limit)) {
+            limit = limits.ProcessMemoryLimit;
+        }
+        if (limit > 0) {
+            out->memoryLimit = limit;
+            out->limitSource = "job";
+        }
+    }
+    return out->logicalProcessors > 0;
+}
+
+#else
+
+// ========== 其它平台：cgroup ==========
+namespace
+{
+    bool ReadText(const std::string& path, std::string* out)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        out->clear();
+        char buf[4096];
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof(buf))) > 0) out->append(buf, (size_t)n);
+        close(fd);
+        if (n < 0) return false;
+        while (!out->empty() && (out->back() == '\n' || out->back() == ' ')) out->pop_back();
+        return true;
+    }
+
+    bool Exists(const char* path)
+    {
+        return access(path, F_OK) == 0;
+    }
+
+    std::vector<std::string> SplitLines(const std::string& text)
+    {
+        std::vector<std::string> lines;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            if (end == std::string::npos) end = text.size();
+            lines.push_back(text.substr(pos, end - pos));
+            pos = end + 1;
+        }
+        return lines;
+    }
+
+    bool HasToken(const std::string& list, const char* token, char sep)
+    {
+        size_t pos = 0;
+        while (pos <= list.size()) {
+            size_t end = list.find(sep, pos);
+            if (end == std::string::npos) end = list.size();
+            if (list.compare(pos, end - pos, token) == 0) return true;
+            pos = end + 1;
+        }
+        return false;
+    }
+
+    // 本进程所在的 cgroup：controller 为空表示 v2 统一层级
+    struct Membership
+    {
+        std::string v2;
+        std::string cpu;       // v1
+        std::string memory;    // v1
+        bool hasV2 = false;
+    };
+
+    Membership ReadMembership(const std::string& text)
+    {
+        // 每行 "层级号:控制器列表:路径"；v2 为 "0::/路径"
+        Membership m;
+        for (const std::string& line : SplitLines(text)) {
+            size_t a = line.find(':');
+            size_t b = a == std::string::npos ? a : line.find(':', a + 1);
+            if (b == std::string::npos) continue;
+            std::string controllers = line.substr(a + 1, b - a - 1);
+            std::string path = line.substr(b + 1);
+            if (controllers.empty()) {
+                m.v2 = path;
+                m.hasV2 = true;
+            }
+            if (HasToken(controllers, "cpu", ',')) m.cpu = path;
+            if (HasToken(controllers, "memory", ',')) m.memory = path;
+        }
+        return m;
+    }
+
+    // mountinfo：挂载号 父号 主:次 根 挂载点 选项 ... - 类型 来源 超级块选项
+    struct Mount
+    {
+        std::string root;
+        std::string point;
+        std::string type;
+        std::string options;
+    };
+
+    std::vector<Mount> CgroupMounts()
+    {
+        std::vector<Mount> mounts;
+        std::string text;
+        if (!ReadText("/proc/self/mountinfo", &text)) return mounts;
+        for (const std::string& line : SplitLines(text)) {
+            std::vector<std::string> fields;
+            size_t pos = 0;
+            while (pos < line.size()) {
+                size_t end = line.find(' ', pos);
+                if (end == std::string::npos) end = line.size();
+                fields.push_back(line.substr(pos, end - pos));
+                pos = end + 1;
+            }
+            auto dash = std::find(fields.begin(), fields.end(), "-");
+            if (fields.size() < 5 || dash == fields.end() || dash + 3 > fields.end()) continue;
+            Mount mount{ fields[3], fields[4], *(dash + 1), *(dash + 3) };
+            if (mount.type == "cgroup2" || mount.type == "cgroup") mounts.push_back(std::move(mount));
+        }
+        return mounts;
+    }
+
+    // 进程所在 cgroup 的目录：挂载点 + 相对挂载根的路径。
+    // 有 cgroup 命名空间时路径已是 "/"，只能看到容器自己这一级
+    std::string CgroupDir(const Mount& mount, const std::string& path)
+    {
+        std::string rel = path;
+        if (mount.root != "/") {
+            if (path.compare(0, mount.root.size(), mount.root) != 0) return mount.point;
+            rel = path.substr(mount.root.size());
+        }
+        if (rel == "/") rel.clear();
+        return mount.point + rel;
+    }
+
+    // 从 dir 逐级向上到挂载点，对每一级调用 visit；上级的限制同样约束本级
+    template <typename Visit>
+    void WalkUp(std::string dir, const std::string& top, Visit visit)
+    {
+        for (;;) {
+            visit(dir);
+            if (dir.size() <= top.size()) break;
+            size_t slash = dir.rfind('/');
+            if (slash == std::string::npos || slash < top.size()) break;
+            dir.resize(slash);
+        }
+    }
+
+    void MinLimit(double value, double* out)
+    {
+        if (value > 0 && (*out == 0 || value < *out)) *out = value;
+    }
+
+    void MinLimit(uint64_t value, uint64_t* out)
+    {
+        if (value > 0 && (*out == 0 || value < *out)) *out = value;
+    }
+
+    bool ReadCgroupV2(const Mount& mount, const std::string& path, Info* out)
+    {
+        bool found = false;
+        WalkUp(CgroupDir(mount, path), mount.point, [&](const std::string& dir) {
+            std::string text;
+            // cpu.max："配额 周期"，不限时配额为 "max"
+            if (ReadText(dir + "/cpu.max", &text)) {
+                found = true;
+                char* end;
+                double quota = strtod(text.c_str(), &end);
+                double period = end != text.c_str() ? strtod(end, nullptr) : 0;
+                if (period > 0) MinLimit(quota / period, &out->cpuQuota);
+            }
+            if (ReadText(dir + "/memory.max", &text)) {
+                found = true;
+                if (text != "max") MinLimit((uint64_t)strtoull(text.c_str(), nullptr, 10), &out->memoryLimit);
+            }
+        });
+        return found;
+    }
+
+    bool ReadCgroupV1(const std::vector<Mount>& mounts, const Membership& m, Info* out)
+    {
+        bool found = false;
+        for (const Mount& mount : mounts) {
+            if (mount.type != "cgroup") continue;
+            if (HasToken(mount.options, "cpu", ',') && !m.cpu.empty()) {
+                WalkUp(CgroupDir(mount, m.cpu), mount.point, [&](const std::string& dir) {
+                    std::string quota, period;
+                    if (!ReadText(dir + "/cpu.cfs_quota_us", &quota) || !ReadText(dir + "/cpu.cfs_period_us", &period)) return;
+                    found = true;
+                    double q = strtod(quota.c_str(), nullptr);   // 不限时为 -1
+                    double p = strtod(period.c_str(), nullptr);
+                    if (q > 0 && p > 0) MinLimit(q / p, &out->cpuQuota);
+                });
+            }
+            if (HasToken(mount.options, "memory", ',') && !m.memory.empty()) {
+                WalkUp(CgroupDir(mount, m.memory), mount.point, [&](const std::string& dir) {
+                    std::string text;
+                    if (!ReadText(dir + "/memory.limit_in_bytes", &text)) return;
+                    found = true;
+                    // 不限时是接近 2^63 的页对齐值，超出可见内存即视为不限
+                    uint64_t limit = strtoull(text.c_str(), nullptr, 10);
+                    if (out->physicalMemory == 0 || limit < out->physicalMemory) MinLimit(limit, &out->memoryLimit);
+                });
+            }
+        }
+        return found;
+    }
+
+    std::string DetectContainer(const std::string& cgroups)
+    {
+        if (getenv("KUBERNETES_SERVICE_HOST") || cgroups.find("kubepods") != std::string::npos) return "kubernetes";
+        if (Exists("/.dockerenv") || cgroups.find("/docker") != std::string::npos) return "docker";
+        if (Exists("/run/.containerenv") || cgroups.find("libpod") != std::string::npos) return "podman";
+        // systemd 在容器中启动时写入容器类型（"lxc"、"systemd-nspawn" ...）
+        std::string text;
+        if (ReadText("/run/systemd/container", &text) && !text.empty()) return text;
+        if (cgroups.find("/lxc") != std::string::npos) return "lxc";
+        return std::string();
+    }
+}
+
+bool Detect(Info* out)
+{
+    *out = Info();
+    DetectHypervisor(out);
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    out->logicalProcessors = cpus > 0 ? (int)cpus : 0;
+    if (pages > 0 && pageSize > 0) out->physicalMemory = (uint64_t)pages * (uint64_t)pageSize;
+
+    // 亲和性已包含 cpuset（v1 cpuset.cpus、v2 cpuset.cpus.effective）与 taskset 的限制
+    const int maxCpus = 8192;
+    cpu_set_t* set = CPU_ALLOC(maxCpus);
+    size_t setSize = CPU_ALLOC_SIZE(maxCpus);
+    if (set && sched_getaffinity(0, setSize, set) == 0) {
+        for (int cpu = 0; cpu < maxCpus; ++cpu) {
+            if (CPU_ISSET_S(cpu, setSize, set)) out->allowedCpus.push_back(cpu);
+        }
+    }
+    if (set) CPU_FREE(set);
+
+    std::string cgroups;
+    ReadText("/proc/self/cgroup", &cgroups);
+    out->container = DetectContainer(cgroups);
+
+    Membership membership = ReadMembership(cgroups);
+    std::vector<Mount> mounts = CgroupMounts();
+    // 混合模式下 v1 控制器优先：挂在 v1 上的控制器在 v2 层级中不可用
+    if (ReadCgroupV1(mounts, membership, out)) {
+        out->limitSource = "cgroup v1";
+    } else if (membership.hasV2) {
+        for (const Mount& mount : mounts) {
+            if (mount.type == "cgroup2" && ReadCgroupV2(mount, membership.v2, out)) {
+                out->limitSource = "cgroup v2";
+                break;
+            }
+        }
+    }
+    return out->logicalProcessors > 0;
+}
+
+#endif
+
+} // namespace environment
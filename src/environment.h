@@ -0,0 +1,46 @@
+#ifndef ENVIRONMENT_H
+#define ENVIRONMENT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ========== 运行环境：虚拟化、容器与资源限制 ==========
+// 在虚拟机或容器中，CPU / 内存探测看到的是宿主（或虚拟机）的全部资源，实际可用的往往更少。
+// 虚拟机监控程序经 CPUID.1:ECX[31] 与 0x40000000 叶的厂商签名识别；
+// 其它平台读取 /proc/self/cgroup 所在的 cgroup v1/v2 层级（CPU 配额、内存上限，逐级向上取最小值），
+// 可用处理器取调度亲和性（cpuset 与 taskset 最终都体现在这里）；
+// Windows 容器的限制在作业对象上（CPU 速率硬上限、作业/进程内存上限）。不依赖 wxWidgets。
+namespace environment
+{
+
+struct Info
+{
+    std::string hypervisor;         // "KVM"、"Hyper-V"、"VMware" ...；物理机为空
+    bool hypervisorRoot = false;    // Hyper-V 根分区：宿主本身运行在虚拟机监控程序之上，仍算物理机
+    std::string container;          // "docker"、"podman"、"kubernetes"、"lxc"、"windows" ...；不在容器中为空
+    std::string limitSource;        // "cgroup v2"、"cgroup v1"、"job"；没有找到限制机制时为空
+
+    int logicalProcessors = 0;      // 操作系统可见的逻辑处理器数
+    std::vector<int> allowedCpus;   // 本进程可调度的逻辑处理器，升序
+    double cpuQuota = 0;            // CPU 配额（核），0 表示不限
+    uint64_t physicalMemory = 0;    // 操作系统可见的内存（字节）
+    uint64_t memoryLimit = 0;       // 内存上限（字节），0 表示不限
+
+    bool IsVirtualMachine() const { return !hypervisor.empty() && !hypervisorRoot; }
+    bool IsContainer() const { return !container.empty(); }
+
+    // 实际可用：处理器取亲和性与配额的较小者，内存取可见内存与上限的较小者
+    double EffectiveCpus() const;
+    uint64_t EffectiveMemory() const;
+};
+
+// 平台接口全部不可用时返回 false；单项取不到时保留默认值
+bool Detect(Info* out);
+
+// CPUID 0x40000000 叶的 12 字节签名 → 名称；未知签名原样返回（去掉结尾的 NUL 与空白）
+std::string HypervisorName(const char signature[12]);
+
+} // namespace environment
+
+#endif // ENVIRONMENT_H
@@ -0,0 +1,263 @@
+#include "fingerprint.h"
+#include <algorithm>
+#include <cstdio>
+
+// ========== 哈希工具 ==========
+static inline uint64_t Mix64(uint64_t x)
+{
+    // splitmix64 终结函数
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// 归一化（去首尾空白、ASCII 大写）后做 FNV-1a；占位值返回 false
+static bool HashComponent(ComponentKind kind, const std::string& value, uint64_t* out)
+{
+    size_t begin = 0, end = value.size();
+    while (begin < end && (unsigned char)value[begin] <= ' ') ++begin;
+    while (end > begin && (unsigned char)value[end - 1] <= ' ') --end;
+    if (begin == end) return false;
+
+    std::string norm;
+    norm.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        char c = value[i];
+        norm += (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+    }
+    // 采集失败时的占位值不参与指纹
+    if (norm.compare(0, 7, "UNKNOWN") == 0 || norm == "N/A" || norm == "N/A|N/A" ||
+        norm == "00:00:00:00:00:00" || norm == "00000000-0000-0000-0000-000000000000") {
+        return false;
+    }
+
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (unsigned char c : norm) {
+        h ^= c;
+        h *= 0x100000001B3ULL;
+    }
+    *out = Mix64(h ^ ((uint64_t)kind << 56));
+    return true;
+}
+
+// ========== ComponentFingerprint ==========
+ComponentFingerprint ComponentFingerprint::FromInput(const FingerprintInput& input)
+{
+    ComponentFingerprint fp;
+    uint64_t h;
+
+    if (HashComponent(ComponentKind::Board, input.boardManufacturer + "|" + input.boardProduct, &h)) {
+        fp.m_components.push_back({ComponentKind::Board, h});
+    }
+    if (HashComponent(ComponentKind::Cpu, input.cpuManufacturer + "|" + input.cpuName, &h)) {
+        fp.m_components.push_back({ComponentKind::Cpu, h});
+    }
+    for (const std::string& disk : input.disks) {
+        if (HashComponent(ComponentKind::Disk, disk, &h)) fp.m_components.push_back({ComponentKind::Disk, h});
+    }
+    for (const std::string& mac : input.macs) {
+        if (HashComponent(ComponentKind::Nic, mac, &h)) fp.m_components.push_back({ComponentKind::Nic, h});
+    }
+    if (HashComponent(ComponentKind::Uuid, input.systemUUID, &h)) {
+        fp.m_components.push_back({ComponentKind::Uuid, h});
+    }
+    for (const std::string& field : input.plugins) {
+        if (HashComponent(ComponentKind::Plugin, field, &h)) fp.m_components.push_back({ComponentKind::Plugin, h});
+    }
+    if (HashComponent(ComponentKind::Virtual, input.platform, &h)) {
+        fp.m_components.push_back({ComponentKind::Virtual, h});
+    }
+
+    // 排序后与采集顺序无关；完全重复的组件（同一网卡多条记录）只保留一个
+    std::sort(fp.m_components.begin(), fp.m_components.end());
+    fp.m_components.erase(std::unique(fp.m_components.begin(), fp.m_components.end()), fp.m_components.end());
+    return fp;
+}
+
+uint32_t ComponentFingerprint::Weight(ComponentKind kind)
+{
+    // 主板/CPU 在同型号机器间相同，区分度低；UUID 区分度最高
+    switch (kind) {
+        case ComponentKind::Board: return 1;
+        case ComponentKind::Cpu:   return 1;
+        case ComponentKind::Disk:  return 2;
+        case ComponentKind::Nic:   return 2;
+        case ComponentKind::Uuid:  return 4;
+        case ComponentKind::Plugin: return 2;   // 资产标签、控制器序列号等，区分度与硬盘相当
+        case ComponentKind::Virtual: return 1;  // 只是标记：同一虚拟机迁移宿主时不变
+    }
+    return 1;
+}
+
+std::string ComponentFingerprint::Encode() const
+{
+    std::string out = "2";
+    char buf[24];
+    for (const FingerprintComponent& c : m_components) {
+        snprintf(buf, sizeof(buf), ";%c:%016llX", (char)c.kind, (unsigned long long)c.hash);
+        out += buf;
+    }
+    return out;
+}
+
+bool ComponentFingerprint::Decode(const std::string& text, ComponentFingerprint* out)
+{
+    if (!out || text.empty() || (text[0] != '1' && text[0] != '2')) return false;
+    bool v1 = text[0] == '1';   // 版本 1 没有插件与虚拟化组件
+
+    ComponentFingerprint fp;
+    size_t pos = 1;
+    while (pos < text.size()) {
+        // 每项固定为 ";K:" + 16 位十六进制
+        if (pos + 19 > text.size() || text[pos] != ';' || text[pos + 2] != ':') return false;
+        char kind = text[pos + 1];
+        bool known = kind == 'B' || kind == 'C' || kind == 'D' || kind == 'N' || kind == 'U' ||
+                     (!v1 && (kind == 'P' || kind == 'V'));
+        if (!known) return false;
+
+        uint64_t h = 0;
+        for (size_t i = pos + 3; i < pos + 19; ++i) {
+            char c = text[i];
+            int v = (c >= '0' && c <= '9') ? c - '0'
+                  : (c >= 'A' && c <= 'F') ? c - 'A' + 10
+                  : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+            if (v < 0) return false;
+            h = (h << 4) | (uint64_t)v;
+        }
+        fp.m_components.push_back({(ComponentKind)kind, h});
+        pos += 19;
+    }
+
+    std::sort(fp.m_components.begin(), fp.m_components.end());
+    *out = std::move(fp);
+    return true;
+}
+
+FingerprintMatch ComponentFingerprint::Compare(const FingerprintComponent* a, size_t aCount,
+                                               const FingerprintComponent* b, size_t bCount)
+{
+    FingerprintMatch m;
+    uint64_t common = 0, onlyA = 0, onlyB = 0;
+    size_t i = 0, j = 0;
+
+    while (i < aCount && j < bCount) {
+        if (a[i] == b[j]) {
+            common += Weight(a[i].kind);
+            ++m.matched;
+            ++i;
+            ++j;
+        } else if (a[i] < b[j]) {
+            onlyA += Weight(a[i++].kind);
+        } else {
+            onlyB += Weight(b[j++].kind);
+        }
+    }
+    for (; i < aCount; ++i) onlyA += Weight(a[i].kind);
+    for (; j < bCount; ++j) onlyB += Weight(b[j].kind);
+
+    uint64_t unionWeight = common + onlyA + onlyB;
+    m.total = (unsigned int)std::max(aCount, bCount);
+    m.changed = m.total - m.matched;
+    m.score = unionWeight ? (double)common / (double)unionWeight : 0.0;
+    return m;
+}
+
+bool ComponentFingerprint::IsSameMachine(const FingerprintMatch& match, unsigned int maxChanged, double minScore)
+{
+    return match.matched > 0 && match.changed <= maxChanged && match.score >= minScore;
+}
+
+// ========== FingerprintIndex ==========
+FingerprintIndex::FingerprintIndex(const Params& params)
+    : m_params(params), m_bands(params.bands), m_offsets(1, 0)
+{
+    if (m_params.rows == 0) m_params.rows = 1;
+}
+
+// 加权 MinHash：权重为 w 的组件展开为 w 个记号，签名第 i 位是全部记号在第 i 个哈希函数下的最小值
+std::vector<uint32_t> FingerprintIndex::Signature(const ComponentFingerprint& fp) const
+{
+    const size_t k = (size_t)m_params.bands * m_params.rows;
+    std::vector<uint32_t> sig(k, UINT32_MAX);
+
+    for (const FingerprintComponent& c : fp.Components()) {
+        uint32_t w = ComponentFingerprint::Weight(c.kind);
+        for (uint32_t r = 0; r < w; ++r) {
+            uint64_t token = Mix64(c.hash + r);
+            for (size_t i = 0; i < k; ++i) {
+                uint32_t v = (uint32_t)(Mix64(token ^ (0xA0761D6478BD642FULL * (i + 1))) >> 32);
+                if (v < sig[i]) sig[i] = v;
+            }
+        }
+    }
+    return sig;
+}
+
+uint32_t FingerprintIndex::BandKey(const std::vector<uint32_t>& sig, unsigned int band) const
+{
+    uint64_t h = band;
+    for (unsigned int r = 0; r < m_params.rows; ++r) {
+        h = Mix64(h ^ sig[(size_t)band * m_params.rows + r]);
+    }
+    return (uint32_t)(h >> 32);
+}
+
+uint32_t FingerprintIndex::Add(const ComponentFingerprint& fp)
+{
+    uint32_t id = (uint32_t)Size();
+    std::vector<uint32_t> sig = Signature(fp);
+    for (unsigned int b = 0; b < m_params.bands; ++b) {
+        m_bands[b].push_back(((uint64_t)BandKey(sig, b) << 32) | id);
+    }
+    m_components.insert(m_components.end(), fp.Components().begin(), fp.Components().end());
+    m_offsets.push_back((uint32_t)m_components.size());
+    return id;
+}
+
+void FingerprintIndex::Build()
+{
+    for (std::vector<uint64_t>& band : m_bands) {
+        std::sort(band.begin(), band.end());
+    }
+}
+
+std::vector<FingerprintIndex::Result> FingerprintIndex::Query(const ComponentFingerprint& fp, double minScore,
+                                                              size_t maxResults) const
+{
+    std::vector<uint32_t> sig = Signature(fp);
+
+    // 收集候选：任一带键相同
+    std::vector<uint32_t> candidates;
+    for (unsigned int b = 0; b < m_params.bands; ++b) {
+        const std::vector<uint64_t>& band = m_bands[b];
+        uint64_t key = BandKey(sig, b);
+        auto it = std::lower_bound(band.begin(), band.end(), key << 32);
+        for (; it != band.end() && (*it >> 32) == key; ++it) {
+            candidates.push_back((uint32_t)*it);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // 候选精确打分
+    std::vector<Result> results;
+    const std::vector<FingerprintComponent>& query = fp.Components();
+    for (uint32_t id : candidates) {
+        const FingerprintComponent* comps = m_components.data() + m_offsets[id];
+        size_t count = m_offsets[id + 1] - m_offsets[id];
+        FingerprintMatch m = ComponentFingerprint::Compare(query.data(), query.size(), comps, count);
+        if (m.score >= minScore) results.push_back({id, m});
+    }
+
+    auto byScore = [](const Result& x, const Result& y) {
+        return x.match.score != y.match.score ? x.match.score > y.match.score : x.id < y.id;
+    };
+    if (results.size() > maxResults) {
+        std::partial_sort(results.begin(), results.begin() + maxResults, results.end(), byScore);
+        results.resize(maxResults);
+    } else {
+        std::sort(results.begin(), results.end(), byScore);
+    }
+    return results;
+}
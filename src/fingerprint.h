@@ -0,0 +1,133 @@
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ========== 分组件机器指纹 ==========
+// MachineFingerprint 把所有组件揉成一个哈希，换一块网卡就变。
+// 这里为每个组件单独计算哈希并加权，用于判断"同一台机器，n 个组件中改了 k 个"；
+// 网卡、硬盘按多重集合比较，与 GetAdaptersAddresses 返回的顺序无关。
+// 不依赖 wxWidgets，授权服务器端可直接使用。
+
+enum class ComponentKind : uint8_t
+{
+    Board = 'B',   // 主板制造商 + 型号
+    Cpu   = 'C',   // CPU 厂商 + 型号
+    Disk  = 'D',   // 每块硬盘一个（型号 + 序列号）
+    Nic   = 'N',   // 每个 MAC 一个
+    Uuid  = 'U',   // 系统 UUID
+    Plugin = 'P',  // 插件声明参与指纹的字段，每个一个（节名 + 键 + 值）
+    Virtual = 'V', // 虚拟化/容器标记（类型 + 虚拟机监控程序 + 容器）；物理机没有此组件
+};
+
+struct FingerprintComponent
+{
+    ComponentKind kind;
+    uint64_t hash;
+
+    bool operator==(const FingerprintComponent& o) const { return kind == o.kind && hash == o.hash; }
+    bool operator<(const FingerprintComponent& o) const
+    {
+        return kind != o.kind ? kind < o.kind : hash < o.hash;
+    }
+};
+
+// 采集结果（UTF-8），由 Hardware 填充
+struct FingerprintInput
+{
+    std::string boardManufacturer, boardProduct;
+    std::string cpuManufacturer, cpuName;
+    std::vector<std::string> disks;
+    std::vector<std::string> macs;
+    std::string systemUUID;
+    std::vector<std::string> plugins;   // "节名.键=值"
+    std::string platform;               // 物理机为空，否则如 "vm|KVM|none"
+};
+
+struct FingerprintMatch
+{
+    double score = 0.0;         // 加权 Jaccard 相似度 [0, 1]
+    unsigned int matched = 0;   // 相同的组件数
+    unsigned int changed = 0;   // 改变（新增/移除/替换）的组件数
+    unsigned int total = 0;     // 两侧组件数的较大值
+};
+
+class ComponentFingerprint
+{
+public:
+    static ComponentFingerprint FromInput(const FingerprintInput& input);
+
+    // 文本编码："2;B:<hex>;C:<hex>;D:<hex>;N:<hex>;P:<hex>;U:<hex>;V:<hex>"，组件有序，可直接存库。
+    // 版本 1 只有 B/C/D/N/U 五类；Decode 两个版本都接受，旧解码器遇到版本 2 直接拒绝而不是误读
+    std::string Encode() const;
+    static bool Decode(const std::string& text, ComponentFingerprint* out);
+
+    static uint32_t Weight(ComponentKind kind);
+
+    const std::vector<FingerprintComponent>& Components() const { return m_components; }
+    bool IsEmpty() const { return m_components.empty(); }
+
+    // 逐组件比较（两侧组件均已排序，线性合并）
+    static FingerprintMatch Compare(const FingerprintComponent* a, size_t aCount,
+                                    const FingerprintComponent* b, size_t bCount);
+    static FingerprintMatch Compare(const ComponentFingerprint& a, const ComponentFingerprint& b)
+    {
+        return Compare(a.m_components.data(), a.m_components.size(),
+                       b.m_components.data(), b.m_components.size());
+    }
+
+    // 同一台机器：最多 maxChanged 个组件改变，且加权相似度不低于 minScore
+    static bool IsSameMachine(const FingerprintMatch& match, unsigned int maxChanged = 2, double minScore = 0.5);
+
+private:
+    std::vector<FingerprintComponent> m_components;  // 按 (kind, hash) 排序
+};
+
+// ========== 局部敏感哈希索引（服务端相似查询）==========
+// 加权 MinHash 签名 + 分带（banding）：相似度高的指纹至少有一个带完全相同，
+// 候选集再用 Compare 精确打分。每个带是按键排序的扁平数组，查询为 bands 次二分查找。
+class FingerprintIndex
+{
+public:
+    struct Params
+    {
+        unsigned int bands = 24;
+        unsigned int rows = 4;      // 每带行数越大，越能排除同型号的"孪生"机器
+    };
+
+    struct Result
+    {
+        uint32_t id;
+        FingerprintMatch match;
+    };
+
+    FingerprintIndex() : FingerprintIndex(Params()) {}
+    explicit FingerprintIndex(const Params& params);
+
+    // 添加指纹，返回其 id（从 0 递增）；添加完成后须调用 Build() 才能查询
+    uint32_t Add(const ComponentFingerprint& fp);
+    void Build();
+
+    // 相似查询：返回得分不低于 minScore 的结果，按得分降序，最多 maxResults 个
+    // Build() 之后可多线程并发查询
+    std::vector<Result> Query(const ComponentFingerprint& fp, double minScore = 0.5,
+                              size_t maxResults = 10) const;
+
+    size_t Size() const { return m_offsets.size() - 1; }
+
+private:
+    std::vector<uint32_t> Signature(const ComponentFingerprint& fp) const;
+    uint32_t BandKey(const std::vector<uint32_t>& sig, unsigned int band) const;
+
+    Params m_params;
+    // 每带一个数组：高 32 位为带哈希，低 32 位为 id
+    std::vector<std::vector<uint64_t>> m_bands;
+    // 全部指纹的组件扁平存储，m_offsets[i]..m_offsets[i+1] 为第 i 个
+    std::vector<FingerprintComponent> m_components;
+    std::vector<uint32_t> m_offsets;
+};
+
+#endif // FINGERPRINT_H
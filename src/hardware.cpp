@@ -1,11 +1,23 @@
 #include "hardware.h"
+#include "transcode.h"
+#include "pci.h"
+#include "pciids.h"
+#include "numa.h"
+#include "energy.h"
+#include "environment.h"
+#include "audit.h"
+#include "lowimpact.h"
 #include <wx/log.h>
 #include <wx/arrstr.h>
-#include <vector>
 #include <iphlpapi.h>    // GetAdaptersAddresses
 #include <psapi.h>       // GetPhysicallyInstalledSystemMemory
 #include <cstring>       // memcpy
 #include <cwchar>        // wcslen
+#include <algorithm>     // std::min
+#include <numeric>       // std::iota
+#include <cmath>         // std::lround
+#include <map>
+#include <mutex>
 
 // ✅ 关键修复：避免内联汇编，使用 __get_cpuid（MinGW 安全）
 #if defined(__GNUC__) || defined(__MINGW32__)
@@ -28,28 +40,282 @@
 #endif
 
 // ========== 工具方法：宽字符转换 ==========
+// 注册表字符串（UTF-16）→ wxString，单趟完成，短串不做堆分配
 wxString Hardware::WCharToWxString(const wchar_t* wstr, DWORD size)
 {
     if (!wstr || wstr[0] == L'\0') return wxEmptyString;
     
-    if (size == 0) {
-        size = (DWORD)(wcslen(wstr) * sizeof(wchar_t));
-    }
+    static_assert(sizeof(wchar_t) == sizeof(char16_t), "Windows wchar_t 应为 UTF-16");
+    const char16_t* src = reinterpret_cast<const char16_t*>(wstr);
+    
+    // 注册表返回的字节数包含结尾 NUL，按第一个 NUL 截断
+    size_t len = (size == 0) ? wcslen(wstr)
+                             : transcode::Utf16Length(src, size / sizeof(wchar_t));
     
-    // 转换为 UTF-8
-    int len = WideCharToMultiByte(CP_UTF8, 0, wstr, size / sizeof(wchar_t), NULL, 0, NULL, NULL);
-    if (len <= 0) return wxEmptyString;
+#if wxUSE_UNICODE_WCHAR
+    // wxString 内部即 UTF-16：直接拷贝，无需转码
+    return wxString(wstr, len);
+#else
+    transcode::SmallBuffer<char, 768> utf8(transcode::MaxUtf8Length(len));
+    size_t n = transcode::Utf16ToUtf8(src, len, utf8.data());
+    return wxString::FromUTF8(utf8.data(), n);
+#endif
+}
+
+// UTF-8（CPUID 字符串等）→ wxString，ASCII 走 SIMD 快速路径
+wxString Hardware::Utf8ToWxString(const char* str, size_t len)
+{
+    if (!str || len == 0) return wxEmptyString;
     
-    std::vector<char> buffer(len + 1, 0);
-    WideCharToMultiByte(CP_UTF8, 0, wstr, size / sizeof(wchar_t), buffer.data(), len, NULL, NULL);
+#if wxUSE_UNICODE_WCHAR
+    transcode::SmallBuffer<char16_t, 256> utf16(transcode::MaxUtf16Length(len));
+    size_t n = transcode::Utf8ToUtf16(str, len, utf16.data());
+    return wxString(reinterpret_cast<const wchar_t*>(utf16.data()), n);
+#else
+    return wxString::FromUTF8(str, len);
+#endif
+}
+
+// 无符号整数 → 十进制 wxString，不经 printf 格式化
+static wxString DecimalToWxString(unsigned long long value)
+{
+    char buf[transcode::kMaxDecimalLength];
+    return Hardware::Utf8ToWxString(buf, transcode::FormatDecimal(value, buf));
+}
+
+// MAC 地址 → "AA:BB:CC:DD:EE:FF"，在栈上拼接后一次构造
+wxString Hardware::FormatMacAddress(const BYTE* addr, ULONG len)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    char buf[3 * MAX_ADAPTER_ADDRESS_LENGTH];
+    if (len > MAX_ADAPTER_ADDRESS_LENGTH) len = MAX_ADAPTER_ADDRESS_LENGTH;
     
-    return wxString::FromUTF8(buffer.data());
+    size_t n = 0;
+    for (ULONG i = 0; i < len; ++i) {
+        if (i > 0) buf[n++] = ':';
+        buf[n++] = hex[addr[i] >> 4];
+        buf[n++] = hex[addr[i] & 0x0F];
+    }
+    return Utf8ToWxString(buf, n);
+}
+
+// ========== 探测表 ==========
+// 顺序即同步采集时的执行顺序（声明了耗时的插件探测先行）；每个探测只写自己的字段，
+// 字段归属见 snapshot.h 中的 HardwareSnapshotSchema（section 与探测名一致）
+const Hardware::Probe Hardware::s_probes[] = {
+    { "BaseBoard", &Hardware::getBaseBoardInfo, true },
+    { "CPU", &Hardware::getCPUInfo, true },
+    { "Memory", &Hardware::getMemoryInfo, false },
+    { "Disk", &Hardware::getDiskInfo, true },
+    { "Network", &Hardware::getNetworkInfo, true },
+    { "BIOS", &Hardware::getBIOSInfo, false },
+    { "SystemUUID", &Hardware::getSystemUUID, true },
+    { "PCI", &Hardware::getPciInfo, false },
+    { "NUMA", &Hardware::getNumaInfo, false },
+    { "Environment", &Hardware::getEnvironmentInfo, true },
+};
+const size_t Hardware::s_probeCount = sizeof(s_probes) / sizeof(s_probes[0]);
+
+// 插件探测排在内置探测之后；与内置探测重名的不加载
+namespace
+{
+    std::vector<std::string>& PluginLoadErrors()
+    {
+        static std::vector<std::string> errors;
+        return errors;
+    }
+
+    // 文本格式中列表下标的上限，所有插件的字段合计不超过此数
+    constexpr size_t kMaxPluginFields = 4096;
+
+    // 进程内共用一个计量器：计数器只在首次采集时枚举、打开，各次采集以读数之差计量
+    energy::Meter& EnergyMeter()
+    {
+        static energy::Meter* meter = [] {
+            energy::Meter* m = new energy::Meter();
+            m->Discover();
+            return m;
+        }();
+        return *meter;
+    }
+
+    // RAPL 只有封装/平台粒度：区间内的全部能耗记为 CollectionMj，再按采集工作实际消耗的线程 CPU 时间
+    // （collectorCpuSeconds）占整机繁忙 CPU 时间的份额折算出 AttributedMj。
+    // 用线程时间而不是进程时间：界面、传感器采样等同进程的其它线程不算在采集头上
+    std::vector<EnergyReading> MeasureEnergy(const energy::Meter& meter, const energy::Mark& from,
+                                              const energy::Mark& to, double collectorCpuSeconds)
+    {
+        std::vector<EnergyReading> readings;
+        double seconds = std::chrono::duration<double>(to.time - from.time).count();
+        double share = energy::Share(collectorCpuSeconds, from, to);
+        const std::vector<energy::Counter>& counters = meter.Counters();
+        for (size_t i = 0; i < counters.size() && i < from.joules.size() && i < to.joules.size(); ++i) {
+            double joules = to.joules[i] - from.joules[i];
+            EnergyReading reading;
+            reading.Domain = wxString::FromUTF8(counters[i].name.c_str());
+            reading.Source = wxString::FromUTF8(counters[i].source.c_str());
+            reading.PowerMw = seconds > 0 ? std::lround(joules / seconds * 1000.0) : 0;
+            reading.CollectionMj = std::lround(joules * 1000.0);
+            reading.AttributedMj = std::lround(joules * share * 1000.0);
+            readings.push_back(std::move(reading));
+        }
+        return readings;
+    }
+}
+
+// ========== 调优检查规则包 ==========
+// 内置规则包，再合并可执行文件旁的 audit.rules（同 ID 覆盖）；进程内只解析一次
+namespace
+{
+    struct AuditRulePack
+    {
+        std::vector<audit::Rule> rules;
+        std::vector<std::string> errors;
+    };
+
+    const AuditRulePack& AuditRules()
+    {
+        static const AuditRulePack pack = [] {
+            AuditRulePack p;
+            audit::ParseRules(audit::DefaultRules(), "builtin", &p.rules, &p.errors);
+            audit::LoadRuleFile(audit::DefaultRuleFile(), &p.rules, &p.errors);
+            return p;
+        }();
+        return pack;
+    }
+
+    // 快照的扁平键值作为 "snapshot:<键>" 来源；空值与 "Unknown" 不算事实
+    audit::Facts SnapshotFacts(const HardwareSnapshot& snap)
+    {
+        audit::Facts facts;
+        schema::ForEachKeyValue(snap, [&](const std::string& key, const std::string& value) {
+            if (value.empty() || value.compare(0, 7, "Unknown") == 0) return;
+            facts.Add("snapshot:" + key, key, value);
+        });
+        return facts;
+    }
+
+    // 取事实与求值作为一个任务：超时后它在后台跑完，事实表归它自己的协程帧所有。
+    // 读取来源所用的线程 CPU 时间写入 *cpuSeconds（规则求值只在内存中比较，忽略不计）
+    mt::Task<std::vector<audit::Finding>> RunAudit(mt::Scheduler& scheduler, const AuditRulePack& pack, audit::Facts facts,
+                                                   std::shared_ptr<double> cpuSeconds)
+    {
+        // 命名任务而非临时对象：同 WhenAll 的等待器，规避 GCC 对协程中临时对象的析构问题
+        mt::Task<void> load = mt::Offload(scheduler, [&facts, &pack, cpuSeconds] {
+            double begin = energy::ThreadCpuSeconds();
+            facts.Load(pack.rules);
+            *cpuSeconds = energy::ThreadCpuSeconds() - begin;
+        });
+        co_await load;
+        mt::Task<std::vector<audit::Finding>> evaluate = audit::EvaluateAll(scheduler, pack.rules, facts);
+        co_return co_await evaluate;
+    }
+
+    std::pair<bool, energy::Mark> TakeEnergy(energy::Meter& meter)
+    {
+        energy::Mark mark;
+        bool ok = energy::Take(meter, &mark);
+        return { ok, std::move(mark) };
+    }
+}
+
+// ========== 低影响模式 ==========
+namespace
+{
+    // 专用线程池：工作线程启动时即降为空闲优先级并绑定到 housekeeping 核心，此后不再恢复。
+    // 两个线程：枚举本就限速，并发度低一些对业务更友好。不随进程退出析构，理由同 SharedPool
+    mt::ThreadPoolScheduler& LowImpactPool()
+    {
+        static mt::ThreadPoolScheduler* pool = new mt::ThreadPoolScheduler(2, [] {
+            static const std::vector<int> cpus = lowimpact::HousekeepingCpus();
+            if (!lowimpact::EnterBackground(cpus)) wxLogDebug("low-impact: could not fully lower collector thread priority");
+        });
+        return *pool;
+    }
+}
+
+bool Hardware::paceRead()
+{
+    if (m_reads && !m_reads->Acquire(m_stop)) return false;
+    return !m_stop.stop_requested();
+}
+
+const std::vector<std::string>& Hardware::AuditRuleErrors()
+{
+    return AuditRules().errors;
+}
+
+const std::vector<Hardware::Probe>& Hardware::probeTable()
+{
+    static const std::vector<Probe> table = [] {
+        std::vector<Probe> probes(s_probes, s_probes + s_probeCount);
+        std::vector<std::string>& errors = PluginLoadErrors();
+        errors = plugins::LoadErrors();
+        for (const plugins::Probe& plugin : plugins::Loaded()) {
+            bool builtin = std::any_of(s_probes, s_probes + s_probeCount,
+                                       [&](const Probe& probe) { return plugin.section == probe.name; });
+            if (builtin) {
+                errors.push_back(plugin.plugin + ": section " + plugin.section + " is a built-in probe");
+                continue;
+            }
+            probes.push_back(Probe{ plugin.section.c_str(), nullptr, plugin.forFingerprint, &plugin });
+        }
+        for (const std::string& error : errors) wxLogDebug("plugin: %s", error.c_str());
+        return probes;
+    }();
+    return table;
+}
+
+const std::vector<std::string>& Hardware::PluginErrors()
+{
+    probeTable();
+    return PluginLoadErrors();
+}
+
+bool Hardware::IsPluginProbe(const wxString& section)
+{
+    for (const Probe& probe : probeTable()) {
+        if (probe.plugin && section == probe.name) return true;
+    }
+    return false;
 }
 
 // ========== 主采集入口 ==========
-int Hardware::GetInfo()
+int Hardware::GetInfo(std::stop_token stop, const CollectOptions& options)
+{
+    if (options.TotalBudget.count() > 0 || options.ProbeTimeout.count() > 0) {
+        // 有预算：探测在共享线程池上执行，超时的探测留在池中跑完，调用方按期返回
+        *this = mt::SyncWait(collectProbes(SharedPool(), stop, options, false));
+    } else {
+        // 同步入口：内联调度器上按探测表顺序依次执行
+        mt::InlineScheduler scheduler;
+        *this = mt::SyncWait(collectProbes(scheduler, stop, options, false));
+    }
+    if (stop.stop_requested()) return 1;
+    return IsPartial() ? 2 : 0;
+}
+
+mt::Task<Hardware> Hardware::CollectAsync(mt::Scheduler& scheduler, std::stop_token stop,
+                                          CollectOptions options)
+{
+    return collectProbes(scheduler, stop, options, false);
+}
+
+mt::ThreadPoolScheduler& Hardware::SharedPool()
+{
+    static mt::ThreadPoolScheduler* pool = new mt::ThreadPoolScheduler(4);
+    return *pool;
+}
+
+mt::Task<wxString> Hardware::FingerprintAsync(mt::Scheduler& scheduler, std::stop_token stop,
+                                              CollectOptions options)
+{
+    Hardware hw = co_await collectProbes(scheduler, stop, options, true);
+    co_return hw.MachineFingerprint;
+}
+
+void Hardware::resetDefaults()
 {
-    // 初始化默认值
     BaseBoardManufacturer = _("Unknown");
     BaseBoardProduct = _("Unknown");
     CPUManufacturer = _("Unknown");
@@ -58,6 +324,7 @@ int Hardware::GetInfo()
     TotalPhysicalMemory = "0";
     MemoryType = _("Unknown");
     MemorySpeed = _("Unknown");
+    MemoryRatedSpeed.clear();
     DiskModels.clear();
     DiskSerialNumbers.clear();
     MACAddresses.clear();
@@ -66,34 +333,305 @@ int Hardware::GetInfo()
     BIOSReleaseDate = _("Unknown");
     SystemUUID = _("Unknown");
     MachineFingerprint = _("Unknown");
+    ComponentFingerprintCode.clear();
+    ProbeReports.clear();
+    PciDevices.clear();
+    NumaNodes.clear();
+    PluginFields.clear();
+    EnergyReadings.clear();
+    Virtualization = _("Unknown");
+    Hypervisor = _("Unknown");
+    Container = _("Unknown");
+    ResourceLimits.clear();
+    LogicalProcessors = 0;
+    AllowedCpus.clear();
+    CpuQuotaMilli = 0;
+    EffectiveCpuMilli = 0;
+    MemoryLimit.clear();
+    EffectiveMemory.clear();
+    AuditFindings.clear();
+}
+
+// ========== 卡住的探测 ==========
+// 超时的探测仍占着一个工作线程，直到驱动调用返回，而这可能永远不会发生。
+// 看门狗放弃时若探测已在运行，记为卡住：同名探测在它返回前不再启动（状态 Hung），
+// 并给线程池补一个工作线程顶替。每个探测最多同时卡住一次，线程池的增长以探测个数为上限
+struct Hardware::ProbeRun
+{
+    bool running = false;    // 已在工作线程上开始、尚未返回
+    bool overdue = false;    // 看门狗放弃时仍在运行
+};
 
-    // 1. 主板信息
-    getBaseBoardInfo();
+namespace
+{
+    std::mutex g_hungMutex;
+    std::map<std::string, int> g_hung;   // 探测名 → 超时后仍未返回的运行数，受 g_hungMutex 保护
 
-    // 2. CPU 信息
-    getCPUInfo();
+    bool IsHung(const char* name)
+    {
+        std::lock_guard<std::mutex> lock(g_hungMutex);
+        return g_hung.count(name) != 0;
+    }
+}
 
-    // 3. 内存信息
-    getMemoryInfo();
+Hardware Hardware::probeResult(const Probe* probe, ProbeStatus status, long elapsedMs)
+{
+    Hardware hw;
+    hw.resetDefaults();
+    hw.ProbeReports.push_back(ProbeReport{ probe->name, status, elapsedMs });
+    return hw;
+}
 
-    // 4. 硬盘信息
-    getDiskInfo();
+// 单个探测：切换到调度器线程，在独立的临时对象上运行
+// 超时后迟到的写入只落在临时对象上，不会影响已返回的结果
+mt::Task<Hardware> Hardware::probeTask(mt::Scheduler& scheduler, const Probe* probe, std::stop_token stop,
+                                       std::chrono::steady_clock::time_point deadline,
+                                       std::shared_ptr<lowimpact::TokenBucket> reads,
+                                       std::shared_ptr<ProbeRun> run)
+{
+    co_await scheduler.Schedule();
+    // 排队期间已取消或已过期：不再开始，避免在看门狗放弃之后继续占用线程
+    auto start = std::chrono::steady_clock::now();
+    if (stop.stop_requested() || start >= deadline) {
+        co_return probeResult(probe, ProbeStatus::Skipped, 0);
+    }
+    if (run) {
+        std::lock_guard<std::mutex> lock(g_hungMutex);
+        run->running = true;
+    }
+    
+    Hardware scratch;
+    scratch.resetDefaults();
+    scratch.m_stop = stop;
+    scratch.m_reads = std::move(reads);
+    double cpuBegin = energy::ThreadCpuSeconds();
+    bool ok = probe->plugin ? scratch.getPluginInfo(*probe->plugin, deadline) : (scratch.*(probe->collect))();
+    scratch.m_cpuSeconds = energy::ThreadCpuSeconds() - cpuBegin;
+    if (run) {
+        std::lock_guard<std::mutex> lock(g_hungMutex);
+        run->running = false;
+        if (run->overdue) {
+            auto it = g_hung.find(probe->name);
+            if (it != g_hung.end() && --it->second == 0) g_hung.erase(it);
+        }
+    }
+    
+    long elapsed = (long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    ProbeStatus status = !ok ? ProbeStatus::Failed
+                       : scratch.m_fallback ? ProbeStatus::Fallback
+                       : ProbeStatus::Ok;
+    scratch.ProbeReports.push_back(ProbeReport{ probe->name, status, elapsed });
+    co_return scratch;
+}
 
-    // 5. 网卡信息
-    getNetworkInfo();
+mt::Task<Hardware> Hardware::runProbe(mt::Scheduler& scheduler, const Probe* probe,
+                                      std::stop_token stop, std::chrono::milliseconds timeout,
+                                      std::shared_ptr<lowimpact::TokenBucket> reads)
+{
+    // 上一次超时的运行还卡着：再启动只会再卡住一个线程
+    if (IsHung(probe->name)) {
+        co_return probeResult(probe, ProbeStatus::Hung, 0);
+    }
+    if (timeout.count() <= 0) {
+        co_return co_await probeTask(scheduler, probe, stop, std::chrono::steady_clock::time_point::max(),
+                                     std::move(reads), nullptr);
+    }
+    // 插件声明的耗时超过期限：注定超时，且超时后仍会占住一个线程，不如不开始
+    if (probe->plugin && (long long)probe->plugin->costMs > (long long)timeout.count()) {
+        co_return probeResult(probe, ProbeStatus::Skipped, 0);
+    }
+    
+    // 期限从排队时起算：线程池忙时排队等待的时间也计入
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto run = std::make_shared<ProbeRun>();
+    std::optional<Hardware> result =
+        co_await mt::WithTimeout(scheduler, probeTask(scheduler, probe, stop, deadline, std::move(reads), run), timeout);
+    if (!result) {
+        bool poisoned = false;
+        {
+            std::lock_guard<std::mutex> lock(g_hungMutex);
+            if (run->running) {
+                run->overdue = true;
+                ++g_hung[probe->name];
+                poisoned = true;
+            }
+        }
+        // 还在排队的运行到期后会自行跳过；已在运行的占住了线程，补一个
+        if (poisoned) {
+            if (auto* pool = dynamic_cast<mt::ThreadPoolScheduler*>(&scheduler)) pool->AddWorker();
+        }
+        wxLogDebug("probe %s timed out%s", probe->name, poisoned ? " while running" : "");
+        co_return probeResult(probe, ProbeStatus::TimedOut, (long)timeout.count());
+    }
+    co_return std::move(*result);
+}
 
-    // 6. BIOS 信息
-    getBIOSInfo();
+mt::Task<Hardware> Hardware::collectProbes(mt::Scheduler& callerScheduler, std::stop_token stop,
+                                           CollectOptions options, bool fingerprintOnly)
+{
+    // 低影响模式：全部探测与调优检查改在后台优先级线程池上执行，设备枚举共用一个令牌桶
+    mt::Scheduler& scheduler = options.LowImpact ? LowImpactPool() : callerScheduler;
+    std::shared_ptr<lowimpact::TokenBucket> reads;
+    if (options.LowImpact && options.ReadsPerSecond > 0) {
+        reads = std::make_shared<lowimpact::TokenBucket>(options.ReadsPerSecond, std::max(1.0, options.ReadsPerSecond / 20.0));
+    }
+    
+    // 所有探测同时开始，各自的期限不超过整体预算
+    auto begin = std::chrono::steady_clock::now();
+    std::chrono::milliseconds timeout = options.ProbeTimeout;
+    if (options.TotalBudget.count() > 0 && (timeout.count() <= 0 || timeout > options.TotalBudget)) {
+        timeout = options.TotalBudget;
+    }
+    
+    std::vector<const Probe*> selected;
+    for (const Probe& probe : probeTable()) {
+        if (fingerprintOnly && !probe.forFingerprint) continue;
+        selected.push_back(&probe);
+    }
+    
+    // 插件声明耗时长的先启动，线程池满时不至于排在最后；合并与状态仍按探测表顺序
+    auto cost = [](const Probe* probe) { return probe->plugin ? probe->plugin->costMs : 0u; };
+    std::vector<size_t> order(selected.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return cost(selected[a]) > cost(selected[b]); });
+    // 从启动第一个探测到生成指纹为止计量能耗；超时后仍在后台运行的探测不计入
+    energy::Meter& meter = EnergyMeter();
+    energy::Mark energyStart;
+    bool metered = energy::Take(meter, &energyStart);
+    
+    std::vector<mt::Task<Hardware>> tasks;
+    for (size_t i : order) {
+        tasks.push_back(runProbe(scheduler, selected[i], stop, timeout, reads));
+    }
+    
+    std::vector<Hardware> launched = co_await mt::WhenAll(std::move(tasks));
+    std::vector<Hardware*> results(selected.size());
+    for (size_t k = 0; k < order.size(); ++k) results[order[k]] = &launched[k];
+    
+    // 超时、被跳过的探测只带回默认值，合并后相应字段仍为 "Unknown"，状态另行记录
+    Hardware hw;
+    hw.resetDefaults();
+    double collectorCpu = 0;   // 按期完成的探测与调优检查消耗的线程 CPU 时间，用于能耗归属
+    for (size_t i = 0; i < results.size(); ++i) {
+        Hardware& result = *results[i];
+        collectorCpu += result.m_cpuSeconds;
+        if (selected[i]->plugin) {
+            for (PluginField& field : result.PluginFields) {
+                if (hw.PluginFields.size() >= kMaxPluginFields) {
+                    for (ProbeReport& report : result.ProbeReports) {
+                        if (report.Status == ProbeStatus::Ok) report.Status = ProbeStatus::Fallback;
+                    }
+                    break;
+                }
+                hw.PluginFields.push_back(std::move(field));
+            }
+        } else {
+            schema::MoveSection(hw, result, selected[i]->name);
+        }
+        for (ProbeReport& report : result.ProbeReports) {
+            hw.ProbeReports.push_back(std::move(report));
+        }
+    }
+    
+    // 生成机器指纹
+    if (!stop.stop_requested() && !hw.SystemUUID.IsEmpty() && !hw.SystemUUID.StartsWith("Unknown")) {
+        hw.MachineFingerprint = hw.generateFingerprint();
+    }
+    if (!stop.stop_requested()) {
+        std::string code = ComponentFingerprint::FromInput(hw.GetFingerprintInput()).Encode();
+        hw.ComponentFingerprintCode = Utf8ToWxString(code.data(), code.size());
+    }
+    
+    // 探测之后的阶段也受整体预算约束：余量用尽时跳过，否则以余量为期限
+    auto remaining = [&] {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+        return options.TotalBudget - elapsed;
+    };
+    bool budgeted = options.TotalBudget.count() > 0;
+    
+    // 调优检查：规则引用的 sysfs / procfs / 注册表来源在调度器上一次读完，各规则再并发求值。
+    // 结果记为 "Audit" 探测状态；超时（含开始前余量已用尽）时没有发现，状态为 timed-out
+    if (!fingerprintOnly && !stop.stop_requested()) {
+        auto auditBegin = std::chrono::steady_clock::now();
+        std::optional<std::vector<audit::Finding>> findings;
+        ProbeStatus auditStatus = ProbeStatus::Ok;
+        auto auditCpu = std::make_shared<double>(0.0);
+        if (!budgeted) {
+            mt::Task<std::vector<audit::Finding>> run = RunAudit(scheduler, AuditRules(), SnapshotFacts(hw), auditCpu);
+            findings = co_await run;
+        } else if (std::chrono::milliseconds left = remaining(); left.count() > 0) {
+            mt::Task<std::optional<std::vector<audit::Finding>>> run =
+                mt::WithTimeout(scheduler, RunAudit(scheduler, AuditRules(), SnapshotFacts(hw), auditCpu), left);
+            findings = co_await run;
+        }
+        if (!findings) {
+            wxLogDebug("audit timed out");
+            auditStatus = ProbeStatus::TimedOut;
+        } else {
+            collectorCpu += *auditCpu;   // 只在按期完成时读取：超时的任务可能仍在写
+            for (const audit::Finding& finding : *findings) {
+                AuditFinding item;
+                item.Rule = wxString::FromUTF8(finding.rule.c_str());
+                item.Severity = audit::SeverityName(finding.severity);
+                item.Title = wxString::FromUTF8(finding.title.c_str());
+                item.Detail = wxString::FromUTF8(finding.detail.c_str());
+                item.Advice = wxString::FromUTF8(finding.advice.c_str());
+                hw.AuditFindings.push_back(std::move(item));
+            }
+        }
+        long auditMs = (long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - auditBegin).count();
+        hw.ProbeReports.push_back(ProbeReport{ wxT("Audit"), auditStatus, auditMs });
+    }
+    
+    // 结束读数同样不超出预算：读不到时本次不报告能耗
+    std::optional<std::pair<bool, energy::Mark>> energyEnd;
+    if (metered && !budgeted) {
+        energyEnd = TakeEnergy(meter);
+    } else if (metered) {
+        if (std::chrono::milliseconds left = remaining(); left.count() > 0) {
+            mt::Task<std::optional<std::pair<bool, energy::Mark>>> take =
+                mt::WithTimeout(scheduler, mt::Offload(scheduler, [&meter] { return TakeEnergy(meter); }), left);
+            energyEnd = co_await take;
+        }
+    }
+    if (energyEnd && energyEnd->first) {
+        hw.EnergyReadings = MeasureEnergy(meter, energyStart, energyEnd->second, collectorCpu);
+    }
+    // 回到调用方的调度器再交付结果：等待者的后续代码不应跑在空闲优先级线程上
+    if (options.LowImpact) co_await callerScheduler.Schedule();
+    co_return hw;
+}
 
-    // 7. 系统 UUID
-    getSystemUUID();
+// ========== 探测状态查询 ==========
+const ProbeReport* Hardware::FindProbeReport(const wxString& section) const
+{
+    for (const ProbeReport& report : ProbeReports) {
+        if (report.Section == section) return &report;
+    }
+    return nullptr;
+}
 
-    // 8. 生成机器指纹
-    if (!SystemUUID.IsEmpty() && !SystemUUID.StartsWith("Unknown")) {
-        MachineFingerprint = generateFingerprint();
+bool Hardware::IsPartial() const
+{
+    for (const ProbeReport& report : ProbeReports) {
+        if (report.Status != ProbeStatus::Ok && report.Status != ProbeStatus::Fallback) return true;
     }
+    return false;
+}
 
-    return 0;
+const char* Hardware::ProbeStatusName(ProbeStatus status)
+{
+    switch (status) {
+        case ProbeStatus::Ok:       return "ok";
+        case ProbeStatus::Fallback: return "fallback";
+        case ProbeStatus::Failed:   return "failed";
+        case ProbeStatus::TimedOut: return "timed-out";
+        case ProbeStatus::Skipped:  return "skipped";
+        case ProbeStatus::Hung:     return "hung";
+    }
+    return "unknown";
 }
 
 // ========== 主板信息（注册表） ==========
@@ -123,11 +661,16 @@ bool Hardware::getBaseBoardInfo()
 }
 
 // ========== CPU 信息 ==========
-void Hardware::getCPUInfo()
+bool Hardware::getCPUInfo()
 {
-    CPUManufacturer = wxString::FromUTF8(getCpuVendor());
-    CPUName = wxString::FromUTF8(getCpuName());
+    std::string vendor = getCpuVendor();
+    std::string name = getCpuName();
+    CPUManufacturer = Utf8ToWxString(vendor.data(), vendor.size());
+    CPUName = Utf8ToWxString(name.data(), name.size());
     CPUMaxClockSpeed = getCPUClockSpeed();
+    // 不支持品牌字符串或注册表中没有主频
+    m_fallback = name == "Unknown CPU" || CPUMaxClockSpeed == 0;
+    return true;
 }
 
 std::string Hardware::getCpuVendor()
@@ -173,6 +716,94 @@ long Hardware::getCPUClockSpeed()
     return 0;
 }
 
+// ========== 内存条（SMBIOS 类型 17）==========
+namespace
+{
+    struct MemoryModules
+    {
+        int count = 0;                  // 已插内存条数
+        BYTE type = 0;                  // SMBIOS 内存类型编码，各条不一致时为 0
+        unsigned ratedSpeed = 0;        // 各条额定频率的最小值 (MT/s)，0 表示未知
+        unsigned configuredSpeed = 0;   // 各条当前配置频率的最小值 (MT/s)，0 表示未知
+    };
+
+    const char* MemoryTypeName(BYTE type)
+    {
+        switch (type) {
+            case 0x12: return "DDR";
+            case 0x13: return "DDR2";
+            case 0x18: return "DDR3";
+            case 0x1A: return "DDR4";
+            case 0x1B: return "LPDDR";
+            case 0x1C: return "LPDDR2";
+            case 0x1D: return "LPDDR3";
+            case 0x1E: return "LPDDR4";
+            case 0x20: return "HBM";
+            case 0x21: return "HBM2";
+            case 0x22: return "DDR5";
+            case 0x23: return "LPDDR5";
+        }
+        return nullptr;
+    }
+
+    // 取 0xFFFF 时改用 SMBIOS 3.3 的 32 位扩展字段
+    unsigned SmbiosSpeed(const BYTE* entry, BYTE length, size_t offset, size_t extended)
+    {
+        if (length < offset + 2) return 0;
+        WORD speed;
+        memcpy(&speed, entry + offset, sizeof(speed));
+        if (speed != 0xFFFF) return speed;
+        if (length < extended + 4) return 0;
+        DWORD ext;
+        memcpy(&ext, entry + extended, sizeof(ext));
+        return ext;
+    }
+
+    // 固件表提供者 'RSMB'；写成整数以免多字符常量告警
+    const DWORD kRawSmbiosProvider = 0x52534D42;
+
+    bool ReadMemoryModules(MemoryModules* out)
+    {
+        UINT size = GetSystemFirmwareTable(kRawSmbiosProvider, 0, nullptr, 0);
+        if (size <= 8) return false;
+        std::vector<BYTE> table(size);
+        if (GetSystemFirmwareTable(kRawSmbiosProvider, 0, table.data(), size) != size) return false;
+
+        // RawSMBIOSData：8 字节头之后是结构表；每个结构为格式化区加以双 NUL 结尾的字符串区
+        DWORD length;
+        memcpy(&length, &table[4], sizeof(length));
+        const BYTE* p = table.data() + 8;
+        const BYTE* end = p + std::min<size_t>(length, size - 8);
+        bool typeSet = false;
+        while (p + 4 <= end && p + p[1] <= end && p[1] >= 4) {
+            BYTE type = p[0];
+            BYTE len = p[1];
+            if (type == 127) break;
+            if (type == 17 && len >= 0x15) {
+                WORD moduleSize;
+                memcpy(&moduleSize, p + 0x0C, sizeof(moduleSize));
+                if (moduleSize != 0 && moduleSize != 0xFFFF) {
+                    ++out->count;
+                    BYTE memoryType = p[0x12];
+                    if (!typeSet) out->type = memoryType;
+                    else if (out->type != memoryType) out->type = 0;
+                    typeSet = true;
+                    unsigned rated = SmbiosSpeed(p, len, 0x15, 0x54);
+                    unsigned configured = SmbiosSpeed(p, len, 0x20, 0x58);
+                    if (rated && (!out->ratedSpeed || rated < out->ratedSpeed)) out->ratedSpeed = rated;
+                    if (configured && (!out->configuredSpeed || configured < out->configuredSpeed)) {
+                        out->configuredSpeed = configured;
+                    }
+                }
+            }
+            const BYTE* next = p + len;
+            while (next + 1 < end && (next[0] != 0 || next[1] != 0)) ++next;
+            p = next + 2;
+        }
+        return out->count > 0;
+    }
+}
+
 // ========== 内存信息（修复 ULONGLONG 类型问题）==========
 bool Hardware::getMemoryInfo()
 {
@@ -181,19 +812,29 @@ bool Hardware::getMemoryInfo()
     ULONGLONG memKb = 0;  // ✅ 关键修复：64位类型
     if (GetPhysicallyInstalledSystemMemory(&memKb)) {
         unsigned long long bytes = memKb * 1024ULL;  // 转换为字节
-        TotalPhysicalMemory = wxString::Format("%llu", bytes);
+        TotalPhysicalMemory = DecimalToWxString(bytes);
     } else {
         // 方法2：GlobalMemoryStatusEx（备用）
+        m_fallback = true;
         MEMORYSTATUSEX memInfo;
         memInfo.dwLength = sizeof(MEMORYSTATUSEX);
         if (GlobalMemoryStatusEx(&memInfo)) {
-            TotalPhysicalMemory = wxString::Format("%llu", memInfo.ullTotalPhys);
+            TotalPhysicalMemory = DecimalToWxString(memInfo.ullTotalPhys);
         }
     }
 
-    // 内存类型/频率：纯 WinAPI 无法可靠获取（需 WMI），设为估计值
-    MemoryType = _("DDR4 (estimated)");
-    MemorySpeed = _("2400 (estimated)");
+    // 内存类型/频率：取 SMBIOS 内存条记录；固件不提供时设为估计值
+    MemoryModules modules;
+    if (ReadMemoryModules(&modules)) {
+        const char* typeName = MemoryTypeName(modules.type);
+        MemoryType = typeName ? wxString(typeName) : _("Unknown");
+        MemorySpeed = modules.configuredSpeed ? DecimalToWxString(modules.configuredSpeed) : _("Unknown");
+        if (modules.ratedSpeed) MemoryRatedSpeed = DecimalToWxString(modules.ratedSpeed);
+    } else {
+        MemoryType = _("DDR4 (estimated)");
+        MemorySpeed = _("2400 (estimated)");
+        m_fallback = true;
+    }
 
     return !TotalPhysicalMemory.IsEmpty() && TotalPhysicalMemory != "0";
 }
@@ -209,6 +850,7 @@ bool Hardware::getDiskInfo()
     };
     
     for (const wchar_t* path : paths) {
+        if (!paceRead()) break;
         HKEY hKey;
         if (RegOpenKeyEx(HKEY_LOCAL_MACHINE, path, 0, KEY_READ, &hKey) != ERROR_SUCCESS) continue;
         
@@ -221,7 +863,7 @@ bool Hardware::getDiskInfo()
         }
         
         std::vector<wchar_t> subKeyName(maxSubKeyLen + 1, 0);
-        for (DWORD i = 0; i < subKeyCount; ++i) {
+        for (DWORD i = 0; i < subKeyCount && paceRead(); ++i) {
             DWORD nameSize = maxSubKeyLen + 1;
             if (RegEnumKeyEx(hKey, i, subKeyName.data(), &nameSize, NULL, NULL, NULL, NULL) != ERROR_SUCCESS) continue;
             
@@ -233,7 +875,7 @@ bool Hardware::getDiskInfo()
             DWORD maxDevLen = 0;
             if (RegQueryInfoKey(hSubKey, NULL, NULL, NULL, &devCount, &maxDevLen, NULL, NULL, NULL, NULL, NULL, NULL) == ERROR_SUCCESS) {
                 std::vector<wchar_t> devName(maxDevLen + 1, 0);
-                for (DWORD j = 0; j < devCount; ++j) {
+                for (DWORD j = 0; j < devCount && paceRead(); ++j) {
                     DWORD devSize = maxDevLen + 1;
                     if (RegEnumKeyEx(hSubKey, j, devName.data(), &devSize, NULL, NULL, NULL, NULL) != ERROR_SUCCESS) continue;
                     
@@ -246,11 +888,12 @@ bool Hardware::getDiskInfo()
                     if (RegQueryValueEx(hDevKey, L"FriendlyName", NULL, NULL, (LPBYTE)model, &size) == ERROR_SUCCESS ||
                         RegQueryValueEx(hDevKey, L"DeviceDesc", NULL, NULL, (LPBYTE)model, &size) == ERROR_SUCCESS) {
                         wxString modelName = WCharToWxString(model, size);
+                        wxString lowerName = modelName.Lower();
                         // 过滤通用/USB设备
                         if (!modelName.IsEmpty() && 
-                            !modelName.Lower().Contains("generic") && 
-                            !modelName.Lower().Contains("usb") &&
-                            !modelName.Lower().Contains("sd")) {
+                            !lowerName.Contains("generic") && 
+                            !lowerName.Contains("usb") &&
+                            !lowerName.Contains("sd")) {
                             DiskModels.push_back(modelName);
                             DiskSerialNumbers.push_back(_("N/A"));
                         }
@@ -265,6 +908,7 @@ bool Hardware::getDiskInfo()
     
     // 保证至少有一个条目（避免UI崩溃）
     if (DiskModels.empty()) {
+        m_fallback = true;
         DiskModels.push_back(_("Unknown Disk"));
         DiskSerialNumbers.push_back(_("N/A"));
     }
@@ -275,7 +919,8 @@ bool Hardware::getDiskInfo()
 // ========== 网卡信息（GetAdaptersAddresses） ==========
 bool Hardware::getNetworkInfo()
 {
-    // 使用 GetAdaptersAddresses（Vista+）
+    // 使用 GetAdaptersAddresses（Vista+）；每次查询都是一次完整的适配器枚举，计一次读取
+    if (!paceRead()) return false;
     ULONG size = 15000;
     std::vector<BYTE> buffer(size);
     PIP_ADAPTER_ADDRESSES pAddresses = (PIP_ADAPTER_ADDRESSES)buffer.data();
@@ -288,7 +933,7 @@ bool Hardware::getNetworkInfo()
         &size
     );
     
-    if (result == ERROR_BUFFER_OVERFLOW) {
+    if (result == ERROR_BUFFER_OVERFLOW && paceRead()) {
         buffer.resize(size);
         pAddresses = (PIP_ADAPTER_ADDRESSES)buffer.data();
         result = GetAdaptersAddresses(
@@ -302,11 +947,12 @@ bool Hardware::getNetworkInfo()
     
     if (result != ERROR_SUCCESS) {
         // 备用：GetAdaptersInfo（XP兼容）
+        m_fallback = true;
         ULONG bufSize = sizeof(IP_ADAPTER_INFO);
         std::vector<BYTE> buf(bufSize);
         PIP_ADAPTER_INFO pAdapterInfo = (PIP_ADAPTER_INFO)buf.data();
         
-        if (GetAdaptersInfo(pAdapterInfo, &bufSize) == ERROR_BUFFER_OVERFLOW) {
+        if (GetAdaptersInfo(pAdapterInfo, &bufSize) == ERROR_BUFFER_OVERFLOW && paceRead()) {
             buf.resize(bufSize);
             pAdapterInfo = (PIP_ADAPTER_INFO)buf.data();
             if (GetAdaptersInfo(pAdapterInfo, &bufSize) != NO_ERROR) {
@@ -319,13 +965,7 @@ bool Hardware::getNetworkInfo()
             if (pAdapter->AddressLength == 6 && 
                 memcmp(pAdapter->Address, "\x00\x00\x00\x00\x00\x00", 6) != 0) {
                 
-                wxString mac;
-                for (DWORD i = 0; i < pAdapter->AddressLength; i++) {
-                    mac += wxString::Format("%02X%s", 
-                        (int)pAdapter->Address[i], 
-                        (i < pAdapter->AddressLength - 1) ? ":" : "");
-                }
-                MACAddresses.push_back(mac);
+                MACAddresses.push_back(FormatMacAddress(pAdapter->Address, pAdapter->AddressLength));
             }
             pAdapter = pAdapter->Next;
         }
@@ -349,17 +989,12 @@ bool Hardware::getNetworkInfo()
         if (allZero) continue;
         
         // 格式化 MAC 地址
-        wxString mac;
-        for (ULONG i = 0; i < pCurr->PhysicalAddressLength; ++i) {
-            mac += wxString::Format("%02X%s", 
-                (int)pCurr->PhysicalAddress[i], 
-                (i < pCurr->PhysicalAddressLength - 1) ? ":" : "");
-        }
-        MACAddresses.push_back(mac);
+        MACAddresses.push_back(FormatMacAddress(pCurr->PhysicalAddress, pCurr->PhysicalAddressLength));
     }
     
     // 保证至少有一个条目
     if (MACAddresses.empty()) {
+        m_fallback = true;
         MACAddresses.push_back(_("00:00:00:00:00:00"));
     }
     
@@ -417,12 +1052,146 @@ bool Hardware::getSystemUUID()
     
     // 保证有有效值
     if (SystemUUID.IsEmpty() || SystemUUID.StartsWith("Unknown")) {
+        m_fallback = true;
         SystemUUID = _("00000000-0000-0000-0000-000000000000");
     }
     
     return true;
 }
 
+// ========== PCI 设备（SetupAPI + pci.ids 索引）==========
+// 索引文件在进程内只映射一次；缺失时为空，设备只显示数字 ID 与内置的基本类别名
+static const pciids::Index* PciNameIndex()
+{
+    static const std::unique_ptr<pciids::Index> index = pciids::Index::Open(pciids::Index::DefaultPath());
+    return index.get();
+}
+
+bool Hardware::getPciInfo()
+{
+    std::vector<pci::DeviceInfo> devices;
+    if (!pci::Enumerate(&devices, m_stop, [this] { return paceRead(); })) return false;
+
+    const pciids::Index* ids = PciNameIndex();
+    if (!ids) m_fallback = true;
+
+    auto name = [ids](uint64_t key) {
+        const char* str;
+        size_t len;
+        return ids && ids->Lookup(key, &str, &len) ? Utf8ToWxString(str, len) : wxString();
+    };
+
+    for (const pci::DeviceInfo& info : devices) {
+        PciDevice dev;
+        dev.Address = Utf8ToWxString(info.address.data(), info.address.size());
+        dev.VendorId = info.vendorId;
+        dev.DeviceId = info.deviceId;
+        dev.SubsystemVendorId = info.subVendorId;
+        dev.SubsystemId = info.subDeviceId;
+        dev.ClassCode = (long)info.classCode;
+        dev.VendorName = name(pciids::VendorKey(info.vendorId));
+        dev.DeviceName = name(pciids::DeviceKey(info.vendorId, info.deviceId));
+        dev.SubsystemName = name(pciids::SubsystemKey(info.vendorId, info.deviceId, info.subVendorId, info.subDeviceId));
+
+        // 类别名取最具体的一级：子类别，其次基本类别，最后用内置表
+        uint8_t baseClass = (uint8_t)(info.classCode >> 16);
+        dev.ClassName = name(pciids::SubclassKey(baseClass, (uint8_t)(info.classCode >> 8)));
+        if (dev.ClassName.IsEmpty()) dev.ClassName = name(pciids::ClassKey(baseClass));
+        if (dev.ClassName.IsEmpty()) {
+            const char* builtin = pci::BaseClassName(baseClass);
+            dev.ClassName = Utf8ToWxString(builtin, strlen(builtin));
+        }
+
+        dev.LinkWidth = info.linkWidth;
+        dev.MaxLinkWidth = info.maxLinkWidth;
+        dev.LinkSpeed = Utf8ToWxString(info.linkSpeed.data(), info.linkSpeed.size());
+        dev.MaxLinkSpeed = Utf8ToWxString(info.maxLinkSpeed.data(), info.maxLinkSpeed.size());
+        dev.NumaNode = info.numaNode;
+        dev.Driver = Utf8ToWxString(info.driver.data(), info.driver.size());
+        PciDevices.push_back(std::move(dev));
+    }
+    return true;
+}
+
+// ========== NUMA 拓扑（GetNumaNode* + ACPI SRAT/SLIT）==========
+bool Hardware::getNumaInfo()
+{
+    std::vector<numa::NodeInfo> nodes;
+    if (!numa::Enumerate(&nodes, m_stop)) return false;
+
+    for (const numa::NodeInfo& info : nodes) {
+        NumaNode node;
+        node.Id = info.id;
+        std::string cpus = numa::FormatCpuList(info.cpus);
+        node.Cpus = Utf8ToWxString(cpus.data(), cpus.size());
+        node.CpuCount = (long)info.cpus.size();
+        node.MemoryTotalMB = (long)(info.memTotal >> 20);
+        node.MemoryFreeMB = (long)(info.memFree >> 20);
+        for (int distance : info.distances) {
+            if (!node.Distances.IsEmpty()) node.Distances += wxT(" ");
+            node.Distances += wxString::Format(wxT("%d"), distance);
+        }
+        for (const numa::HugePagePool& pool : info.hugePages) {
+            if (!node.HugePages.IsEmpty()) node.HugePages += wxT(" ");
+            node.HugePages += wxString::Format(wxT("%llukB:%llu/%llu"), (unsigned long long)pool.pageSizeKB,
+                                               (unsigned long long)pool.total, (unsigned long long)pool.free);
+        }
+        // 固件未给出各节点内存或距离表时只有部分信息
+        if (info.memTotal == 0 || info.distances.size() != nodes.size()) m_fallback = true;
+        NumaNodes.push_back(std::move(node));
+    }
+    return true;
+}
+
+// ========== 运行环境（CPUID + 作业对象）==========
+// CPU / 内存探测报告的是可见的全部资源；这里给出扣除限制后调度器应当使用的值
+bool Hardware::getEnvironmentInfo()
+{
+    environment::Info info;
+    if (!environment::Detect(&info)) return false;
+
+    bool vm = info.IsVirtualMachine();
+    bool container = info.IsContainer();
+    Virtualization = vm && container ? wxT("vm+container") : vm ? wxT("vm") : container ? wxT("container") : wxT("physical");
+    Hypervisor = info.hypervisor.empty() ? wxString(wxT("none")) : Utf8ToWxString(info.hypervisor.data(), info.hypervisor.size());
+    if (info.hypervisorRoot) Hypervisor += wxT(" (root)");
+    Container = container ? Utf8ToWxString(info.container.data(), info.container.size()) : wxString(wxT("none"));
+    ResourceLimits = Utf8ToWxString(info.limitSource.data(), info.limitSource.size());
+
+    LogicalProcessors = info.logicalProcessors;
+    std::string cpus = numa::FormatCpuList(info.allowedCpus);
+    AllowedCpus = Utf8ToWxString(cpus.data(), cpus.size());
+    CpuQuotaMilli = (long)std::lround(info.cpuQuota * 1000.0);
+    EffectiveCpuMilli = (long)std::lround(info.EffectiveCpus() * 1000.0);
+    if (info.memoryLimit > 0) MemoryLimit = DecimalToWxString(info.memoryLimit);
+    EffectiveMemory = DecimalToWxString(info.EffectiveMemory());
+    // 亲和性或可见内存取不到时，有效值只是估计
+    if (info.allowedCpus.empty() || info.physicalMemory == 0) m_fallback = true;
+    return true;
+}
+
+// ========== 插件探测（见 plugins.h）==========
+// 插件的输出是键值对，统一写入 PluginFields；取消或过期限时插件经 cancelled 回调得知
+bool Hardware::getPluginInfo(const plugins::Probe& probe, std::chrono::steady_clock::time_point deadline)
+{
+    wxString section = Utf8ToWxString(probe.section.data(), probe.section.size());
+    std::stop_token stop = m_stop;
+    int rc = plugins::Run(probe,
+        [&](const std::string& key, const std::string& value) {
+            PluginField field;
+            field.Section = section;
+            field.Key = Utf8ToWxString(key.data(), key.size());
+            field.Value = Utf8ToWxString(value.data(), value.size());
+            field.Volatile = probe.isVolatile ? 1 : 0;
+            field.Fingerprint = probe.forFingerprint ? 1 : 0;
+            PluginFields.push_back(std::move(field));
+        },
+        [&] { return stop.stop_requested() || std::chrono::steady_clock::now() >= deadline; });
+    if (rc == MT_PLUGIN_FAILED) return false;
+    if (rc == MT_PLUGIN_FALLBACK) m_fallback = true;
+    return true;
+}
+
 // ========== 机器指纹生成（修复 wxUniCharRef 二义性）==========
 wxString Hardware::generateFingerprint() const
 {
@@ -444,6 +1213,48 @@ wxString Hardware::generateFingerprint() const
     return wxString::Format("%08lX", hash);
 }
 
+// ========== 分组件指纹输入 ==========
+FingerprintInput Hardware::GetFingerprintInput() const
+{
+    FingerprintInput in;
+    in.boardManufacturer = ToUtf8(BaseBoardManufacturer);
+    in.boardProduct = ToUtf8(BaseBoardProduct);
+    in.cpuManufacturer = ToUtf8(CPUManufacturer);
+    in.cpuName = ToUtf8(CPUName);
+    
+    size_t diskCount = std::min(DiskModels.size(), DiskSerialNumbers.size());
+    for (size_t i = 0; i < diskCount; ++i) {
+        in.disks.push_back(ToUtf8(DiskModels[i]) + "|" + ToUtf8(DiskSerialNumbers[i]));
+    }
+    for (const wxString& mac : MACAddresses) {
+        in.macs.push_back(ToUtf8(mac));
+    }
+    in.systemUUID = ToUtf8(SystemUUID);
+    // 虚拟机与容器显式标记：同型号的虚拟机与物理机不会因此被当作同一台
+    if (Virtualization != wxT("physical") && !Virtualization.StartsWith("Unknown")) {
+        in.platform = ToUtf8(Virtualization) + "|" + ToUtf8(Hypervisor) + "|" + ToUtf8(Container);
+    }
+    // 易变字段在采集时已去掉指纹标志；空值不参与
+    for (const PluginField& field : PluginFields) {
+        if (!field.Fingerprint || field.Volatile || field.Value.Strip(wxString::both).IsEmpty()) continue;
+        in.plugins.push_back(ToUtf8(field.Section) + "." + ToUtf8(field.Key) + "=" + ToUtf8(field.Value));
+    }
+    return in;
+}
+
+// ========== 辅助方法：wxString → UTF-8 ==========
+std::string Hardware::ToUtf8(const wxString& str)
+{
+#if wxUSE_UNICODE_WCHAR
+    const char16_t* src = reinterpret_cast<const char16_t*>(str.wc_str());
+    std::string out(transcode::MaxUtf8Length(str.length()), '\0');
+    out.resize(transcode::Utf16ToUtf8(src, str.length(), &out[0]));
+    return out;
+#else
+    return std::string(str.utf8_str());
+#endif
+}
+
 // ========== 辅助方法：格式化内存大小 ==========
 wxString Hardware::FormatMemorySize(const wxString& bytesStr)
 {
@@ -5,50 +5,78 @@
 #include <windows.h>
 #include <vector>
 #include <string>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include "async.h"
+#include "fingerprint.h"
+#include "snapshot.h"
+#include "plugins.h"
+
+namespace lowimpact { class TokenBucket; }
 
 // MinGW 不支持 #pragma comment，需在链接时手动指定库：
 //   -ladvapi32 -liphlpapi -lole32 -loleaut32 -luuid
 
+// ========== 采集预算 ==========
+// 各探测并发执行，每个探测的期限取 min(ProbeTimeout, TotalBudget)，
+// 因此整体调用在 TotalBudget 内返回（另加合并与指纹计算的少量开销）。
+struct CollectOptions
+{
+    std::chrono::milliseconds TotalBudget{0};    // 整体预算，0 表示不限
+    std::chrono::milliseconds ProbeTimeout{0};   // 单个探测期限，0 表示只受整体预算约束
+    
+    // 低影响模式（见 lowimpact.h）：探测改在专用的空闲优先级线程上执行并绑定到 housekeeping 核心，
+    // 设备枚举每秒最多 ReadsPerSecond 次读取（0 表示不限速）。业务繁忙时采集会明显变慢，宜配合较宽的预算
+    bool LowImpact = false;
+    unsigned int ReadsPerSecond = 200;
+};
+
 // ========== 硬件采集类 ==========
-class Hardware
+class Hardware : public HardwareSnapshot
 {
 public:
-    // ===== 硬件信息字段 =====
-    // 主板
-    wxString BaseBoardManufacturer;  // 主板制造商
-    wxString BaseBoardProduct;       // 主板型号
+    // 硬件信息字段见基类 HardwareSnapshot（snapshot.h）
     
-    // CPU
-    wxString CPUManufacturer;        // CPU厂商 (GenuineIntel/AMD)
-    wxString CPUName;                // CPU型号字符串
-    long CPUMaxClockSpeed;           // CPU主频 (MHz)
+    // ===== 接口方法 =====
+    // 主采集入口，返回0表示成功，1表示已取消，2表示部分结果（有探测超时或失败）
+    // 设置了预算时探测在共享线程池上执行，卡住的探测不会拖住调用方
+    int GetInfo(std::stop_token stop = {}, const CollectOptions& options = {});
     
-    // 内存
-    wxString TotalPhysicalMemory;    // 总物理内存 (bytes)
-    wxString MemoryType;             // 内存类型 (e.g., "DDR4")
-    wxString MemorySpeed;            // 内存频率 (MHz)
+    // ===== 异步接口（C++20 协程）=====
+    // 每个探测是独立任务，在 scheduler 上并发执行；scheduler 须在任务完成前保持有效。
+    // 超过期限的探测对应字段保持默认值，状态记为 TimedOut。
+    static mt::Task<Hardware> CollectAsync(mt::Scheduler& scheduler, std::stop_token stop = {},
+                                           CollectOptions options = {});
+    // 只运行机器指纹所需的探测（跳过内存、BIOS）
+    static mt::Task<wxString> FingerprintAsync(mt::Scheduler& scheduler, std::stop_token stop = {},
+                                               CollectOptions options = {});
+    // 进程共享的采集线程池，首次调用时创建。从不析构：超时的探测可能永远卡在驱动调用里，
+    // 析构时 join 会让退出挂起。长期持有调度器的使用者（界面、守护进程、C 接口）都应使用它
+    static mt::ThreadPoolScheduler& SharedPool();
     
-    // 硬盘
-    std::vector<wxString> DiskModels;          // 硬盘型号列表
-    std::vector<wxString> DiskSerialNumbers;   // 硬盘序列号列表
+    // 探测状态查询
+    const ProbeReport* FindProbeReport(const wxString& section) const;
+    bool IsPartial() const;  // 有探测超时、失败或被跳过
+    static const char* ProbeStatusName(ProbeStatus status);  // "ok"、"timed-out" ...
     
-    // 网卡
-    std::vector<wxString> MACAddresses;        // MAC地址列表
+    // 辅助方法：格式化内存大小（bytes → GB）
+    static wxString FormatMemorySize(const wxString& bytesStr);
     
-    // BIOS
-    wxString BIOSManufacturer;       // BIOS制造商
-    wxString BIOSVersion;            // BIOS版本
-    wxString BIOSReleaseDate;        // BIOS发布日期
+    // 辅助方法：wxString ↔ UTF-8
+    static std::string ToUtf8(const wxString& str);
+    static wxString Utf8ToWxString(const char* str, size_t len);
     
-    // 系统
-    wxString SystemUUID;             // 系统UUID (机器唯一标识)
-    wxString MachineFingerprint;     // 生成的机器指纹（用于授权绑定）
+    // 分组件指纹的输入（UTF-8）
+    FingerprintInput GetFingerprintInput() const;
     
-    // ===== 接口方法 =====
-    int GetInfo();  // 主采集入口，返回0表示成功
+    // 插件目录（见 plugins.h）加载时的问题：版本不符、节名重复等，UTF-8
+    static const std::vector<std::string>& PluginErrors();
+    static bool IsPluginProbe(const wxString& section);   // section 为已加载的插件探测
     
-    // 辅助方法：格式化内存大小（bytes → GB）
-    static wxString FormatMemorySize(const wxString& bytesStr);
+    // 调优检查规则包（内置规则 + 可执行文件旁的 audit.rules，见 audit.h）的解析错误，UTF-8
+    static const std::vector<std::string>& AuditRuleErrors();
     
 private:
     // ===== CPUID (MinGW 兼容) =====
@@ -67,17 +95,58 @@ private:
     
     // ===== 硬件采集模块 =====
     bool getBaseBoardInfo();   // 主板（注册表）
-    void getCPUInfo();         // CPU（CPUID + 注册表）
+    bool getCPUInfo();         // CPU（CPUID + 注册表）
     bool getMemoryInfo();      // 内存（注册表 + 备用方案）
     bool getDiskInfo();        // 硬盘（注册表 + IOCTL 备用）
     bool getNetworkInfo();     // 网卡（GetAdaptersAddresses）
     bool getBIOSInfo();        // BIOS（注册表）
     bool getSystemUUID();      // 系统UUID（注册表）
+    bool getPciInfo();         // PCI 设备（SetupAPI，名称查 pci.ids 索引）
+    bool getNumaInfo();        // NUMA 拓扑（GetNumaNode* + ACPI SRAT/SLIT）
+    bool getEnvironmentInfo(); // 虚拟化、容器与资源限制（CPUID + 作业对象）
+    bool getPluginInfo(const plugins::Probe& probe, std::chrono::steady_clock::time_point deadline);  // 插件探测
     
     wxString generateFingerprint() const;  // 生成机器指纹
+    void resetDefaults();                  // 全部字段恢复为 "Unknown" 等默认值
+    
+    // ===== 探测表：采集模块 =====
+    struct Probe
+    {
+        const char* name;             // 同时是字段表中的 section，合并时据此移动字段
+        bool (Hardware::*collect)();
+        bool forFingerprint;          // 指纹计算依赖此探测
+        const plugins::Probe* plugin = nullptr;   // 插件探测：collect 为空，字段写入 PluginFields
+    };
+    static const Probe s_probes[];
+    static const size_t s_probeCount;
+    // 内置探测 + 已加载的插件探测，进程内首次使用时建立
+    static const std::vector<Probe>& probeTable();
+    
+    // 一次有期限的探测运行：看门狗据此判断超时后探测是否仍占着工作线程（见 hardware.cpp）
+    struct ProbeRun;
+    
+    // 探测结果是只含本探测字段与一条 ProbeReport 的临时对象
+    static mt::Task<Hardware> probeTask(mt::Scheduler& scheduler, const Probe* probe, std::stop_token stop,
+                                        std::chrono::steady_clock::time_point deadline,
+                                        std::shared_ptr<lowimpact::TokenBucket> reads,
+                                        std::shared_ptr<ProbeRun> run);
+    static mt::Task<Hardware> runProbe(mt::Scheduler& scheduler, const Probe* probe, std::stop_token stop,
+                                       std::chrono::milliseconds timeout, std::shared_ptr<lowimpact::TokenBucket> reads);
+    static mt::Task<Hardware> collectProbes(mt::Scheduler& scheduler, std::stop_token stop,
+                                            CollectOptions options, bool fingerprintOnly);
+    static Hardware probeResult(const Probe* probe, ProbeStatus status, long elapsedMs);
+    
+    std::stop_token m_stop;    // 当前采集的取消令牌，探测在步骤之间检查
+    bool m_fallback = false;   // 探测使用了备用方案或占位值
+    double m_cpuSeconds = 0;   // 探测在工作线程上消耗的 CPU 时间（秒），用于能耗归属
+    std::shared_ptr<lowimpact::TokenBucket> m_reads;   // 低影响模式下设备枚举的限速；超时后仍在运行的探测共享
+    
+    // 设备枚举每次读取之前调用：低影响模式下按令牌桶等待；已取消时返回 false
+    bool paceRead();
     
     // ===== 工具方法 =====
     static wxString WCharToWxString(const wchar_t* wstr, DWORD size = 0);
+    static wxString FormatMacAddress(const BYTE* addr, ULONG len);
 };
 
 #endif // HARDWARE_H
\ No newline at end of file
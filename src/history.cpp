@@ -0,0 +1,549 @@
+#include "history.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <share.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace history
+{
+
+// ========== 文件格式 ==========
+// 文件头 "MTH1"，之后逐帧：u32 负载长 + u8 类型 + i64 时间 + u32 CRC32(负载) + 负载，小端序。
+// 关键帧负载为 schema::ToBinary，增量帧负载为相对上一帧的 schema::ToBinaryDelta；第一帧必为关键帧
+namespace
+{
+    const char kFileMagic[4] = { 'M', 'T', 'H', '1' };
+    const size_t kHeaderSize = 4;
+    const size_t kFrameHeaderSize = 17;
+    const uint32_t kMaxPayload = 64u << 20;   // 防御损坏的长度字段
+
+    enum : uint8_t
+    {
+        FrameKey = 1,
+        FrameDelta = 2,
+    };
+
+    uint32_t Crc32(const std::string& data)
+    {
+        static const auto table = [] {
+            std::vector<uint32_t> t(256);
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[i] = c;
+            }
+            return t;
+        }();
+        uint32_t crc = 0xFFFFFFFFu;
+        for (char ch : data) crc = table[(crc ^ (uint8_t)ch) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    uint32_t Load32(const unsigned char* p)
+    {
+        return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+    }
+
+    void Store32(unsigned char* p, uint32_t v)
+    {
+        for (int i = 0; i < 4; ++i) p[i] = (unsigned char)(v >> (8 * i));
+    }
+
+    struct FrameHeader
+    {
+        uint32_t length = 0;
+        uint8_t kind = 0;
+        int64_t time = 0;
+        uint32_t crc = 0;
+    };
+
+    void EncodeHeader(const FrameHeader& header, unsigned char* out)
+    {
+        Store32(out, header.length);
+        out[4] = header.kind;
+        Store32(out + 5, (uint32_t)(uint64_t)header.time);
+        Store32(out + 9, (uint32_t)((uint64_t)header.time >> 32));
+        Store32(out + 13, header.crc);
+    }
+
+    FrameHeader DecodeHeader(const unsigned char* in)
+    {
+        FrameHeader header;
+        header.length = Load32(in);
+        header.kind = in[4];
+        header.time = (int64_t)((uint64_t)Load32(in + 5) | (uint64_t)Load32(in + 9) << 32);
+        header.crc = Load32(in + 13);
+        return header;
+    }
+
+    // ----- 平台相关的文件操作 -----
+#ifdef _WIN32
+    std::wstring Widen(const std::string& str)
+    {
+        int n = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0);
+        if (n <= 1) return std::wstring();
+        std::wstring out(n - 1, L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, &out[0], n);
+        return out;
+    }
+
+    bool Seek(FILE* file, uint64_t offset) { return _fseeki64(file, (__int64)offset, SEEK_SET) == 0; }
+
+    uint64_t SizeOf(FILE* file)
+    {
+        if (_fseeki64(file, 0, SEEK_END) != 0) return 0;
+        __int64 size = _ftelli64(file);
+        return size < 0 ? 0 : (uint64_t)size;
+    }
+
+    bool Truncate(FILE* file, uint64_t size)
+    {
+        return fflush(file) == 0 && _chsize_s(_fileno(file), (__int64)size) == 0;
+    }
+
+    bool Sync(FILE* file) { return fflush(file) == 0 && _commit(_fileno(file)) == 0; }
+
+    // 读写打开并禁止其它进程写：第二个实例打开同一文件时失败
+    FILE* OpenExclusive(const std::string& path, bool* busy)
+    {
+        FILE* file = _wfsopen(Widen(path).c_str(), L"a+b", _SH_DENYWR);
+        *busy = !file && errno == EACCES;
+        return file;
+    }
+
+    FILE* OpenRead(const std::string& path) { return _wfsopen(Widen(path).c_str(), L"rb", _SH_DENYNO); }
+    FILE* OpenWrite(const std::string& path) { return _wfsopen(Widen(path).c_str(), L"wb", _SH_DENYWR); }
+    void Remove(const std::string& path) { _wremove(Widen(path).c_str()); }
+
+    bool Replace(const std::string& from, const std::string& to)
+    {
+        return MoveFileExW(Widen(from).c_str(), Widen(to).c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+    }
+#else
+    bool Seek(FILE* file, uint64_t offset) { return fseeko(file, (off_t)offset, SEEK_SET) == 0; }
+
+    uint64_t SizeOf(FILE* file)
+    {
+        if (fseeko(file, 0, SEEK_END) != 0) return 0;
+        off_t size = ftello(file);
+        return size < 0 ? 0 : (uint64_t)size;
+    }
+
+    bool Truncate(FILE* file, uint64_t size)
+    {
+        return fflush(file) == 0 && ftruncate(fileno(file), (off_t)size) == 0;
+    }
+
+    bool Sync(FILE* file) { return fflush(file) == 0 && fsync(fileno(file)) == 0; }
+
+    FILE* OpenExclusive(const std::string& path, bool* busy)
+    {
+        *busy = false;
+        FILE* file = fopen(path.c_str(), "a+be");
+        if (file && flock(fileno(file), LOCK_EX | LOCK_NB) != 0) {
+            *busy = errno == EWOULDBLOCK;
+            fclose(file);
+            return nullptr;
+        }
+        return file;
+    }
+
+    FILE* OpenRead(const std::string& path) { return fopen(path.c_str(), "rbe"); }
+    FILE* OpenWrite(const std::string& path) { return fopen(path.c_str(), "wbe"); }
+    void Remove(const std::string& path) { remove(path.c_str()); }
+
+    // rename 只改目录项：须再 fsync 所在目录，否则掉电后可能仍是旧文件（或新旧都不在）
+    bool Replace(const std::string& from, const std::string& to)
+    {
+        if (rename(from.c_str(), to.c_str()) != 0) return false;
+        size_t slash = to.rfind('/');
+        std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : to.substr(0, slash);
+        int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) return false;
+        bool synced = fsync(fd) == 0;
+        close(fd);
+        return synced;
+    }
+#endif
+
+    bool ReadAt(FILE* file, uint64_t offset, void* buffer, size_t size)
+    {
+        return Seek(file, offset) && fread(buffer, 1, size, file) == size;
+    }
+
+    // 读取一帧并校验负载的 CRC
+    bool ReadFrame(FILE* file, uint64_t offset, FrameHeader* header, std::string* payload)
+    {
+        unsigned char raw[kFrameHeaderSize];
+        if (!ReadAt(file, offset, raw, sizeof(raw))) return false;
+        *header = DecodeHeader(raw);
+        if (header->length > kMaxPayload) return false;
+        payload->resize(header->length);
+        if (header->length > 0 && fread(&(*payload)[0], 1, header->length, file) != header->length) return false;
+        return Crc32(*payload) == header->crc;
+    }
+
+    bool WriteFrame(FILE* file, uint8_t kind, int64_t time, const std::string& payload)
+    {
+        FrameHeader header;
+        header.length = (uint32_t)payload.size();
+        header.kind = kind;
+        header.time = time;
+        header.crc = Crc32(payload);
+        unsigned char raw[kFrameHeaderSize];
+        EncodeHeader(header, raw);
+        return fwrite(raw, 1, sizeof(raw), file) == sizeof(raw) &&
+               fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+    }
+
+    // 关键帧按需，或增量已接近完整快照的一半（变化面很大）时也改写关键帧
+    uint8_t Encode(const HardwareSnapshot* base, const HardwareSnapshot& snap, std::string* payload)
+    {
+        std::string full = schema::ToBinary(snap);
+        if (base) {
+            std::string delta = schema::ToBinaryDelta(*base, snap);
+            if (delta.size() * 2 <= full.size()) {
+                *payload = std::move(delta);
+                return FrameDelta;
+            }
+        }
+        *payload = std::move(full);
+        return FrameKey;
+    }
+
+    bool Decode(uint8_t kind, const std::string& payload, HardwareSnapshot* state)
+    {
+        return kind == FrameKey ? schema::FromBinary(payload, state) : schema::ApplyBinaryDelta(payload, state);
+    }
+}
+
+// ========== 打开与索引 ==========
+Store::Store(const Options& options)
+    : m_options(options)
+{
+}
+
+Store::~Store()
+{
+    Close();
+}
+
+bool Store::Open(const std::string& path, std::string* error)
+{
+    Close();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    bool busy = false;
+    m_file = OpenExclusive(path, &busy);
+    if (!m_file) {
+        if (error) *error = busy ? "历史文件已被其它进程打开" : std::string("无法打开历史文件：") + strerror(errno);
+        return false;
+    }
+    m_path = path;
+    if (!scanLocked(error)) {
+        closeLocked();
+        return false;
+    }
+    return true;
+}
+
+void Store::Close()
+{
+    if (m_compactor.joinable()) m_compactor.join();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    closeLocked();
+}
+
+void Store::closeLocked()
+{
+    if (m_file) fclose(m_file);
+    m_file = nullptr;
+    m_frames.clear();
+    m_keyframes.clear();
+    m_end = 0;
+    m_last = HardwareSnapshot();
+    m_lastValid = false;
+    m_archived = 0;
+    m_sinceCompact = 0;
+}
+
+bool Store::IsOpen() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_file != nullptr;
+}
+
+// 只读帧头逐帧跳过建立索引；写了一半的尾帧（长度越界、时间倒退、校验和不符）截掉
+bool Store::scanLocked(std::string* error)
+{
+    m_frames.clear();
+    m_keyframes.clear();
+    m_lastValid = false;
+    uint64_t size = SizeOf(m_file);
+    if (size < kHeaderSize) {
+        if (!Truncate(m_file, 0) || fwrite(kFileMagic, 1, kHeaderSize, m_file) != kHeaderSize || fflush(m_file) != 0) {
+            if (error) *error = "无法写入历史文件";
+            return false;
+        }
+        m_end = kHeaderSize;
+        return true;
+    }
+    char magic[kHeaderSize];
+    if (!ReadAt(m_file, 0, magic, kHeaderSize) || memcmp(magic, kFileMagic, kHeaderSize) != 0) {
+        if (error) *error = "不是历史文件";
+        return false;
+    }
+
+    uint64_t pos = kHeaderSize;
+    while (pos + kFrameHeaderSize <= size) {
+        unsigned char raw[kFrameHeaderSize];
+        if (!ReadAt(m_file, pos, raw, sizeof(raw))) break;
+        FrameHeader header = DecodeHeader(raw);
+        if (header.length > kMaxPayload || pos + kFrameHeaderSize + header.length > size) break;
+        if (header.kind != FrameKey && (header.kind != FrameDelta || m_frames.empty())) break;
+        if (!m_frames.empty() && header.time < m_frames.back().time) break;
+        if (header.kind == FrameKey) m_keyframes.push_back((uint32_t)m_frames.size());
+        m_frames.push_back(Frame{ header.time, pos });
+        pos += kFrameHeaderSize + header.length;
+    }
+    // 中间的帧在读取时校验，这里只确认最后一帧完整写入
+    while (!m_frames.empty()) {
+        FrameHeader header;
+        std::string payload;
+        if (ReadFrame(m_file, m_frames.back().offset, &header, &payload)) break;
+        pos = m_frames.back().offset;
+        m_frames.pop_back();
+        if (!m_keyframes.empty() && m_keyframes.back() == m_frames.size()) m_keyframes.pop_back();
+    }
+    if (pos < size && !Truncate(m_file, pos)) {
+        if (error) *error = "无法截断历史文件";
+        return false;
+    }
+    m_end = pos;
+    return true;
+}
+
+// ========== 追加 ==========
+bool Store::Append(int64_t time, const HardwareSnapshot& snap, std::string* error)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file) {
+        if (error) *error = "历史文件未打开";
+        return false;
+    }
+    if (!m_frames.empty()) time = std::max(time, m_frames.back().time);
+    if (!m_lastValid && !m_frames.empty()) m_lastValid = loadLocked(m_frames.size() - 1, &m_last);
+
+    // 基准无法还原（文件损坏）时写关键帧，之后的帧不受影响
+    bool keyDue = !m_lastValid || m_keyframes.empty() ||
+                  m_frames.size() - m_keyframes.back() >= m_options.keyframeInterval;
+    std::string payload;
+    uint8_t kind = Encode(keyDue ? nullptr : &m_last, snap, &payload);
+
+    // 追加模式下写入总在文件末尾；读写切换之间需要一次定位
+    if (!Seek(m_file, m_end) || !WriteFrame(m_file, kind, time, payload) || fflush(m_file) != 0) {
+        Truncate(m_file, m_end);
+        if (error) *error = std::string("写入历史文件失败：") + strerror(errno);
+        return false;
+    }
+    if (kind == FrameKey) m_keyframes.push_back((uint32_t)m_frames.size());
+    m_frames.push_back(Frame{ time, m_end });
+    m_end += kFrameHeaderSize + payload.size();
+    m_last = snap;
+    m_lastValid = true;
+
+    if (m_options.compactEvery && ++m_sinceCompact >= m_options.compactEvery && !m_compacting) {
+        m_sinceCompact = 0;
+        if (m_compactor.joinable()) m_compactor.join();   // 上一轮已结束
+        m_compactor = std::thread([this, time] { Compact(time); });
+    }
+    return true;
+}
+
+// ========== 读取 ==========
+size_t Store::Count() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_frames.size();
+}
+
+int64_t Store::TimeAt(size_t index) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return index < m_frames.size() ? m_frames[index].time : 0;
+}
+
+uint64_t Store::FileSize() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_end;
+}
+
+bool Store::Load(size_t index, HardwareSnapshot* out) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return out && loadLocked(index, out);
+}
+
+bool Store::LoadAt(int64_t time, HardwareSnapshot* out, size_t* index) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::upper_bound(m_frames.begin(), m_frames.end(), time,
+                               [](int64_t t, const Frame& frame) { return t < frame.time; });
+    if (it == m_frames.begin() || !out) return false;
+    size_t found = (size_t)(it - m_frames.begin()) - 1;
+    if (!loadLocked(found, out)) return false;
+    if (index) *index = found;
+    return true;
+}
+
+// 从 index 之前最近的关键帧起依次应用增量
+bool Store::loadLocked(size_t index, HardwareSnapshot* out) const
+{
+    if (!m_file || index >= m_frames.size()) return false;
+    auto key = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), (uint32_t)index);
+    if (key == m_keyframes.begin()) return false;
+    HardwareSnapshot state;
+    std::string payload;
+    for (size_t i = *(key - 1); i <= index; ++i) {
+        FrameHeader header;
+        if (!ReadFrame(m_file, m_frames[i].offset, &header, &payload) || !Decode(header.kind, payload, &state)) return false;
+    }
+    *out = std::move(state);
+    return true;
+}
+
+// ========== 压缩 ==========
+// 第一阶段不持锁：用单独的读句柄重放旧帧，写入临时文件；
+// 第二阶段持锁：原样复制较新的帧（包括第一阶段期间追加的），替换原文件并重建索引。
+// 去掉的帧与前一帧内容相同，较新帧的增量基准因此不变，可以原样复制
+bool Store::Compact(int64_t now, std::string* error)
+{
+    if (m_compacting.exchange(true)) {
+        if (error) *error = "压缩正在进行";
+        return false;
+    }
+    struct Reset
+    {
+        std::atomic<bool>& flag;
+        ~Reset() { flag = false; }
+    } reset{ m_compacting };
+
+    std::string path;
+    std::vector<Frame> frames;
+    std::vector<uint32_t> keyframes;
+    uint64_t end;
+    size_t archived;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_file) {
+            if (error) *error = "历史文件未打开";
+            return false;
+        }
+        path = m_path;
+        frames = m_frames;
+        keyframes = m_keyframes;
+        end = m_end;
+        archived = m_archived;
+    }
+    int64_t boundary = now - (int64_t)std::chrono::duration_cast<std::chrono::seconds>(m_options.archiveAge).count();
+    size_t split = (size_t)(std::lower_bound(frames.begin(), frames.end(), boundary,
+                                             [](const Frame& frame, int64_t t) { return frame.time < t; }) - frames.begin());
+    if (split <= archived) return true;   // 没有新变旧的帧
+
+    auto fail = [&](FILE* reader, FILE* out, const char* message) {
+        if (reader) fclose(reader);
+        if (out) fclose(out);
+        Remove(path + ".tmp");
+        if (error) *error = message;
+        return false;
+    };
+    FILE* reader = OpenRead(path);
+    FILE* out = reader ? OpenWrite(path + ".tmp") : nullptr;
+    if (!out) return fail(reader, out, "无法创建临时文件");
+
+    // 上次已压缩的部分原样复制，只重放其最后一个关键帧之后的帧以取得基准
+    uint64_t prefix = archived > 0 ? frames[archived].offset : kHeaderSize;
+    std::vector<char> buffer(1 << 16);
+    for (uint64_t pos = 0; pos < prefix;) {
+        size_t chunk = (size_t)std::min<uint64_t>(buffer.size(), prefix - pos);
+        if (!ReadAt(reader, pos, buffer.data(), chunk) || fwrite(buffer.data(), 1, chunk, out) != chunk) {
+            return fail(reader, out, "写入临时文件失败");
+        }
+        pos += chunk;
+    }
+    HardwareSnapshot state, previous;
+    std::string payload;
+    size_t written = archived, sinceKey = 0;
+    if (archived > 0) {
+        size_t key = *(std::upper_bound(keyframes.begin(), keyframes.end(), (uint32_t)(archived - 1)) - 1);
+        for (size_t i = key; i < archived; ++i) {
+            FrameHeader header;
+            if (!ReadFrame(reader, frames[i].offset, &header, &payload) || !Decode(header.kind, payload, &state)) {
+                return fail(reader, out, "历史文件已损坏");
+            }
+        }
+        previous = state;
+        sinceKey = archived - 1 - key;
+    }
+    for (size_t i = archived; i < split; ++i) {
+        FrameHeader header;
+        if (!ReadFrame(reader, frames[i].offset, &header, &payload) || !Decode(header.kind, payload, &state)) {
+            return fail(reader, out, "历史文件已损坏");
+        }
+        // 压缩区最后一帧总是保留：其后原样保留的增量以它为基准，而 Diff 不比较易变插件字段的取值
+        if (written > 0 && i + 1 < split && schema::Diff(previous, state).empty()) continue;
+        bool keyDue = written == 0 || sinceKey + 1 >= m_options.archiveKeyframeInterval;
+        uint8_t kind = Encode(keyDue ? nullptr : &previous, state, &payload);
+        if (!WriteFrame(out, kind, frames[i].time, payload)) return fail(reader, out, "写入临时文件失败");
+        sinceKey = kind == FrameKey ? 0 : sinceKey + 1;
+        previous = state;
+        ++written;
+    }
+    fclose(reader);
+    reader = nullptr;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file || m_path != path) return fail(reader, out, "历史文件已关闭");
+    uint64_t from = split < frames.size() ? frames[split].offset : end;
+    for (uint64_t pos = from; pos < m_end;) {
+        size_t chunk = (size_t)std::min<uint64_t>(buffer.size(), m_end - pos);
+        if (!ReadAt(m_file, pos, buffer.data(), chunk) || fwrite(buffer.data(), 1, chunk, out) != chunk) {
+            return fail(reader, out, "写入临时文件失败");
+        }
+        pos += chunk;
+    }
+    if (!Sync(out)) return fail(reader, out, "写入临时文件失败");
+    fclose(out);
+
+    // Windows 上替换前须关闭原文件；替换失败时重新打开原文件
+    fclose(m_file);
+    m_file = nullptr;
+    bool replaced = Replace(path + ".tmp", path);
+    if (!replaced) Remove(path + ".tmp");
+    bool busy = false;
+    m_file = OpenExclusive(path, &busy);
+    HardwareSnapshot last = std::move(m_last);
+    bool lastValid = m_lastValid;
+    if (!m_file || !scanLocked(error)) {
+        closeLocked();
+        if (error && error->empty()) *error = "无法重新打开历史文件";
+        return false;
+    }
+    // 最后一帧的状态不变，继续作为下一帧增量的基准
+    m_last = std::move(last);
+    m_lastValid = lastValid;
+    m_archived = replaced ? written : 0;
+    if (!replaced && error) *error = "无法替换历史文件";
+    return replaced;
+}
+
+} // namespace history
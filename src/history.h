@@ -0,0 +1,90 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "snapshot.h"
+
+// ========== 快照历史 ==========
+// 只追加的日志文件：每次采集追加一帧，内容为与上一帧相比的增量（见 schema::ToBinaryDelta），
+// 每隔 keyframeInterval 帧写一个完整关键帧。帧头带时间与校验和，打开时截掉写了一半的尾帧。
+// 内存中保存每帧的时间与偏移，关键帧另有稀疏索引：任意时刻的状态 = 两次二分查找 +
+// 从所在关键帧起至多重放 keyframeInterval 个增量。
+// 早于 archiveAge 的旧帧在后台压缩：去掉内容未变的帧，关键帧放宽到每 archiveKeyframeInterval 帧一个，
+// 写入临时文件后整体替换。同一文件同时只允许一个进程打开。
+namespace history
+{
+
+struct Options
+{
+    unsigned keyframeInterval = 64;
+    unsigned archiveKeyframeInterval = 1024;
+    std::chrono::hours archiveAge{ 24 * 7 };
+    unsigned compactEvery = 256;     // 每追加这么多帧在后台压缩一次；0 表示只手动压缩
+};
+
+class Store
+{
+public:
+    explicit Store(const Options& options = Options());
+    ~Store();                        // 等待后台压缩结束
+
+    Store(const Store&) = delete;
+    Store& operator=(const Store&) = delete;
+
+    // UTF-8 路径，不存在则创建；文件已被其它进程打开时失败
+    bool Open(const std::string& path, std::string* error);
+    void Close();
+    bool IsOpen() const;
+
+    // time 为 Unix 秒；早于最后一帧时按最后一帧的时间记录，保证时间单调
+    bool Append(int64_t time, const HardwareSnapshot& snap, std::string* error = nullptr);
+
+    size_t Count() const;
+    int64_t TimeAt(size_t index) const;
+    uint64_t FileSize() const;
+
+    // 第 index 帧时的快照
+    bool Load(size_t index, HardwareSnapshot* out) const;
+    // time 时刻的快照，即不晚于 time 的最后一帧；time 早于第一帧时返回 false
+    bool LoadAt(int64_t time, HardwareSnapshot* out, size_t* index = nullptr) const;
+
+    // 同步压缩早于 now - archiveAge 的帧；后台压缩也调用它。压缩期间仍可追加与读取
+    bool Compact(int64_t now, std::string* error = nullptr);
+
+private:
+    struct Frame
+    {
+        int64_t time;
+        uint64_t offset;             // 帧头在文件中的位置
+    };
+
+    bool scanLocked(std::string* error);
+    bool loadLocked(size_t index, HardwareSnapshot* out) const;
+    void closeLocked();
+
+    Options m_options;
+    std::string m_path;
+    mutable std::mutex m_mutex;      // 保护以下成员与 m_file 的读写位置
+    FILE* m_file = nullptr;
+    std::vector<Frame> m_frames;
+    std::vector<uint32_t> m_keyframes;   // 关键帧在 m_frames 中的下标，升序（稀疏索引）
+    uint64_t m_end = 0;                  // 最后一个完整帧的末尾
+    HardwareSnapshot m_last;             // 最后一帧的状态，下一帧增量的基准
+    bool m_lastValid = false;
+    size_t m_archived = 0;               // 文件开头已压缩过的帧数
+    unsigned m_sinceCompact = 0;
+
+    std::atomic<bool> m_compacting{ false };
+    std::thread m_compactor;
+};
+
+} // namespace history
+
+#endif // HISTORY_H
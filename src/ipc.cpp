@@ -0,0 +1,803 @@
+#include "ipc.h"
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <sddl.h>    // ConvertStringSecurityDescriptorToSecurityDescriptorW
+#else
+    #include <cerrno>
+    #include <cstdlib>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sys/mman.h>
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+namespace ipc
+{
+
+// ========== 协议 ==========
+namespace
+{
+    void PutU32(char* p, uint32_t v)
+    {
+        for (int i = 0; i < 4; ++i) p[i] = (char)(v >> (8 * i));
+    }
+
+    uint32_t GetU32(const char* p)
+    {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v |= (uint32_t)(uint8_t)p[i] << (8 * i);
+        return v;
+    }
+
+    const size_t ReadChunk = 64 * 1024;
+}
+
+ParseResult ParseFrame(const char* data, size_t size, FrameView* out, size_t* consumed)
+{
+    if (size < 4) return ParseResult::Incomplete;
+    uint32_t len = GetU32(data);
+    if (len < FrameHeaderSize - 4 || len > MaxFrameSize) return ParseResult::Malformed;
+    if (size < 4 + (size_t)len) return ParseResult::Incomplete;
+
+    out->op = (uint8_t)data[4];
+    out->status = (uint8_t)data[5];
+    out->id = GetU32(data + 6);
+    out->payload = data + FrameHeaderSize;
+    out->size = len - (FrameHeaderSize - 4);
+    *consumed = 4 + (size_t)len;
+    return ParseResult::Complete;
+}
+
+void AppendFrame(std::string& out, uint8_t op, uint8_t status, uint32_t id, const char* payload, size_t size)
+{
+    char header[FrameHeaderSize];
+    PutU32(header, (uint32_t)(FrameHeaderSize - 4 + size));
+    header[4] = (char)op;
+    header[5] = (char)status;
+    PutU32(header + 6, id);
+    out.append(header, FrameHeaderSize);
+    if (size) out.append(payload, size);
+}
+
+void AppendU64(std::string& out, uint64_t v)
+{
+    char buf[8];
+    for (int i = 0; i < 8; ++i) buf[i] = (char)(v >> (8 * i));
+    out.append(buf, 8);
+}
+
+uint64_t ReadU64(const char* p)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v |= (uint64_t)(uint8_t)p[i] << (8 * i);
+    return v;
+}
+
+#ifdef _WIN32
+
+// ========== Windows：命名管道（重叠 I/O）==========
+// 读写都用重叠 I/O：同步句柄上挂起的 ReadFile 会阻塞同一句柄上的 WriteFile，
+// 推送事件需要在等待请求的同时写出。
+std::string DefaultEndpoint()
+{
+    return "\\\\.\\pipe\\minitool";
+}
+
+std::string DefaultSharedName()
+{
+    return "Local\\minitool_snapshot";
+}
+
+namespace
+{
+    // 只允许当前用户与 SYSTEM 访问的安全描述符。默认 DACL 取决于令牌：
+    // 以管理员身份运行时属主是 Administrators 组，其它管理员账户也能连接或映射
+    class OwnerOnlySecurity
+    {
+    public:
+        OwnerOnlySecurity()
+        {
+            HANDLE token;
+            if (!OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &token)) return;
+            DWORD size = 0;
+            GetTokenInformation(token, TokenUser, NULL, 0, &size);
+            std::vector<char> user(size);
+            LPWSTR sid = NULL;
+            if (size && GetTokenInformation(token, TokenUser, user.data(), size, &size) &&
+                ConvertSidToStringSidW(reinterpret_cast<TOKEN_USER*>(user.data())->User.Sid, &sid)) {
+                std::wstring sddl = L"D:P(A;;GA;;;" + std::wstring(sid) + L")(A;;GA;;;SY)";
+                LocalFree(sid);
+                ConvertStringSecurityDescriptorToSecurityDescriptorW(sddl.c_str(), SDDL_REVISION_1, &m_descriptor, NULL);
+            }
+            CloseHandle(token);
+            m_attributes.nLength = sizeof(m_attributes);
+            m_attributes.lpSecurityDescriptor = m_descriptor;
+            m_attributes.bInheritHandle = FALSE;
+        }
+        ~OwnerOnlySecurity()
+        {
+            if (m_descriptor) LocalFree(m_descriptor);
+        }
+        OwnerOnlySecurity(const OwnerOnlySecurity&) = delete;
+        OwnerOnlySecurity& operator=(const OwnerOnlySecurity&) = delete;
+
+        // 建立失败时为 NULL：调用方应拒绝创建对象，而不是退回默认 DACL
+        SECURITY_ATTRIBUTES* Attributes() { return m_descriptor ? &m_attributes : NULL; }
+
+    private:
+        PSECURITY_DESCRIPTOR m_descriptor = NULL;
+        SECURITY_ATTRIBUTES m_attributes = {};
+    };
+}
+
+struct Connection::Impl
+{
+    HANDLE pipe = INVALID_HANDLE_VALUE;
+    HANDLE readEvent = NULL;    // 手动复位
+    HANDLE writeEvent = NULL;   // 手动复位
+    HANDLE wakeEvent = NULL;    // 自动复位
+    OVERLAPPED readOv;
+    OVERLAPPED writeOv;
+    bool readPending = false;
+    bool server = false;
+    std::vector<char> buffer;   // 挂起的读操作写入此处，须在完成前保持有效
+
+    Impl() : buffer(ReadChunk)
+    {
+        readEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+        writeEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+        wakeEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+    }
+
+    ~Impl()
+    {
+        if (pipe != INVALID_HANDLE_VALUE) {
+            if (readPending) {
+                DWORD n;
+                CancelIoEx(pipe, &readOv);
+                GetOverlappedResult(pipe, &readOv, &n, TRUE);
+            }
+            if (server) DisconnectNamedPipe(pipe);
+            CloseHandle(pipe);
+        }
+        if (readEvent) CloseHandle(readEvent);
+        if (writeEvent) CloseHandle(writeEvent);
+        if (wakeEvent) CloseHandle(wakeEvent);
+    }
+
+    bool Valid() const { return readEvent && writeEvent && wakeEvent; }
+};
+
+Connection::Connection(std::unique_ptr<Impl> impl) : m_impl(std::move(impl)) {}
+Connection::~Connection() = default;
+
+std::unique_ptr<Connection> Connection::Connect(const std::string& endpoint)
+{
+    auto impl = std::make_unique<Impl>();
+    if (!impl->Valid()) return nullptr;
+
+    for (int attempt = 0; attempt < 5; ++attempt) {
+        impl->pipe = CreateFileA(endpoint.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL,
+                                 OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+        if (impl->pipe != INVALID_HANDLE_VALUE) break;
+        // 所有实例都在忙：守护进程正在为下一个连接创建实例，稍候重试
+        if (GetLastError() != ERROR_PIPE_BUSY || !WaitNamedPipeA(endpoint.c_str(), 2000)) return nullptr;
+    }
+    if (impl->pipe == INVALID_HANDLE_VALUE) return nullptr;
+    return std::unique_ptr<Connection>(new Connection(std::move(impl)));
+}
+
+long Connection::Read(char* buf, size_t size)
+{
+    Impl& d = *m_impl;
+    if (!d.readPending) {
+        ZeroMemory(&d.readOv, sizeof(d.readOv));
+        d.readOv.hEvent = d.readEvent;
+        ResetEvent(d.readEvent);
+        DWORD want = (DWORD)(size < d.buffer.size() ? size : d.buffer.size());
+        if (!ReadFile(d.pipe, d.buffer.data(), want, NULL, &d.readOv)) {
+            DWORD err = GetLastError();
+            if (err == ERROR_BROKEN_PIPE) return 0;
+            if (err != ERROR_IO_PENDING) return -1;
+        }
+        d.readPending = true;
+    }
+
+    HANDLE handles[2] = { d.readEvent, d.wakeEvent };
+    DWORD w = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+    if (w == WAIT_OBJECT_0 + 1) return -2;   // 读操作保持挂起，下次调用继续等待
+    if (w != WAIT_OBJECT_0) return -1;
+
+    d.readPending = false;
+    DWORD n = 0;
+    if (!GetOverlappedResult(d.pipe, &d.readOv, &n, FALSE)) {
+        return GetLastError() == ERROR_BROKEN_PIPE ? 0 : -1;
+    }
+    memcpy(buf, d.buffer.data(), n);
+    return (long)n;
+}
+
+bool Connection::Write(const char* data, size_t size)
+{
+    Impl& d = *m_impl;
+    while (size > 0) {
+        DWORD chunk = (DWORD)(size < (1u << 30) ? size : (1u << 30));
+        ZeroMemory(&d.writeOv, sizeof(d.writeOv));
+        d.writeOv.hEvent = d.writeEvent;
+        ResetEvent(d.writeEvent);
+        if (!WriteFile(d.pipe, data, chunk, NULL, &d.writeOv) && GetLastError() != ERROR_IO_PENDING) {
+            return false;
+        }
+        DWORD n = 0;
+        if (!GetOverlappedResult(d.pipe, &d.writeOv, &n, TRUE) || n == 0) return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+void Connection::Wake()
+{
+    SetEvent(m_impl->wakeEvent);
+}
+
+struct Listener::Impl
+{
+    std::string endpoint;
+    HANDLE stopEvent = NULL;
+    HANDLE connectEvent = NULL;
+    HANDLE next = INVALID_HANDLE_VALUE;   // 下一个等待连接的管道实例
+    OwnerOnlySecurity security;           // 每个管道实例都用它创建
+
+    ~Impl()
+    {
+        if (next != INVALID_HANDLE_VALUE) CloseHandle(next);
+        if (stopEvent) CloseHandle(stopEvent);
+        if (connectEvent) CloseHandle(connectEvent);
+    }
+
+    HANDLE CreateInstance(bool first)
+    {
+        DWORD openMode = PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | (first ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0);
+        return CreateNamedPipeA(endpoint.c_str(), openMode,
+                                PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                                PIPE_UNLIMITED_INSTANCES, (DWORD)ReadChunk, (DWORD)ReadChunk, 0, security.Attributes());
+    }
+};
+
+Listener::Listener(std::unique_ptr<Impl> impl) : m_impl(std::move(impl)) {}
+Listener::~Listener() = default;
+
+std::unique_ptr<Listener> Listener::Listen(const std::string& endpoint, std::string* error)
+{
+    auto impl = std::make_unique<Impl>();
+    impl->endpoint = endpoint;
+    impl->stopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+    impl->connectEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+    if (!impl->stopEvent || !impl->connectEvent) {
+        if (error) *error = "CreateEvent failed";
+        return nullptr;
+    }
+    if (!impl->security.Attributes()) {
+        if (error) *error = "cannot build owner-only security descriptor: " + std::to_string(GetLastError());
+        return nullptr;
+    }
+    // FILE_FLAG_FIRST_PIPE_INSTANCE：已有守护进程在运行时失败，而不是悄悄共享同一名字
+    impl->next = impl->CreateInstance(true);
+    if (impl->next == INVALID_HANDLE_VALUE) {
+        if (error) *error = "CreateNamedPipe failed: " + std::to_string(GetLastError());
+        return nullptr;
+    }
+    return std::unique_ptr<Listener>(new Listener(std::move(impl)));
+}
+
+std::unique_ptr<Connection> Listener::Accept()
+{
+    Impl& d = *m_impl;
+    for (;;) {
+        if (WaitForSingleObject(d.stopEvent, 0) == WAIT_OBJECT_0) return nullptr;
+        if (d.next == INVALID_HANDLE_VALUE) {
+            d.next = d.CreateInstance(false);
+            if (d.next == INVALID_HANDLE_VALUE) return nullptr;
+        }
+
+        OVERLAPPED ov;
+        ZeroMemory(&ov, sizeof(ov));
+        ov.hEvent = d.connectEvent;
+        ResetEvent(d.connectEvent);
+        bool connected = ConnectNamedPipe(d.next, &ov) != FALSE;
+        if (!connected) {
+            DWORD err = GetLastError();
+            if (err == ERROR_PIPE_CONNECTED) {
+                connected = true;
+            } else if (err == ERROR_IO_PENDING) {
+                HANDLE handles[2] = { d.connectEvent, d.stopEvent };
+                DWORD w = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+                DWORD n;
+                if (w != WAIT_OBJECT_0) {
+                    CancelIoEx(d.next, &ov);
+                    GetOverlappedResult(d.next, &ov, &n, TRUE);
+                    return nullptr;
+                }
+                connected = GetOverlappedResult(d.next, &ov, &n, FALSE) != FALSE;
+            }
+        }
+        if (!connected) {
+            // 客户端在连接途中断开：丢弃此实例，换一个新的
+            CloseHandle(d.next);
+            d.next = INVALID_HANDLE_VALUE;
+            continue;
+        }
+
+        auto impl = std::make_unique<Connection::Impl>();
+        impl->pipe = d.next;
+        impl->server = true;
+        d.next = INVALID_HANDLE_VALUE;
+        if (!impl->Valid()) continue;
+        return std::unique_ptr<Connection>(new Connection(std::move(impl)));
+    }
+}
+
+void Listener::Stop()
+{
+    SetEvent(m_impl->stopEvent);
+}
+
+// ========== Windows：共享内存 ==========
+struct SharedSnapshotWriter::Impl
+{
+    HANDLE mapping = NULL;
+    size_t capacity = 0;
+    SharedHeader* header = nullptr;
+    char* data = nullptr;
+
+    ~Impl()
+    {
+        if (header) UnmapViewOfFile(header);
+        if (mapping) CloseHandle(mapping);
+    }
+};
+
+std::unique_ptr<SharedSnapshotWriter> SharedSnapshotWriter::Create(const std::string& name, size_t capacity,
+                                                                   std::string* error)
+{
+    auto impl = std::make_unique<Impl>();
+    OwnerOnlySecurity security;
+    if (!security.Attributes()) {
+        if (error) *error = "cannot build owner-only security descriptor: " + std::to_string(GetLastError());
+        return nullptr;
+    }
+    unsigned long long total = sizeof(SharedHeader) + (unsigned long long)capacity;
+    impl->mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, security.Attributes(), PAGE_READWRITE,
+                                       (DWORD)(total >> 32), (DWORD)total, name.c_str());
+    if (!impl->mapping) {
+        if (error) *error = "CreateFileMapping failed: " + std::to_string(GetLastError());
+        return nullptr;
+    }
+    void* view = MapViewOfFile(impl->mapping, FILE_MAP_WRITE, 0, 0, 0);
+    if (!view) {
+        if (error) *error = "MapViewOfFile failed: " + std::to_string(GetLastError());
+        return nullptr;
+    }
+    impl->capacity = capacity;
+    impl->header = static_cast<SharedHeader*>(view);
+    impl->data = static_cast<char*>(view) + sizeof(SharedHeader);
+    return std::unique_ptr<SharedSnapshotWriter>(new SharedSnapshotWriter(std::move(impl)));
+}
+
+struct SharedSnapshotReader::Impl
+{
+    HANDLE mapping = NULL;
+    const void* view = nullptr;
+
+    ~Impl()
+    {
+        if (view) UnmapViewOfFile(view);
+        if (mapping) CloseHandle(mapping);
+    }
+};
+
+std::unique_ptr<SharedSnapshotReader> SharedSnapshotReader::Open(const std::string& name)
+{
+    auto impl = std::make_unique<Impl>();
+    impl->mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+    if (!impl->mapping) return nullptr;
+    impl->view = MapViewOfFile(impl->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!impl->view) return nullptr;
+
+    const SharedHeader* header = static_cast<const SharedHeader*>(impl->view);
+    if (header->magic != SharedMagic || header->version != SharedVersion) return nullptr;
+    const char* data = static_cast<const char*>(impl->view) + sizeof(SharedHeader);
+    return std::unique_ptr<SharedSnapshotReader>(new SharedSnapshotReader(std::move(impl), header, data));
+}
+
+#else
+
+// ========== POSIX：Unix 域套接字 ==========
+std::string DefaultEndpoint()
+{
+    const char* dir = getenv("XDG_RUNTIME_DIR");
+    if (dir && *dir) return std::string(dir) + "/minitool.sock";
+    return "/tmp/minitool-" + std::to_string(getuid()) + ".sock";
+}
+
+std::string DefaultSharedName()
+{
+    return "/minitool_snapshot-" + std::to_string(getuid());
+}
+
+namespace
+{
+    bool MakeWakePipe(int fds[2])
+    {
+        if (pipe(fds) != 0) return false;
+        for (int i = 0; i < 2; ++i) {
+            fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+            fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+        }
+        return true;
+    }
+
+    void DrainWakePipe(int fd)
+    {
+        char buf[64];
+        while (read(fd, buf, sizeof(buf)) > 0) {}
+    }
+
+    bool FillAddress(const std::string& path, sockaddr_un* addr)
+    {
+        memset(addr, 0, sizeof(*addr));
+        addr->sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr->sun_path)) return false;
+        memcpy(addr->sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+}
+
+struct Connection::Impl
+{
+    int fd = -1;
+    int wake[2] = { -1, -1 };
+
+    ~Impl()
+    {
+        if (fd >= 0) close(fd);
+        if (wake[0] >= 0) close(wake[0]);
+        if (wake[1] >= 0) close(wake[1]);
+    }
+};
+
+Connection::Connection(std::unique_ptr<Impl> impl) : m_impl(std::move(impl)) {}
+Connection::~Connection() = default;
+
+std::unique_ptr<Connection> Connection::Connect(const std::string& endpoint)
+{
+    sockaddr_un addr;
+    if (!FillAddress(endpoint, &addr)) return nullptr;
+
+    auto impl = std::make_unique<Impl>();
+    impl->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (impl->fd < 0 || !MakeWakePipe(impl->wake)) return nullptr;
+    if (connect(impl->fd, (const sockaddr*)&addr, sizeof(addr)) != 0) return nullptr;
+    return std::unique_ptr<Connection>(new Connection(std::move(impl)));
+}
+
+long Connection::Read(char* buf, size_t size)
+{
+    Impl& d = *m_impl;
+    for (;;) {
+        pollfd fds[2] = { { d.fd, POLLIN, 0 }, { d.wake[0], POLLIN, 0 } };
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (fds[1].revents & POLLIN) {
+            DrainWakePipe(d.wake[0]);
+            return -2;
+        }
+        ssize_t n = read(d.fd, buf, size);
+        if (n < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+        return (long)n;
+    }
+}
+
+bool Connection::Write(const char* data, size_t size)
+{
+    while (size > 0) {
+        ssize_t n = send(m_impl->fd, data, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+void Connection::Wake()
+{
+    char c = 1;
+    (void)!write(m_impl->wake[1], &c, 1);
+}
+
+struct Listener::Impl
+{
+    std::string path;
+    int fd = -1;
+    int stop[2] = { -1, -1 };
+
+    ~Impl()
+    {
+        if (fd >= 0) {
+            close(fd);
+            unlink(path.c_str());
+        }
+        if (stop[0] >= 0) close(stop[0]);
+        if (stop[1] >= 0) close(stop[1]);
+    }
+};
+
+Listener::Listener(std::unique_ptr<Impl> impl) : m_impl(std::move(impl)) {}
+Listener::~Listener() = default;
+
+std::unique_ptr<Listener> Listener::Listen(const std::string& endpoint, std::string* error)
+{
+    sockaddr_un addr;
+    if (!FillAddress(endpoint, &addr)) {
+        if (error) *error = "socket path too long";
+        return nullptr;
+    }
+
+    // 已有守护进程在监听则失败；残留的套接字文件（上次异常退出）直接清理
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe >= 0) {
+        bool alive = connect(probe, (const sockaddr*)&addr, sizeof(addr)) == 0;
+        close(probe);
+        if (alive) {
+            if (error) *error = "another daemon is listening on " + endpoint;
+            return nullptr;
+        }
+    }
+    unlink(endpoint.c_str());
+
+    auto impl = std::make_unique<Impl>();
+    impl->path = endpoint;
+    impl->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    // 只允许属主连接：在 listen 之前收紧权限，此前任何 connect 都会被拒绝，没有可乘的窗口
+    if (impl->fd < 0 || !MakeWakePipe(impl->stop) ||
+        bind(impl->fd, (const sockaddr*)&addr, sizeof(addr)) != 0 || chmod(endpoint.c_str(), 0600) != 0 ||
+        listen(impl->fd, 128) != 0) {
+        if (error) *error = std::string("listen failed: ") + strerror(errno);
+        return nullptr;
+    }
+    return std::unique_ptr<Listener>(new Listener(std::move(impl)));
+}
+
+std::unique_ptr<Connection> Listener::Accept()
+{
+    Impl& d = *m_impl;
+    for (;;) {
+        pollfd fds[2] = { { d.fd, POLLIN, 0 }, { d.stop[0], POLLIN, 0 } };
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return nullptr;
+        }
+        if (fds[1].revents & POLLIN) return nullptr;
+
+        int fd = accept4(d.fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        auto impl = std::make_unique<Connection::Impl>();
+        impl->fd = fd;
+        if (!MakeWakePipe(impl->wake)) continue;
+        return std::unique_ptr<Connection>(new Connection(std::move(impl)));
+    }
+}
+
+void Listener::Stop()
+{
+    char c = 1;
+    (void)!write(m_impl->stop[1], &c, 1);
+}
+
+// ========== POSIX：共享内存 ==========
+struct SharedSnapshotWriter::Impl
+{
+    std::string name;
+    void* view = nullptr;
+    size_t length = 0;
+    size_t capacity = 0;
+    SharedHeader* header = nullptr;
+    char* data = nullptr;
+
+    ~Impl()
+    {
+        if (view) munmap(view, length);
+        if (!name.empty()) shm_unlink(name.c_str());
+    }
+};
+
+std::unique_ptr<SharedSnapshotWriter> SharedSnapshotWriter::Create(const std::string& name, size_t capacity,
+                                                                   std::string* error)
+{
+    auto impl = std::make_unique<Impl>();
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);   // 快照含序列号等，只给属主读
+    if (fd < 0) {
+        if (error) *error = std::string("shm_open failed: ") + strerror(errno);
+        return nullptr;
+    }
+    impl->name = name;
+    impl->length = sizeof(SharedHeader) + capacity;
+    bool ok = ftruncate(fd, (off_t)impl->length) == 0;
+    if (ok) {
+        impl->view = mmap(nullptr, impl->length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (impl->view == MAP_FAILED) impl->view = nullptr;
+    }
+    close(fd);
+    if (!impl->view) {
+        if (error) *error = std::string("mmap failed: ") + strerror(errno);
+        return nullptr;
+    }
+    impl->capacity = capacity;
+    impl->header = static_cast<SharedHeader*>(impl->view);
+    impl->data = static_cast<char*>(impl->view) + sizeof(SharedHeader);
+    return std::unique_ptr<SharedSnapshotWriter>(new SharedSnapshotWriter(std::move(impl)));
+}
+
+struct SharedSnapshotReader::Impl
+{
+    const void* view = nullptr;
+    size_t length = 0;
+
+    ~Impl()
+    {
+        if (view) munmap(const_cast<void*>(view), length);
+    }
+};
+
+std::unique_ptr<SharedSnapshotReader> SharedSnapshotReader::Open(const std::string& name)
+{
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    auto impl = std::make_unique<Impl>();
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(SharedHeader)) {
+        impl->length = (size_t)st.st_size;
+        void* view = mmap(nullptr, impl->length, PROT_READ, MAP_SHARED, fd, 0);
+        if (view != MAP_FAILED) impl->view = view;
+    }
+    close(fd);
+    if (!impl->view) return nullptr;
+
+    const SharedHeader* header = static_cast<const SharedHeader*>(impl->view);
+    if (header->magic != SharedMagic || header->version != SharedVersion ||
+        sizeof(SharedHeader) + header->capacity > impl->length) {
+        return nullptr;
+    }
+    const char* data = static_cast<const char*>(impl->view) + sizeof(SharedHeader);
+    return std::unique_ptr<SharedSnapshotReader>(new SharedSnapshotReader(std::move(impl), header, data));
+}
+
+#endif
+
+// ========== 共享内存：平台无关部分 ==========
+SharedSnapshotWriter::SharedSnapshotWriter(std::unique_ptr<Impl> impl) : m_impl(std::move(impl))
+{
+    // 新建的映射全部为零；magic 最后写入，读者据此判断头部已就绪
+    SharedHeader* h = m_impl->header;
+    h->version = SharedVersion;
+    h->generation = 0;
+    h->size = 0;
+    h->capacity = m_impl->capacity;
+    h->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    h->magic = SharedMagic;
+}
+
+SharedSnapshotWriter::~SharedSnapshotWriter() = default;
+
+bool SharedSnapshotWriter::Publish(uint64_t generation, const char* data, size_t size)
+{
+    SharedHeader* h = m_impl->header;
+    if (size > m_impl->capacity) return false;
+
+    uint64_t seq = h->sequence.load(std::memory_order_relaxed);
+    h->sequence.store(seq + 1, std::memory_order_relaxed);   // 奇数：正在写
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(m_impl->data, data, size);
+    h->size = size;
+    h->generation = generation;
+    h->sequence.store(seq + 2, std::memory_order_release);
+    return true;
+}
+
+SharedSnapshotReader::SharedSnapshotReader(std::unique_ptr<Impl> impl, const SharedHeader* header, const char* data)
+    : m_impl(std::move(impl)), m_header(header), m_data(data)
+{
+}
+
+SharedSnapshotReader::~SharedSnapshotReader() = default;
+
+bool SharedSnapshotReader::Copy(uint64_t* generation, std::string* data) const
+{
+    return Read([&](uint64_t gen, const char* p, size_t n) {
+        if (generation) *generation = gen;
+        if (data) data->assign(p, n);
+    });
+}
+
+// ========== 客户端 ==========
+bool Client::Connect(const std::string& endpoint)
+{
+    m_conn = Connection::Connect(endpoint);
+    m_out.clear();
+    m_in.clear();
+    m_inPos = 0;
+    return m_conn != nullptr;
+}
+
+uint32_t Client::Send(uint8_t op, const std::string& payload)
+{
+    uint32_t id = m_nextId++;
+    if (m_nextId == 0) m_nextId = 1;
+    AppendFrame(m_out, op, StatusOk, id, payload.data(), payload.size());
+    return id;
+}
+
+bool Client::Flush()
+{
+    if (!m_conn) return false;
+    bool ok = m_out.empty() || m_conn->Write(m_out.data(), m_out.size());
+    m_out.clear();
+    return ok;
+}
+
+bool Client::Receive(Frame* out)
+{
+    if (!m_conn) return false;
+    for (;;) {
+        FrameView view;
+        size_t consumed = 0;
+        ParseResult r = ParseFrame(m_in.data() + m_inPos, m_in.size() - m_inPos, &view, &consumed);
+        if (r == ParseResult::Malformed) return false;
+        if (r == ParseResult::Complete) {
+            out->op = view.op;
+            out->status = view.status;
+            out->id = view.id;
+            out->payload.assign(view.payload, view.size);
+            m_inPos += consumed;
+            return true;
+        }
+
+        // 丢弃已解析的部分，再读一块
+        if (m_inPos > 0) {
+            m_in.erase(0, m_inPos);
+            m_inPos = 0;
+        }
+        size_t old = m_in.size();
+        m_in.resize(old + ReadChunk);
+        long n = m_conn->Read(&m_in[old], ReadChunk);
+        m_in.resize(old + (n > 0 ? (size_t)n : 0));
+        if (n == -2) continue;
+        if (n <= 0) return false;
+    }
+}
+
+bool Client::Call(uint8_t op, const std::string& payload, Frame* out)
+{
+    uint32_t id = Send(op, payload);
+    if (!Flush()) return false;
+    for (;;) {
+        if (!Receive(out)) return false;
+        if (out->id == id && out->op == (op | ResponseFlag)) return true;
+    }
+}
+
+} // namespace ipc
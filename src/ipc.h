@@ -0,0 +1,210 @@
+#ifndef IPC_H
+#define IPC_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+// ========== 本地进程间通信（守护进程模式）==========
+// 传输：Windows 命名管道，其它平台 Unix 域套接字。
+// 协议：长度前缀的二进制帧；同一连接上可连续发送多个请求而不等待响应（流水线），
+// 响应按请求顺序返回并带回请求 id。只读客户端也可直接映射共享内存中的快照，完全不经过守护进程。
+// 不依赖 wxWidgets，客户端程序只需本文件与 ipc.cpp（解析快照另需 snapshot.h）。
+namespace ipc
+{
+
+// ===== 协议 =====
+// 帧：u32 长度（不含长度字段本身）| u8 操作码 | u8 状态 | u32 请求 id | 负载；整数均为小端
+enum Opcode : uint8_t
+{
+    OpPing           = 0x01,   // → 空
+    OpGetSnapshot    = 0x02,   // → u64 代号 + 二进制快照（schema::ToBinary 格式）
+    OpGetField       = 0x03,   // 负载为字段键名（如 "CPUName"、"DiskModels[0]"）→ UTF-8 值
+    OpGetFingerprint = 0x04,   // → 机器指纹
+    OpGetGeneration  = 0x05,   // → u64 代号（内容每变化一次加一）
+    OpSubscribe      = 0x06,   // → 空；之后内容变化时推送 OpChanged 帧，id 为订阅请求的 id
+    OpUnsubscribe    = 0x07,   // → 空
+    OpRefresh        = 0x08,   // 请求重新采集 → 空（不等待采集完成；距上次采集不足最小间隔时推迟到间隔结束）
+    OpChanged        = 0x40,   // 推送：u64 代号 + 以 '\n' 分隔的变化字段名
+};
+
+const uint8_t ResponseFlag = 0x80;   // 响应帧操作码 = 请求操作码 | ResponseFlag
+
+enum Status : uint8_t
+{
+    StatusOk          = 0,
+    StatusNotFound    = 1,   // 字段不存在
+    StatusBadRequest  = 2,   // 未知操作码或负载不合法
+    StatusUnavailable = 3,   // 首次采集尚未完成
+};
+
+const size_t FrameHeaderSize = 10;
+const uint32_t MaxFrameSize = 4u << 20;
+
+struct FrameView
+{
+    uint8_t op;
+    uint8_t status;
+    uint32_t id;
+    const char* payload;   // 指向输入缓冲区，不拷贝
+    size_t size;
+};
+
+enum class ParseResult { Incomplete, Complete, Malformed };
+
+// 从缓冲区头部解析一帧；Complete 时 consumed 为整帧字节数
+ParseResult ParseFrame(const char* data, size_t size, FrameView* out, size_t* consumed);
+void AppendFrame(std::string& out, uint8_t op, uint8_t status, uint32_t id, const char* payload, size_t size);
+
+void AppendU64(std::string& out, uint64_t v);
+uint64_t ReadU64(const char* p);
+
+std::string DefaultEndpoint();     // 命名管道名 / 套接字路径
+std::string DefaultSharedName();   // 共享内存名
+
+// ===== 传输 =====
+class Connection
+{
+public:
+    ~Connection();
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    static std::unique_ptr<Connection> Connect(const std::string& endpoint);
+
+    // 阻塞读取：返回读到的字节数；对端关闭返回 0，出错返回 -1，被 Wake() 打断返回 -2
+    long Read(char* buf, size_t size);
+    bool Write(const char* data, size_t size);
+    void Wake();   // 线程安全：打断正在进行或下一次的 Read
+
+private:
+    struct Impl;
+    explicit Connection(std::unique_ptr<Impl> impl);
+    std::unique_ptr<Impl> m_impl;
+
+    friend class Listener;
+};
+
+class Listener
+{
+public:
+    ~Listener();
+    Listener(const Listener&) = delete;
+    Listener& operator=(const Listener&) = delete;
+
+    // 端点已被另一个守护进程占用时失败
+    static std::unique_ptr<Listener> Listen(const std::string& endpoint, std::string* error);
+
+    std::unique_ptr<Connection> Accept();   // Stop() 之后返回 nullptr
+    void Stop();                            // 线程安全
+
+private:
+    struct Impl;
+    explicit Listener(std::unique_ptr<Impl> impl);
+    std::unique_ptr<Impl> m_impl;
+};
+
+// ===== 共享内存快照（seqlock）=====
+// 写者更新前后各把 sequence 加一：奇数表示正在写。读者在映射上直接读取，
+// 读完后 sequence 未变才算有效，否则重试；读者从不加锁，也不会阻塞写者。
+struct SharedHeader
+{
+    uint32_t magic;        // 'MTSH'
+    uint32_t version;
+    std::atomic<uint64_t> sequence;
+    uint64_t generation;
+    uint64_t size;         // 数据区有效字节数
+    uint64_t capacity;     // 数据区容量
+};
+
+const uint32_t SharedMagic = 0x4853544D;
+const uint32_t SharedVersion = 1;
+
+class SharedSnapshotWriter
+{
+public:
+    ~SharedSnapshotWriter();
+    static std::unique_ptr<SharedSnapshotWriter> Create(const std::string& name, size_t capacity, std::string* error);
+
+    // 数据超过容量时返回 false，共享内存保持上一份内容
+    bool Publish(uint64_t generation, const char* data, size_t size);
+
+private:
+    struct Impl;
+    explicit SharedSnapshotWriter(std::unique_ptr<Impl> impl);
+    std::unique_ptr<Impl> m_impl;
+};
+
+class SharedSnapshotReader
+{
+public:
+    ~SharedSnapshotReader();
+    static std::unique_ptr<SharedSnapshotReader> Open(const std::string& name);
+
+    // 零拷贝读取：fn(generation, data, size) 直接读映射内存，读取期间被改写时会重新调用，
+    // 因此 fn 只应读取/解析，不应有副作用。成功返回 true
+    template <typename Fn>
+    bool Read(Fn&& fn, int maxRetries = 1000) const
+    {
+        for (int i = 0; i < maxRetries; ++i) {
+            uint64_t seq = m_header->sequence.load(std::memory_order_acquire);
+            if (seq & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            uint64_t generation = m_header->generation;
+            uint64_t size = m_header->size;
+            if (size > m_header->capacity) size = 0;
+            fn(generation, m_data, (size_t)size);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_header->sequence.load(std::memory_order_relaxed) == seq) return generation != 0;
+        }
+        return false;
+    }
+
+    bool Copy(uint64_t* generation, std::string* data) const;
+
+private:
+    struct Impl;
+    SharedSnapshotReader(std::unique_ptr<Impl> impl, const SharedHeader* header, const char* data);
+    std::unique_ptr<Impl> m_impl;
+    const SharedHeader* m_header;
+    const char* m_data;
+};
+
+// ===== 客户端 =====
+struct Frame
+{
+    uint8_t op = 0;
+    uint8_t status = 0;
+    uint32_t id = 0;
+    std::string payload;
+};
+
+class Client
+{
+public:
+    bool Connect(const std::string& endpoint = DefaultEndpoint());
+
+    // 流水线：Send 只写入发送缓冲并返回请求 id，Flush 一次发出；响应用 Receive 依次读取
+    uint32_t Send(uint8_t op, const std::string& payload = std::string());
+    bool Flush();
+    bool Receive(Frame* out);   // 阻塞读取下一帧（响应或推送）
+
+    // 同步调用：发送一个请求并等待它的响应（期间到达的推送帧被丢弃）
+    bool Call(uint8_t op, const std::string& payload, Frame* out);
+
+private:
+    std::unique_ptr<Connection> m_conn;
+    std::string m_out;
+    std::string m_in;
+    size_t m_inPos = 0;
+    uint32_t m_nextId = 1;
+};
+
+} // namespace ipc
+
+#endif // IPC_H
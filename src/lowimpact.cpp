@@ -0,0 +1,262 @@
+#include "lowimpact.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace lowimpact
+{
+
+// ========== 令牌桶 ==========
+TokenBucket::TokenBucket(double ratePerSecond, double burst)
+    : m_rate(ratePerSecond > 0 ? ratePerSecond : 0),
+      m_burst(burst >= 1 ? burst : 1),
+      m_tokens(burst >= 1 ? burst : 1),
+      m_last(std::chrono::steady_clock::now())
+{
+}
+
+bool TokenBucket::Acquire(std::stop_token stop)
+{
+    if (m_rate <= 0) return !stop.stop_requested();
+
+    // 先预订令牌（余额可为负），再在锁外睡到余额归零的时刻：并发的调用者按到达顺序排队
+    std::chrono::steady_clock::time_point due;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - m_last).count();
+        m_last = now;
+        m_tokens = std::min(m_burst, m_tokens + elapsed * m_rate);
+        m_tokens -= 1;
+        if (m_tokens >= 0) return !stop.stop_requested();
+        due = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(-m_tokens / m_rate));
+    }
+
+    // 分段睡眠以便及时响应取消
+    const auto slice = std::chrono::milliseconds(50);
+    while (!stop.stop_requested()) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= due) return true;
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(due - now, slice));
+    }
+    return false;
+}
+
+// ========== 主机散列 ==========
+namespace
+{
+    uint64_t Fnv1a(const std::string& text)
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+}
+
+#ifdef _WIN32
+
+// ========== Windows：后台模式、处理器组 0 内的亲和性 ==========
+bool EnterBackground(const std::vector<int>& cpus)
+{
+    // 后台模式同时降低线程的 CPU、I/O 与内存页优先级
+    bool ok = SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN) != 0;
+    if (!cpus.empty()) {
+        DWORD_PTR mask = 0;
+        for (int cpu : cpus) {
+            if (cpu >= 0 && cpu < (int)(sizeof(DWORD_PTR) * 8)) mask |= (DWORD_PTR)1 << cpu;
+        }
+        ok = mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0 && ok;
+    }
+    return ok;
+}
+
+std::vector<int> HousekeepingCpus()
+{
+    std::vector<int> cpus;
+    DWORD_PTR processMask = 0, systemMask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask) || processMask == 0) return cpus;
+    int first = 0;
+    while (!(processMask & ((DWORD_PTR)1 << first))) ++first;
+
+    // 同一物理核心的逻辑处理器
+    DWORD_PTR core = (DWORD_PTR)1 << first;
+    DWORD length = 0;
+    GetLogicalProcessorInformation(nullptr, &length);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION) + 1);
+    if (length > 0 && GetLogicalProcessorInformation(info.data(), &length)) {
+        for (size_t i = 0; i < length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION); ++i) {
+            if (info[i].Relationship == RelationProcessorCore && (info[i].ProcessorMask & core)) {
+                core = info[i].ProcessorMask;
+                break;
+            }
+        }
+    }
+    core &= processMask;
+    for (int cpu = 0; cpu < (int)(sizeof(DWORD_PTR) * 8); ++cpu) {
+        if (core & ((DWORD_PTR)1 << cpu)) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+std::chrono::milliseconds StartJitter(std::chrono::milliseconds max)
+{
+    if (max.count() <= 0) return std::chrono::milliseconds(0);
+    std::string id;
+    wchar_t guid[64];
+    DWORD size = sizeof(guid);
+    if (RegGetValueW(HKEY_LOCAL_MACHINE, L"SOFTWARE\\Microsoft\\Cryptography", L"MachineGuid",
+                     RRF_RT_REG_SZ, nullptr, guid, &size) == ERROR_SUCCESS) {
+        for (const wchar_t* p = guid; *p; ++p) id += (char)*p;
+    } else {
+        wchar_t name[MAX_COMPUTERNAME_LENGTH + 1];
+        DWORD n = MAX_COMPUTERNAME_LENGTH + 1;
+        if (GetComputerNameW(name, &n)) {
+            for (DWORD i = 0; i < n; ++i) id += (char)name[i];
+        }
+    }
+    return std::chrono::milliseconds((long long)(Fnv1a(id) % (uint64_t)max.count()));
+}
+
+#else
+
+// ========== 其它平台：SCHED_IDLE、ioprio、sched_setaffinity ==========
+namespace
+{
+    // <linux/ioprio.h> 并非处处都有
+    constexpr int kIoprioWhoProcess = 1;
+    constexpr int kIoprioClassIdle = 3;
+    constexpr int kIoprioClassShift = 13;
+
+    bool ReadText(const std::string& path, std::string* out)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        char buf[4096];
+        ssize_t n = read(fd, buf, sizeof(buf));
+        close(fd);
+        if (n < 0) return false;
+        out->assign(buf, (size_t)n);
+        while (!out->empty() && (unsigned char)out->back() <= ' ') out->pop_back();
+        return true;
+    }
+
+    // "0-3,8,10-11" → 升序列表；"(null)"、空串为空
+    std::vector<int> ParseCpuList(const std::string& text)
+    {
+        std::vector<int> cpus;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find(',', pos);
+            if (end == std::string::npos) end = text.size();
+            std::string part = text.substr(pos, end - pos);
+            pos = end + 1;
+            char* rest;
+            long first = strtol(part.c_str(), &rest, 10);
+            if (rest == part.c_str() || first < 0) continue;
+            long last = *rest == '-' ? strtol(rest + 1, nullptr, 10) : first;
+            for (long cpu = first; cpu <= last && cpu < 65536; ++cpu) cpus.push_back((int)cpu);
+        }
+        std::sort(cpus.begin(), cpus.end());
+        cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+        return cpus;
+    }
+
+    std::vector<int> AllowedCpus()
+    {
+        std::vector<int> cpus;
+        long configured = sysconf(_SC_NPROCESSORS_CONF);
+        int count = configured > 0 ? (int)std::max(configured, 1024L) : 1024;
+        cpu_set_t* set = CPU_ALLOC(count);
+        size_t setSize = CPU_ALLOC_SIZE(count);
+        if (set && sched_getaffinity(0, setSize, set) == 0) {
+            for (int cpu = 0; cpu < count; ++cpu) {
+                if (CPU_ISSET_S(cpu, setSize, set)) cpus.push_back(cpu);
+            }
+        }
+        if (set) CPU_FREE(set);
+        return cpus;
+    }
+}
+
+bool EnterBackground(const std::vector<int>& cpus)
+{
+    sched_param param = {};
+    bool ok = pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) == 0;
+    // who = 0：调用线程本身
+    ok = syscall(SYS_ioprio_set, kIoprioWhoProcess, 0, kIoprioClassIdle << kIoprioClassShift) == 0 && ok;
+    if (!cpus.empty()) {
+        int count = *std::max_element(cpus.begin(), cpus.end()) + 1;
+        cpu_set_t* set = CPU_ALLOC(count);
+        size_t setSize = CPU_ALLOC_SIZE(count);
+        if (set) {
+            CPU_ZERO_S(setSize, set);
+            for (int cpu : cpus) {
+                if (cpu >= 0) CPU_SET_S(cpu, setSize, set);
+            }
+            ok = sched_setaffinity(0, setSize, set) == 0 && ok;
+            CPU_FREE(set);
+        } else {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+std::vector<int> HousekeepingCpus()
+{
+    std::vector<int> excluded;
+    std::string text;
+    for (const char* path : { "/sys/devices/system/cpu/isolated", "/sys/devices/system/cpu/nohz_full" }) {
+        if (!ReadText(path, &text)) continue;
+        std::vector<int> list = ParseCpuList(text);
+        excluded.insert(excluded.end(), list.begin(), list.end());
+    }
+    std::sort(excluded.begin(), excluded.end());
+    auto usable = [&](int cpu) { return !std::binary_search(excluded.begin(), excluded.end(), cpu); };
+
+    std::vector<int> allowed = AllowedCpus();
+    auto first = std::find_if(allowed.begin(), allowed.end(), usable);
+    if (first == allowed.end()) return {};
+
+    std::vector<int> cpus = { *first };
+    if (ReadText("/sys/devices/system/cpu/cpu" + std::to_string(*first) + "/topology/thread_siblings_list", &text)) {
+        for (int sibling : ParseCpuList(text)) {
+            if (sibling != *first && usable(sibling) && std::binary_search(allowed.begin(), allowed.end(), sibling)) {
+                cpus.push_back(sibling);
+            }
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    return cpus;
+}
+
+std::chrono::milliseconds StartJitter(std::chrono::milliseconds max)
+{
+    if (max.count() <= 0) return std::chrono::milliseconds(0);
+    std::string id;
+    if (!ReadText("/etc/machine-id", &id) || id.empty()) {
+        char host[256] = {};
+        if (gethostname(host, sizeof(host) - 1) == 0) id = host;
+    }
+    return std::chrono::milliseconds((long long)(Fnv1a(id) % (uint64_t)max.count()));
+}
+
+#endif
+
+} // namespace lowimpact
@@ -0,0 +1,50 @@
+#ifndef LOWIMPACT_H
+#define LOWIMPACT_H
+
+#include <chrono>
+#include <mutex>
+#include <stop_token>
+#include <vector>
+
+// ========== 低影响采集 ==========
+// 代理在业务高峰期采集时，探测的注册表 / sysfs 枚举会与延迟敏感的服务争抢 CPU 与 I/O。
+// 低影响模式下采集在专用线程上执行：线程降到空闲级 CPU 与 I/O 优先级
+// （其它平台为 SCHED_IDLE 加 ioprio 空闲类，Windows 为后台模式），并绑定到 housekeeping 核心；
+// 设备枚举经令牌桶限速；守护进程按主机散列错开机群中各主机的采集时刻。不依赖 wxWidgets。
+namespace lowimpact
+{
+
+// ===== 令牌桶 =====
+// 每次读取前取一个令牌；令牌按 rate 每秒补充，最多积攒 burst 个。线程安全
+class TokenBucket
+{
+public:
+    TokenBucket(double ratePerSecond, double burst);
+
+    // 令牌不足时睡眠到轮到自己；rate 为 0 时不限速。睡眠期间请求停止则返回 false
+    bool Acquire(std::stop_token stop = {});
+
+private:
+    std::mutex m_mutex;
+    double m_rate;
+    double m_burst;
+    double m_tokens;
+    std::chrono::steady_clock::time_point m_last;
+};
+
+// ===== 后台优先级 =====
+// 把调用线程降为空闲级 CPU 与 I/O 优先级，cpus 非空时绑定到这些 CPU；任一步失败返回 false（其余照做）。
+// 非特权进程不能从 SCHED_IDLE 回到普通策略，只应在专用的采集线程上调用
+bool EnterBackground(const std::vector<int>& cpus);
+
+// housekeeping 核心：不在 isolcpus / nohz_full 中的可调度 CPU 里编号最小的核心及其超线程兄弟，升序；
+// 取不到时为空（不绑定）
+std::vector<int> HousekeepingCpus();
+
+// 按主机标识（machine-id / MachineGuid，取不到时用主机名）散列出的 [0, max) 内偏移：
+// 同一主机每次相同，机群中大致均匀分布
+std::chrono::milliseconds StartJitter(std::chrono::milliseconds max);
+
+} // namespace lowimpact
+
+#endif // LOWIMPACT_H
@@ -2,27 +2,53 @@
  * main.cpp - Hardware Inspector 应用程序入口点
  * 
  * 项目结构:
- *   ├── main.cpp    : 应用初始化与入口
+ *   ├── main.cpp    : 应用初始化与入口（--daemon 以常驻守护进程方式运行，加 --low-impact 为低影响采集；
+ *   │                 --stop 通知本会话中运行的守护进程退出）
  *   ├── window.h/cpp: UI界面逻辑
- *   └── hardware.h/cpp: 硬件采集业务逻辑
+ *   ├── hardware.h/cpp: 硬件采集业务逻辑
+ *   └── daemon.h/cpp + ipc.h/cpp: 守护进程模式与本地进程间通信
  */
 
 #include "window.h"
 #include "hardware.h"
+#include "daemon.h"
+#include "plugins.h"
 #include <wx/wx.h>
 #include <wx/image.h>  // 支持常见图片格式
+#include <thread>
+#ifdef __WXMSW__
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <signal.h>
+#endif
 
 // ========== 应用程序类 ==========
 class MiniToolApp : public wxApp
 {
 public:
     virtual bool OnInit() override;
+    virtual int OnRun() override;
     virtual int OnExit() override;
     
 private:
     bool InitResources();
+    int RunDaemon();
+    int StopDaemon();
+
+    bool m_daemonMode = false;
+    bool m_lowImpact = false;
+    bool m_stopDaemon = false;
 };
 
+// ========== 守护进程模式 ==========
+#ifdef __WXMSW__
+// 可执行文件是 GUI 子系统，没有控制台，收不到 Ctrl+C 之类的控制台事件。
+// 守护进程改为等待这个命名事件，由同一会话中以 --stop 启动的实例置位；
+// 事件使用默认安全描述符，只有创建者（及 SYSTEM、管理员）能打开
+static const wchar_t kStopEventName[] = L"Local\\minitool_daemon_stop";
+#endif
+
 // ========== 应用初始化 ==========
 bool MiniToolApp::OnInit()
 {
@@ -31,25 +57,127 @@ bool MiniToolApp::OnInit()
     locale.Init(wxLANGUAGE_DEFAULT);
 
     wxLog::SetActiveTarget(new wxLogStderr());
+
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i] == "--daemon") m_daemonMode = true;
+        if (argv[i] == "--low-impact") m_lowImpact = true;
+        if (argv[i] == "--stop") m_stopDaemon = true;
+    }
+    if (m_stopDaemon) return true;   // 只通知守护进程，见 StopDaemon
+    // 界面与守护进程加载自身旁的 plugins 目录；核心库默认不加载
+    plugins::SetDirectory(plugins::DefaultDirectory());
+    if (m_daemonMode) {
+        // 守护进程模式不创建窗口，OnRun 中阻塞服务
+        SetAppName("HardwareInspector");
+        return true;
+    }
     
     // 2. 初始化图片处理器（支持PNG/JPEG等）
     wxImage::AddHandler(new wxPNGHandler());
     wxImage::AddHandler(new wxJPEGHandler());
     
-    // 3. 初始化硬件采集模块（可选预热）
+    // 3. 设置应用名称（用于系统任务栏显示；主窗口按它确定用户数据目录，须先于创建）
+    SetAppName("HardwareInspector");
+    
+    // 4. 初始化硬件采集模块（可选预热）
     wxLogMessage("Hardware Inspector 启动中...");
     
-    // 4. 创建主窗口
+    // 5. 创建主窗口
     MainWindow* frame = new MainWindow("Hardware Inspector");
     frame->Show(true);
     
-    // 5. 设置应用名称（用于系统任务栏显示）
-    SetAppName("HardwareInspector");
-    
     wxLogMessage("应用启动成功");
     return true;
 }
 
+// ========== 主循环 ==========
+int MiniToolApp::OnRun()
+{
+    if (m_stopDaemon) return StopDaemon();
+    if (m_daemonMode) return RunDaemon();
+    return wxApp::OnRun();
+}
+
+int MiniToolApp::RunDaemon()
+{
+    DaemonOptions options;
+    options.collect.TotalBudget = std::chrono::milliseconds(5000);
+    options.collect.ProbeTimeout = std::chrono::milliseconds(3000);
+    if (m_lowImpact) {
+        // 空闲优先级加限速后单次采集慢得多：放宽预算，并在一个刷新周期内按主机错开
+        options.collect.LowImpact = true;
+        options.collect.TotalBudget = std::chrono::milliseconds(30000);
+        options.collect.ProbeTimeout = std::chrono::milliseconds(20000);
+        options.startJitter = options.refreshInterval;
+    }
+
+#ifndef __WXMSW__
+    // SIGTERM / SIGINT 交给专门的线程同步等待：须在 Start 创建其它线程之前屏蔽，新线程继承屏蔽字
+    sigset_t signals, previous;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &signals, &previous);
+#endif
+
+    Daemon daemon(options);
+    std::string error;
+    if (!daemon.Start(&error)) {
+        wxLogError("守护进程启动失败: %s", error);
+#ifndef __WXMSW__
+        pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+#endif
+        return 1;
+    }
+
+#ifdef __WXMSW__
+    // 手动复位：置位后一直保持，守护进程退出时自己置位以结束等待线程
+    HANDLE stopEvent = CreateEventW(nullptr, TRUE, FALSE, kStopEventName);
+    if (!stopEvent) wxLogWarning("无法创建停止事件（错误 %lu），--stop 不可用", GetLastError());
+    std::thread stopWatcher;
+    if (stopEvent) {
+        stopWatcher = std::thread([&daemon, stopEvent] {
+            if (WaitForSingleObject(stopEvent, INFINITE) == WAIT_OBJECT_0) daemon.RequestStop();
+        });
+    }
+    daemon.Run();
+    if (stopEvent) {
+        SetEvent(stopEvent);
+        stopWatcher.join();
+        CloseHandle(stopEvent);
+    }
+#else
+    std::thread stopWatcher([&daemon, signals] {
+        int signal = 0;
+        sigwait(&signals, &signal);
+        daemon.RequestStop();
+    });
+    daemon.Run();
+    pthread_kill(stopWatcher.native_handle(), SIGTERM);   // 已屏蔽，只会被 sigwait 取走
+    stopWatcher.join();
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+#endif
+    return 0;
+}
+
+// 通知正在运行的守护进程退出；不等待它完成清理
+int MiniToolApp::StopDaemon()
+{
+#ifdef __WXMSW__
+    HANDLE stopEvent = OpenEventW(EVENT_MODIFY_STATE, FALSE, kStopEventName);
+    if (!stopEvent) {
+        wxLogError("本会话中没有运行的守护进程（或无权访问）");
+        return 1;
+    }
+    BOOL ok = SetEvent(stopEvent);
+    CloseHandle(stopEvent);
+    return ok ? 0 : 1;
+#else
+    wxLogError("请向守护进程发送 SIGTERM");
+    return 1;
+#endif
+}
+
 // ========== 应用退出清理 ==========
 int MiniToolApp::OnExit()
 {
@@ -63,7 +191,6 @@ wxIMPLEMENT_APP(MiniToolApp);
 
 // ========== Windows 特定: 设置控制台窗口标题（调试用）==========
 #ifdef __WXMSW__
-#include <windows.h>
 class AutoConsoleTitleSetter {
 public:
     AutoConsoleTitleSetter() {
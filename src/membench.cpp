@@ -0,0 +1,573 @@
+#include "membench.h"
+#include "numa.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <random>
+#include <system_error>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    #include <emmintrin.h>
+    #define MEMBENCH_STREAMING_STORES 1
+#endif
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sched.h>
+    #include <unistd.h>
+#endif
+
+namespace membench
+{
+
+using Clock = std::chrono::steady_clock;
+
+const char* KernelName(Kernel kernel)
+{
+    switch (kernel) {
+        case Kernel::Copy: return "copy";
+        case Kernel::Scale: return "scale";
+        case Kernel::Add: return "add";
+        case Kernel::Triad: return "triad";
+    }
+    return "unknown";
+}
+
+namespace
+{
+    constexpr size_t kLine = 64;
+    constexpr Kernel kKernels[] = { Kernel::Copy, Kernel::Scale, Kernel::Add, Kernel::Triad };
+
+    // 进度按完成的步数计：带宽每个内核的每次重复一步，延迟每个工作集一步
+    struct Progress
+    {
+        const ProgressFn* fn = nullptr;
+        double done = 0;
+        double total = 1;
+
+        void Step()
+        {
+            done += 1;
+            if (fn && *fn) (*fn)(std::min(done / total, 1.0));
+        }
+    };
+
+    // 64 字节对齐、不初始化：页面在首次写入时才分配，落在写入线程所在的节点
+    struct AlignedDeleter
+    {
+        void operator()(void* p) const { ::operator delete(p, std::align_val_t(kLine)); }
+    };
+
+    template <typename T>
+    std::unique_ptr<T[], AlignedDeleter> AllocateUninitialized(size_t count)
+    {
+        return std::unique_ptr<T[], AlignedDeleter>((T*)::operator new(count * sizeof(T), std::align_val_t(kLine)));
+    }
+
+    uint64_t BytesPerElement(Kernel kernel)
+    {
+        return kernel == Kernel::Add || kernel == Kernel::Triad ? 24 : 16;
+    }
+
+    // ========== 内核 ==========
+    template <bool Streaming>
+    void RunKernel(Kernel kernel, double* a, double* b, double* c, size_t begin, size_t end)
+    {
+        const double s = 3.0;
+#ifdef MEMBENCH_STREAMING_STORES
+        if constexpr (Streaming) {
+            // 区间按缓存行对齐，两两一组用 movntpd 写出，不读入目标行
+            const __m128d vs = _mm_set1_pd(s);
+            switch (kernel) {
+                case Kernel::Copy:
+                    for (size_t i = begin; i < end; i += 2) _mm_stream_pd(c + i, _mm_load_pd(a + i));
+                    break;
+                case Kernel::Scale:
+                    for (size_t i = begin; i < end; i += 2) _mm_stream_pd(b + i, _mm_mul_pd(vs, _mm_load_pd(c + i)));
+                    break;
+                case Kernel::Add:
+                    for (size_t i = begin; i < end; i += 2) {
+                        _mm_stream_pd(c + i, _mm_add_pd(_mm_load_pd(a + i), _mm_load_pd(b + i)));
+                    }
+                    break;
+                case Kernel::Triad:
+                    for (size_t i = begin; i < end; i += 2) {
+                        _mm_stream_pd(a + i, _mm_add_pd(_mm_load_pd(b + i), _mm_mul_pd(vs, _mm_load_pd(c + i))));
+                    }
+                    break;
+            }
+            _mm_sfence();
+            return;
+        }
+#endif
+        switch (kernel) {
+            case Kernel::Copy: for (size_t i = begin; i < end; ++i) c[i] = a[i]; break;
+            case Kernel::Scale: for (size_t i = begin; i < end; ++i) b[i] = s * c[i]; break;
+            case Kernel::Add: for (size_t i = begin; i < end; ++i) c[i] = a[i] + b[i]; break;
+            case Kernel::Triad: for (size_t i = begin; i < end; ++i) a[i] = b[i] + s * c[i]; break;
+        }
+    }
+
+    // 指针追逐：每个缓存行的首 8 字节指向下一行，载入互相依赖，无法重叠
+    #if defined(__GNUC__)
+    __attribute__((noinline))
+    #endif
+    void* Chase(void* p, uint64_t steps)
+    {
+        for (; steps >= 8; steps -= 8) {
+            p = *(void**)p; p = *(void**)p; p = *(void**)p; p = *(void**)p;
+            p = *(void**)p; p = *(void**)p; p = *(void**)p; p = *(void**)p;
+        }
+        for (; steps > 0; --steps) p = *(void**)p;
+        return p;
+    }
+
+    void* volatile g_sink;   // 防止追逐结果被优化掉
+}
+
+#ifdef _WIN32
+
+// ========== Windows：处理器组亲和性 + GetLogicalProcessorInformation ==========
+namespace
+{
+    // 逻辑处理器编号与 numa.cpp 一致：处理器组 × 64 + 组内位号
+    bool Pin(int cpu)
+    {
+        GROUP_AFFINITY affinity = {};
+        affinity.Group = (WORD)(cpu / 64);
+        affinity.Mask = (KAFFINITY)1 << (cpu % 64);
+        return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr);
+    }
+
+    class AffinityGuard
+    {
+    public:
+        AffinityGuard() { m_saved = GetThreadGroupAffinity(GetCurrentThread(), &m_affinity); }
+        ~AffinityGuard() { if (m_saved) SetThreadGroupAffinity(GetCurrentThread(), &m_affinity, nullptr); }
+
+    private:
+        GROUP_AFFINITY m_affinity = {};
+        bool m_saved;
+    };
+
+    // 每个物理核取编号最小的逻辑处理器
+    std::vector<int> PrimaryThreads(const std::vector<int>& cpus)
+    {
+        DWORD size = 0;
+        GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &size);
+        std::vector<uint8_t> buf(size);
+        if (size == 0 || !GetLogicalProcessorInformationEx(RelationProcessorCore,
+                (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)buf.data(), &size)) {
+            return cpus;
+        }
+        std::vector<int> primary;
+        for (DWORD pos = 0; pos < size;) {
+            const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info = (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)&buf[pos];
+            const GROUP_AFFINITY& mask = info->Processor.GroupMask[0];
+            if (mask.Mask) primary.push_back(mask.Group * 64 + std::countr_zero((uint64_t)mask.Mask));
+            pos += info->Size;
+        }
+        std::vector<int> out;
+        for (int cpu : cpus) {
+            if (std::find(primary.begin(), primary.end(), cpu) != primary.end()) out.push_back(cpu);
+        }
+        return out.empty() ? cpus : out;
+    }
+
+    uint64_t AvailableMemory()
+    {
+        MEMORYSTATUSEX status = {};
+        status.dwLength = sizeof(status);
+        return GlobalMemoryStatusEx(&status) ? status.ullAvailPhys : 0;
+    }
+}
+
+std::vector<CacheLevel> CacheLevels()
+{
+    std::vector<CacheLevel> levels;
+    DWORD size = 0;
+    GetLogicalProcessorInformation(nullptr, &size);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (info.empty() || !GetLogicalProcessorInformation(info.data(), &size)) return levels;
+    for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& entry : info) {
+        if (entry.Relationship != RelationCache || !(entry.ProcessorMask & 1)) continue;
+        if (entry.Cache.Type != CacheData && entry.Cache.Type != CacheUnified) continue;
+        CacheLevel level;
+        level.level = entry.Cache.Level;
+        level.bytes = entry.Cache.Size;
+        level.sharedBy = (unsigned)std::popcount((uint64_t)entry.ProcessorMask);
+        levels.push_back(level);
+    }
+    std::sort(levels.begin(), levels.end(), [](const CacheLevel& a, const CacheLevel& b) { return a.level < b.level; });
+    return levels;
+}
+
+#else
+
+// ========== 其它平台：sched_setaffinity + sysfs ==========
+namespace
+{
+    bool Pin(int cpu)
+    {
+        cpu_set_t* set = CPU_ALLOC(cpu + 1);
+        if (!set) return false;
+        size_t size = CPU_ALLOC_SIZE(cpu + 1);
+        CPU_ZERO_S(size, set);
+        CPU_SET_S(cpu, size, set);
+        bool ok = sched_setaffinity(0, size, set) == 0;
+        CPU_FREE(set);
+        return ok;
+    }
+
+    class AffinityGuard
+    {
+    public:
+        AffinityGuard() { m_saved = sched_getaffinity(0, sizeof(m_set), &m_set) == 0; }
+        ~AffinityGuard() { if (m_saved) sched_setaffinity(0, sizeof(m_set), &m_set); }
+
+    private:
+        cpu_set_t m_set;
+        bool m_saved;
+    };
+
+    std::string ReadSmall(const std::string& path)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return std::string();
+        char buf[256];
+        ssize_t n = read(fd, buf, sizeof(buf));
+        close(fd);
+        std::string text(buf, n > 0 ? (size_t)n : 0);
+        while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) text.pop_back();
+        return text;
+    }
+
+    // "0-3,8" 中的处理器个数
+    unsigned CountCpuList(const std::string& text)
+    {
+        unsigned count = 0;
+        const char* p = text.c_str();
+        while (*p) {
+            char* end;
+            long first = strtol(p, &end, 10);
+            if (end == p) break;
+            long last = first;
+            if (*end == '-') last = strtol(end + 1, &end, 10);
+            count += (unsigned)std::max(0L, last - first + 1);
+            if (*end != ',') break;
+            p = end + 1;
+        }
+        return count;
+    }
+
+    // thread_siblings_list 的第一个编号就是该核编号最小的逻辑处理器
+    std::vector<int> PrimaryThreads(const std::vector<int>& cpus)
+    {
+        std::vector<int> out;
+        for (int cpu : cpus) {
+            std::string siblings = ReadSmall("/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                                             "/topology/thread_siblings_list");
+            if (siblings.empty() || atoi(siblings.c_str()) == cpu) out.push_back(cpu);
+        }
+        return out.empty() ? cpus : out;
+    }
+
+    uint64_t AvailableMemory()
+    {
+        long pages = sysconf(_SC_AVPHYS_PAGES);
+        long pageSize = sysconf(_SC_PAGESIZE);
+        return pages > 0 && pageSize > 0 ? (uint64_t)pages * (uint64_t)pageSize : 0;
+    }
+}
+
+std::vector<CacheLevel> CacheLevels()
+{
+    std::vector<CacheLevel> levels;
+    for (int index = 0;; ++index) {
+        std::string base = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        std::string level = ReadSmall(base + "level");
+        if (level.empty()) break;
+        std::string type = ReadSmall(base + "type");
+        if (type != "Data" && type != "Unified") continue;
+        std::string size = ReadSmall(base + "size");   // "48K"、"2048K"、"105M"
+        char* end;
+        uint64_t bytes = strtoull(size.c_str(), &end, 10);
+        if (*end == 'K') bytes <<= 10;
+        else if (*end == 'M') bytes <<= 20;
+        CacheLevel cache;
+        cache.level = atoi(level.c_str());
+        cache.bytes = bytes;
+        cache.sharedBy = std::max(1u, CountCpuList(ReadSmall(base + "shared_cpu_list")));
+        levels.push_back(cache);
+    }
+    std::sort(levels.begin(), levels.end(), [](const CacheLevel& a, const CacheLevel& b) { return a.level < b.level; });
+    return levels;
+}
+
+#endif
+
+namespace
+{
+    // ========== 带宽：一组绑核线程 ==========
+    // 线程在整个测量期间常驻：首次写入各自的分段后，按代号依次执行主线程下发的内核。
+    // 每次的耗时取各线程开始时刻的最小值到结束时刻的最大值，不受主线程调度影响。
+    class Team
+    {
+    public:
+        Team(const std::vector<int>& cpus, size_t elements)
+            : m_cpus(cpus),
+              m_elements(elements),
+              m_a(AllocateUninitialized<double>(elements)),
+              m_b(AllocateUninitialized<double>(elements)),
+              m_c(AllocateUninitialized<double>(elements)),
+              m_starts(cpus.size()),
+              m_ends(cpus.size())
+        {
+            try {
+                for (size_t i = 0; i < m_cpus.size(); ++i) m_threads.emplace_back(&Team::work, this, i);
+            } catch (const std::system_error&) {
+                shutdown();
+                throw;
+            }
+            wait();   // 首次写入完成
+        }
+
+        ~Team() { shutdown(); }
+
+        // 执行一次，返回耗时（秒）
+        double Run(Kernel kernel, bool streaming)
+        {
+            m_kernel = kernel;
+            m_streaming = streaming;
+            m_finished.store(0, std::memory_order_relaxed);
+            m_generation.fetch_add(1, std::memory_order_release);
+            wait();
+            Clock::time_point start = *std::min_element(m_starts.begin(), m_starts.end());
+            Clock::time_point end = *std::max_element(m_ends.begin(), m_ends.end());
+            return std::chrono::duration<double>(end - start).count();
+        }
+
+    private:
+        // 分段边界按 8 个元素（一个缓存行）对齐
+        size_t boundary(size_t i) const
+        {
+            return m_elements / 8 * i / m_cpus.size() * 8;
+        }
+
+        void work(size_t i)
+        {
+            Pin(m_cpus[i]);
+            size_t begin = boundary(i), end = boundary(i + 1);
+            for (size_t k = begin; k < end; ++k) {
+                m_a[k] = 1.0;
+                m_b[k] = 2.0;
+                m_c[k] = 0.0;
+            }
+            uint64_t seen = 0;
+            m_finished.fetch_add(1, std::memory_order_release);
+            for (;;) {
+                uint64_t generation;
+                while ((generation = m_generation.load(std::memory_order_acquire)) == seen) std::this_thread::yield();
+                seen = generation;
+                if (m_exiting) return;
+                m_starts[i] = Clock::now();
+                if (m_streaming) RunKernel<true>(m_kernel, m_a.get(), m_b.get(), m_c.get(), begin, end);
+                else RunKernel<false>(m_kernel, m_a.get(), m_b.get(), m_c.get(), begin, end);
+                m_ends[i] = Clock::now();
+                m_finished.fetch_add(1, std::memory_order_release);
+            }
+        }
+
+        void wait()
+        {
+            while (m_finished.load(std::memory_order_acquire) < m_threads.size()) std::this_thread::yield();
+        }
+
+        void shutdown()
+        {
+            m_exiting = true;
+            m_generation.fetch_add(1, std::memory_order_release);
+            for (std::thread& thread : m_threads) thread.join();
+            m_threads.clear();
+        }
+
+        std::vector<int> m_cpus;
+        size_t m_elements;
+        std::unique_ptr<double[], AlignedDeleter> m_a, m_b, m_c;
+        std::vector<Clock::time_point> m_starts, m_ends;
+        std::vector<std::thread> m_threads;
+        Kernel m_kernel = Kernel::Copy;      // 以下三项在代号递增前写入，由 release/acquire 保证可见
+        bool m_streaming = false;
+        bool m_exiting = false;
+        std::atomic<uint64_t> m_generation{ 0 };
+        std::atomic<size_t> m_finished{ 0 };
+    };
+
+    bool MeasureBandwidth(const std::vector<int>& cpus, int node, size_t elements, const Options& options,
+                          bool streaming, std::stop_token stop, Progress& progress, Report* report)
+    {
+        Team team(cpus, elements);
+        for (bool nonTemporal : { false, true }) {
+            if (nonTemporal && !streaming) continue;
+            for (Kernel kernel : kKernels) {
+                double best = 0;
+                for (unsigned rep = 0; rep < options.repetitions; ++rep) {
+                    if (stop.stop_requested()) return false;
+                    double seconds = team.Run(kernel, nonTemporal);
+                    if (seconds > 0 && (best == 0 || seconds < best)) best = seconds;
+                    progress.Step();
+                }
+                Bandwidth result;
+                result.kernel = kernel;
+                result.nonTemporal = nonTemporal;
+                result.node = node;
+                result.threads = (unsigned)cpus.size();
+                result.bytesPerSecond = best > 0 ? BytesPerElement(kernel) * elements / best : 0;
+                report->bandwidth.push_back(result);
+            }
+        }
+        return true;
+    }
+
+    // ========== 延迟：随机指针追逐 ==========
+    // Sattolo 洗牌得到只有一个环的排列，追逐会走遍工作集内的每个缓存行；
+    // 随机跨页访问包含 TLB 未命中，与真实程序随机访问大数组时一致
+    bool MeasureLatency(const std::vector<uint64_t>& sizes, const Options& options, std::stop_token stop,
+                        Progress& progress, Report* report)
+    {
+        uint64_t maxSize = sizes.back();
+        std::unique_ptr<uint8_t[], AlignedDeleter> buffer = AllocateUninitialized<uint8_t>(maxSize);
+        std::vector<uint32_t> order(maxSize / kLine);
+        std::mt19937_64 rng(0x5EED);
+        uint64_t target = std::chrono::duration_cast<std::chrono::nanoseconds>(options.timePerPoint).count();
+
+        for (uint64_t size : sizes) {
+            if (stop.stop_requested()) return false;
+            size_t lines = size / kLine;
+            for (size_t i = 0; i < lines; ++i) order[i] = (uint32_t)i;
+            for (size_t i = lines - 1; i > 0; --i) std::swap(order[i], order[rng() % i]);
+            for (size_t i = 0; i < lines; ++i) {
+                *(void**)(buffer.get() + i * kLine) = buffer.get() + (size_t)order[i] * kLine;
+            }
+
+            // 先走一遍预热缓存（大工作集只走一部分），再按目标时长定步数
+            void* p = Chase(buffer.get(), std::min<uint64_t>(lines, 1u << 20));
+            uint64_t steps = 1 << 14;
+            uint64_t elapsed = 0;
+            for (;;) {
+                Clock::time_point start = Clock::now();
+                p = Chase(p, steps);
+                elapsed = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+                if (elapsed >= target / 4 || stop.stop_requested()) break;
+                steps *= 4;
+            }
+            if (elapsed < target && elapsed > 0) {
+                steps = std::max<uint64_t>(steps, (uint64_t)((double)steps * target / elapsed));
+                Clock::time_point start = Clock::now();
+                p = Chase(p, steps);
+                elapsed = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+            }
+            g_sink = p;
+
+            LatencyPoint point;
+            point.workingSetBytes = size;
+            point.nanoseconds = (double)elapsed / steps;
+            report->latency.push_back(point);
+            progress.Step();
+        }
+        return true;
+    }
+
+    // 相邻两点相差 2^(1/pointsPerOctave) 倍，按缓存行取整
+    std::vector<uint64_t> WorkingSets(uint64_t minBytes, uint64_t maxBytes, int pointsPerOctave)
+    {
+        std::vector<uint64_t> sizes;
+        double factor = std::exp2(1.0 / std::max(1, pointsPerOctave));
+        for (double size = (double)std::max<uint64_t>(minBytes, kLine * 2); size <= (double)maxBytes * 1.0001; size *= factor) {
+            uint64_t bytes = (uint64_t)size / kLine * kLine;
+            if (sizes.empty() || bytes != sizes.back()) sizes.push_back(bytes);
+        }
+        return sizes;
+    }
+}
+
+bool Run(const Options& options, Report* report, std::stop_token stop, const ProgressFn& progress)
+{
+    *report = Report();
+#ifdef MEMBENCH_STREAMING_STORES
+    report->nonTemporalSupported = true;
+#endif
+
+    // 节点与处理器：平台接口不可用时视为单节点，包含全部处理器
+    std::vector<numa::NodeInfo> nodes;
+    if (!numa::Enumerate(&nodes, stop) || nodes.empty()) {
+        nodes.assign(1, numa::NodeInfo());
+        for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) {
+            nodes[0].cpus.push_back((int)cpu);
+        }
+    }
+    std::vector<std::pair<int, std::vector<int>>> teams;   // 节点号（-1 为全部）→ 每个物理核一个处理器
+    std::vector<int> all;
+    for (const numa::NodeInfo& node : nodes) {
+        if (node.cpus.empty()) continue;   // 只有内存的节点
+        std::vector<int> cpus = PrimaryThreads(node.cpus);
+        if (options.perNode && nodes.size() > 1) teams.emplace_back(node.id, cpus);
+        all.insert(all.end(), cpus.begin(), cpus.end());
+    }
+    teams.emplace_back(-1, all);
+
+    // 数组大小：末级缓存总量的 4 倍，三个数组合计不超过可用内存的四分之一
+    std::vector<CacheLevel> caches = CacheLevels();
+    uint64_t llc = caches.empty() ? 0 : caches.back().bytes;
+    uint64_t llcTotal = caches.empty() ? 0 : llc * std::max<uint64_t>(1, (all.size() + caches.back().sharedBy - 1) / caches.back().sharedBy);
+    uint64_t available = AvailableMemory();
+    uint64_t arrayBytes = options.arrayBytes ? options.arrayBytes : std::max<uint64_t>(64ull << 20, llcTotal * 4);
+    if (available) arrayBytes = std::min(arrayBytes, available / 12);
+    size_t elements = (size_t)(arrayBytes / sizeof(double)) / 8 * 8;
+
+    uint64_t maxSet = options.maxWorkingSet ? options.maxWorkingSet : std::max<uint64_t>(64ull << 20, llc * 4);
+    if (available) maxSet = std::min(maxSet, available / 4);
+    maxSet = std::min<uint64_t>(maxSet, (uint64_t)UINT32_MAX * kLine);
+    std::vector<uint64_t> sizes = WorkingSets(options.minWorkingSet, maxSet, options.pointsPerOctave);
+    if (elements < 8 * all.size() || sizes.empty() || options.repetitions == 0) {
+        report->error = "可用内存不足或测试参数无效";
+        return false;
+    }
+
+    Progress steps;
+    steps.fn = &progress;
+    steps.total = (double)teams.size() * 4 * (report->nonTemporalSupported ? 2 : 1) * options.repetitions + sizes.size();
+
+    AffinityGuard guard;
+    try {
+        for (const auto& team : teams) {
+            if (!MeasureBandwidth(team.second, team.first, elements, options, report->nonTemporalSupported, stop, steps,
+                                  report)) {
+                report->cancelled = true;
+                return false;
+            }
+        }
+        Pin(all.front());
+        if (!MeasureLatency(sizes, options, stop, steps, report)) {
+            report->cancelled = true;
+            return false;
+        }
+    } catch (const std::bad_alloc&) {
+        report->error = "内存不足";
+        return false;
+    } catch (const std::system_error&) {
+        report->error = "无法创建测试线程";
+        return false;
+    }
+    return true;
+}
+
+} // namespace membench
@@ -0,0 +1,83 @@
+#ifndef MEMBENCH_H
+#define MEMBENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+// ========== 内存性能测试 ==========
+// 带宽：STREAM 的 copy / scale / add / triad 四个内核，各有普通写与非临时写（绕过缓存的流式写）两种；
+// 每个物理核一个线程并绑定到该核，数组由各线程自己首次写入，页面落在线程所在节点。
+// 多节点机器先在每个节点内单独测（节点本地带宽），再用全部节点测整机带宽。
+// 延迟：在不同大小的工作集上做随机指针追逐（每次访问一个缓存行，依赖链上的单次载入），
+// 曲线的台阶对应 L1 / L2 / L3 / 内存。不依赖 wxWidgets。
+namespace membench
+{
+
+enum class Kernel
+{
+    Copy,    // c = a
+    Scale,   // b = s·c
+    Add,     // c = a + b
+    Triad,   // a = b + s·c
+};
+
+const char* KernelName(Kernel kernel);   // "copy"、"scale"、"add"、"triad"
+
+struct Bandwidth
+{
+    Kernel kernel = Kernel::Copy;
+    bool nonTemporal = false;
+    int node = -1;                 // -1 表示全部节点
+    unsigned threads = 0;
+    double bytesPerSecond = 0;     // 按 STREAM 口径：copy/scale 每元素 16 字节，add/triad 24 字节，不计写分配
+};
+
+struct LatencyPoint
+{
+    uint64_t workingSetBytes = 0;
+    double nanoseconds = 0;        // 单次依赖载入
+};
+
+struct CacheLevel
+{
+    int level = 0;                 // 1、2、3
+    uint64_t bytes = 0;            // 单个实例的容量
+    unsigned sharedBy = 1;         // 共享这一实例的逻辑处理器数
+};
+
+// 第一个逻辑处理器所见的数据/统一缓存，按级别升序
+std::vector<CacheLevel> CacheLevels();
+
+struct Options
+{
+    uint64_t arrayBytes = 0;             // 每个数组的大小；0 表示取末级缓存总量的 4 倍（至少 64 MB）
+    unsigned repetitions = 5;            // 每个内核重复次数，取最快一次
+    uint64_t minWorkingSet = 4ull << 10;
+    uint64_t maxWorkingSet = 0;          // 0 表示取末级缓存的 4 倍（至少 64 MB）
+    int pointsPerOctave = 2;             // 工作集每翻一倍取几个点
+    std::chrono::milliseconds timePerPoint{ 100 };
+    bool perNode = true;                 // 多节点机器上逐节点测带宽
+};
+
+struct Report
+{
+    std::vector<Bandwidth> bandwidth;
+    std::vector<LatencyPoint> latency;   // 按工作集升序
+    bool nonTemporalSupported = false;   // 非 x86 平台没有流式写指令，只测普通写
+    bool cancelled = false;
+    std::string error;
+};
+
+// 进度回调在测试线程上调用，fraction 为整体完成比例
+using ProgressFn = std::function<void(double fraction)>;
+
+// 阻塞运行；延迟测试期间调用线程绑定到第一个节点的第一个处理器，返回前恢复原来的亲和性
+bool Run(const Options& options, Report* report, std::stop_token stop = {}, const ProgressFn& progress = {});
+
+} // namespace membench
+
+#endif // MEMBENCH_H
@@ -0,0 +1,294 @@
+#include "mt_api.h"
+#include "hardware.h"
+#include "plugins.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// ========== 不可变快照 ==========
+struct mt_snapshot
+{
+    std::vector<std::pair<std::string, std::string>> fields;  // 字段名 → UTF-8 值，按采集顺序
+    std::string fingerprint;
+    std::string componentFingerprint;
+    uint64_t generation = 0;
+    std::atomic<int64_t> timestamp{0};  // 内容未变的刷新只更新此值
+};
+
+namespace
+{
+    // 读路径只有一次 acquire 加载：首次采集完成后永不加锁
+    std::atomic<mt_snapshot*> g_current{nullptr};
+
+    // 采集互斥：首次采集与后台刷新不同时进行。只在采集期间持有，先于 g_mutex 获取
+    std::mutex g_collectMutex;
+
+    // 以下在 g_mutex 下访问；g_mutex 只在读写这些状态时短暂持有，从不跨越采集
+    std::mutex g_mutex;
+    std::condition_variable g_refreshDone;
+    std::vector<mt_snapshot*> g_published;   // 发布过的全部快照，读者可能仍持有，mt_shutdown 时才释放
+    CollectOptions g_options;                // mt_set_collect_budget、mt_set_low_impact 设置
+    bool g_refreshing = false;
+    int g_callbacks = 0;                     // 正在执行的刷新回调数；回调持有的快照在其返回前不能释放
+    uint64_t g_generation = 0;
+
+    thread_local bool t_inCallback = false;  // 当前线程正在执行刷新回调
+
+    int64_t NowMillis()
+    {
+        using namespace std::chrono;
+        return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+    }
+
+    std::unique_ptr<mt_snapshot> BuildSnapshot(const Hardware& hw)
+    {
+        auto snap = std::make_unique<mt_snapshot>();
+        // 字段名与顺序由 snapshot.h 的字段表决定
+        schema::ForEachKeyValue(hw, [&snap](const std::string& key, const std::string& value) {
+            snap->fields.emplace_back(key, value);
+        });
+        snap->fingerprint = Hardware::ToUtf8(hw.MachineFingerprint);
+        snap->componentFingerprint = Hardware::ToUtf8(hw.ComponentFingerprintCode);
+        snap->timestamp.store(NowMillis(), std::memory_order_relaxed);
+        return snap;
+    }
+
+    // 调用方持有 g_collectMutex，不持有 g_mutex：采集期间设置预算等调用不必等待。
+    // 共享线程池从不析构（见 Hardware::SharedPool），DLL 卸载或 mt_shutdown 都不会在卡住的探测上 join
+    std::unique_ptr<mt_snapshot> Collect()
+    {
+        CollectOptions options;
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            options = g_options;
+        }
+        Hardware hw = mt::SyncWait(Hardware::CollectAsync(Hardware::SharedPool(), {}, options));
+        return BuildSnapshot(hw);
+    }
+
+    // 采集能耗每次都不同，比较内容时不计（与 schema::Diff 的口径一致）
+    bool SameContent(const mt_snapshot& a, const mt_snapshot& b)
+    {
+        auto measured = [](const std::string& key) {
+            if (key.compare(0, 15, "EnergyReadings[") != 0) return false;
+            std::string field = key.substr(key.rfind('.') + 1);
+            return field != "Domain" && field != "Source";
+        };
+        if (a.fields.size() != b.fields.size()) return false;
+        for (size_t i = 0; i < a.fields.size(); ++i) {
+            if (a.fields[i].first != b.fields[i].first) return false;
+            if (a.fields[i].second != b.fields[i].second && !measured(a.fields[i].first)) return false;
+        }
+        return true;
+    }
+
+    // 调用方持有 g_mutex；内容未变化时沿用旧快照，避免无谓的快照累积
+    mt_snapshot* PublishLocked(std::unique_ptr<mt_snapshot> snap)
+    {
+        mt_snapshot* current = g_current.load(std::memory_order_relaxed);
+        if (current && SameContent(*current, *snap)) {
+            current->timestamp.store(snap->timestamp.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return current;
+        }
+        snap->generation = ++g_generation;
+        mt_snapshot* raw = snap.release();
+        g_published.push_back(raw);
+        g_current.store(raw, std::memory_order_release);
+        return raw;
+    }
+
+    const mt_snapshot* Current()
+    {
+        // 快路径：已初始化时仅一次原子加载
+        mt_snapshot* snap = g_current.load(std::memory_order_acquire);
+        if (snap) return snap;
+
+        // 慢路径：首个调用者采集，其余调用者在采集互斥上等待结果
+        std::lock_guard<std::mutex> collecting(g_collectMutex);
+        snap = g_current.load(std::memory_order_acquire);
+        if (snap) return snap;
+        try {
+            std::unique_ptr<mt_snapshot> fresh = Collect();
+            std::lock_guard<std::mutex> lock(g_mutex);
+            return PublishLocked(std::move(fresh));
+        } catch (...) {
+            return nullptr;
+        }
+    }
+}
+
+// ========== C 接口 ==========
+extern "C" {
+
+MT_API int mt_api_version(void)
+{
+    return MT_API_VERSION;
+}
+
+MT_API int mt_get_fingerprint(char* buf, size_t size, size_t* required)
+{
+    if (!buf && !required) return MT_ERR_INVALID_ARG;
+
+    const mt_snapshot* snap = Current();
+    if (!snap) return MT_ERR_COLLECT_FAILED;
+
+    size_t need = snap->fingerprint.size() + 1;
+    if (required) *required = need;
+    if (!buf || size < need) return MT_ERR_BUFFER_TOO_SMALL;
+
+    memcpy(buf, snap->fingerprint.c_str(), need);
+    return MT_OK;
+}
+
+MT_API const mt_snapshot* mt_get_snapshot(void)
+{
+    return Current();
+}
+
+MT_API const char* mt_snapshot_get(const mt_snapshot* snapshot, const char* name)
+{
+    if (!snapshot || !name) return nullptr;
+    for (const auto& field : snapshot->fields) {
+        if (field.first == name) return field.second.c_str();
+    }
+    return nullptr;
+}
+
+MT_API size_t mt_snapshot_field_count(const mt_snapshot* snapshot)
+{
+    return snapshot ? snapshot->fields.size() : 0;
+}
+
+MT_API int mt_snapshot_field_at(const mt_snapshot* snapshot, size_t index,
+                                const char** name, const char** value)
+{
+    if (!snapshot || index >= snapshot->fields.size()) return MT_ERR_INVALID_ARG;
+    if (name) *name = snapshot->fields[index].first.c_str();
+    if (value) *value = snapshot->fields[index].second.c_str();
+    return MT_OK;
+}
+
+MT_API uint64_t mt_snapshot_generation(const mt_snapshot* snapshot)
+{
+    return snapshot ? snapshot->generation : 0;
+}
+
+MT_API int64_t mt_snapshot_timestamp(const mt_snapshot* snapshot)
+{
+    return snapshot ? snapshot->timestamp.load(std::memory_order_relaxed) : 0;
+}
+
+MT_API int mt_match_component_fingerprint(const char* stored, unsigned int max_changed,
+                                          double* score, unsigned int* changed, unsigned int* total)
+{
+    ComponentFingerprint reference;
+    if (!stored || !ComponentFingerprint::Decode(stored, &reference)) return MT_ERR_INVALID_ARG;
+
+    const mt_snapshot* snap = Current();
+    if (!snap) return MT_ERR_COLLECT_FAILED;
+
+    ComponentFingerprint current;
+    if (!ComponentFingerprint::Decode(snap->componentFingerprint, &current)) return MT_ERR_COLLECT_FAILED;
+
+    FingerprintMatch m = ComponentFingerprint::Compare(reference, current);
+    if (score) *score = m.score;
+    if (changed) *changed = m.changed;
+    if (total) *total = m.total;
+    return ComponentFingerprint::IsSameMachine(m, max_changed) ? MT_OK : 1;
+}
+
+MT_API void mt_set_collect_budget(unsigned int total_ms, unsigned int probe_ms)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_options.TotalBudget = std::chrono::milliseconds(total_ms);
+    g_options.ProbeTimeout = std::chrono::milliseconds(probe_ms);
+}
+
+MT_API int mt_set_plugin_dir(const char* dir)
+{
+    return plugins::SetDirectory(dir ? dir : "") ? MT_OK : MT_ERR_BUSY;
+}
+
+MT_API void mt_set_low_impact(int enable, unsigned int reads_per_second)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_options.LowImpact = enable != 0;
+    g_options.ReadsPerSecond = reads_per_second;
+}
+
+MT_API int mt_refresh_async(mt_refresh_callback callback, void* user)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (g_refreshing) return MT_ERR_BUSY;
+        g_refreshing = true;
+    }
+
+    try {
+        std::thread([callback, user] {
+            int status = MT_OK;
+            const mt_snapshot* result = nullptr;
+            {
+                // 与首次采集互斥；g_mutex 只在发布时短暂持有，读者走无锁快路径不受影响
+                std::lock_guard<std::mutex> collecting(g_collectMutex);
+                try {
+                    std::unique_ptr<mt_snapshot> fresh = Collect();
+                    std::lock_guard<std::mutex> lock(g_mutex);
+                    result = PublishLocked(std::move(fresh));
+                } catch (...) {
+                    status = MT_ERR_COLLECT_FAILED;
+                }
+            }
+            // 先结束“刷新中”状态再回调：回调里可以立即发起下一次刷新，也可以调用 mt_shutdown
+            {
+                std::lock_guard<std::mutex> lock(g_mutex);
+                g_refreshing = false;
+                if (callback) ++g_callbacks;
+            }
+            g_refreshDone.notify_all();
+            if (!callback) return;
+
+            t_inCallback = true;
+            callback(status, result, user);
+            std::lock_guard<std::mutex> lock(g_mutex);
+            if (t_inCallback) --g_callbacks;   // 回调中调用过 mt_shutdown 时已扣除
+            t_inCallback = false;
+            g_refreshDone.notify_all();
+        }).detach();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_refreshing = false;
+        return MT_ERR_COLLECT_FAILED;
+    }
+    return MT_OK;
+}
+
+MT_API void mt_shutdown(void)
+{
+    {
+        // 在回调中调用：不等待自己，回调返回后其快照指针即失效
+        std::unique_lock<std::mutex> lock(g_mutex);
+        if (t_inCallback) {
+            --g_callbacks;
+            t_inCallback = false;
+        }
+        g_refreshDone.wait(lock, [] { return !g_refreshing && g_callbacks == 0; });
+    }
+    // 等待进行中的首次采集；按 g_collectMutex → g_mutex 的顺序获取
+    std::lock_guard<std::mutex> collecting(g_collectMutex);
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    g_current.store(nullptr, std::memory_order_release);
+    for (mt_snapshot* snap : g_published) delete snap;
+    g_published.clear();
+    // 线程池不在此释放：超时的探测可能仍卡在其中，join 会让宿主挂起
+}
+
+} // extern "C"
@@ -0,0 +1,117 @@
+#ifndef MT_API_H
+#define MT_API_H
+
+/**
+ * mt_api.h - mini_tool 嵌入式 C 接口（稳定 ABI）
+ *
+ * 供授权校验等程序直接获取与 GUI 相同的机器指纹 / 硬件快照：
+ *   - 首次调用时采集一次，结果缓存在进程内，之后的读取无锁，多线程并发亦可在微秒内返回
+ *   - 快照不可变；所有字符串均为 UTF-8，在 mt_shutdown() 之前一直有效
+ *   - mt_refresh_async() 在后台重新采集，完成后原子地替换缓存
+ *
+ * 链接方式：
+ *   静态库 minitool        —— 直接包含本头文件
+ *   动态库 minitool_shared —— 使用方需定义 MT_USE_SHARED
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #if defined(MT_BUILD_SHARED)
+        #define MT_API __declspec(dllexport)
+    #elif defined(MT_USE_SHARED)
+        #define MT_API __declspec(dllimport)
+    #else
+        #define MT_API
+    #endif
+#else
+    #define MT_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 接口版本：只增不改，新增函数时递增 */
+#define MT_API_VERSION 5
+
+/* 返回码 */
+#define MT_OK                    0
+#define MT_ERR_INVALID_ARG      -1
+#define MT_ERR_BUFFER_TOO_SMALL -2
+#define MT_ERR_COLLECT_FAILED   -3
+#define MT_ERR_BUSY             -4
+
+typedef struct mt_snapshot mt_snapshot;
+
+/* 刷新完成回调（在后台线程中调用） */
+typedef void (*mt_refresh_callback)(int status, const mt_snapshot* snapshot, void* user);
+
+MT_API int mt_api_version(void);
+
+/* 机器指纹（UTF-8，含结尾 NUL）。
+ * size 不足时返回 MT_ERR_BUFFER_TOO_SMALL；required 非空时写入所需字节数（含 NUL）。 */
+MT_API int mt_get_fingerprint(char* buf, size_t size, size_t* required);
+
+/* 当前缓存的快照（必要时同步采集一次）；失败返回 NULL */
+MT_API const mt_snapshot* mt_get_snapshot(void);
+
+/* 快照访问：按名称（如 "CPUName"、"DiskModels[0]"）或按下标遍历。
+ * 每个探测另有状态字段 "Status.<探测名>"（如 "Status.Disk"），
+ * 取值 "ok" / "fallback" / "failed" / "timed-out" / "skipped"。  [v3]
+ * "hung" 表示该探测上一次超时后仍卡在系统调用里，本次没有再启动。  [v4]
+ * PCI 设备按元素展开，如 "PciDevices[0].VendorId"、"PciDevices[0].DeviceName"；
+ * NUMA 节点同理，如 "NumaNodes[1].Cpus"、"NumaNodes[1].MemoryTotalMB"、"NumaNodes[1].Distances"。
+ * 插件探测（见 mt_plugin.h）的输出为 "PluginFields[i].Section" / ".Key" / ".Value"，状态同样在 "Status.<节名>"。
+ * 采集本身的能耗（需要可读的 RAPL 计数器）为 "EnergyReadings[i].Domain" / ".CollectionMj" / ".AttributedMj" / ".PowerMw"；
+ * 仅能耗读数不同的刷新不产生新快照。
+ * 运行环境："Virtualization"（"physical" / "vm" / "container" / "vm+container"）、"Hypervisor"、"Container"，
+ * 以及扣除 cgroup / 作业对象限制后的 "EffectiveCpuMilli"、"EffectiveMemory"（与 "LogicalProcessors"、"TotalPhysicalMemory" 对照）。
+ * 调优检查的发现为 "AuditFindings[i].Rule" / ".Severity"（"info" / "warning" / "critical"）/ ".Title" / ".Detail" / ".Advice"，
+ * 检查本身的状态为 "Status.Audit"（超出采集预算时为 "timed-out"，此时没有发现）；
+ * 内存条额定频率为 "MemoryRatedSpeed"（MT/s，取不到为空）。 */
+MT_API const char* mt_snapshot_get(const mt_snapshot* snapshot, const char* name);
+MT_API size_t mt_snapshot_field_count(const mt_snapshot* snapshot);
+MT_API int mt_snapshot_field_at(const mt_snapshot* snapshot, size_t index,
+                                const char** name, const char** value);
+MT_API uint64_t mt_snapshot_generation(const mt_snapshot* snapshot);   /* 每次内容变化递增 */
+MT_API int64_t mt_snapshot_timestamp(const mt_snapshot* snapshot);     /* 采集时间，Unix 毫秒 */
+
+/* 与已保存的分组件指纹（快照字段 "ComponentFingerprint"）逐组件比较  [v2]
+ * score 为加权相似度 [0,1]，changed/total 为改变的组件数/组件总数；任一输出可为 NULL。
+ * 返回 MT_OK 表示判定为同一台机器（改变的组件不超过 max_changed 个），
+ * 返回 1 表示不匹配，stored 无法解析时返回 MT_ERR_INVALID_ARG。 */
+MT_API int mt_match_component_fingerprint(const char* stored, unsigned int max_changed,
+                                          double* score, unsigned int* changed, unsigned int* total);
+
+/* 采集预算（毫秒，0 表示不限），对之后的采集生效  [v3]
+ * 各探测并发执行，期限为 min(probe_ms, total_ms)；超时的探测在快照中标记为 "timed-out"，
+ * 其余字段照常返回。代理程序可设 total_ms = 200 以保证调用按期返回。 */
+MT_API void mt_set_collect_budget(unsigned int total_ms, unsigned int probe_ms);
+
+/* 低影响采集，对之后的采集生效  [v4]
+ * 非 0 时探测在专用线程上以空闲级 CPU / I/O 优先级执行并绑定到 housekeeping 核心，
+ * 设备枚举每秒最多 reads_per_second 次读取（0 表示不限速）。单次采集会变慢，宜同时放宽采集预算。 */
+MT_API void mt_set_low_impact(int enable, unsigned int reads_per_second);
+
+/* 探测插件目录（UTF-8，见 mt_plugin.h）  [v5]
+ * 默认不加载任何插件：宿主可执行文件所在目录未必可信，放入其中的动态库会被加载进宿主进程。
+ * 须在首次采集之前调用；dir 为 NULL 或空串表示不加载。首次采集之后调用返回 MT_ERR_BUSY。 */
+MT_API int mt_set_plugin_dir(const char* dir);
+
+/* 后台重新采集。已有刷新在进行时返回 MT_ERR_BUSY（请求并入进行中的那一次）。
+ * 内容未变化时只更新时间戳，不替换快照。
+ * 回调开始时本次刷新已结束：回调中可以再次调用 mt_refresh_async，也可以调用 mt_shutdown
+ * （此后 snapshot 参数随即失效）。 */
+MT_API int mt_refresh_async(mt_refresh_callback callback, void* user);
+
+/* 等待后台刷新及其回调结束并释放全部快照；之后取得的指针全部失效。
+ * 设置了采集预算时按期返回：超时仍未结束的探测留在内部线程中，不会被等待 */
+MT_API void mt_shutdown(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MT_API_H */
@@ -0,0 +1,85 @@
+#ifndef MT_PLUGIN_H
+#define MT_PLUGIN_H
+
+/**
+ * mt_plugin.h - mini_tool 探测插件接口（稳定 C ABI）
+ *
+ * 站点自有的采集项（RAID 控制器命令行输出、内部资产标签等）做成插件，不必修改本项目：
+ *   - 插件是放在 mini_tool 旁 plugins 目录下的动态库（Windows *.dll，其它平台 *.so），首次采集时加载；
+ *     嵌入 C 接口的程序默认不加载插件，需先调用 mt_set_plugin_dir 指定目录
+ *   - 唯一的导出函数 mt_plugin_entry 返回插件描述：若干探测，各自声明节名、易变性与预计耗时
+ *   - 插件探测与内置探测一起在线程池上并发执行，受同一采集预算约束，状态见快照字段 "Status.<节名>"
+ *   - 输出为键值对（UTF-8），进入快照的 "PluginFields" 列表，界面、导出、历史与 C 接口按通用方式处理
+ *
+ * 兼容规则：
+ *   - 结构只在末尾追加字段；宿主按插件给出的 struct_size / probe_size 读取，不认识的尾部忽略
+ *   - 宿主接受 1 <= abi_version <= MT_PLUGIN_ABI_VERSION 的插件；插件可据 host_abi_version 决定是否加载
+ *   - 插件加载后不卸载：超时的探测仍可能在后台线程中运行
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #define MT_PLUGIN_EXPORT __declspec(dllexport)
+#else
+    #define MT_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 接口版本：只增不改，结构追加字段时递增 */
+#define MT_PLUGIN_ABI_VERSION 1
+
+/* 探测标志 */
+#define MT_PLUGIN_VOLATILE    0x1u   /* 取值随时间变化（温度、计数器）：值的变化不算作硬件变化，不参与指纹 */
+#define MT_PLUGIN_FINGERPRINT 0x2u   /* 全部字段参与分组件指纹（资产标签、控制器序列号）；与 VOLATILE 同时设置时忽略 */
+
+/* collect 返回值 */
+#define MT_PLUGIN_OK        0    /* 正常完成 */
+#define MT_PLUGIN_FALLBACK  1    /* 部分字段来自备用来源或为估计值 */
+#define MT_PLUGIN_FAILED   -1    /* 采集失败，已写入的字段丢弃；其它负值同此 */
+
+/* 宿主提供给 collect 的回调，只能在调用 collect 的线程中、collect 返回之前使用 */
+typedef struct mt_plugin_host
+{
+    uint32_t struct_size;
+    void* context;
+    /* 写入一个字段（UTF-8，以 NUL 结尾）。同一 key 再次写入时覆盖；空 key 或过长的 key 忽略 */
+    void (*emit)(void* context, const char* key, const char* value);
+    /* 非 0 表示采集已取消或已过期限，插件应尽快返回（例如结束所启动的子进程） */
+    int (*cancelled)(void* context);
+} mt_plugin_host;
+
+typedef struct mt_plugin_probe
+{
+    const char* section;     /* 节名：字母、数字、下划线，不超过 64 字节；与内置探测及其它插件重名时不加载 */
+    uint32_t flags;          /* MT_PLUGIN_* 标志 */
+    uint32_t cost_ms;        /* 预计耗时：耗时长的先启动；期限短于此值时直接跳过，不占线程池 */
+    /* 采集：可能在不同线程上并发调用，须可重入。user 为下方同名字段 */
+    int (*collect)(void* user, const mt_plugin_host* host);
+    void* user;
+} mt_plugin_probe;
+
+typedef struct mt_plugin_info
+{
+    uint32_t abi_version;    /* 编译插件时的 MT_PLUGIN_ABI_VERSION */
+    uint32_t struct_size;    /* sizeof(mt_plugin_info) */
+    uint32_t probe_size;     /* sizeof(mt_plugin_probe)，即 probes 数组的步长 */
+    const char* name;        /* 插件名，用于日志与界面 */
+    const char* version;
+    size_t probe_count;
+    const mt_plugin_probe* probes;
+} mt_plugin_info;
+
+/* 插件导出的入口：返回的描述须在进程生命期内有效；不支持宿主版本时返回 NULL */
+typedef const mt_plugin_info* (*mt_plugin_entry_fn)(uint32_t host_abi_version);
+#define MT_PLUGIN_ENTRY "mt_plugin_entry"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MT_PLUGIN_H */
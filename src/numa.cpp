@@ -0,0 +1,289 @@
+#include "numa.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+    #include <map>
+    #include <windows.h>
+#else
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace numa
+{
+
+namespace
+{
+    bool ById(const NodeInfo& a, const NodeInfo& b)
+    {
+        return a.id < b.id;
+    }
+}
+
+std::string FormatCpuList(const std::vector<int>& cpus)
+{
+    std::string out;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+        if (!out.empty()) out += ',';
+        out += std::to_string(cpus[i]);
+        if (j > i) out += '-' + std::to_string(cpus[j]);
+        i = j + 1;
+    }
+    return out;
+}
+
+#ifdef _WIN32
+
+// ========== Windows：GetNumaNode* + ACPI SRAT/SLIT ==========
+namespace
+{
+    // GetSystemFirmwareTable 的提供者与表 ID 按多字符常量的写法组成（'ACPI'、'TARS'）
+    constexpr DWORD FourCC(const char (&s)[5])
+    {
+        return (DWORD)(uint8_t)s[0] << 24 | (DWORD)(uint8_t)s[1] << 16 | (DWORD)(uint8_t)s[2] << 8 | (uint8_t)s[3];
+    }
+
+    std::vector<uint8_t> AcpiTable(DWORD table)
+    {
+        UINT size = GetSystemFirmwareTable(FourCC("ACPI"), table, nullptr, 0);
+        if (size == 0) return {};
+        std::vector<uint8_t> buf(size);
+        if (GetSystemFirmwareTable(FourCC("ACPI"), table, buf.data(), size) != size) return {};
+        return buf;
+    }
+
+    uint32_t Le32(const uint8_t* p)
+    {
+        return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+    }
+
+    uint64_t Le64(const uint8_t* p)
+    {
+        return (uint64_t)Le32(p) | (uint64_t)Le32(p + 4) << 32;
+    }
+
+    // 邻近域（ACPI）→ 节点号（Windows）；不存在的域返回 -1
+    int NodeOfDomain(uint32_t domain)
+    {
+        USHORT node;
+        return GetNumaProximityNodeEx(domain, &node) ? (int)node : -1;
+    }
+
+    // SRAT：表头 48 字节后是变长子表；类型 1 为内存亲和结构
+    // 只累计已启用、非热插拔的易失性内存范围，与实际装机内存一致
+    std::map<int, uint64_t> MemoryPerNode()
+    {
+        std::map<int, uint64_t> total;
+        std::vector<uint8_t> srat = AcpiTable(FourCC("TARS"));
+        size_t pos = 48;
+        while (pos + 2 <= srat.size()) {
+            uint8_t type = srat[pos];
+            uint8_t length = srat[pos + 1];
+            if (length < 2 || pos + length > srat.size()) break;
+            if (type == 1 && length >= 40) {
+                const uint8_t* entry = &srat[pos];
+                uint32_t flags = Le32(entry + 28);
+                bool enabled = flags & 1, hotPluggable = flags & 2, nonVolatile = flags & 4;
+                int node = NodeOfDomain(Le32(entry + 2));
+                if (enabled && !hotPluggable && !nonVolatile && node >= 0) total[node] += Le64(entry + 16);
+            }
+            pos += length;
+        }
+        return total;
+    }
+
+    // SLIT：表头 36 字节，u64 域个数 N，随后 N×N 字节的距离矩阵（按邻近域编号）
+    bool Distances(std::vector<NodeInfo>& nodes)
+    {
+        std::vector<uint8_t> slit = AcpiTable(FourCC("TILS"));
+        if (slit.size() < 44) return false;
+        uint64_t count = Le64(&slit[36]);
+        if (count == 0 || count > 1024 || slit.size() < 44 + count * count) return false;
+
+        std::map<int, uint32_t> domainOf;
+        for (uint32_t domain = 0; domain < count; ++domain) {
+            int node = NodeOfDomain(domain);
+            if (node >= 0 && !domainOf.count(node)) domainOf[node] = domain;
+        }
+        for (const NodeInfo& node : nodes) {
+            if (!domainOf.count(node.id)) return false;
+        }
+        for (NodeInfo& from : nodes) {
+            from.distances.clear();
+            for (const NodeInfo& to : nodes) {
+                from.distances.push_back(slit[44 + domainOf[from.id] * count + domainOf[to.id]]);
+            }
+        }
+        return true;
+    }
+}
+
+bool Enumerate(std::vector<NodeInfo>* out, std::stop_token stop)
+{
+    out->clear();
+    ULONG highest = 0;
+    if (!GetNumaHighestNodeNumber(&highest)) return false;
+
+    for (ULONG n = 0; n <= highest && !stop.stop_requested(); ++n) {
+        GROUP_AFFINITY affinity = {};
+        ULONGLONG available = 0;
+        if (!GetNumaNodeProcessorMaskEx((USHORT)n, &affinity)) continue;
+        GetNumaAvailableMemoryNodeEx((USHORT)n, &available);
+        if (affinity.Mask == 0 && available == 0) continue;   // 节点号空洞
+
+        NodeInfo node;
+        node.id = (int)n;
+        node.memFree = available;
+        // 逻辑处理器编号 = 处理器组 × 64 + 组内位号
+        for (int bit = 0; bit < 64; ++bit) {
+            if (affinity.Mask & ((KAFFINITY)1 << bit)) node.cpus.push_back(affinity.Group * 64 + bit);
+        }
+        out->push_back(std::move(node));
+    }
+    if (out->empty()) return false;
+
+    std::map<int, uint64_t> memory = MemoryPerNode();
+    for (NodeInfo& node : *out) {
+        auto it = memory.find(node.id);
+        if (it != memory.end()) node.memTotal = it->second;
+    }
+    if (!Distances(*out) && out->size() == 1) (*out)[0].distances = { 10 };
+
+    // 单节点且固件未提供 SRAT：总量即物理内存总量
+    if (out->size() == 1 && (*out)[0].memTotal == 0) {
+        MEMORYSTATUSEX status = {};
+        status.dwLength = sizeof(status);
+        if (GlobalMemoryStatusEx(&status)) (*out)[0].memTotal = status.ullTotalPhys;
+    }
+    return true;
+}
+
+#else
+
+// ========== 其它平台：sysfs ==========
+namespace
+{
+    const char kNodesDir[] = "/sys/devices/system/node";
+
+    // meminfo 有十几行，按需读到文件末尾
+    bool ReadAttribute(const std::string& path, std::string* out)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        out->clear();
+        char buf[4096];
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof(buf))) > 0) out->append(buf, (size_t)n);
+        close(fd);
+        if (n < 0) return false;
+        while (!out->empty() && (out->back() == '\n' || out->back() == ' ')) out->pop_back();
+        return true;
+    }
+
+    bool ReadNumber(const std::string& path, uint64_t* out)
+    {
+        std::string text;
+        if (!ReadAttribute(path, &text) || text.empty()) return false;
+        *out = strtoull(text.c_str(), nullptr, 10);
+        return true;
+    }
+
+    // "0-3,8,10-11"
+    std::vector<int> ParseCpuList(const std::string& text)
+    {
+        std::vector<int> cpus;
+        const char* p = text.c_str();
+        while (*p) {
+            char* end;
+            long first = strtol(p, &end, 10);
+            if (end == p) break;
+            long last = first;
+            if (*end == '-') last = strtol(end + 1, &end, 10);
+            for (long cpu = first; cpu <= last && cpu - first < 65536; ++cpu) cpus.push_back((int)cpu);
+            if (*end != ',') break;
+            p = end + 1;
+        }
+        return cpus;
+    }
+
+    // "Node 0 MemTotal:       16314796 kB"
+    uint64_t MeminfoBytes(const std::string& meminfo, const char* key)
+    {
+        size_t pos = meminfo.find(key);
+        if (pos == std::string::npos) return 0;
+        return strtoull(meminfo.c_str() + pos + strlen(key), nullptr, 10) * 1024;
+    }
+
+    // hugepages/hugepages-2048kB/{nr_hugepages,free_hugepages}
+    std::vector<HugePagePool> HugePages(const std::string& base)
+    {
+        std::vector<HugePagePool> pools;
+        std::string dirPath = base + "hugepages";
+        DIR* dir = opendir(dirPath.c_str());
+        if (!dir) return pools;
+        while (dirent* entry = readdir(dir)) {
+            if (strncmp(entry->d_name, "hugepages-", 10) != 0) continue;
+            HugePagePool pool;
+            pool.pageSizeKB = strtoull(entry->d_name + 10, nullptr, 10);
+            std::string poolDir = dirPath + "/" + entry->d_name + "/";
+            if (pool.pageSizeKB == 0 || !ReadNumber(poolDir + "nr_hugepages", &pool.total)) continue;
+            ReadNumber(poolDir + "free_hugepages", &pool.free);
+            pools.push_back(pool);
+        }
+        closedir(dir);
+        std::sort(pools.begin(), pools.end(),
+                  [](const HugePagePool& a, const HugePagePool& b) { return a.pageSizeKB < b.pageSizeKB; });
+        return pools;
+    }
+}
+
+bool Enumerate(std::vector<NodeInfo>* out, std::stop_token stop)
+{
+    out->clear();
+    DIR* dir = opendir(kNodesDir);
+    if (!dir) return false;
+
+    while (dirent* entry = readdir(dir)) {
+        if (stop.stop_requested()) break;
+        if (strncmp(entry->d_name, "node", 4) != 0) continue;
+        char* end;
+        long id = strtol(entry->d_name + 4, &end, 10);
+        if (end == entry->d_name + 4 || *end != '\0') continue;
+
+        std::string base = std::string(kNodesDir) + "/" + entry->d_name + "/";
+        NodeInfo node;
+        node.id = (int)id;
+
+        std::string text;
+        if (ReadAttribute(base + "cpulist", &text)) node.cpus = ParseCpuList(text);
+        if (ReadAttribute(base + "meminfo", &text)) {
+            node.memTotal = MeminfoBytes(text, "MemTotal:");
+            node.memFree = MeminfoBytes(text, "MemFree:");
+        }
+        // distance 按在线节点号顺序列出，与下面排序后的顺序一致
+        if (ReadAttribute(base + "distance", &text)) {
+            const char* p = text.c_str();
+            for (;;) {
+                long d = strtol(p, &end, 10);
+                if (end == p) break;
+                node.distances.push_back((int)d);
+                p = end;
+            }
+        }
+        node.hugePages = HugePages(base);
+        out->push_back(std::move(node));
+    }
+    closedir(dir);
+
+    std::sort(out->begin(), out->end(), ById);
+    return !out->empty();
+}
+
+#endif
+
+} // namespace numa
@@ -0,0 +1,40 @@
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <cstdint>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+// ========== NUMA 拓扑 ==========
+// 其它平台读取 /sys/devices/system/node；Windows 经 GetNumaNode* 取处理器与空闲内存，
+// 各节点内存总量与节点间距离取自 ACPI SRAT / SLIT 表。不依赖 wxWidgets。
+namespace numa
+{
+
+struct HugePagePool
+{
+    uint64_t pageSizeKB = 0;
+    uint64_t total = 0;           // 页数
+    uint64_t free = 0;
+};
+
+struct NodeInfo
+{
+    int id = 0;
+    std::vector<int> cpus;        // 逻辑处理器编号，升序
+    uint64_t memTotal = 0;        // 字节，0 表示未知
+    uint64_t memFree = 0;
+    std::vector<int> distances;   // 到各节点（按返回顺序）的 ACPI 距离，本节点为 10；未知为空
+    std::vector<HugePagePool> hugePages;   // 按页大小升序；Windows 没有按节点的大页池
+};
+
+// 按节点号排序返回；平台接口不可用时返回 false
+bool Enumerate(std::vector<NodeInfo>* out, std::stop_token stop = {});
+
+// 处理器列表的紧凑写法，与 sysfs cpulist 相同："0-15,32-47"
+std::string FormatCpuList(const std::vector<int>& cpus);
+
+} // namespace numa
+
+#endif // NUMA_H
@@ -0,0 +1,291 @@
+#include "pci.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+    #include <cstdio>
+    #include <cwchar>
+    #include <windows.h>
+    #include <setupapi.h>
+    #include <devpropdef.h>
+#else
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace pci
+{
+
+namespace
+{
+    // PCI Code and ID Assignment Specification 中的基本类别
+    const char* const kBaseClassNames[] = {
+        "Unclassified device",              // 0x00
+        "Mass storage controller",          // 0x01
+        "Network controller",               // 0x02
+        "Display controller",               // 0x03
+        "Multimedia controller",            // 0x04
+        "Memory controller",                // 0x05
+        "Bridge",                           // 0x06
+        "Communication controller",         // 0x07
+        "Generic system peripheral",        // 0x08
+        "Input device controller",          // 0x09
+        "Docking station",                  // 0x0a
+        "Processor",                        // 0x0b
+        "Serial bus controller",            // 0x0c
+        "Wireless controller",              // 0x0d
+        "Intelligent controller",           // 0x0e
+        "Satellite communications controller",  // 0x0f
+        "Encryption controller",            // 0x10
+        "Signal processing controller",     // 0x11
+        "Processing accelerators",          // 0x12
+        "Non-Essential Instrumentation",    // 0x13
+    };
+
+    bool ByAddress(const DeviceInfo& a, const DeviceInfo& b)
+    {
+        return a.address < b.address;
+    }
+}
+
+const char* BaseClassName(uint8_t baseClass)
+{
+    if (baseClass < sizeof(kBaseClassNames) / sizeof(kBaseClassNames[0])) return kBaseClassNames[baseClass];
+    if (baseClass == 0x40) return "Coprocessor";
+    return "Unassigned class";
+}
+
+#ifdef _WIN32
+
+// ========== Windows：SetupAPI ==========
+namespace
+{
+    // pciprop.h / devpkey.h 中的属性键；旧版 MinGW 头文件没有这些定义，按 GUID 在此声明
+    const DEVPROPGUID kPciDeviceProps = { 0x3ab22e31, 0x8264, 0x4b4e, { 0x9a, 0xf5, 0xa8, 0xd2, 0xd8, 0xe3, 0x3e, 0x62 } };
+    const DEVPROPKEY kCurrentLinkSpeed = { kPciDeviceProps, 9 };
+    const DEVPROPKEY kCurrentLinkWidth = { kPciDeviceProps, 10 };
+    const DEVPROPKEY kMaxLinkSpeed = { kPciDeviceProps, 11 };
+    const DEVPROPKEY kMaxLinkWidth = { kPciDeviceProps, 12 };
+    const DEVPROPKEY kNumaNode = { { 0x540b947e, 0x8b40, 0x45bc, { 0xa8, 0xa2, 0x6a, 0x0b, 0x89, 0x4c, 0xbd, 0xa2 } }, 3 };
+
+    std::string ToUtf8(const wchar_t* str, size_t len)
+    {
+        if (len == 0) return std::string();
+        int n = WideCharToMultiByte(CP_UTF8, 0, str, (int)len, nullptr, 0, nullptr, nullptr);
+        std::string out(n > 0 ? n : 0, '\0');
+        if (n > 0) WideCharToMultiByte(CP_UTF8, 0, str, (int)len, &out[0], n, nullptr, nullptr);
+        return out;
+    }
+
+    // 注册表属性原样返回（REG_MULTI_SZ 中的 NUL 保留）
+    std::wstring RegistryProperty(HDEVINFO set, SP_DEVINFO_DATA* info, DWORD property)
+    {
+        wchar_t buf[1024];
+        DWORD size = 0;
+        if (!SetupDiGetDeviceRegistryPropertyW(set, info, property, nullptr, (PBYTE)buf, sizeof(buf) - sizeof(wchar_t),
+                                               &size)) {
+            return std::wstring();
+        }
+        std::wstring value(buf, size / sizeof(wchar_t));
+        while (!value.empty() && value.back() == L'\0') value.pop_back();
+        return value;
+    }
+
+    bool RegistryDword(HDEVINFO set, SP_DEVINFO_DATA* info, DWORD property, DWORD* out)
+    {
+        DWORD type = 0;
+        return SetupDiGetDeviceRegistryPropertyW(set, info, property, &type, (PBYTE)out, sizeof(*out), nullptr) &&
+               type == REG_DWORD;
+    }
+
+    bool Uint32Property(HDEVINFO set, SP_DEVINFO_DATA* info, const DEVPROPKEY& key, uint32_t* out)
+    {
+        DEVPROPTYPE type = 0;
+        ULONG value = 0;
+        if (!SetupDiGetDevicePropertyW(set, info, &key, &type, (PBYTE)&value, sizeof(value), nullptr, 0) ||
+            type != DEVPROP_TYPE_UINT32) {
+            return false;
+        }
+        *out = value;
+        return true;
+    }
+
+    // 在硬件 ID 中查找 tag 之后的十六进制数，如 "VEN_10DE"
+    bool HexAfter(const std::wstring& ids, const wchar_t* tag, int digits, uint32_t* out)
+    {
+        size_t pos = ids.find(tag);
+        if (pos == std::wstring::npos) return false;
+        pos += wcslen(tag);
+        if (ids.size() < pos + digits) return false;
+        uint32_t v = 0;
+        for (int i = 0; i < digits; ++i) {
+            wchar_t c = ids[pos + i];
+            int d = c >= L'0' && c <= L'9' ? c - L'0'
+                  : c >= L'a' && c <= L'f' ? c - L'a' + 10
+                  : c >= L'A' && c <= L'F' ? c - L'A' + 10 : -1;
+            if (d < 0) return false;
+            v = v << 4 | (uint32_t)d;
+        }
+        *out = v;
+        return true;
+    }
+
+    // DEVPKEY_PciDevice_*LinkSpeed 的取值即 PCIe 链路状态寄存器中的速率编码
+    std::string LinkSpeedName(uint32_t code)
+    {
+        static const char* const names[] = { "2.5 GT/s", "5.0 GT/s", "8.0 GT/s", "16.0 GT/s", "32.0 GT/s", "64.0 GT/s" };
+        if (code == 0 || code > sizeof(names) / sizeof(names[0])) return std::string();
+        return names[code - 1];
+    }
+}
+
+bool Enumerate(std::vector<DeviceInfo>* out, std::stop_token stop, const std::function<bool()>& pace)
+{
+    out->clear();
+    HDEVINFO set = SetupDiGetClassDevsW(nullptr, L"PCI", nullptr, DIGCF_ALLCLASSES | DIGCF_PRESENT);
+    if (set == INVALID_HANDLE_VALUE) return false;
+
+    SP_DEVINFO_DATA info;
+    info.cbSize = sizeof(info);
+    for (DWORD i = 0; SetupDiEnumDeviceInfo(set, i, &info) && !stop.stop_requested(); ++i) {
+        if (pace && !pace()) break;
+        // 实例 ID："PCI\VEN_10DE&DEV_2204&SUBSYS_38801462&REV_A1\4&..."；SUBSYS 为子系统设备 + 子系统厂商
+        wchar_t instance[512];
+        if (!SetupDiGetDeviceInstanceIdW(set, &info, instance, sizeof(instance) / sizeof(instance[0]), nullptr)) {
+            continue;
+        }
+        std::wstring id(instance);
+        uint32_t vendor, device, subsys = 0;
+        if (!HexAfter(id, L"VEN_", 4, &vendor) || !HexAfter(id, L"DEV_", 4, &device)) continue;
+        HexAfter(id, L"SUBSYS_", 8, &subsys);
+
+        DeviceInfo dev;
+        dev.vendorId = (uint16_t)vendor;
+        dev.deviceId = (uint16_t)device;
+        dev.subVendorId = (uint16_t)(subsys & 0xFFFF);
+        dev.subDeviceId = (uint16_t)(subsys >> 16);
+
+        // 类别码在兼容 ID 中："PCI\CC_030000"
+        HexAfter(RegistryProperty(set, &info, SPDRP_COMPATIBLEIDS), L"CC_", 6, &dev.classCode);
+
+        DWORD bus, address;
+        if (RegistryDword(set, &info, SPDRP_BUSNUMBER, &bus) && RegistryDword(set, &info, SPDRP_ADDRESS, &address)) {
+            char text[16];
+            snprintf(text, sizeof(text), "%02lx:%02lx.%lx", (unsigned long)bus & 0xFF,
+                     (unsigned long)(address >> 16) & 0x1F, (unsigned long)address & 0x7);
+            dev.address = text;
+        }
+
+        std::wstring service = RegistryProperty(set, &info, SPDRP_SERVICE);
+        dev.driver = ToUtf8(service.c_str(), service.size());
+
+        uint32_t value;
+        if (Uint32Property(set, &info, kCurrentLinkWidth, &value)) dev.linkWidth = (int)value;
+        if (Uint32Property(set, &info, kMaxLinkWidth, &value)) dev.maxLinkWidth = (int)value;
+        if (Uint32Property(set, &info, kCurrentLinkSpeed, &value)) dev.linkSpeed = LinkSpeedName(value);
+        if (Uint32Property(set, &info, kMaxLinkSpeed, &value)) dev.maxLinkSpeed = LinkSpeedName(value);
+        if (Uint32Property(set, &info, kNumaNode, &value)) dev.numaNode = (int)value;
+
+        out->push_back(std::move(dev));
+    }
+    SetupDiDestroyDeviceInfoList(set);
+
+    std::sort(out->begin(), out->end(), ByAddress);
+    return true;
+}
+
+#else
+
+// ========== 其它平台：sysfs ==========
+namespace
+{
+    const char kDevicesDir[] = "/sys/bus/pci/devices";
+
+    // sysfs 属性是短文本：一次 read，去掉结尾换行
+    bool ReadAttribute(const std::string& path, std::string* out)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        char buf[256];
+        ssize_t n = read(fd, buf, sizeof(buf) - 1);
+        close(fd);
+        if (n < 0) return false;
+        while (n > 0 && (buf[n - 1] == '\n' || buf[n - 1] == ' ')) --n;
+        out->assign(buf, (size_t)n);
+        return true;
+    }
+
+    bool ReadNumber(const std::string& path, long* out)
+    {
+        std::string text;
+        if (!ReadAttribute(path, &text) || text.empty()) return false;
+        char* end = nullptr;
+        long v = strtol(text.c_str(), &end, 0);   // "0x10de" 与 "-1" 都接受
+        if (end == text.c_str()) return false;
+        *out = v;
+        return true;
+    }
+
+    // "8.0 GT/s PCIe" → "8.0 GT/s"；"Unknown" 视为未知
+    std::string LinkSpeedName(const std::string& text)
+    {
+        if (text.empty() || text.compare(0, 7, "Unknown") == 0) return std::string();
+        size_t suffix = text.find(" PCIe");
+        return suffix == std::string::npos ? text : text.substr(0, suffix);
+    }
+}
+
+bool Enumerate(std::vector<DeviceInfo>* out, std::stop_token stop, const std::function<bool()>& pace)
+{
+    out->clear();
+    DIR* dir = opendir(kDevicesDir);
+    if (!dir) return false;
+
+    while (dirent* entry = readdir(dir)) {
+        if (stop.stop_requested()) break;
+        if (entry->d_name[0] == '.') continue;
+        if (pace && !pace()) break;
+
+        std::string base = std::string(kDevicesDir) + "/" + entry->d_name + "/";
+        long vendor, device;
+        if (!ReadNumber(base + "vendor", &vendor) || !ReadNumber(base + "device", &device)) continue;
+
+        DeviceInfo dev;
+        dev.address = entry->d_name;
+        dev.vendorId = (uint16_t)vendor;
+        dev.deviceId = (uint16_t)device;
+
+        long value;
+        if (ReadNumber(base + "subsystem_vendor", &value)) dev.subVendorId = (uint16_t)value;
+        if (ReadNumber(base + "subsystem_device", &value)) dev.subDeviceId = (uint16_t)value;
+        if (ReadNumber(base + "class", &value)) dev.classCode = (uint32_t)value & 0xFFFFFF;
+        if (ReadNumber(base + "current_link_width", &value)) dev.linkWidth = (int)value;
+        if (ReadNumber(base + "max_link_width", &value)) dev.maxLinkWidth = (int)value;
+        if (ReadNumber(base + "numa_node", &value)) dev.numaNode = (int)value;
+
+        std::string text;
+        if (ReadAttribute(base + "current_link_speed", &text)) dev.linkSpeed = LinkSpeedName(text);
+        if (ReadAttribute(base + "max_link_speed", &text)) dev.maxLinkSpeed = LinkSpeedName(text);
+
+        // driver 是指向 /sys/bus/pci/drivers/<名称> 的符号链接
+        char link[512];
+        ssize_t n = readlink((base + "driver").c_str(), link, sizeof(link) - 1);
+        if (n > 0) {
+            link[n] = '\0';
+            const char* slash = strrchr(link, '/');
+            dev.driver = slash ? slash + 1 : link;
+        }
+
+        out->push_back(std::move(dev));
+    }
+    closedir(dir);
+
+    std::sort(out->begin(), out->end(), ByAddress);
+    return true;
+}
+
+#endif
+
+} // namespace pci
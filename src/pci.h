@@ -0,0 +1,41 @@
+#ifndef PCI_H
+#define PCI_H
+
+#include <cstdint>
+#include <functional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+// ========== PCI 设备枚举 ==========
+// Windows 经 SetupAPI，其它平台读取 /sys/bus/pci/devices。只给出数字 ID 与拓扑信息，
+// 名称由调用方查 pci.ids 索引（pciids.h）。不依赖 wxWidgets；字符串为 UTF-8。
+namespace pci
+{
+
+struct DeviceInfo
+{
+    std::string address;          // 总线地址："0000:03:00.0"（sysfs）/ "03:00.0"（SetupAPI）
+    uint16_t vendorId = 0;
+    uint16_t deviceId = 0;
+    uint16_t subVendorId = 0;
+    uint16_t subDeviceId = 0;
+    uint32_t classCode = 0;       // 类 << 16 | 子类 << 8 | 编程接口
+    int linkWidth = 0;            // 当前 PCIe 链路宽度，0 表示未知或非 PCIe
+    int maxLinkWidth = 0;
+    std::string linkSpeed;        // "8.0 GT/s"，未知为空
+    std::string maxLinkSpeed;
+    int numaNode = -1;            // -1 表示未知或单节点
+    std::string driver;           // 内核驱动 / Windows 服务名
+};
+
+// 按地址排序返回；平台接口不可用时返回 false。
+// pace 非空时每读一个设备之前调用（限速，见 lowimpact.h），返回 false 时停止枚举
+bool Enumerate(std::vector<DeviceInfo>* out, std::stop_token stop = {}, const std::function<bool()>& pace = {});
+
+// PCI 规范中的基本类别名（英文，与 pci.ids 一致），索引缺失时的备用名称
+const char* BaseClassName(uint8_t baseClass);
+
+} // namespace pci
+
+#endif // PCI_H
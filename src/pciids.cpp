@@ -0,0 +1,432 @@
+#include "pciids.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace pciids
+{
+
+// ========== 键 ==========
+uint64_t VendorKey(uint16_t vendor)
+{
+    return (uint64_t)vendor << 48 | 0xFFFFFFFFFFFFULL;
+}
+
+uint64_t DeviceKey(uint16_t vendor, uint16_t device)
+{
+    return (uint64_t)vendor << 48 | (uint64_t)device << 32 | 0xFFFFFFFFULL;
+}
+
+uint64_t SubsystemKey(uint16_t vendor, uint16_t device, uint16_t subVendor, uint16_t subDevice)
+{
+    return (uint64_t)vendor << 48 | (uint64_t)device << 32 | (uint64_t)subVendor << 16 | subDevice;
+}
+
+// 类别键：厂商位为 0xFFFF，再按层级区分
+uint64_t ClassKey(uint8_t baseClass)
+{
+    return 0xFFFFULL << 48 | 1ULL << 32 | (uint64_t)baseClass << 16;
+}
+
+uint64_t SubclassKey(uint8_t baseClass, uint8_t subClass)
+{
+    return 0xFFFFULL << 48 | 2ULL << 32 | (uint64_t)baseClass << 16 | (uint64_t)subClass << 8;
+}
+
+uint64_t ProgIfKey(uint8_t baseClass, uint8_t subClass, uint8_t progIf)
+{
+    return 0xFFFFULL << 48 | 3ULL << 32 | (uint64_t)baseClass << 16 | (uint64_t)subClass << 8 | progIf;
+}
+
+// ========== 哈希 ==========
+namespace
+{
+    const char kMagic[4] = { 'M', 'T', 'P', 'I' };
+    const uint32_t kDirectSlot = 0x80000000u;
+    const uint32_t kMaxDisplacement = 1u << 22;   // 单桶搜索上限，超过则换种子重建
+
+    uint64_t Mix(uint64_t x)
+    {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    uint32_t BucketOf(uint64_t key, uint32_t seed, uint32_t bucketCount)
+    {
+        return (uint32_t)(Mix(key ^ seed) % bucketCount);
+    }
+
+    uint32_t SlotOf(uint64_t key, uint32_t seed, uint32_t displacement, uint32_t slotCount)
+    {
+        return (uint32_t)(Mix(key + 0x9E3779B97F4A7C15ULL * ((uint64_t)displacement + 1) + seed) % slotCount);
+    }
+
+    size_t SlotsOffset(uint32_t bucketCount)
+    {
+        size_t end = sizeof(IndexHeader) + sizeof(uint32_t) * (size_t)bucketCount;
+        return (end + 7) & ~(size_t)7;   // 槽位含 u64，按 8 字节对齐
+    }
+
+    // ----- pci.ids 文本解析 -----
+    bool ParseHex(const std::string& line, size_t pos, int digits, unsigned* out)
+    {
+        if (line.size() < pos + digits) return false;
+        unsigned v = 0;
+        for (int i = 0; i < digits; ++i) {
+            char c = line[pos + i];
+            int d = c >= '0' && c <= '9' ? c - '0'
+                  : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                  : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+            if (d < 0) return false;
+            v = v << 4 | (unsigned)d;
+        }
+        *out = v;
+        return true;
+    }
+
+    // ID 之后的名称：跳过分隔空白
+    std::string NameAfter(const std::string& line, size_t pos)
+    {
+        while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t')) ++pos;
+        size_t end = line.size();
+        while (end > pos && (line[end - 1] == ' ' || line[end - 1] == '\r')) --end;
+        return line.substr(pos, end - pos);
+    }
+
+    using Entry = std::pair<uint64_t, std::string>;
+
+    void ParseIds(const std::string& text, std::vector<Entry>* entries)
+    {
+        enum class Scope { None, Vendor, Class };
+        Scope scope = Scope::None;
+        unsigned vendor = 0, device = 0, baseClass = 0, subClass = 0;
+        bool haveDevice = false, haveSubclass = false;
+
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            if (end == std::string::npos) end = text.size();
+            std::string line = text.substr(pos, end - pos);
+            pos = end + 1;
+            if (line.empty() || line[0] == '#') continue;
+
+            size_t depth = 0;
+            while (depth < line.size() && line[depth] == '\t') ++depth;
+            unsigned a, b;
+            if (depth == 0) {
+                haveDevice = haveSubclass = false;
+                if (line.size() > 2 && line[0] == 'C' && line[1] == ' ' && ParseHex(line, 2, 2, &a)) {
+                    scope = Scope::Class;
+                    baseClass = a;
+                    entries->emplace_back(ClassKey((uint8_t)a), NameAfter(line, 4));
+                } else if (ParseHex(line, 0, 4, &a) && line.size() > 4 && line[4] == ' ') {
+                    scope = Scope::Vendor;
+                    vendor = a;
+                    entries->emplace_back(VendorKey((uint16_t)a), NameAfter(line, 4));
+                } else {
+                    scope = Scope::None;   // 无法识别的顶层行：其下的缩进行一并忽略
+                }
+            } else if (scope == Scope::Vendor && depth == 1 && ParseHex(line, 1, 4, &a)) {
+                device = a;
+                haveDevice = true;
+                entries->emplace_back(DeviceKey((uint16_t)vendor, (uint16_t)a), NameAfter(line, 5));
+            } else if (scope == Scope::Vendor && depth == 2 && haveDevice &&
+                       ParseHex(line, 2, 4, &a) && ParseHex(line, 7, 4, &b)) {
+                entries->emplace_back(SubsystemKey((uint16_t)vendor, (uint16_t)device, (uint16_t)a, (uint16_t)b),
+                                      NameAfter(line, 11));
+            } else if (scope == Scope::Class && depth == 1 && ParseHex(line, 1, 2, &a)) {
+                subClass = a;
+                haveSubclass = true;
+                entries->emplace_back(SubclassKey((uint8_t)baseClass, (uint8_t)a), NameAfter(line, 3));
+            } else if (scope == Scope::Class && depth == 2 && haveSubclass && ParseHex(line, 2, 2, &a)) {
+                entries->emplace_back(ProgIfKey((uint8_t)baseClass, (uint8_t)subClass, (uint8_t)a),
+                                      NameAfter(line, 4));
+            }
+        }
+    }
+
+    // ----- 最小完美哈希构造（哈希 + 位移）-----
+    // 键按桶分组，大桶先放：为每个桶搜索位移 d，使桶内所有键落到互不相同的空槽；
+    // 单键桶直接记录一个空槽号。成功返回 true
+    bool Place(const std::vector<Entry>& entries, uint32_t seed, uint32_t bucketCount,
+               std::vector<uint32_t>* displacements, std::vector<uint32_t>* slotOfEntry)
+    {
+        uint32_t slotCount = (uint32_t)entries.size();
+        std::vector<std::vector<uint32_t>> buckets(bucketCount);
+        for (uint32_t i = 0; i < slotCount; ++i) {
+            buckets[BucketOf(entries[i].first, seed, bucketCount)].push_back(i);
+        }
+        std::vector<uint32_t> order(bucketCount);
+        for (uint32_t b = 0; b < bucketCount; ++b) order[b] = b;
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t x, uint32_t y) {
+            return buckets[x].size() > buckets[y].size();
+        });
+
+        displacements->assign(bucketCount, 0);
+        slotOfEntry->assign(slotCount, 0);
+        std::vector<bool> used(slotCount, false);
+        std::vector<uint32_t> trial;
+        uint32_t nextFree = 0;
+
+        for (uint32_t b : order) {
+            const std::vector<uint32_t>& keys = buckets[b];
+            if (keys.empty()) break;   // 已排序，其后均为空桶
+
+            if (keys.size() == 1) {
+                while (used[nextFree]) ++nextFree;
+                used[nextFree] = true;
+                (*slotOfEntry)[keys[0]] = nextFree;
+                (*displacements)[b] = kDirectSlot | nextFree;
+                continue;
+            }
+
+            bool placed = false;
+            for (uint32_t d = 0; d < kMaxDisplacement && !placed; ++d) {
+                trial.clear();
+                for (uint32_t k : keys) {
+                    uint32_t slot = SlotOf(entries[k].first, seed, d, slotCount);
+                    if (used[slot] || std::find(trial.begin(), trial.end(), slot) != trial.end()) break;
+                    trial.push_back(slot);
+                }
+                if (trial.size() != keys.size()) continue;
+                for (size_t i = 0; i < keys.size(); ++i) {
+                    used[trial[i]] = true;
+                    (*slotOfEntry)[keys[i]] = trial[i];
+                }
+                (*displacements)[b] = d;
+                placed = true;
+            }
+            if (!placed) return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    void AppendRaw(std::string& out, const T& value)
+    {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+}
+
+// ========== 构建 ==========
+bool BuildIndex(const std::string& text, std::string* out, std::string* error)
+{
+    std::vector<Entry> parsed;
+    ParseIds(text, &parsed);
+
+    // 重复键保留第一条
+    std::vector<Entry> entries;
+    std::unordered_set<uint64_t> seen;
+    for (Entry& entry : parsed) {
+        if (seen.insert(entry.first).second) entries.push_back(std::move(entry));
+    }
+    if (entries.empty()) {
+        if (error) *error = "no entries found (not a pci.ids file?)";
+        return false;
+    }
+    if (entries.size() >= kDirectSlot) {
+        if (error) *error = "too many entries";
+        return false;
+    }
+
+    uint32_t slotCount = (uint32_t)entries.size();
+    uint32_t bucketCount = (slotCount + 2) / 3;   // 平均每桶 3 个键
+    std::vector<uint32_t> displacements, slotOfEntry;
+    uint32_t seed = 0x5F3759DF;
+    int attempt = 0;
+    while (!Place(entries, seed, bucketCount, &displacements, &slotOfEntry)) {
+        if (++attempt == 16) {
+            if (error) *error = "failed to build perfect hash";
+            return false;
+        }
+        seed = (uint32_t)Mix(seed);
+    }
+
+    std::vector<IndexSlot> slots(slotCount);
+    std::string names;
+    for (uint32_t i = 0; i < slotCount; ++i) {
+        IndexSlot& slot = slots[slotOfEntry[i]];
+        slot.key = entries[i].first;
+        slot.nameOffset = (uint32_t)names.size();
+        slot.nameLength = (uint32_t)entries[i].second.size();
+        names += entries[i].second;
+        names += '\0';   // 映射后的名称可直接当 C 字符串使用
+    }
+
+    IndexHeader header;
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = IndexVersion;
+    header.seed = seed;
+    header.bucketCount = bucketCount;
+    header.slotCount = slotCount;
+    header.namesSize = (uint32_t)names.size();
+
+    out->clear();
+    out->reserve(SlotsOffset(bucketCount) + slots.size() * sizeof(IndexSlot) + names.size());
+    AppendRaw(*out, header);
+    out->append(reinterpret_cast<const char*>(displacements.data()), displacements.size() * sizeof(uint32_t));
+    out->resize(SlotsOffset(bucketCount), '\0');
+    out->append(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(IndexSlot));
+    out->append(names);
+    return true;
+}
+
+// ========== 映射 ==========
+#ifdef _WIN32
+
+struct Index::Impl
+{
+    HANDLE mapping = nullptr;
+    const void* view = nullptr;
+
+    ~Impl()
+    {
+        if (view) UnmapViewOfFile(view);
+        if (mapping) CloseHandle(mapping);
+    }
+};
+
+std::unique_ptr<Index> Index::Open(const std::string& path)
+{
+    int len = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    if (len <= 0) return nullptr;
+    std::wstring wpath(len, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wpath[0], len);
+
+    HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    LARGE_INTEGER size;
+    auto impl = std::make_unique<Impl>();
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        impl->mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (impl->mapping) impl->view = MapViewOfFile(impl->mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    CloseHandle(file);
+    if (!impl->view) return nullptr;
+
+    const char* base = static_cast<const char*>(impl->view);
+    std::unique_ptr<Index> index(new Index(std::move(impl), base, (size_t)size.QuadPart));
+    return index->m_header ? std::move(index) : nullptr;
+}
+
+std::string Index::DefaultPath()
+{
+    wchar_t module[MAX_PATH];
+    DWORD n = GetModuleFileNameW(nullptr, module, MAX_PATH);
+    if (n == 0 || n == MAX_PATH) return "pci_ids.idx";
+    std::wstring path(module, n);
+    size_t slash = path.find_last_of(L"\\/");
+    path = (slash == std::wstring::npos ? std::wstring() : path.substr(0, slash + 1)) + L"pci_ids.idx";
+
+    int len = WideCharToMultiByte(CP_UTF8, 0, path.c_str(), (int)path.size(), nullptr, 0, nullptr, nullptr);
+    std::string out(len > 0 ? len : 0, '\0');
+    if (len > 0) WideCharToMultiByte(CP_UTF8, 0, path.c_str(), (int)path.size(), &out[0], len, nullptr, nullptr);
+    return out;
+}
+
+#else
+
+struct Index::Impl
+{
+    void* view = nullptr;
+    size_t length = 0;
+
+    ~Impl()
+    {
+        if (view) munmap(view, length);
+    }
+};
+
+std::unique_ptr<Index> Index::Open(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    auto impl = std::make_unique<Impl>();
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        impl->length = (size_t)st.st_size;
+        void* view = mmap(nullptr, impl->length, PROT_READ, MAP_SHARED, fd, 0);
+        if (view != MAP_FAILED) impl->view = view;
+    }
+    close(fd);
+    if (!impl->view) return nullptr;
+
+    const char* base = static_cast<const char*>(impl->view);
+    size_t length = impl->length;
+    std::unique_ptr<Index> index(new Index(std::move(impl), base, length));
+    return index->m_header ? std::move(index) : nullptr;
+}
+
+std::string Index::DefaultPath()
+{
+    char exe[4096];
+    ssize_t n = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    if (n <= 0) return "pci_ids.idx";
+    std::string path(exe, (size_t)n);
+    size_t slash = path.rfind('/');
+    return (slash == std::string::npos ? std::string() : path.substr(0, slash + 1)) + "pci_ids.idx";
+}
+
+#endif
+
+// ========== 查询 ==========
+// 构造时校验头部与各区大小；格式不符时 m_header 为空，Open 返回 nullptr
+Index::Index(std::unique_ptr<Impl> impl, const char* base, size_t size)
+    : m_impl(std::move(impl)), m_header(nullptr), m_displacements(nullptr), m_slots(nullptr), m_names(nullptr)
+{
+    if (size < sizeof(IndexHeader)) return;
+    const IndexHeader* header = reinterpret_cast<const IndexHeader*>(base);
+    if (memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != IndexVersion ||
+        header->bucketCount == 0 || header->slotCount == 0) {
+        return;
+    }
+    size_t slotsOffset = SlotsOffset(header->bucketCount);
+    size_t namesOffset = slotsOffset + (size_t)header->slotCount * sizeof(IndexSlot);
+    if (namesOffset + header->namesSize > size) return;
+
+    m_header = header;
+    m_displacements = reinterpret_cast<const uint32_t*>(base + sizeof(IndexHeader));
+    m_slots = reinterpret_cast<const IndexSlot*>(base + slotsOffset);
+    m_names = base + namesOffset;
+}
+
+Index::~Index() = default;
+
+bool Index::Lookup(uint64_t key, const char** name, size_t* length) const
+{
+    if (!m_header) return false;
+    uint32_t d = m_displacements[BucketOf(key, m_header->seed, m_header->bucketCount)];
+    uint32_t slot = (d & kDirectSlot) ? (d & ~kDirectSlot) : SlotOf(key, m_header->seed, d, m_header->slotCount);
+    if (slot >= m_header->slotCount) return false;
+
+    const IndexSlot& s = m_slots[slot];
+    if (s.key != key || (uint64_t)s.nameOffset + s.nameLength > m_header->namesSize) return false;
+    *name = m_names + s.nameOffset;
+    *length = s.nameLength;
+    return true;
+}
+
+std::string Index::Name(uint64_t key) const
+{
+    const char* name;
+    size_t length;
+    return Lookup(key, &name, &length) ? std::string(name, length) : std::string();
+}
+
+} // namespace pciids
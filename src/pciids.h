@@ -0,0 +1,82 @@
+#ifndef PCIIDS_H
+#define PCIIDS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// ========== pci.ids 名称索引 ==========
+// 构建期把 pci.ids 文本数据库（https://pci-ids.ucw.cz）编译为索引文件（见 tools/pciids_compile.cpp），
+// 运行时只读映射该文件：最小完美哈希（哈希 + 位移）定位槽位，一次比较确认键，
+// 查名是 O(1) 且启动时不解析任何文本。索引缺失时调用方只显示数字 ID。
+// 不依赖 wxWidgets；名称为 UTF-8。
+namespace pciids
+{
+
+// ===== 键 =====
+// 0xFFFF 不是合法的厂商/设备 ID，用作"该层不存在"的占位，四类键互不冲突
+uint64_t VendorKey(uint16_t vendor);
+uint64_t DeviceKey(uint16_t vendor, uint16_t device);
+uint64_t SubsystemKey(uint16_t vendor, uint16_t device, uint16_t subVendor, uint16_t subDevice);
+uint64_t ClassKey(uint8_t baseClass);
+uint64_t SubclassKey(uint8_t baseClass, uint8_t subClass);
+uint64_t ProgIfKey(uint8_t baseClass, uint8_t subClass, uint8_t progIf);
+
+// ===== 索引文件格式（小端）=====
+// 头部 | u32 位移[bucketCount] | 槽位[slotCount] | 名称区
+// 位移最高位置位时，低 31 位直接是槽位号（单键桶无需搜索）
+struct IndexHeader
+{
+    char magic[4];          // "MTPI"
+    uint32_t version;
+    uint32_t seed;
+    uint32_t bucketCount;
+    uint32_t slotCount;     // = 条目数（最小完美哈希）
+    uint32_t namesSize;
+};
+
+struct IndexSlot
+{
+    uint64_t key;
+    uint32_t nameOffset;    // 相对名称区
+    uint32_t nameLength;    // 不含结尾 NUL
+};
+
+const uint32_t IndexVersion = 1;
+
+// 解析 pci.ids 文本并生成索引文件内容；失败时返回 false 并给出原因
+bool BuildIndex(const std::string& text, std::string* out, std::string* error);
+
+// ===== 运行时查询 =====
+class Index
+{
+public:
+    ~Index();
+    Index(const Index&) = delete;
+    Index& operator=(const Index&) = delete;
+
+    static std::unique_ptr<Index> Open(const std::string& path);
+    // 可执行文件同目录下的 pci_ids.idx
+    static std::string DefaultPath();
+
+    // 找到时返回 true；name 指向映射内存（以 NUL 结尾），随 Index 一同有效
+    bool Lookup(uint64_t key, const char** name, size_t* length) const;
+    std::string Name(uint64_t key) const;   // 未找到返回空串
+
+    size_t Size() const { return m_header ? m_header->slotCount : 0; }
+
+private:
+    struct Impl;
+    Index(std::unique_ptr<Impl> impl, const char* base, size_t size);
+
+    std::unique_ptr<Impl> m_impl;
+    const IndexHeader* m_header;
+    const uint32_t* m_displacements;
+    const IndexSlot* m_slots;
+    const char* m_names;
+};
+
+} // namespace pciids
+
+#endif // PCIIDS_H
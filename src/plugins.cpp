@@ -0,0 +1,310 @@
+#include "plugins.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <utility>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <dirent.h>
+    #include <dlfcn.h>
+    #include <unistd.h>
+#endif
+
+namespace plugins
+{
+
+namespace
+{
+    // 节名只含字母、数字、下划线：同时用作键名前缀与界面分组
+    bool ValidSection(const char* section)
+    {
+        if (!section || !*section) return false;
+        size_t len = 0;
+        for (const char* p = section; *p; ++p, ++len) {
+            char c = *p;
+            bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+            if (!ok || len >= 64) return false;
+        }
+        return true;
+    }
+
+    // 校验描述并展开探测；path 只用于错误信息
+    void AddPlugin(const std::string& path, const mt_plugin_info* info, std::vector<Probe>* probes,
+                   std::vector<std::string>* errors)
+    {
+        if (!info) {
+            errors->push_back(path + ": plugin declined host ABI version");
+            return;
+        }
+        // 新版插件在结构末尾追加的字段这里读不到，不影响已知字段
+        if (info->abi_version < 1 || info->abi_version > MT_PLUGIN_ABI_VERSION ||
+            info->struct_size < sizeof(mt_plugin_info) || info->probe_size < sizeof(mt_plugin_probe)) {
+            errors->push_back(path + ": unsupported plugin ABI version " + std::to_string(info->abi_version));
+            return;
+        }
+        std::string name = info->name && *info->name ? info->name : path;
+
+        const char* base = reinterpret_cast<const char*>(info->probes);
+        for (size_t i = 0; i < info->probe_count && base; ++i) {
+            const mt_plugin_probe* p = reinterpret_cast<const mt_plugin_probe*>(base + i * info->probe_size);
+            if (!ValidSection(p->section) || !p->collect) {
+                errors->push_back(name + ": probe " + std::to_string(i) + " has an invalid section or no collect function");
+                continue;
+            }
+            bool duplicate = std::any_of(probes->begin(), probes->end(),
+                                         [p](const Probe& other) { return other.section == p->section; });
+            if (duplicate) {
+                errors->push_back(name + ": section " + p->section + " is already provided by another plugin");
+                continue;
+            }
+
+            Probe probe;
+            probe.plugin = name;
+            probe.path = path;
+            probe.section = p->section;
+            probe.isVolatile = (p->flags & MT_PLUGIN_VOLATILE) != 0;
+            probe.forFingerprint = !probe.isVolatile && (p->flags & MT_PLUGIN_FINGERPRINT) != 0;
+            probe.costMs = p->cost_ms;
+            probe.collect = p->collect;
+            probe.user = p->user;
+            probes->push_back(std::move(probe));
+        }
+    }
+
+    // ----- 单次运行的状态：宿主回调的 context -----
+    struct RunState
+    {
+        std::vector<std::pair<std::string, std::string>> fields;
+        const std::function<bool()>* cancelled;
+        bool truncated = false;
+    };
+
+    void Emit(void* context, const char* key, const char* value)
+    {
+        RunState* state = static_cast<RunState*>(context);
+        if (!key || !*key) return;
+        if (strnlen(key, kMaxKeyLength + 1) > kMaxKeyLength) {
+            state->truncated = true;
+            return;
+        }
+        std::string text = value ? std::string(value, strnlen(value, kMaxValueLength + 1)) : std::string();
+        if (text.size() > kMaxValueLength) {
+            text.resize(kMaxValueLength);
+            state->truncated = true;
+        }
+
+        for (auto& field : state->fields) {
+            if (field.first == key) {
+                field.second = std::move(text);
+                return;
+            }
+        }
+        if (state->fields.size() >= kMaxFields) {
+            state->truncated = true;
+            return;
+        }
+        state->fields.emplace_back(key, std::move(text));
+    }
+
+    int Cancelled(void* context)
+    {
+        const RunState* state = static_cast<const RunState*>(context);
+        return *state->cancelled && (*state->cancelled)() ? 1 : 0;
+    }
+
+    struct LoadState
+    {
+        std::vector<Probe> probes;
+        std::vector<std::string> errors;
+    };
+
+    std::mutex g_directoryMutex;
+    std::string g_directory;    // 空 = 不加载插件，受 g_directoryMutex 保护
+    bool g_loaded = false;      // 已按 g_directory 加载，之后不能再改
+
+    const LoadState& ConfiguredState()
+    {
+        static const LoadState state = [] {
+            std::string dir;
+            {
+                std::lock_guard<std::mutex> lock(g_directoryMutex);
+                dir = g_directory;
+                g_loaded = true;
+            }
+            LoadState s;
+            if (!dir.empty()) LoadDirectory(dir, &s.probes, &s.errors);
+            return s;
+        }();
+        return state;
+    }
+}
+
+// ========== 平台相关：枚举目录、加载动态库 ==========
+#ifdef _WIN32
+
+namespace
+{
+    std::wstring Widen(const std::string& str)
+    {
+        int n = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0);
+        if (n <= 1) return std::wstring();
+        std::wstring out(n - 1, L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, &out[0], n);
+        return out;
+    }
+
+    std::string Narrow(const std::wstring& str)
+    {
+        int n = WideCharToMultiByte(CP_UTF8, 0, str.c_str(), (int)str.size(), nullptr, 0, nullptr, nullptr);
+        std::string out(n > 0 ? n : 0, '\0');
+        if (n > 0) WideCharToMultiByte(CP_UTF8, 0, str.c_str(), (int)str.size(), &out[0], n, nullptr, nullptr);
+        return out;
+    }
+}
+
+void LoadDirectory(const std::string& dir, std::vector<Probe>* probes, std::vector<std::string>* errors)
+{
+    std::wstring wdir = Widen(dir);
+    if (wdir.empty()) return;
+    if (wdir.back() != L'\\' && wdir.back() != L'/') wdir += L'\\';
+
+    std::vector<std::wstring> files;
+    WIN32_FIND_DATAW data;
+    HANDLE find = FindFirstFileW((wdir + L"*.dll").c_str(), &data);
+    if (find == INVALID_HANDLE_VALUE) return;   // 没有插件目录是常态
+    do {
+        if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) files.push_back(wdir + data.cFileName);
+    } while (FindNextFileW(find, &data));
+    FindClose(find);
+    std::sort(files.begin(), files.end());
+
+    for (const std::wstring& file : files) {
+        std::string path = Narrow(file);
+        // 插件依赖的其它 DLL 从插件所在目录查找
+        HMODULE module = LoadLibraryExW(file.c_str(), nullptr, LOAD_WITH_ALTERED_SEARCH_PATH);
+        if (!module) {
+            errors->push_back(path + ": LoadLibrary failed (error " + std::to_string(GetLastError()) + ")");
+            continue;
+        }
+        auto entry = reinterpret_cast<mt_plugin_entry_fn>(reinterpret_cast<void*>(GetProcAddress(module, MT_PLUGIN_ENTRY)));
+        if (!entry) {
+            errors->push_back(path + ": missing " MT_PLUGIN_ENTRY);
+            FreeLibrary(module);
+            continue;
+        }
+        size_t before = probes->size();
+        AddPlugin(path, entry(MT_PLUGIN_ABI_VERSION), probes, errors);
+        if (probes->size() == before) FreeLibrary(module);   // 没有可用探测的插件不必常驻
+    }
+}
+
+std::string DefaultDirectory()
+{
+    // 按本函数的地址找到所在模块：核心编译为 DLL 时是 DLL 的目录，而不是宿主可执行文件的目录
+    HMODULE self = nullptr;
+    if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                            reinterpret_cast<LPCWSTR>(&DefaultDirectory), &self)) {
+        return "plugins";
+    }
+    wchar_t module[MAX_PATH];
+    DWORD n = GetModuleFileNameW(self, module, MAX_PATH);
+    if (n == 0 || n == MAX_PATH) return "plugins";
+    std::wstring path(module, n);
+    size_t slash = path.find_last_of(L"\\/");
+    return Narrow((slash == std::wstring::npos ? std::wstring() : path.substr(0, slash + 1)) + L"plugins");
+}
+
+#else
+
+void LoadDirectory(const std::string& dir, std::vector<Probe>* probes, std::vector<std::string>* errors)
+{
+    DIR* d = opendir(dir.c_str());
+    if (!d) return;   // 没有插件目录是常态
+    std::vector<std::string> files;
+    while (struct dirent* entry = readdir(d)) {
+        std::string name = entry->d_name;
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, ".so") == 0) files.push_back(dir + "/" + name);
+    }
+    closedir(d);
+    std::sort(files.begin(), files.end());
+
+    for (const std::string& path : files) {
+        // RTLD_LOCAL：各插件的符号互不干扰
+        void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!handle) {
+            const char* err = dlerror();
+            errors->push_back(path + ": " + (err ? err : "dlopen failed"));
+            continue;
+        }
+        auto entry = reinterpret_cast<mt_plugin_entry_fn>(dlsym(handle, MT_PLUGIN_ENTRY));
+        if (!entry) {
+            errors->push_back(path + ": missing " MT_PLUGIN_ENTRY);
+            dlclose(handle);
+            continue;
+        }
+        size_t before = probes->size();
+        AddPlugin(path, entry(MT_PLUGIN_ABI_VERSION), probes, errors);
+        if (probes->size() == before) dlclose(handle);   // 没有可用探测的插件不必常驻
+    }
+}
+
+std::string DefaultDirectory()
+{
+    // 按本函数的地址找到所在模块（可执行文件或共享库）
+    Dl_info info;
+    if (!dladdr(reinterpret_cast<void*>(&DefaultDirectory), &info) || !info.dli_fname) return "plugins";
+    std::string path = info.dli_fname;
+    // 主程序的 dli_fname 可能只是 argv[0]：换成 /proc/self/exe 的绝对路径
+    if (path.empty() || path[0] != '/') {
+        char exe[4096];
+        ssize_t n = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+        if (n <= 0) return "plugins";
+        path.assign(exe, (size_t)n);
+    }
+    size_t slash = path.rfind('/');
+    return (slash == std::string::npos ? std::string() : path.substr(0, slash + 1)) + "plugins";
+}
+
+#endif
+
+// ========== 已配置的目录 ==========
+bool SetDirectory(const std::string& dir)
+{
+    std::lock_guard<std::mutex> lock(g_directoryMutex);
+    if (g_loaded) return false;
+    g_directory = dir;
+    return true;
+}
+
+const std::vector<Probe>& Loaded()
+{
+    return ConfiguredState().probes;
+}
+
+const std::vector<std::string>& LoadErrors()
+{
+    return ConfiguredState().errors;
+}
+
+// ========== 运行 ==========
+int Run(const Probe& probe, const FieldSink& sink, const std::function<bool()>& cancelled)
+{
+    RunState state;
+    state.cancelled = &cancelled;
+
+    mt_plugin_host host;
+    host.struct_size = sizeof(host);
+    host.context = &state;
+    host.emit = Emit;
+    host.cancelled = Cancelled;
+
+    int rc = probe.collect(probe.user, &host);
+    if (rc < 0) return MT_PLUGIN_FAILED;
+
+    for (const auto& field : state.fields) sink(field.first, field.second);
+    return rc == MT_PLUGIN_OK && !state.truncated ? MT_PLUGIN_OK : MT_PLUGIN_FALLBACK;
+}
+
+} // namespace plugins
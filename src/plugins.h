@@ -0,0 +1,54 @@
+#ifndef PLUGINS_H
+#define PLUGINS_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "mt_plugin.h"
+
+// ========== 探测插件 ==========
+// 从插件目录加载实现 mt_plugin.h 的动态库（Windows LoadLibrary，其它平台 dlopen），
+// 校验 ABI 版本与描述后展开为探测列表。库加载后不卸载。不依赖 wxWidgets；字符串为 UTF-8。
+namespace plugins
+{
+
+struct Probe
+{
+    std::string plugin;           // 插件名
+    std::string path;             // 动态库路径
+    std::string section;          // 节名，即 ProbeReport::Section
+    bool isVolatile = false;
+    bool forFingerprint = false;  // 已排除易变探测
+    unsigned costMs = 0;
+    int (*collect)(void* user, const mt_plugin_host* host) = nullptr;
+    void* user = nullptr;
+};
+
+// 单个探测最多保留的字段数与键长；超出的写入丢弃，结果记为 MT_PLUGIN_FALLBACK
+constexpr size_t kMaxFields = 256;
+constexpr size_t kMaxKeyLength = 128;
+constexpr size_t kMaxValueLength = 4096;
+
+// 加载 dir 下全部插件（按文件名排序），追加到 *probes；不合规的插件与探测跳过，原因写入 *errors
+void LoadDirectory(const std::string& dir, std::vector<Probe>* probes, std::vector<std::string>* errors);
+
+// 本模块（包含这段代码的可执行文件或动态库）旁的 plugins 目录，而不是宿主进程的可执行文件目录
+std::string DefaultDirectory();
+
+// 设置要加载的插件目录，空串表示不加载。默认不加载：嵌入核心库的宿主未必信任自己所在的目录，
+// 由界面、守护进程或 mt_set_plugin_dir 显式开启。须在首次 Loaded() 之前调用，之后返回 false
+bool SetDirectory(const std::string& dir);
+
+// 进程内首次调用时加载 SetDirectory 设置的目录，之后返回同一份结果；可多线程调用
+const std::vector<Probe>& Loaded();
+const std::vector<std::string>& LoadErrors();
+
+// 运行一个探测：字段按首次写入的顺序交给 sink（同名键取最后一次的值），返回 MT_PLUGIN_* 结果码。
+// 失败时不调用 sink；cancelled 返回 true 时插件应尽快返回
+using FieldSink = std::function<void(const std::string& key, const std::string& value)>;
+int Run(const Probe& probe, const FieldSink& sink, const std::function<bool()>& cancelled);
+
+} // namespace plugins
+
+#endif // PLUGINS_H
@@ -0,0 +1,674 @@
+#include "procs.h"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/resource.h>
+#endif
+
+namespace procs
+{
+
+namespace
+{
+    bool ByPid(const Process& a, const Process& b)
+    {
+        return a.pid < b.pid;
+    }
+
+    // 计数器回绕或 pid 复用时不给出负速率
+    double Rate(uint64_t now, uint64_t before, double seconds)
+    {
+        return now >= before && seconds > 0 ? (double)(now - before) / seconds : 0;
+    }
+}
+
+#ifdef _WIN32
+
+// ========== Windows：EnumProcesses + 常驻句柄 ==========
+namespace
+{
+    struct Entry
+    {
+        HANDLE handle = nullptr;   // 持有句柄期间该 pid 不会被复用
+        bool denied = false;       // OpenProcess 失败，pid 消失前不再重试
+        bool fresh = true;         // 还没有上一次的计数，本周期不计算速率
+        std::string name;
+        uint64_t cpu = 0;          // 100ns
+        uint64_t read = 0;
+        uint64_t write = 0;
+        uint32_t seen = 0;
+    };
+
+    uint64_t FileTime64(const FILETIME& ft)
+    {
+        return (uint64_t)ft.dwHighDateTime << 32 | ft.dwLowDateTime;
+    }
+
+    // "C:\Windows\System32\svchost.exe" → "svchost.exe"
+    std::string ImageName(HANDLE process)
+    {
+        wchar_t path[MAX_PATH];
+        DWORD size = MAX_PATH;
+        if (!QueryFullProcessImageNameW(process, 0, path, &size)) return std::string();
+        const wchar_t* base = wcsrchr(path, L'\\');
+        base = base ? base + 1 : path;
+        int n = WideCharToMultiByte(CP_UTF8, 0, base, -1, nullptr, 0, nullptr, nullptr);
+        if (n <= 1) return std::string();
+        std::string out(n - 1, '\0');
+        WideCharToMultiByte(CP_UTF8, 0, base, -1, &out[0], n, nullptr, nullptr);
+        return out;
+    }
+}
+
+struct Monitor::Impl
+{
+    std::vector<DWORD> pids;
+    std::unordered_map<uint32_t, Entry> entries;
+    uint32_t tick = 0;
+    std::chrono::steady_clock::time_point last;
+
+    ~Impl()
+    {
+        for (auto& item : entries) {
+            if (item.second.handle) CloseHandle(item.second.handle);
+        }
+    }
+};
+
+bool Monitor::Sample()
+{
+    Impl& impl = *m_impl;
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = impl.tick == 0 ? 0 : std::chrono::duration<double>(now - impl.last).count();
+    impl.last = now;
+    ++impl.tick;
+
+    // 缓冲被填满说明可能还有更多进程，扩大后重取
+    DWORD needed = 0;
+    if (impl.pids.empty()) impl.pids.resize(1024);
+    for (;;) {
+        DWORD bytes = (DWORD)(impl.pids.size() * sizeof(DWORD));
+        if (!EnumProcesses(impl.pids.data(), bytes, &needed)) return false;
+        if (needed < bytes) break;
+        impl.pids.resize(impl.pids.size() * 2);
+    }
+    size_t count = needed / sizeof(DWORD);
+
+    auto list = std::make_shared<ProcessList>();
+    list->reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t pid = impl.pids[i];
+        if (pid == 0) continue;   // 系统空闲进程
+        Entry& entry = impl.entries[pid];
+        entry.seen = impl.tick;
+
+        // 句柄对应的进程已退出而 pid 又出现：是复用了该 pid 的新进程
+        if (entry.handle && WaitForSingleObject(entry.handle, 0) == WAIT_OBJECT_0) {
+            CloseHandle(entry.handle);
+            entry = Entry();
+            entry.seen = impl.tick;
+        }
+        if (!entry.handle && !entry.denied) {
+            entry.handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | SYNCHRONIZE, FALSE, pid);
+            entry.denied = entry.handle == nullptr;
+            if (entry.handle) entry.name = ImageName(entry.handle);
+        }
+
+        Process p;
+        p.pid = pid;
+        p.name = entry.name;
+        FILETIME created, exited, kernel, user;
+        if (entry.handle && GetProcessTimes(entry.handle, &created, &exited, &kernel, &user)) {
+            uint64_t cpu = FileTime64(kernel) + FileTime64(user);
+            p.known = true;
+            p.cpuTimeMs = cpu / 10000;
+            if (!entry.fresh) p.cpuPercent = Rate(cpu, entry.cpu, elapsed) / 1e7 * 100;
+            entry.cpu = cpu;
+
+            PROCESS_MEMORY_COUNTERS memory;
+            if (GetProcessMemoryInfo(entry.handle, &memory, sizeof(memory))) p.rssBytes = memory.WorkingSetSize;
+
+            // 读写计数包含文件、网络与设备 I/O
+            IO_COUNTERS io;
+            if (GetProcessIoCounters(entry.handle, &io)) {
+                p.ioKnown = true;
+                p.readBytes = io.ReadTransferCount;
+                p.writeBytes = io.WriteTransferCount;
+                if (!entry.fresh) {
+                    p.readRate = Rate(p.readBytes, entry.read, elapsed);
+                    p.writeRate = Rate(p.writeBytes, entry.write, elapsed);
+                }
+                entry.read = p.readBytes;
+                entry.write = p.writeBytes;
+            }
+            entry.fresh = false;
+        }
+        list->push_back(std::move(p));
+    }
+
+    // 本周期未出现的 pid 已退出
+    for (auto it = impl.entries.begin(); it != impl.entries.end();) {
+        if (it->second.seen == impl.tick) {
+            ++it;
+            continue;
+        }
+        if (it->second.handle) CloseHandle(it->second.handle);
+        it = impl.entries.erase(it);
+    }
+
+    std::sort(list->begin(), list->end(), ByPid);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_latest = std::move(list);
+    return true;
+}
+
+#else
+
+// ========== 其它平台：/proc ==========
+namespace
+{
+    // 空闲进程的读写计数最多隔这么多个周期读取一次
+    const uint32_t kIoRefreshTicks = 5;
+
+    // 读 stat 是每周期的主要开销（内核为每个进程汇总全部线程的时间），而多数进程长期空闲：
+    // CPU 时间未变的进程读取间隔逐次翻倍，最多隔这么多个周期；一旦变化恢复每周期读取。
+    // 开始忙的进程由下面的全系统核对兜底，间隔只影响空闲进程内存读数的新鲜度
+    const uint32_t kMaxStatInterval = 16;
+
+    // 跳过的进程可能刚开始忙：全系统 CPU 时间（/proc/stat）比本周期读到的各进程增量之和
+    // 多出这么多（单个逻辑处理器的比例）时，下一周期读全部进程
+    const double kUnaccountedShare = 0.05;
+    // 两者不是同一时刻读取的：忙碌进程的增量与全系统计数之间有采样偏差，按已读增量的比例放宽
+    const double kSampleSkewShare = 0.15;
+
+    struct Entry
+    {
+        int statFd = -1;           // 常驻描述符，超出预算时为 -1（每周期打开再关闭）
+        int ioFd = -1;
+        bool ioDenied = false;     // /proc/[pid]/io 需要同一用户或 CAP_SYS_PTRACE
+        bool ioRead = false;       // 读到过读写计数，read / write 有效
+        bool fresh = true;         // 还没有上一次的计数，本周期不计算速率
+        uint64_t startTime = 0;    // 启动时刻（时钟滴答），用于识别 pid 复用
+        uint64_t cpuTicks = 0;
+        uint64_t rssPages = 0;
+        uint32_t statTick = 0;     // 上次读取 stat 的周期
+        uint32_t statInterval = 1; // 当前读取间隔（周期数）
+        std::chrono::steady_clock::time_point statTime;
+        uint64_t read = 0;
+        uint64_t write = 0;
+        uint64_t ioCpuTicks = 0;   // 上次读取读写计数时的 CPU 时间
+        uint32_t ioTick = 0;
+        std::chrono::steady_clock::time_point ioTime;
+        char comm[16] = {};        // TASK_COMM_LEN
+        uint32_t seen = 0;
+    };
+
+    // "/proc/<pid>/<file>"，写入调用方的栈缓冲
+    void ProcPath(char* out, uint32_t pid, const char* file)
+    {
+        char digits[10];
+        int n = 0;
+        do {
+            digits[n++] = (char)('0' + pid % 10);
+            pid /= 10;
+        } while (pid);
+        memcpy(out, "/proc/", 6);
+        out += 6;
+        while (n) *out++ = digits[--n];
+        *out++ = '/';
+        strcpy(out, file);
+    }
+
+    bool ParsePid(const char* name, uint32_t* pid)
+    {
+        uint32_t v = 0;
+        if (*name == '\0') return false;
+        for (; *name; ++name) {
+            if (*name < '0' || *name > '9') return false;
+            v = v * 10 + (uint32_t)(*name - '0');
+        }
+        *pid = v;
+        return true;
+    }
+
+    uint64_t ParseUnsigned(const char*& p, const char* end)
+    {
+        uint64_t v = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p) v = v * 10 + (uint64_t)(*p - '0');
+        return v;
+    }
+
+    // "pid (comm) state ppid ..."：comm 可含空格与括号，取最后一个 ')'；
+    // 之后从第 3 个字段开始计数，取 utime(14)、stime(15)、starttime(22)、rss(24)
+    bool ParseStat(const char* buf, size_t size, Entry& entry, uint64_t* cpuTicks, uint64_t* startTime,
+                   uint64_t* rssPages)
+    {
+        const char* end = buf + size;
+        const char* open = (const char*)memchr(buf, '(', size);
+        const char* close = end;
+        while (close > buf && close[-1] != ')') --close;
+        if (!open || close <= open + 1) return false;
+        size_t commLen = std::min<size_t>((size_t)(close - 1 - (open + 1)), sizeof(entry.comm) - 1);
+        memcpy(entry.comm, open + 1, commLen);
+        entry.comm[commLen] = '\0';
+
+        uint64_t utime = 0, stime = 0;
+        const char* p = close;
+        int field = 3;
+        for (; p < end && field <= 24; ++field) {
+            while (p < end && *p == ' ') ++p;
+            switch (field) {
+                case 14: utime = ParseUnsigned(p, end); break;
+                case 15: stime = ParseUnsigned(p, end); break;
+                case 22: *startTime = ParseUnsigned(p, end); break;
+                case 24: *rssPages = ParseUnsigned(p, end); break;
+                default: break;
+            }
+            while (p < end && *p != ' ') ++p;
+        }
+        *cpuTicks = utime + stime;
+        return field > 24;
+    }
+
+    // "0.00 0.01 0.05 1/5123 45678"：任务总数（含线程）与最近分配的 pid
+    bool ParseLoadavg(const char* buf, size_t size, uint64_t* tasks, uint64_t* lastPid)
+    {
+        const char* end = buf + size;
+        const char* slash = (const char*)memchr(buf, '/', size);
+        if (!slash) return false;
+        const char* p = slash + 1;
+        *tasks = ParseUnsigned(p, end);
+        while (p < end && *p == ' ') ++p;
+        *lastPid = ParseUnsigned(p, end);
+        return true;
+    }
+
+    // "cpu  user nice system idle ..."：返回 user + nice + system（时钟滴答）
+    bool ParseSystemStat(const char* buf, size_t size, uint64_t* busyTicks)
+    {
+        const char* end = buf + size;
+        if (size < 4 || memcmp(buf, "cpu ", 4) != 0) return false;
+        const char* p = buf + 4;
+        uint64_t busy = 0;
+        for (int field = 0; field < 3; ++field) {
+            while (p < end && *p == ' ') ++p;
+            busy += ParseUnsigned(p, end);
+        }
+        *busyTicks = busy;
+        return true;
+    }
+
+    // "...\nread_bytes: 123\nwrite_bytes: 456\ncancelled_write_bytes: ..."
+    bool ParseIo(const char* buf, size_t size, uint64_t* read, uint64_t* write)
+    {
+        std::string_view text(buf, size);
+        size_t r = text.find("\nread_bytes: ");
+        size_t w = text.find("\nwrite_bytes: ");
+        if (r == std::string_view::npos || w == std::string_view::npos) return false;
+        const char* p = buf + r + 13;
+        *read = ParseUnsigned(p, buf + size);
+        p = buf + w + 14;
+        *write = ParseUnsigned(p, buf + size);
+        return true;
+    }
+}
+
+struct Monitor::Impl
+{
+    DIR* proc = nullptr;       // 保持打开，需要列目录时 rewinddir
+    int systemStatFd = -1;     // /proc/stat
+    int loadavgFd = -1;        // /proc/loadavg
+    // 列 /proc 本身每个条目约 1 µs，数千进程时与读 stat 相当：任务总数与最近分配的 pid 都未变时
+    // 没有进程创建或退出，沿用上次列出的 pid
+    std::vector<uint32_t> pids;
+    bool pidsValid = false;
+    uint64_t tasks = 0;
+    uint64_t lastPid = 0;
+    bool lastPidKnown = false; // 上一周期读到了 lastPid
+    std::unordered_map<uint32_t, Entry> entries;
+    uint32_t tick = 0;
+    std::chrono::steady_clock::time_point last;
+    size_t openFds = 0;
+    size_t fdBudget = 0;       // 常驻描述符上限，留出余量给进程的其它用途
+    double clockTicks = 100;
+    uint64_t pageSize = 4096;
+    uint64_t systemBusy = 0;   // 上一周期的全系统忙碌时间（时钟滴答），0 表示还没有
+    bool fullScan = true;      // 本周期读取全部进程
+
+    // 界面提示的副本，版本变化时才从 Monitor 复制
+    std::vector<uint32_t> visible;
+    bool ioForAll = true;
+    uint32_t hintVersion = 0;
+
+    // 已发布的列表；界面换用更新的列表后只剩这里持有，下一周期清空复用，不再每周期分配
+    std::shared_ptr<ProcessList> published;
+    std::shared_ptr<ProcessList> spare;
+
+    Impl()
+    {
+        rlimit limit;
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+            fdBudget = limit.rlim_cur > 512 ? (size_t)limit.rlim_cur - 512 : 0;
+        } else {
+            fdBudget = 16384;
+        }
+        long ticks = sysconf(_SC_CLK_TCK);
+        long page = sysconf(_SC_PAGESIZE);
+        if (ticks > 0) clockTicks = (double)ticks;
+        if (page > 0) pageSize = (uint64_t)page;
+    }
+
+    ~Impl()
+    {
+        for (auto& item : entries) release(item.second);
+        if (proc) closedir(proc);
+        if (systemStatFd >= 0) close(systemStatFd);
+        if (loadavgFd >= 0) close(loadavgFd);
+    }
+
+    void release(Entry& entry)
+    {
+        if (entry.statFd >= 0) {
+            close(entry.statFd);
+            --openFds;
+        }
+        if (entry.ioFd >= 0) {
+            close(entry.ioFd);
+            --openFds;
+        }
+        entry.statFd = entry.ioFd = -1;
+    }
+
+    // 读 /proc/<pid>/<file>：有常驻描述符时 pread；失败（进程已退出或 pid 被复用）则重新打开。
+    // 新打开的描述符在预算内保留，否则读完即关
+    ssize_t read(uint32_t pid, const char* file, int* fd, char* buf, size_t size)
+    {
+        if (*fd >= 0) {
+            ssize_t n = pread(*fd, buf, size, 0);
+            if (n > 0) return n;
+            close(*fd);
+            *fd = -1;
+            --openFds;
+        }
+        char path[32];
+        ProcPath(path, pid, file);
+        int f = open(path, O_RDONLY | O_CLOEXEC);
+        if (f < 0) return -1;
+        ssize_t n = pread(f, buf, size, 0);
+        if (n > 0 && openFds < fdBudget) {
+            *fd = f;
+            ++openFds;
+        } else {
+            close(f);
+        }
+        return n;
+    }
+};
+
+bool Monitor::Sample()
+{
+    Impl& impl = *m_impl;
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = impl.tick == 0 ? 0 : std::chrono::duration<double>(now - impl.last).count();
+    impl.last = now;
+    ++impl.tick;
+
+    char buf[1024];
+    uint64_t tasks = 0, lastPid = 0;
+    bool haveLoadavg = false;
+    if (impl.loadavgFd < 0) impl.loadavgFd = open("/proc/loadavg", O_RDONLY | O_CLOEXEC);
+    if (impl.loadavgFd >= 0) {
+        ssize_t n = pread(impl.loadavgFd, buf, sizeof(buf), 0);
+        haveLoadavg = n > 0 && ParseLoadavg(buf, (size_t)n, &tasks, &lastPid);
+    }
+    bool listDir = !(impl.pidsValid && haveLoadavg && tasks == impl.tasks && lastPid == impl.lastPid);
+    // pid 按升序循环分配：上一周期以来新分配的 pid 都在 (上次 last_pid, 本次 last_pid] 区间内（可能绕回）。
+    // 只有这些 pid 可能已换成另一个进程，跳过读取的空闲进程落在区间内时须重读 stat 核对启动时刻
+    bool rangeKnown = haveLoadavg && impl.lastPidKnown;
+    uint64_t allocatedAfter = impl.lastPid;
+    auto mayBeReused = [&](uint32_t pid) {
+        if (!rangeKnown) return true;
+        if (lastPid == allocatedAfter) return false;
+        return lastPid > allocatedAfter ? pid > allocatedAfter && pid <= lastPid
+                                        : pid > allocatedAfter || pid <= lastPid;
+    };
+    impl.tasks = tasks;
+    impl.lastPid = lastPid;
+    impl.lastPidKnown = haveLoadavg;
+    if (listDir) {
+        if (impl.proc) {
+            rewinddir(impl.proc);
+        } else if (!(impl.proc = opendir("/proc"))) {
+            return false;
+        }
+        impl.pids.clear();
+    }
+    impl.pidsValid = haveLoadavg;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (impl.hintVersion != m_hintVersion) {
+            impl.visible = m_visible;
+            impl.ioForAll = m_ioForAll;
+            impl.hintVersion = m_hintVersion;
+        }
+    }
+
+    std::shared_ptr<ProcessList> list;
+    if (impl.spare && impl.spare.use_count() == 1) {
+        list = std::move(impl.spare);
+        list->clear();
+    } else {
+        list = std::make_shared<ProcessList>();
+        list->reserve(impl.entries.size() + 64);
+    }
+
+    uint64_t systemBusy = 0;
+    bool haveSystem = false;
+    if (impl.systemStatFd < 0) impl.systemStatFd = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+    if (impl.systemStatFd >= 0) {
+        ssize_t n = pread(impl.systemStatFd, buf, sizeof(buf), 0);
+        haveSystem = n > 0 && ParseSystemStat(buf, (size_t)n, &systemBusy);
+    }
+
+    uint64_t accounted = 0;    // 本周期读到的各进程 CPU 增量之和
+    size_t next = 0;
+    for (;;) {
+        uint32_t pid;
+        if (listDir) {
+            dirent* dirEntry = readdir(impl.proc);
+            if (!dirEntry) break;
+            if (!ParsePid(dirEntry->d_name, &pid)) continue;
+            impl.pids.push_back(pid);
+        } else {
+            if (next == impl.pids.size()) break;
+            pid = impl.pids[next++];
+        }
+        auto [it, inserted] = impl.entries.try_emplace(pid);
+        Entry& entry = it->second;
+        bool focused = std::binary_search(impl.visible.begin(), impl.visible.end(), pid);
+        bool ioWanted = impl.ioForAll || focused;
+
+        Process p;
+        p.pid = pid;
+        p.known = true;
+
+        // 空闲进程未到读取周期：沿用上次读数，期间的 CPU 时间在下次读取时按实际间隔计入
+        if (!entry.fresh && !focused && !impl.fullScan && impl.tick - entry.statTick < entry.statInterval &&
+            !mayBeReused(pid)) {
+            entry.seen = impl.tick;
+            p.name = entry.comm;
+            p.cpuTimeMs = (uint64_t)(entry.cpuTicks * 1000 / impl.clockTicks);
+            p.rssBytes = entry.rssPages * impl.pageSize;
+            if (ioWanted && entry.ioRead) {
+                p.ioKnown = true;
+                p.readBytes = entry.read;
+                p.writeBytes = entry.write;
+            }
+            list->push_back(std::move(p));
+            continue;
+        }
+
+        uint64_t cpuTicks = 0, startTime = 0, rssPages = 0;
+        ssize_t n = impl.read(pid, "stat", &entry.statFd, buf, sizeof(buf));
+        if (n <= 0 || !ParseStat(buf, (size_t)n, entry, &cpuTicks, &startTime, &rssPages)) {
+            // 列目录之后刚退出；留给下面统一清理，下一周期重新列目录
+            impl.pidsValid = false;
+            continue;
+        }
+        if (!entry.fresh && startTime != entry.startTime) {
+            // pid 被复用：上一进程的计数与描述符作废
+            char comm[sizeof(entry.comm)];
+            memcpy(comm, entry.comm, sizeof(comm));
+            impl.release(entry);
+            entry = Entry();
+            memcpy(entry.comm, comm, sizeof(comm));
+        }
+        entry.startTime = startTime;
+        entry.seen = impl.tick;
+
+        p.name = entry.comm;
+        p.cpuTimeMs = (uint64_t)(cpuTicks * 1000 / impl.clockTicks);
+        p.rssBytes = rssPages * impl.pageSize;
+        if (!entry.fresh) {
+            double statElapsed = std::chrono::duration<double>(now - entry.statTime).count();
+            p.cpuPercent = Rate(cpuTicks, entry.cpuTicks, statElapsed) / impl.clockTicks * 100;
+            if (cpuTicks > entry.cpuTicks) accounted += cpuTicks - entry.cpuTicks;
+            entry.statInterval = cpuTicks == entry.cpuTicks ? std::min(entry.statInterval * 2, kMaxStatInterval) : 1;
+        }
+        entry.cpuTicks = cpuTicks;
+        entry.rssPages = rssPages;
+        entry.statTick = impl.tick;
+        entry.statTime = now;
+
+        // 读写计数是累计值，而发起 I/O 总要消耗 CPU：CPU 时间未变的进程沿用上次读数，
+        // 至多 kIoRefreshTicks 个周期补读一次，其间的字节数不会丢失，只是计入稍后的周期
+        bool ioDue = !entry.ioRead || cpuTicks != entry.ioCpuTicks || impl.tick - entry.ioTick >= kIoRefreshTicks;
+        if (entry.ioDenied || !ioWanted) {
+            // 不可见的行不读：界面不显示，按 CPU、内存排序也用不到
+        } else if (!ioDue) {
+            p.ioKnown = true;
+            p.readBytes = entry.read;
+            p.writeBytes = entry.write;
+        } else {
+            n = impl.read(pid, "io", &entry.ioFd, buf, sizeof(buf));
+            if (n > 0 && ParseIo(buf, (size_t)n, &p.readBytes, &p.writeBytes)) {
+                p.ioKnown = true;
+                if (entry.ioRead) {
+                    double ioElapsed = std::chrono::duration<double>(now - entry.ioTime).count();
+                    p.readRate = Rate(p.readBytes, entry.read, ioElapsed);
+                    p.writeRate = Rate(p.writeBytes, entry.write, ioElapsed);
+                }
+                entry.ioRead = true;
+                entry.read = p.readBytes;
+                entry.write = p.writeBytes;
+                entry.ioCpuTicks = cpuTicks;
+                entry.ioTick = impl.tick;
+                entry.ioTime = now;
+            } else {
+                entry.ioDenied = true;
+            }
+        }
+        entry.fresh = false;
+        list->push_back(std::move(p));
+    }
+
+    // 本周期未读到的 pid 已退出
+    for (auto it = impl.entries.begin(); it != impl.entries.end();) {
+        if (it->second.seen == impl.tick) {
+            ++it;
+            continue;
+        }
+        impl.release(it->second);
+        it = impl.entries.erase(it);
+    }
+
+    // 有进程在未读取期间开始忙（或短命进程较多）时下一周期全读
+    if (haveSystem && impl.systemBusy != 0 && elapsed > 0) {
+        uint64_t busy = systemBusy > impl.systemBusy ? systemBusy - impl.systemBusy : 0;
+        double margin = kUnaccountedShare * impl.clockTicks * elapsed + kSampleSkewShare * (double)accounted;
+        impl.fullScan = (double)busy > (double)accounted + margin;
+    } else {
+        impl.fullScan = !haveSystem;
+    }
+    if (haveSystem) impl.systemBusy = systemBusy;
+
+    // /proc 按 pid 升序列出，通常无需再排
+    if (!std::is_sorted(list->begin(), list->end(), ByPid)) std::sort(list->begin(), list->end(), ByPid);
+    impl.spare = std::move(impl.published);
+    impl.published = list;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_latest = std::move(list);
+    return true;
+}
+
+#endif
+
+// ========== 通用部分 ==========
+Monitor::Monitor()
+    : m_impl(std::make_unique<Impl>()),
+      m_latest(std::make_shared<ProcessList>())
+{
+}
+
+Monitor::~Monitor()
+{
+    Stop();
+}
+
+void Monitor::Start(std::chrono::milliseconds interval)
+{
+    if (m_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = false;
+    }
+    m_thread = std::thread([this, interval] { run(interval); });
+}
+
+void Monitor::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cond.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void Monitor::run(std::chrono::milliseconds interval)
+{
+    auto next = std::chrono::steady_clock::now();
+    for (;;) {
+        Sample();
+        next = std::max(next + interval, std::chrono::steady_clock::now());
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_cond.wait_until(lock, next, [this] { return m_stopping; })) break;
+    }
+}
+
+std::shared_ptr<const ProcessList> Monitor::Latest() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_latest;
+}
+
+void Monitor::SetVisible(std::vector<uint32_t> visible, bool ioForAll)
+{
+    std::sort(visible.begin(), visible.end());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (visible == m_visible && ioForAll == m_ioForAll) return;
+    m_visible = std::move(visible);
+    m_ioForAll = ioForAll;
+    ++m_hintVersion;
+}
+
+} // namespace procs
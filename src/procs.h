@@ -0,0 +1,81 @@
+#ifndef PROCS_H
+#define PROCS_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ========== 进程资源表 ==========
+// 按周期增量采样各进程的 CPU 时间、常驻内存与磁盘读写字节，给出相邻两次采样之间的速率。
+// 其它平台解析 /proc/[pid]/stat 与 /proc/[pid]/io：手写解析器只用栈上缓冲，
+// 已存在进程的描述符保持打开、每次 pread；空闲进程逐步降低读取频率，读写计数只为可见行读取。
+// Windows 对已存在进程复用 OpenProcess 句柄。不依赖 wxWidgets；字符串为 UTF-8。
+namespace procs
+{
+
+struct Process
+{
+    uint32_t pid = 0;
+    std::string name;          // 进程名（Linux 为 comm，Windows 为映像文件名）
+    bool known = false;        // 无权访问时为 false，此时只有 pid
+    double cpuPercent = 0;     // 上一周期的 CPU 占用，100 表示占满一个逻辑处理器
+    uint64_t cpuTimeMs = 0;    // 累计 CPU 时间（用户 + 内核）
+    uint64_t rssBytes = 0;     // 常驻内存 / 工作集
+    bool ioKnown = false;      // 读写计数需要更高权限，取不到时为 false
+    uint64_t readBytes = 0;    // 累计
+    uint64_t writeBytes = 0;
+    double readRate = 0;       // 上一周期的字节/秒
+    double writeRate = 0;
+};
+
+// 一次采样的结果，按 pid 升序；发布后不再修改，可跨线程共享
+using ProcessList = std::vector<Process>;
+
+class Monitor
+{
+public:
+    Monitor();
+    ~Monitor();
+    Monitor(const Monitor&) = delete;
+    Monitor& operator=(const Monitor&) = delete;
+
+    // 采样一次并发布结果；后台线程运行时不要再从其它线程调用
+    bool Sample();
+
+    // 后台线程按固定周期采样，Stop 或析构时结束
+    void Start(std::chrono::milliseconds interval);
+    void Stop();
+
+    // 最近一次发布的结果；尚未采样时为空列表
+    std::shared_ptr<const ProcessList> Latest() const;
+
+    // 界面提示（线程安全，下一次采样生效）：visible 中的 pid 每周期完整采样；
+    // ioForAll 为 false 时其余进程不读读写计数（ioKnown 为 false），按读写速率排序时应为 true。
+    // 默认全部读取。Windows 上这些计数都很便宜，忽略此提示
+    void SetVisible(std::vector<uint32_t> visible, bool ioForAll);
+
+private:
+    struct Impl;
+
+    void run(std::chrono::milliseconds interval);
+
+    std::unique_ptr<Impl> m_impl;      // 只由采样方访问
+
+    mutable std::mutex m_mutex;        // 保护 m_latest、m_stopping 与界面提示
+    std::condition_variable m_cond;
+    std::shared_ptr<const ProcessList> m_latest;
+    bool m_stopping = false;
+    std::vector<uint32_t> m_visible;   // 升序
+    bool m_ioForAll = true;
+    uint32_t m_hintVersion = 0;        // 提示变化时递增，采样方据此决定是否复制
+    std::thread m_thread;
+};
+
+} // namespace procs
+
+#endif // PROCS_H
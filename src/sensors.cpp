@@ -0,0 +1,407 @@
+#include "sensors.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <pdh.h>
+#else
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace sensors
+{
+
+const char* UnitOf(Kind kind)
+{
+    switch (kind) {
+        case Kind::Temperature: return "°C";
+        case Kind::Fan: return "RPM";
+        case Kind::Voltage: return "V";
+        case Kind::Current: return "A";
+        case Kind::Power: return "W";
+    }
+    return "";
+}
+
+#ifdef _WIN32
+
+// ========== Windows：PDH 热区温度 ==========
+struct Sampler::Impl
+{
+    PDH_HQUERY query = nullptr;
+    PDH_HCOUNTER counter = nullptr;
+    std::vector<std::wstring> instances;   // 与 m_sensors 一一对应
+    std::vector<BYTE> buffer;              // PdhGetFormattedCounterArrayW 的输出，跨周期复用
+
+    ~Impl()
+    {
+        if (query) PdhCloseQuery(query);
+    }
+
+    // 取当前一轮的计数器数组；缓冲不足时扩大后重试
+    PDH_FMT_COUNTERVALUE_ITEM_W* Collect(DWORD* count)
+    {
+        if (PdhCollectQueryData(query) != ERROR_SUCCESS) return nullptr;
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            DWORD size = (DWORD)buffer.size();
+            *count = 0;
+            PDH_STATUS status = PdhGetFormattedCounterArrayW(counter, PDH_FMT_DOUBLE, &size, count,
+                buffer.empty() ? nullptr : (PDH_FMT_COUNTERVALUE_ITEM_W*)buffer.data());
+            if (status == ERROR_SUCCESS) return (PDH_FMT_COUNTERVALUE_ITEM_W*)buffer.data();
+            if (status != (PDH_STATUS)PDH_MORE_DATA) return nullptr;
+            buffer.resize(size);
+        }
+        return nullptr;
+    }
+};
+
+namespace
+{
+    std::string ToUtf8(const wchar_t* str)
+    {
+        int n = WideCharToMultiByte(CP_UTF8, 0, str, -1, nullptr, 0, nullptr, nullptr);
+        if (n <= 1) return std::string();
+        std::string out(n - 1, '\0');
+        WideCharToMultiByte(CP_UTF8, 0, str, -1, &out[0], n, nullptr, nullptr);
+        return out;
+    }
+
+    bool IsValid(const PDH_FMT_COUNTERVALUE& value)
+    {
+        return value.CStatus == PDH_CSTATUS_VALID_DATA || value.CStatus == PDH_CSTATUS_NEW_DATA;
+    }
+}
+
+std::string Sampler::DefaultRoot()
+{
+    return std::string();
+}
+
+size_t Sampler::Discover()
+{
+    m_impl = std::make_unique<Impl>();
+    m_sensors.clear();
+    if (PdhOpenQueryW(nullptr, 0, &m_impl->query) != ERROR_SUCCESS) {
+        m_impl->query = nullptr;
+    } else if (PdhAddEnglishCounterW(m_impl->query, L"\\Thermal Zone Information(*)\\Temperature", 0,
+                                     &m_impl->counter) == ERROR_SUCCESS) {
+        DWORD count = 0;
+        PDH_FMT_COUNTERVALUE_ITEM_W* items = m_impl->Collect(&count);
+        for (DWORD i = 0; items && i < count; ++i) {
+            m_impl->instances.push_back(items[i].szName);
+            m_sensors.push_back(Sensor{ "ACPI", ToUtf8(items[i].szName), Kind::Temperature });
+        }
+    }
+    discoverEnergy();
+    m_values.assign(m_sensors.size(), 0);
+    m_valid.assign(m_sensors.size(), 0);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.assign(m_sensors.size(), Stats());
+    m_sums.assign(m_sensors.size(), 0);
+    return m_sensors.size();
+}
+
+void Sampler::readAll()
+{
+    std::fill(m_valid.begin(), m_valid.end(), 0);
+    if (!m_impl || !m_impl->counter) return;
+    DWORD count = 0;
+    PDH_FMT_COUNTERVALUE_ITEM_W* items = m_impl->Collect(&count);
+    // 实例顺序通常不变；对不上时按名称查找
+    for (DWORD i = 0; items && i < count; ++i) {
+        size_t index = i;
+        if (index >= m_impl->instances.size() || m_impl->instances[index] != items[i].szName) {
+            auto it = std::find(m_impl->instances.begin(), m_impl->instances.end(), items[i].szName);
+            if (it == m_impl->instances.end()) continue;
+            index = (size_t)(it - m_impl->instances.begin());
+        }
+        if (!IsValid(items[i].FmtValue)) continue;
+        m_values[index] = items[i].FmtValue.doubleValue - 273.15;   // 开尔文
+        m_valid[index] = 1;
+    }
+}
+
+#else
+
+// ========== 其它平台：hwmon ==========
+struct Sampler::Impl
+{
+    std::vector<int> fds;          // 与 m_sensors 一一对应
+    std::vector<double> scales;    // 原始整数 → 显示单位
+
+    ~Impl()
+    {
+        for (int fd : fds) close(fd);
+    }
+};
+
+namespace
+{
+    struct Input
+    {
+        long hwmon;        // hwmonN 的 N，保证显示顺序稳定
+        Kind kind;
+        long index;
+        std::string chip;
+        std::string path;
+        std::string labelPath;
+    };
+
+    // 前缀 → 类型与换算：温度毫摄氏度、电压毫伏、电流毫安、功率微瓦
+    struct Prefix
+    {
+        const char* name;
+        Kind kind;
+        double scale;
+    };
+    const Prefix kPrefixes[] = {
+        { "temp", Kind::Temperature, 1e-3 },
+        { "fan", Kind::Fan, 1.0 },
+        { "in", Kind::Voltage, 1e-3 },
+        { "curr", Kind::Current, 1e-3 },
+        { "power", Kind::Power, 1e-6 },
+    };
+
+    const Prefix* PrefixOf(Kind kind)
+    {
+        for (const Prefix& prefix : kPrefixes) {
+            if (prefix.kind == kind) return &prefix;
+        }
+        return nullptr;
+    }
+
+    bool ReadText(const std::string& path, std::string* out)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        char buf[128];
+        ssize_t n = read(fd, buf, sizeof(buf));
+        close(fd);
+        if (n < 0) return false;
+        while (n > 0 && (buf[n - 1] == '\n' || buf[n - 1] == ' ')) --n;
+        out->assign(buf, (size_t)n);
+        return true;
+    }
+
+    // "temp3_input" → 温度 3
+    bool ParseInputName(const char* name, Kind* kind, long* index)
+    {
+        for (const Prefix& prefix : kPrefixes) {
+            size_t len = strlen(prefix.name);
+            if (strncmp(name, prefix.name, len) != 0) continue;
+            char* end;
+            long n = strtol(name + len, &end, 10);
+            if (end == name + len || strcmp(end, "_input") != 0) return false;
+            *kind = prefix.kind;
+            *index = n;
+            return true;
+        }
+        return false;
+    }
+
+    // 新驱动把属性放在 hwmonN 下，旧驱动放在 hwmonN/device 下
+    void ScanChip(const std::string& dir, long hwmon, const std::string& chip, std::vector<Input>& out)
+    {
+        DIR* d = opendir(dir.c_str());
+        if (!d) return;
+        while (dirent* entry = readdir(d)) {
+            Input input;
+            if (!ParseInputName(entry->d_name, &input.kind, &input.index)) continue;
+            input.hwmon = hwmon;
+            input.chip = chip;
+            input.path = dir + entry->d_name;
+            input.labelPath = dir + PrefixOf(input.kind)->name + std::to_string(input.index) + "_label";
+            out.push_back(std::move(input));
+        }
+        closedir(d);
+    }
+
+    // sysfs 数值：可带负号的十进制整数加换行；不经 strtol 以免 locale 与 errno 开销
+    bool ParseInteger(const char* p, const char* end, long long* out)
+    {
+        bool negative = p < end && *p == '-';
+        if (negative) ++p;
+        if (p == end || *p < '0' || *p > '9') return false;
+        long long v = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p) v = v * 10 + (*p - '0');
+        *out = negative ? -v : v;
+        return true;
+    }
+}
+
+std::string Sampler::DefaultRoot()
+{
+    return "/sys/class/hwmon";
+}
+
+size_t Sampler::Discover()
+{
+    m_impl = std::make_unique<Impl>();
+    m_sensors.clear();
+
+    std::vector<Input> inputs;
+    if (DIR* root = opendir(m_root.c_str())) {
+        while (dirent* entry = readdir(root)) {
+            if (strncmp(entry->d_name, "hwmon", 5) != 0) continue;
+            long hwmon = strtol(entry->d_name + 5, nullptr, 10);
+            std::string base = m_root + "/" + entry->d_name + "/";
+            std::string chip;
+            if (!ReadText(base + "name", &chip) && !ReadText(base + "device/name", &chip)) chip = entry->d_name;
+            size_t before = inputs.size();
+            ScanChip(base, hwmon, chip, inputs);
+            if (inputs.size() == before) ScanChip(base + "device/", hwmon, chip, inputs);
+        }
+        closedir(root);
+    }
+    std::sort(inputs.begin(), inputs.end(), [](const Input& a, const Input& b) {
+        if (a.hwmon != b.hwmon) return a.hwmon < b.hwmon;
+        if (a.kind != b.kind) return a.kind < b.kind;
+        return a.index < b.index;
+    });
+
+    for (const Input& input : inputs) {
+        int fd = open(input.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+        Sensor sensor{ input.chip, std::string(), input.kind };
+        if (!ReadText(input.labelPath, &sensor.label) || sensor.label.empty()) {
+            sensor.label = PrefixOf(input.kind)->name + std::to_string(input.index);
+        }
+        m_impl->fds.push_back(fd);
+        m_impl->scales.push_back(PrefixOf(input.kind)->scale);
+        m_sensors.push_back(std::move(sensor));
+    }
+
+    discoverEnergy();
+    m_values.assign(m_sensors.size(), 0);
+    m_valid.assign(m_sensors.size(), 0);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.assign(m_sensors.size(), Stats());
+    m_sums.assign(m_sensors.size(), 0);
+    return m_sensors.size();
+}
+
+void Sampler::readAll()
+{
+    if (!m_impl) return;
+    char buf[32];
+    for (size_t i = 0; i < m_impl->fds.size(); ++i) {
+        // 传感器掉线时 pread 返回 EIO/ENODATA，本周期记为无效，描述符保留
+        ssize_t n = pread(m_impl->fds[i], buf, sizeof(buf), 0);
+        long long raw = 0;
+        m_valid[i] = n > 0 && ParseInteger(buf, buf + n, &raw);
+        if (m_valid[i]) m_values[i] = (double)raw * m_impl->scales[i];
+    }
+}
+
+#endif
+
+// ========== 通用部分 ==========
+Sampler::Sampler(std::string root)
+    : m_root(std::move(root))
+{
+}
+
+Sampler::~Sampler()
+{
+    Stop();
+}
+
+// RAPL 计数器累计的是能量：功率取相邻两次读数之差，回绕由 Meter 处理
+void Sampler::discoverEnergy()
+{
+    m_energy = std::make_unique<energy::Meter>();
+    m_energyFirst = m_sensors.size();
+    m_energy->Discover();
+    for (const energy::Counter& counter : m_energy->Counters()) {
+        m_sensors.push_back(Sensor{ "RAPL", counter.name, Kind::Power });
+    }
+    m_energyTime = std::chrono::steady_clock::now();
+    if (!m_energy->Read(&m_energyLast)) m_energyLast.clear();
+}
+
+void Sampler::readEnergy()
+{
+    std::fill(m_valid.begin() + m_energyFirst, m_valid.end(), 0);
+    std::vector<double>& joules = m_energyRead;
+    if (!m_energy || !m_energy->Read(&joules) || joules.size() != m_energyLast.size()) return;
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - m_energyTime).count();
+    // 间隔过短时计数器的更新粒度（约 1 ms）占比太大，留到下一周期
+    if (seconds < 0.005) return;
+    for (size_t i = 0; i < joules.size(); ++i) {
+        m_values[m_energyFirst + i] = (joules[i] - m_energyLast[i]) / seconds;
+        m_valid[m_energyFirst + i] = 1;
+    }
+    m_energyLast.swap(joules);
+    m_energyTime = now;
+}
+
+void Sampler::SampleOnce()
+{
+    readAll();
+    readEnergy();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < m_stats.size(); ++i) {
+        if (!m_valid[i]) continue;
+        Stats& s = m_stats[i];
+        double v = m_values[i];
+        s.current = v;
+        s.min = s.samples == 0 ? v : std::min(s.min, v);
+        s.max = s.samples == 0 ? v : std::max(s.max, v);
+        m_sums[i] += v;
+        ++s.samples;
+        s.average = m_sums[i] / (double)s.samples;
+    }
+}
+
+void Sampler::Start(std::chrono::milliseconds interval)
+{
+    if (m_thread.joinable() || m_sensors.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = false;
+    }
+    m_thread = std::thread([this, interval] { run(interval); });
+}
+
+void Sampler::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cond.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+// 按绝对时刻排期，采样本身的耗时不会累积成漂移
+void Sampler::run(std::chrono::milliseconds interval)
+{
+    auto next = std::chrono::steady_clock::now();
+    for (;;) {
+        SampleOnce();
+        // 落后超过一个周期（如系统休眠）时从当前时刻重新排期，不补采
+        next = std::max(next + interval, std::chrono::steady_clock::now());
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_cond.wait_until(lock, next, [this] { return m_stopping; })) break;
+    }
+}
+
+std::vector<Stats> Sampler::Snapshot() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void Sampler::Reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::fill(m_stats.begin(), m_stats.end(), Stats());
+    std::fill(m_sums.begin(), m_sums.end(), 0);
+}
+
+} // namespace sensors
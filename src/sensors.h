@@ -0,0 +1,106 @@
+#ifndef SENSORS_H
+#define SENSORS_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "energy.h"
+
+// ========== 传感器采样 ==========
+// 其它平台读取 /sys/class/hwmon：发现阶段一次性打开所有 *_input 文件并保持描述符，
+// 每个采样周期由同一线程对全部描述符 pread(偏移 0)，不再拼路径、不重新打开。
+// Windows 没有 hwmon，经 PDH 读取 ACPI 热区温度（"\Thermal Zone Information(*)\Temperature"），
+// 风扇与电压需要主板厂商驱动，不在此列。两个平台都另加 RAPL 功率（芯片名 "RAPL"，见 energy.h），
+// 由相邻两次采样之间的能量差除以间隔得出。不依赖 wxWidgets；字符串为 UTF-8。
+namespace sensors
+{
+
+enum class Kind
+{
+    Temperature,   // °C
+    Fan,           // RPM
+    Voltage,       // V
+    Current,       // A
+    Power,         // W
+};
+
+const char* UnitOf(Kind kind);
+
+struct Sensor
+{
+    std::string chip;      // hwmon 的 name，如 "coretemp"、"nct6798"
+    std::string label;     // *_label 的内容，没有时为 "temp1" 之类的文件前缀
+    Kind kind;
+};
+
+// 自上次 Reset 以来的统计；samples 为 0 表示还没有读到有效值
+struct Stats
+{
+    double current = 0;
+    double min = 0;
+    double max = 0;
+    double average = 0;
+    uint64_t samples = 0;
+};
+
+class Sampler
+{
+public:
+    // root 为 hwmon 目录（测试时可指向伪造的目录树）；Windows 上忽略
+    explicit Sampler(std::string root = DefaultRoot());
+    ~Sampler();
+    Sampler(const Sampler&) = delete;
+    Sampler& operator=(const Sampler&) = delete;
+
+    static std::string DefaultRoot();
+
+    // 枚举传感器并打开输入，返回数量；须在 Start 之前调用
+    size_t Discover();
+    const std::vector<Sensor>& Sensors() const { return m_sensors; }
+
+    // 采样一次并更新统计；采样线程运行时不要再从其它线程调用
+    void SampleOnce();
+
+    // 后台线程按固定周期采样，Stop 或析构时结束
+    void Start(std::chrono::milliseconds interval);
+    void Stop();
+
+    std::vector<Stats> Snapshot() const;   // 与 Sensors() 一一对应
+    void Reset();                          // 清空最小/最大/平均
+
+private:
+    struct Impl;
+
+    void readAll();    // 读取全部输入到 m_values / m_valid
+    void discoverEnergy();   // 在各平台 Discover 末尾追加 RAPL 功率传感器
+    void readEnergy();
+    void run(std::chrono::milliseconds interval);
+
+    std::string m_root;
+    std::unique_ptr<Impl> m_impl;
+    std::vector<Sensor> m_sensors;
+    std::vector<double> m_values;      // 本周期的读数，只由采样方访问
+    std::vector<uint8_t> m_valid;
+    std::vector<double> m_sums;
+
+    std::unique_ptr<energy::Meter> m_energy;
+    size_t m_energyFirst = 0;                  // RAPL 传感器在 m_sensors 中的起始下标
+    std::vector<double> m_energyLast;          // 上次采样时的累计焦耳
+    std::vector<double> m_energyRead;          // 本次读数，与 m_energyLast 交换复用，采样时不再分配
+    std::chrono::steady_clock::time_point m_energyTime;
+
+    mutable std::mutex m_mutex;        // 保护 m_stats、m_sums、m_stopping
+    std::condition_variable m_cond;
+    std::vector<Stats> m_stats;
+    bool m_stopping = false;
+    std::thread m_thread;
+};
+
+} // namespace sensors
+
+#endif // SENSORS_H
@@ -0,0 +1,672 @@
+#include "snapshot.h"
+#include "hardware.h"
+#include <cstring>
+
+namespace schema
+{
+
+namespace
+{
+    // ===== 按字段类型的处理：新增字段类型时在此补充一组重载 =====
+    enum : uint8_t
+    {
+        TypeString = 1,
+        TypeInteger = 2,
+        TypeStringList = 3,
+        TypeProbeList = 4,
+        TypeRecordList = 5,   // 结构列表：每个元素是一组带名记录（格式同顶层）
+        TypeRecordListDelta = 6,   // 仅增量格式：结构列表的新长度 + 每个元素相对原元素变化的字段
+    };
+
+    // 结构列表的元素类型（PciDevice、NumaNode ...），字段表见 RecordSchema
+    template <typename Record>
+    concept IsRecord = requires { RecordSchema<Record>::fields; };
+
+    bool ParseProbeStatus(const std::string& name, ProbeStatus* out)
+    {
+        const ProbeStatus all[] = { ProbeStatus::Ok, ProbeStatus::Fallback, ProbeStatus::Failed,
+                                    ProbeStatus::TimedOut, ProbeStatus::Skipped, ProbeStatus::Hung };
+        for (ProbeStatus status : all) {
+            if (name == Hardware::ProbeStatusName(status)) {
+                *out = status;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    wxString FromUtf8(const std::string& str)
+    {
+        return Hardware::Utf8ToWxString(str.data(), str.size());
+    }
+
+    // ----- 扁平键值 -----
+    void EmitKeyValues(const std::string& name, const wxString& value, const KeyValueSink& sink)
+    {
+        sink(name, Hardware::ToUtf8(value));
+    }
+
+    void EmitKeyValues(const std::string& name, long value, const KeyValueSink& sink)
+    {
+        sink(name, std::to_string(value));
+    }
+
+    void EmitKeyValues(const std::string& name, const std::vector<wxString>& values, const KeyValueSink& sink)
+    {
+        for (size_t i = 0; i < values.size(); ++i) {
+            sink(name + "[" + std::to_string(i) + "]", Hardware::ToUtf8(values[i]));
+        }
+    }
+
+    void EmitKeyValues(const std::string& name, const std::vector<ProbeReport>& reports, const KeyValueSink& sink)
+    {
+        for (const ProbeReport& report : reports) {
+            sink(name + "." + Hardware::ToUtf8(report.Section), Hardware::ProbeStatusName(report.Status));
+        }
+    }
+
+    template <IsRecord Record>
+    void EmitKeyValues(const std::string& name, const std::vector<Record>& records, const KeyValueSink& sink)
+    {
+        for (size_t i = 0; i < records.size(); ++i) {
+            std::string prefix = name + "[" + std::to_string(i) + "].";
+            ForEachField(RecordSchema<Record>::fields, [&](const auto& field) {
+                EmitKeyValues(prefix + field.name, records[i].*(field.member), sink);
+            });
+        }
+    }
+
+    // ----- 文本解析：键属于该字段时写入并返回 true -----
+    bool AssignText(const std::string& key, const std::string& name, const std::string& value, wxString& member)
+    {
+        if (key != name) return false;
+        member = FromUtf8(value);
+        return true;
+    }
+
+    bool AssignText(const std::string& key, const std::string& name, const std::string& value, long& member)
+    {
+        if (key != name) return false;
+        member = strtol(value.c_str(), nullptr, 10);
+        return true;
+    }
+
+    bool AssignText(const std::string& key, const std::string& name, const std::string& value,
+                    std::vector<wxString>& member)
+    {
+        if (key.size() < name.size() + 3 || key.compare(0, name.size(), name) != 0 ||
+            key[name.size()] != '[' || key.back() != ']') {
+            return false;
+        }
+        unsigned long index = strtoul(key.c_str() + name.size() + 1, nullptr, 10);
+        if (index > 4096) return false;  // 防御损坏的输入
+        if (member.size() <= index) member.resize(index + 1);
+        member[index] = FromUtf8(value);
+        return true;
+    }
+
+    bool AssignText(const std::string& key, const std::string& name, const std::string& value,
+                    std::vector<ProbeReport>& member)
+    {
+        if (key.size() <= name.size() + 1 || key.compare(0, name.size(), name) != 0 || key[name.size()] != '.') {
+            return false;
+        }
+        ProbeReport report{ FromUtf8(key.substr(name.size() + 1)), ProbeStatus::Ok, 0 };
+        if (!ParseProbeStatus(value, &report.Status)) return false;
+        member.push_back(std::move(report));
+        return true;
+    }
+
+    template <IsRecord Record>
+    bool AssignText(const std::string& key, const std::string& name, const std::string& value,
+                    std::vector<Record>& member)
+    {
+        // "PciDevices[3].VendorId"
+        if (key.size() < name.size() + 5 || key.compare(0, name.size(), name) != 0 || key[name.size()] != '[') {
+            return false;
+        }
+        char* end = nullptr;
+        unsigned long index = strtoul(key.c_str() + name.size() + 1, &end, 10);
+        if (index > 4096 || end[0] != ']' || end[1] != '.') return false;
+        std::string sub(end + 2);
+
+        bool matched = false;
+        Record record;
+        Record& target = index < member.size() ? member[index] : record;
+        ForEachField(RecordSchema<Record>::fields, [&](const auto& field) {
+            if (!matched) matched = AssignText(sub, field.name, value, target.*(field.member));
+        });
+        if (matched && index >= member.size()) {
+            member.resize(index + 1);
+            member[index] = std::move(record);
+        }
+        return matched;
+    }
+
+    // ----- 二进制：小端序，长度前缀 -----
+    class BinaryWriter
+    {
+    public:
+        void Put8(uint8_t v) { m_out.push_back((char)v); }
+        void Put32(uint32_t v)
+        {
+            for (int i = 0; i < 4; ++i) m_out.push_back((char)(v >> (8 * i)));
+        }
+        void Put64(uint64_t v)
+        {
+            for (int i = 0; i < 8; ++i) m_out.push_back((char)(v >> (8 * i)));
+        }
+        void PutBytes(const std::string& s)
+        {
+            Put32((uint32_t)s.size());
+            m_out += s;
+        }
+        size_t Size() const { return m_out.size(); }
+        void Patch32(size_t pos, uint32_t v)
+        {
+            for (int i = 0; i < 4; ++i) m_out[pos + i] = (char)(v >> (8 * i));
+        }
+        std::string& Str() { return m_out; }
+
+    private:
+        std::string m_out;
+    };
+
+    class BinaryReader
+    {
+    public:
+        BinaryReader(const char* data, size_t size) : m_p(data), m_end(data + size) {}
+
+        bool Get8(uint8_t* v)
+        {
+            if (m_end - m_p < 1) return false;
+            *v = (uint8_t)*m_p++;
+            return true;
+        }
+        bool Get32(uint32_t* v)
+        {
+            if (m_end - m_p < 4) return false;
+            *v = 0;
+            for (int i = 0; i < 4; ++i) *v |= (uint32_t)(uint8_t)m_p[i] << (8 * i);
+            m_p += 4;
+            return true;
+        }
+        bool Get64(uint64_t* v)
+        {
+            if (m_end - m_p < 8) return false;
+            *v = 0;
+            for (int i = 0; i < 8; ++i) *v |= (uint64_t)(uint8_t)m_p[i] << (8 * i);
+            m_p += 8;
+            return true;
+        }
+        bool GetBytes(std::string* s)
+        {
+            uint32_t n;
+            if (!Get32(&n) || (size_t)(m_end - m_p) < n) return false;
+            s->assign(m_p, n);
+            m_p += n;
+            return true;
+        }
+        bool Skip(size_t n)
+        {
+            if ((size_t)(m_end - m_p) < n) return false;
+            m_p += n;
+            return true;
+        }
+        const char* Pos() const { return m_p; }
+        size_t Remaining() const { return (size_t)(m_end - m_p); }
+        bool AtEnd() const { return m_p == m_end; }
+
+    private:
+        const char* m_p;
+        const char* m_end;
+    };
+
+    uint8_t TypeOf(const wxString&) { return TypeString; }
+    uint8_t TypeOf(long) { return TypeInteger; }
+    uint8_t TypeOf(const std::vector<wxString>&) { return TypeStringList; }
+    uint8_t TypeOf(const std::vector<ProbeReport>&) { return TypeProbeList; }
+    template <IsRecord Record>
+    uint8_t TypeOf(const std::vector<Record>&) { return TypeRecordList; }
+
+    void WritePayload(BinaryWriter& w, const wxString& value)
+    {
+        w.PutBytes(Hardware::ToUtf8(value));
+    }
+
+    void WritePayload(BinaryWriter& w, long value)
+    {
+        w.Put64((uint64_t)(int64_t)value);
+    }
+
+    void WritePayload(BinaryWriter& w, const std::vector<wxString>& values)
+    {
+        w.Put32((uint32_t)values.size());
+        for (const wxString& value : values) w.PutBytes(Hardware::ToUtf8(value));
+    }
+
+    void WritePayload(BinaryWriter& w, const std::vector<ProbeReport>& reports)
+    {
+        w.Put32((uint32_t)reports.size());
+        for (const ProbeReport& report : reports) {
+            w.PutBytes(Hardware::ToUtf8(report.Section));
+            w.Put8((uint8_t)report.Status);
+            w.Put64((uint64_t)(int64_t)report.ElapsedMs);
+        }
+    }
+
+    bool ReadPayload(BinaryReader& r, wxString& value)
+    {
+        std::string s;
+        if (!r.GetBytes(&s)) return false;
+        value = FromUtf8(s);
+        return true;
+    }
+
+    bool ReadPayload(BinaryReader& r, long& value)
+    {
+        uint64_t v;
+        if (!r.Get64(&v)) return false;
+        value = (long)(int64_t)v;
+        return true;
+    }
+
+    bool ReadPayload(BinaryReader& r, std::vector<wxString>& values)
+    {
+        uint32_t n;
+        if (!r.Get32(&n)) return false;
+        values.clear();
+        for (uint32_t i = 0; i < n; ++i) {
+            std::string s;
+            if (!r.GetBytes(&s)) return false;
+            values.push_back(FromUtf8(s));
+        }
+        return true;
+    }
+
+    bool ReadPayload(BinaryReader& r, std::vector<ProbeReport>& reports)
+    {
+        uint32_t n;
+        if (!r.Get32(&n)) return false;
+        reports.clear();
+        for (uint32_t i = 0; i < n; ++i) {
+            std::string section;
+            uint8_t status;
+            uint64_t elapsed;
+            if (!r.GetBytes(&section) || !r.Get8(&status) || !r.Get64(&elapsed)) return false;
+            if (status > (uint8_t)ProbeStatus::Hung) return false;
+            reports.push_back(ProbeReport{ FromUtf8(section), (ProbeStatus)status, (long)(int64_t)elapsed });
+        }
+        return true;
+    }
+
+    // ----- 带名记录：u32 个数 + 每字段 (u8 名长, 名, u8 类型, u32 负载长, 负载) -----
+    // 顶层快照与结构列表的元素共用；读取时名称与类型都匹配才解析，否则跳过
+    template <IsRecord Record>
+    void WritePayload(BinaryWriter& w, const std::vector<Record>& records);
+    template <IsRecord Record>
+    bool ReadPayload(BinaryReader& r, std::vector<Record>& records);
+
+    template <typename Schema, typename Owner>
+    void WriteRecords(BinaryWriter& w, const Schema& fields, const Owner& obj)
+    {
+        w.Put32((uint32_t)std::tuple_size_v<Schema>);
+        ForEachField(fields, [&](const auto& field) {
+            size_t nameLen = strlen(field.name);
+            w.Put8((uint8_t)nameLen);
+            w.Str().append(field.name, nameLen);
+            w.Put8(TypeOf(obj.*(field.member)));
+            size_t lenPos = w.Size();
+            w.Put32(0);  // 负载长度，写完后回填
+            WritePayload(w, obj.*(field.member));
+            w.Patch32(lenPos, (uint32_t)(w.Size() - lenPos - 4));
+        });
+    }
+
+    template <typename Schema, typename Owner>
+    bool ReadRecords(BinaryReader& r, const Schema& fields, Owner& obj)
+    {
+        uint32_t count;
+        if (!r.Get32(&count)) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint8_t nameLen, type;
+            uint32_t payloadLen;
+            if (!r.Get8(&nameLen)) return false;
+            const char* namePtr = r.Pos();
+            if (!r.Skip(nameLen)) return false;
+            std::string name(namePtr, nameLen);
+            if (!r.Get8(&type) || !r.Get32(&payloadLen)) return false;
+
+            const char* payload = r.Pos();
+            if (!r.Skip(payloadLen)) return false;
+
+            bool ok = true;
+            ForEachField(fields, [&](const auto& field) {
+                if (name != field.name || type != TypeOf(obj.*(field.member))) return;
+                BinaryReader pr(payload, payloadLen);
+                ok = ReadPayload(pr, obj.*(field.member)) && pr.AtEnd();
+            });
+            if (!ok) return false;
+        }
+        return true;
+    }
+
+    template <IsRecord Record>
+    void WritePayload(BinaryWriter& w, const std::vector<Record>& records)
+    {
+        w.Put32((uint32_t)records.size());
+        for (const Record& record : records) WriteRecords(w, RecordSchema<Record>::fields, record);
+    }
+
+    template <IsRecord Record>
+    bool ReadPayload(BinaryReader& r, std::vector<Record>& records)
+    {
+        uint32_t n;
+        if (!r.Get32(&n)) return false;
+        records.clear();
+        for (uint32_t i = 0; i < n; ++i) {
+            Record record;
+            if (!ReadRecords(r, RecordSchema<Record>::fields, record)) return false;
+            records.push_back(std::move(record));
+        }
+        return true;
+    }
+
+    // ----- 比较 -----
+    template <typename T>
+    bool FieldEquals(const T& a, const T& b)
+    {
+        return a == b;
+    }
+
+    bool FieldEquals(const std::vector<ProbeReport>& a, const std::vector<ProbeReport>& b)
+    {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i].Section != b[i].Section || a[i].Status != b[i].Status) return false;
+        }
+        return true;
+    }
+
+    // Diff 的口径：易变插件字段（温度、计数器）只比较键与标志，采集能耗只比较计数器，取值变化不算作硬件变化
+    template <typename T>
+    bool ChangeEquals(const T& a, const T& b)
+    {
+        return FieldEquals(a, b);
+    }
+
+    bool ChangeEquals(const std::vector<PluginField>& a, const std::vector<PluginField>& b)
+    {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i].Volatile && b[i].Volatile) {
+                if (a[i].Section != b[i].Section || a[i].Key != b[i].Key || a[i].Fingerprint != b[i].Fingerprint) return false;
+            } else if (!(a[i] == b[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ChangeEquals(const std::vector<EnergyReading>& a, const std::vector<EnergyReading>& b)
+    {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i].Domain != b[i].Domain || a[i].Source != b[i].Source) return false;
+        }
+        return true;
+    }
+
+    // ----- 增量：只写与 base 不同的字段，结构列表再逐元素比较 -----
+    template <typename T>
+    uint8_t DeltaTypeOf(const T& value) { return TypeOf(value); }
+    template <IsRecord Record>
+    uint8_t DeltaTypeOf(const std::vector<Record>&) { return TypeRecordListDelta; }
+
+    template <typename T>
+    void WriteDeltaPayload(BinaryWriter& w, const T&, const T& value) { WritePayload(w, value); }
+    template <IsRecord Record>
+    void WriteDeltaPayload(BinaryWriter& w, const std::vector<Record>& base, const std::vector<Record>& records);
+
+    template <typename Schema, typename Owner>
+    void WriteRecordsDelta(BinaryWriter& w, const Schema& fields, const Owner& base, const Owner& obj)
+    {
+        size_t countPos = w.Size();
+        w.Put32(0);  // 变化的字段数，写完后回填
+        uint32_t count = 0;
+        ForEachField(fields, [&](const auto& field) {
+            if (FieldEquals(base.*(field.member), obj.*(field.member))) return;
+            size_t nameLen = strlen(field.name);
+            w.Put8((uint8_t)nameLen);
+            w.Str().append(field.name, nameLen);
+            w.Put8(DeltaTypeOf(obj.*(field.member)));
+            size_t lenPos = w.Size();
+            w.Put32(0);
+            WriteDeltaPayload(w, base.*(field.member), obj.*(field.member));
+            w.Patch32(lenPos, (uint32_t)(w.Size() - lenPos - 4));
+            ++count;
+        });
+        w.Patch32(countPos, count);
+    }
+
+    // 新增的元素相对默认值编码；多出的旧元素由新长度截掉
+    template <IsRecord Record>
+    void WriteDeltaPayload(BinaryWriter& w, const std::vector<Record>& base, const std::vector<Record>& records)
+    {
+        const Record empty{};
+        w.Put32((uint32_t)records.size());
+        for (size_t i = 0; i < records.size(); ++i) {
+            WriteRecordsDelta(w, RecordSchema<Record>::fields, i < base.size() ? base[i] : empty, records[i]);
+        }
+    }
+
+    // 读取增量：完整类型的字段整体替换，结构列表增量逐元素应用；名称或类型不匹配的字段跳过
+    template <typename T>
+    bool ApplyListDelta(BinaryReader&, T&) { return true; }
+    template <IsRecord Record>
+    bool ApplyListDelta(BinaryReader& r, std::vector<Record>& records);
+
+    template <typename Schema, typename Owner>
+    bool ApplyRecords(BinaryReader& r, const Schema& fields, Owner& obj)
+    {
+        uint32_t count;
+        if (!r.Get32(&count)) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint8_t nameLen, type;
+            uint32_t payloadLen;
+            if (!r.Get8(&nameLen)) return false;
+            const char* namePtr = r.Pos();
+            if (!r.Skip(nameLen)) return false;
+            std::string name(namePtr, nameLen);
+            if (!r.Get8(&type) || !r.Get32(&payloadLen)) return false;
+
+            const char* payload = r.Pos();
+            if (!r.Skip(payloadLen)) return false;
+
+            bool ok = true;
+            ForEachField(fields, [&](const auto& field) {
+                if (name != field.name) return;
+                BinaryReader pr(payload, payloadLen);
+                if (type == TypeOf(obj.*(field.member))) {
+                    ok = ReadPayload(pr, obj.*(field.member)) && pr.AtEnd();
+                } else if (type == TypeRecordListDelta) {
+                    ok = ApplyListDelta(pr, obj.*(field.member)) && pr.AtEnd();
+                }
+            });
+            if (!ok) return false;
+        }
+        return true;
+    }
+
+    template <IsRecord Record>
+    bool ApplyListDelta(BinaryReader& r, std::vector<Record>& records)
+    {
+        uint32_t n;
+        if (!r.Get32(&n) || n > r.Remaining() / 4) return false;  // 每个元素至少有 4 字节的字段数
+        records.resize(n);
+        for (Record& record : records) {
+            if (!ApplyRecords(r, RecordSchema<Record>::fields, record)) return false;
+        }
+        return true;
+    }
+
+    // ----- 文本转义 -----
+    void AppendEscaped(std::string& out, const std::string& value)
+    {
+        for (char c : value) {
+            if (c == '\\') out += "\\\\";
+            else if (c == '\n') out += "\\n";
+            else if (c == '\r') out += "\\r";
+            else out += c;
+        }
+    }
+
+    std::string Unescape(const std::string& value)
+    {
+        std::string out;
+        out.reserve(value.size());
+        for (size_t i = 0; i < value.size(); ++i) {
+            if (value[i] != '\\' || i + 1 == value.size()) {
+                out += value[i];
+                continue;
+            }
+            char c = value[++i];
+            out += c == 'n' ? '\n' : c == 'r' ? '\r' : c;
+        }
+        return out;
+    }
+
+    const char kBinaryMagic[4] = { 'M', 'T', 'S', '1' };
+    const char kDeltaMagic[4] = { 'M', 'T', 'D', '1' };
+}
+
+// ========== 扁平键值 ==========
+void ForEachKeyValue(const HardwareSnapshot& snap, const KeyValueSink& sink)
+{
+    ForEachField(HardwareSnapshotSchema, [&](const auto& field) {
+        EmitKeyValues(field.name, snap.*(field.member), sink);
+    });
+}
+
+// ========== 文本格式 ==========
+std::string ToText(const HardwareSnapshot& snap)
+{
+    std::string out;
+    ForEachKeyValue(snap, [&out](const std::string& key, const std::string& value) {
+        out += key;
+        out += '=';
+        AppendEscaped(out, value);
+        out += '\n';
+    });
+    return out;
+}
+
+bool FromText(const std::string& text, HardwareSnapshot* out)
+{
+    if (!out) return false;
+    HardwareSnapshot snap;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) return false;
+        std::string key = line.substr(0, eq);
+        std::string value = Unescape(line.substr(eq + 1));
+
+        // 未知键忽略：旧版本读取新版本写出的文本
+        bool matched = false;
+        ForEachField(HardwareSnapshotSchema, [&](const auto& field) {
+            if (!matched) matched = AssignText(key, field.name, value, snap.*(field.member));
+        });
+    }
+    *out = std::move(snap);
+    return true;
+}
+
+// ========== 二进制格式 ==========
+std::string ToBinary(const HardwareSnapshot& snap)
+{
+    BinaryWriter w;
+    for (char c : kBinaryMagic) w.Put8((uint8_t)c);
+    WriteRecords(w, HardwareSnapshotSchema, snap);
+    return std::move(w.Str());
+}
+
+bool FromBinary(const std::string& data, HardwareSnapshot* out)
+{
+    if (!out) return false;
+    BinaryReader r(data.data(), data.size());
+    for (char c : kBinaryMagic) {
+        uint8_t b;
+        if (!r.Get8(&b) || b != (uint8_t)c) return false;
+    }
+
+    // 名称与类型都匹配才读取，否则视为未知字段跳过
+    HardwareSnapshot snap;
+    if (!ReadRecords(r, HardwareSnapshotSchema, snap) || !r.AtEnd()) return false;
+    *out = std::move(snap);
+    return true;
+}
+
+// ========== 增量格式 ==========
+std::string ToBinaryDelta(const HardwareSnapshot& base, const HardwareSnapshot& snap)
+{
+    BinaryWriter w;
+    for (char c : kDeltaMagic) w.Put8((uint8_t)c);
+    WriteRecordsDelta(w, HardwareSnapshotSchema, base, snap);
+    return std::move(w.Str());
+}
+
+bool ApplyBinaryDelta(const std::string& data, HardwareSnapshot* inout)
+{
+    if (!inout) return false;
+    BinaryReader r(data.data(), data.size());
+    for (char c : kDeltaMagic) {
+        uint8_t b;
+        if (!r.Get8(&b) || b != (uint8_t)c) return false;
+    }
+
+    // 能否解析只取决于输入本身：先在空快照上试一遍，再原地应用，避免每次复制整个快照
+    BinaryReader check = r;
+    HardwareSnapshot scratch;
+    if (!ApplyRecords(check, HardwareSnapshotSchema, scratch) || !check.AtEnd()) return false;
+    return ApplyRecords(r, HardwareSnapshotSchema, *inout);
+}
+
+// ========== 比较 ==========
+std::vector<FieldChange> Diff(const HardwareSnapshot& a, const HardwareSnapshot& b)
+{
+    std::vector<FieldChange> changes;
+    ForEachField(HardwareSnapshotSchema, [&](const auto& field) {
+        if (!ChangeEquals(a.*(field.member), b.*(field.member))) {
+            changes.push_back(FieldChange{ field.name, field.section });
+        }
+    });
+    return changes;
+}
+
+void MoveSection(HardwareSnapshot& dst, HardwareSnapshot& src, const char* section)
+{
+    ForEachField(HardwareSnapshotSchema, [&](const auto& field) {
+        if (field.section && strcmp(field.section, section) == 0) {
+            dst.*(field.member) = std::move(src.*(field.member));
+        }
+    });
+}
+
+const char* SectionOf(const char* name)
+{
+    const char* section = nullptr;
+    ForEachField(HardwareSnapshotSchema, [&](const auto& field) {
+        if (strcmp(field.name, name) == 0) section = field.section;
+    });
+    return section;
+}
+
+} // namespace schema
@@ -0,0 +1,528 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <wx/wx.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// ========== 探测状态 ==========
+enum class ProbeStatus
+{
+    Ok,         // 正常完成
+    Fallback,   // 主路径不可用，字段来自备用方案、估计值或占位值
+    Failed,     // 采集失败，字段保持默认值
+    TimedOut,   // 超过期限，由看门狗放弃，字段保持默认值
+    Skipped,    // 已取消，或开始前整体预算已耗尽
+    Hung,       // 上一次运行超时后仍未返回（卡在驱动调用里），本次未启动，字段保持默认值
+};
+
+struct ProbeReport
+{
+    wxString Section;    // 探测名称（"BaseBoard"、"Disk" ...）
+    ProbeStatus Status;
+    long ElapsedMs;      // 探测耗时；超时时为所给期限
+};
+
+// ========== PCI 设备 ==========
+struct PciDevice
+{
+    wxString Address;            // 总线地址，如 "0000:03:00.0"
+    long VendorId = 0;
+    long DeviceId = 0;
+    long SubsystemVendorId = 0;
+    long SubsystemId = 0;
+    long ClassCode = 0;          // 类 << 16 | 子类 << 8 | 编程接口
+    wxString VendorName;         // 名称来自 pci.ids 索引，索引中没有时为空
+    wxString DeviceName;
+    wxString SubsystemName;
+    wxString ClassName;          // 索引缺失时为内置的基本类别名
+    long LinkWidth = 0;          // 当前 PCIe 链路宽度 (xN)，0 表示未知或非 PCIe
+    long MaxLinkWidth = 0;
+    wxString LinkSpeed;          // 当前链路速率，如 "8.0 GT/s"
+    wxString MaxLinkSpeed;
+    long NumaNode = -1;          // -1 表示未知或单节点
+    wxString Driver;             // 驱动 / 服务名
+
+    bool operator==(const PciDevice&) const = default;
+};
+
+// ========== NUMA 节点 ==========
+struct NumaNode
+{
+    long Id = 0;
+    wxString Cpus;               // 逻辑处理器列表，如 "0-15,32-47"
+    long CpuCount = 0;
+    long MemoryTotalMB = 0;      // 0 表示未知
+    long MemoryFreeMB = 0;
+    wxString Distances;          // 到各节点（按 NumaNodes 顺序）的距离，空格分隔，如 "10 21"；未知为空
+    wxString HugePages;          // 大页池 "页大小kB:总数/空闲"，空格分隔，如 "2048kB:512/480"；无则为空
+
+    bool operator==(const NumaNode&) const = default;
+};
+
+// ========== 硬盘性能测试结果 ==========
+// 由界面按需运行（见 diskbench.h），不属于任何探测；重新采集时保留
+struct DiskBenchmark
+{
+    wxString Disk;               // 硬盘型号，与 DiskModels 中的一项一致
+    wxString Path;               // 测试文件所在目录
+    wxString Time;               // 测试时间，如 "2026-10-18 21:30:05"
+    wxString Test;               // "seq-write"、"seq-read"、"rand-read"
+    long BlockSize = 0;          // 字节
+    long QueueDepth = 0;
+    wxString Engine;             // "iocp"、"io_uring"、"threads"
+    long Direct = 0;             // 1 表示绕过系统缓存
+    long ThroughputKBps = 0;     // 10^3 字节/秒
+    long Iops = 0;
+    long LatencyAvgUs = 0;       // 单次请求从提交到完成
+    long LatencyP50Us = 0;
+    long LatencyP99Us = 0;
+    long LatencyP999Us = 0;
+    long LatencyMaxUs = 0;
+
+    bool operator==(const DiskBenchmark&) const = default;
+};
+
+// ========== 内存性能测试结果 ==========
+// 由界面按需运行（见 membench.h），不属于任何探测；重新采集时保留
+struct MemoryBandwidth
+{
+    wxString Kernel;             // "copy"、"scale"、"add"、"triad"
+    long NonTemporal = 0;        // 1 表示流式写（绕过缓存）
+    long Node = -1;              // 测试线程与数组所在的 NUMA 节点；-1 表示全部节点
+    long Threads = 0;            // 每个物理核一个线程
+    long MBps = 0;               // 10^6 字节/秒，按 STREAM 口径计字节
+
+    bool operator==(const MemoryBandwidth&) const = default;
+};
+
+struct MemoryLatency
+{
+    long WorkingSetKB = 0;       // 随机指针追逐的工作集大小
+    long LatencyPs = 0;          // 单次依赖载入，皮秒
+
+    bool operator==(const MemoryLatency&) const = default;
+};
+
+// ========== CPU 性能测试结果 ==========
+// 由界面按需运行（见 cpubench.h），不属于任何探测；重新采集时保留。分数只在同一版本的测试之间可比
+struct CpuBenchmark
+{
+    wxString Mode;               // "quick"、"soak"，每种模式保留最近一次
+    wxString Time;
+    wxString Isa;                // 评分所用指令集："scalar"、"sse4.1"、"avx2"、"avx512"
+    long Threads = 0;            // 全核测试的线程数
+    long Cores = 0;              // 物理核数
+    long SingleCoreScore = 0;
+    long AllCoreScore = 0;
+    long ScalingPermille = 0;    // 全核分数 / (线程数 × 单核分数)，千分比
+    long BurstMHz = 0;           // 空闲单核；0 表示无法测量
+    long SustainedMHz = 0;       // 全核满载
+
+    bool operator==(const CpuBenchmark&) const = default;
+};
+
+// 最近一次测试的各内核单线程速率
+struct CpuKernelRate
+{
+    wxString Kernel;             // "integer"、"float"、"hash"、"compress"
+    wxString Isa;
+    long Rate = 0;               // 百万单位/秒，单位见 cpubench::KernelUnit
+
+    bool operator==(const CpuKernelRate&) const = default;
+};
+
+// 最近一次测试的扩展曲线
+struct CpuScalingPoint
+{
+    long Threads = 0;
+    long Pinned = 0;             // 1 表示每个线程绑定到一个逻辑处理器
+    long Score = 0;
+    long MHz = 0;
+
+    bool operator==(const CpuScalingPoint&) const = default;
+};
+
+// ========== 插件字段 ==========
+// 由插件探测产生（见 mt_plugin.h、plugins.h），按探测表顺序，探测内按写入顺序
+struct PluginField
+{
+    wxString Section;            // 插件探测的节名，与 ProbeReport::Section 一致
+    wxString Key;                // 探测内唯一，如 "ControllerModel"
+    wxString Value;
+    long Volatile = 0;           // 1 表示易变：取值变化不计入 Diff，不参与指纹
+    long Fingerprint = 0;        // 1 表示参与分组件指纹
+
+    bool operator==(const PluginField&) const = default;
+};
+
+// ========== 采集能耗 ==========
+// 每次采集期间各 RAPL 计数器（见 energy.h）的能耗，用于发布工具本身每次采集的焦耳数。
+// 毫焦、毫瓦：long 在 Windows 上只有 32 位
+struct EnergyReading
+{
+    wxString Domain;             // "package-0"、"package-0/core"、"psys" ...
+    wxString Source;             // "powercap"、"msr"、"emi"
+    long PowerMw = 0;            // 采集期间的平均功率
+    long CollectionMj = 0;       // 采集期间该域的全部能耗（含其它进程）
+    long AttributedMj = 0;       // 按采集线程所占 CPU 时间份额折算的能耗（估计值，不含同进程的其它线程）
+
+    bool operator==(const EnergyReading&) const = default;
+};
+
+// ========== 调优检查 ==========
+// 采集之后按规则包（见 audit.h）检查主机配置，每条未通过的规则一条
+struct AuditFinding
+{
+    wxString Rule;               // 规则 ID，如 "cpu-governor"
+    wxString Severity;           // "info"、"warning"、"critical"
+    wxString Title;
+    wxString Detail;             // 不满足期望的项与实际值
+    wxString Advice;
+
+    bool operator==(const AuditFinding&) const = default;
+};
+
+// ========== 硬件快照 ==========
+// 采集结果的全部字段。Hardware 与界面的 HardwareData 都以它为基类，
+// 采集线程把结果整体移动给界面，不再逐字段深拷贝。
+// 新增字段只需在这里声明，并在下方 HardwareSnapshotSchema 中登记一行。
+struct HardwareSnapshot
+{
+    // 主板
+    wxString BaseBoardManufacturer;  // 主板制造商
+    wxString BaseBoardProduct;       // 主板型号
+
+    // CPU
+    wxString CPUManufacturer;        // CPU厂商 (GenuineIntel/AMD)
+    wxString CPUName;                // CPU型号字符串
+    long CPUMaxClockSpeed = 0;       // CPU主频 (MHz)
+
+    // 内存
+    wxString TotalPhysicalMemory;    // 总物理内存 (bytes)
+    wxString MemoryType;             // 内存类型 (e.g., "DDR4")
+    wxString MemorySpeed;            // 内存频率 (MHz)
+    wxString MemoryRatedSpeed;       // 内存条额定频率 (MT/s，SMBIOS)，取不到为空
+
+    // 硬盘
+    std::vector<wxString> DiskModels;          // 硬盘型号列表
+    std::vector<wxString> DiskSerialNumbers;   // 硬盘序列号列表
+
+    // 网卡
+    std::vector<wxString> MACAddresses;        // MAC地址列表
+
+    // BIOS
+    wxString BIOSManufacturer;       // BIOS制造商
+    wxString BIOSVersion;            // BIOS版本
+    wxString BIOSReleaseDate;        // BIOS发布日期
+
+    // 系统
+    wxString SystemUUID;             // 系统UUID (机器唯一标识)
+    wxString MachineFingerprint;     // 生成的机器指纹（用于授权绑定）
+    wxString ComponentFingerprintCode;  // 分组件指纹编码（容忍部分组件更换，见 fingerprint.h）
+
+    // 各探测的状态，按探测表顺序
+    std::vector<ProbeReport> ProbeReports;
+
+    // PCI 设备（显卡、RAID/HBA、网卡芯片等），按总线地址排序
+    std::vector<PciDevice> PciDevices;
+
+    // NUMA 拓扑，按节点号排序；非 NUMA 机器为单个节点
+    std::vector<NumaNode> NumaNodes;
+
+    // 硬盘性能测试，每个硬盘每项测试一条
+    std::vector<DiskBenchmark> DiskBenchmarks;
+
+    // 内存性能测试：各内核的带宽，以及按工作集升序的访问延迟曲线
+    std::vector<MemoryBandwidth> MemoryBandwidths;
+    std::vector<MemoryLatency> MemoryLatencies;
+
+    // CPU 性能测试：摘要（每种模式一条）、各内核速率与扩展曲线
+    std::vector<CpuBenchmark> CpuBenchmarks;
+    std::vector<CpuKernelRate> CpuKernelRates;
+    std::vector<CpuScalingPoint> CpuScaling;
+
+    // 插件探测的输出，各插件的节名见 ProbeReports
+    std::vector<PluginField> PluginFields;
+
+    // 本次采集的能耗，每个 RAPL 计数器一条；没有可读计数器时为空
+    std::vector<EnergyReading> EnergyReadings;
+
+    // 运行环境（见 environment.h）：虚拟化与容器标记，以及扣除 cgroup / 作业对象限制后实际可用的资源
+    wxString Virtualization;         // "physical"、"vm"、"container"、"vm+container"
+    wxString Hypervisor;             // "KVM"、"Hyper-V" ...；物理机为 "none"，Hyper-V 根分区为 "Hyper-V (root)"
+    wxString Container;              // "docker"、"kubernetes" ...；不在容器中为 "none"
+    wxString ResourceLimits;         // 限制来源："cgroup v2"、"cgroup v1"、"job"；没有为空
+    long LogicalProcessors = 0;      // 操作系统可见的逻辑处理器数
+    wxString AllowedCpus;            // 可调度的逻辑处理器，如 "0-3"
+    long CpuQuotaMilli = 0;          // CPU 配额（千分之一核），0 表示不限
+    long EffectiveCpuMilli = 0;      // 实际可用的处理器（千分之一核）
+    wxString MemoryLimit;            // 内存上限 (bytes)，不限为空
+    wxString EffectiveMemory;        // 实际可用的内存 (bytes)
+
+    // 调优检查的发现，按规则包顺序；全部通过时为空
+    std::vector<AuditFinding> AuditFindings;
+};
+
+// ========== 编译期字段表 ==========
+namespace schema
+{
+    template <typename Owner, typename T>
+    struct Field
+    {
+        const char* name;      // 稳定键名：文本/二进制格式与 C 接口均使用此名
+        const char* section;   // 所属探测，与 ProbeReport::Section 一致（无则为 nullptr）
+        T Owner::* member;
+    };
+
+    template <typename Owner, typename T>
+    constexpr Field<Owner, T> MakeField(const char* name, const char* section, T Owner::* member)
+    {
+        return Field<Owner, T>{ name, section, member };
+    }
+
+    // 对字段表中的每个描述符调用 fn(field)，在编译期展开
+    template <typename Schema, typename Fn>
+    constexpr void ForEachField(const Schema& fields, Fn&& fn)
+    {
+        std::apply([&](const auto&... field) { (fn(field), ...); }, fields);
+    }
+}
+
+// 列表元素的字段表：键名展开为 "PciDevices[0].VendorId"，二进制格式中每个元素是一组带名记录
+inline constexpr auto PciDeviceSchema = std::make_tuple(
+    schema::MakeField("Address", (const char*)nullptr, &PciDevice::Address),
+    schema::MakeField("VendorId", (const char*)nullptr, &PciDevice::VendorId),
+    schema::MakeField("DeviceId", (const char*)nullptr, &PciDevice::DeviceId),
+    schema::MakeField("SubsystemVendorId", (const char*)nullptr, &PciDevice::SubsystemVendorId),
+    schema::MakeField("SubsystemId", (const char*)nullptr, &PciDevice::SubsystemId),
+    schema::MakeField("ClassCode", (const char*)nullptr, &PciDevice::ClassCode),
+    schema::MakeField("VendorName", (const char*)nullptr, &PciDevice::VendorName),
+    schema::MakeField("DeviceName", (const char*)nullptr, &PciDevice::DeviceName),
+    schema::MakeField("SubsystemName", (const char*)nullptr, &PciDevice::SubsystemName),
+    schema::MakeField("ClassName", (const char*)nullptr, &PciDevice::ClassName),
+    schema::MakeField("LinkWidth", (const char*)nullptr, &PciDevice::LinkWidth),
+    schema::MakeField("MaxLinkWidth", (const char*)nullptr, &PciDevice::MaxLinkWidth),
+    schema::MakeField("LinkSpeed", (const char*)nullptr, &PciDevice::LinkSpeed),
+    schema::MakeField("MaxLinkSpeed", (const char*)nullptr, &PciDevice::MaxLinkSpeed),
+    schema::MakeField("NumaNode", (const char*)nullptr, &PciDevice::NumaNode),
+    schema::MakeField("Driver", (const char*)nullptr, &PciDevice::Driver)
+);
+
+inline constexpr auto NumaNodeSchema = std::make_tuple(
+    schema::MakeField("Id", (const char*)nullptr, &NumaNode::Id),
+    schema::MakeField("Cpus", (const char*)nullptr, &NumaNode::Cpus),
+    schema::MakeField("CpuCount", (const char*)nullptr, &NumaNode::CpuCount),
+    schema::MakeField("MemoryTotalMB", (const char*)nullptr, &NumaNode::MemoryTotalMB),
+    schema::MakeField("MemoryFreeMB", (const char*)nullptr, &NumaNode::MemoryFreeMB),
+    schema::MakeField("Distances", (const char*)nullptr, &NumaNode::Distances),
+    schema::MakeField("HugePages", (const char*)nullptr, &NumaNode::HugePages)
+);
+
+inline constexpr auto DiskBenchmarkSchema = std::make_tuple(
+    schema::MakeField("Disk", (const char*)nullptr, &DiskBenchmark::Disk),
+    schema::MakeField("Path", (const char*)nullptr, &DiskBenchmark::Path),
+    schema::MakeField("Time", (const char*)nullptr, &DiskBenchmark::Time),
+    schema::MakeField("Test", (const char*)nullptr, &DiskBenchmark::Test),
+    schema::MakeField("BlockSize", (const char*)nullptr, &DiskBenchmark::BlockSize),
+    schema::MakeField("QueueDepth", (const char*)nullptr, &DiskBenchmark::QueueDepth),
+    schema::MakeField("Engine", (const char*)nullptr, &DiskBenchmark::Engine),
+    schema::MakeField("Direct", (const char*)nullptr, &DiskBenchmark::Direct),
+    schema::MakeField("ThroughputKBps", (const char*)nullptr, &DiskBenchmark::ThroughputKBps),
+    schema::MakeField("Iops", (const char*)nullptr, &DiskBenchmark::Iops),
+    schema::MakeField("LatencyAvgUs", (const char*)nullptr, &DiskBenchmark::LatencyAvgUs),
+    schema::MakeField("LatencyP50Us", (const char*)nullptr, &DiskBenchmark::LatencyP50Us),
+    schema::MakeField("LatencyP99Us", (const char*)nullptr, &DiskBenchmark::LatencyP99Us),
+    schema::MakeField("LatencyP999Us", (const char*)nullptr, &DiskBenchmark::LatencyP999Us),
+    schema::MakeField("LatencyMaxUs", (const char*)nullptr, &DiskBenchmark::LatencyMaxUs)
+);
+
+inline constexpr auto MemoryBandwidthSchema = std::make_tuple(
+    schema::MakeField("Kernel", (const char*)nullptr, &MemoryBandwidth::Kernel),
+    schema::MakeField("NonTemporal", (const char*)nullptr, &MemoryBandwidth::NonTemporal),
+    schema::MakeField("Node", (const char*)nullptr, &MemoryBandwidth::Node),
+    schema::MakeField("Threads", (const char*)nullptr, &MemoryBandwidth::Threads),
+    schema::MakeField("MBps", (const char*)nullptr, &MemoryBandwidth::MBps)
+);
+
+inline constexpr auto MemoryLatencySchema = std::make_tuple(
+    schema::MakeField("WorkingSetKB", (const char*)nullptr, &MemoryLatency::WorkingSetKB),
+    schema::MakeField("LatencyPs", (const char*)nullptr, &MemoryLatency::LatencyPs)
+);
+
+inline constexpr auto CpuBenchmarkSchema = std::make_tuple(
+    schema::MakeField("Mode", (const char*)nullptr, &CpuBenchmark::Mode),
+    schema::MakeField("Time", (const char*)nullptr, &CpuBenchmark::Time),
+    schema::MakeField("Isa", (const char*)nullptr, &CpuBenchmark::Isa),
+    schema::MakeField("Threads", (const char*)nullptr, &CpuBenchmark::Threads),
+    schema::MakeField("Cores", (const char*)nullptr, &CpuBenchmark::Cores),
+    schema::MakeField("SingleCoreScore", (const char*)nullptr, &CpuBenchmark::SingleCoreScore),
+    schema::MakeField("AllCoreScore", (const char*)nullptr, &CpuBenchmark::AllCoreScore),
+    schema::MakeField("ScalingPermille", (const char*)nullptr, &CpuBenchmark::ScalingPermille),
+    schema::MakeField("BurstMHz", (const char*)nullptr, &CpuBenchmark::BurstMHz),
+    schema::MakeField("SustainedMHz", (const char*)nullptr, &CpuBenchmark::SustainedMHz)
+);
+
+inline constexpr auto CpuKernelRateSchema = std::make_tuple(
+    schema::MakeField("Kernel", (const char*)nullptr, &CpuKernelRate::Kernel),
+    schema::MakeField("Isa", (const char*)nullptr, &CpuKernelRate::Isa),
+    schema::MakeField("Rate", (const char*)nullptr, &CpuKernelRate::Rate)
+);
+
+inline constexpr auto CpuScalingPointSchema = std::make_tuple(
+    schema::MakeField("Threads", (const char*)nullptr, &CpuScalingPoint::Threads),
+    schema::MakeField("Pinned", (const char*)nullptr, &CpuScalingPoint::Pinned),
+    schema::MakeField("Score", (const char*)nullptr, &CpuScalingPoint::Score),
+    schema::MakeField("MHz", (const char*)nullptr, &CpuScalingPoint::MHz)
+);
+
+inline constexpr auto PluginFieldSchema = std::make_tuple(
+    schema::MakeField("Section", (const char*)nullptr, &PluginField::Section),
+    schema::MakeField("Key", (const char*)nullptr, &PluginField::Key),
+    schema::MakeField("Value", (const char*)nullptr, &PluginField::Value),
+    schema::MakeField("Volatile", (const char*)nullptr, &PluginField::Volatile),
+    schema::MakeField("Fingerprint", (const char*)nullptr, &PluginField::Fingerprint)
+);
+
+inline constexpr auto EnergyReadingSchema = std::make_tuple(
+    schema::MakeField("Domain", (const char*)nullptr, &EnergyReading::Domain),
+    schema::MakeField("Source", (const char*)nullptr, &EnergyReading::Source),
+    schema::MakeField("PowerMw", (const char*)nullptr, &EnergyReading::PowerMw),
+    schema::MakeField("CollectionMj", (const char*)nullptr, &EnergyReading::CollectionMj),
+    schema::MakeField("AttributedMj", (const char*)nullptr, &EnergyReading::AttributedMj)
+);
+
+inline constexpr auto AuditFindingSchema = std::make_tuple(
+    schema::MakeField("Rule", (const char*)nullptr, &AuditFinding::Rule),
+    schema::MakeField("Severity", (const char*)nullptr, &AuditFinding::Severity),
+    schema::MakeField("Title", (const char*)nullptr, &AuditFinding::Title),
+    schema::MakeField("Detail", (const char*)nullptr, &AuditFinding::Detail),
+    schema::MakeField("Advice", (const char*)nullptr, &AuditFinding::Advice)
+);
+
+namespace schema
+{
+    // 结构列表元素类型 → 其字段表；新增结构列表时在此特化一行
+    template <typename Record>
+    struct RecordSchema {};
+
+    template <>
+    struct RecordSchema<PciDevice> { static constexpr const auto& fields = PciDeviceSchema; };
+
+    template <>
+    struct RecordSchema<NumaNode> { static constexpr const auto& fields = NumaNodeSchema; };
+
+    template <>
+    struct RecordSchema<DiskBenchmark> { static constexpr const auto& fields = DiskBenchmarkSchema; };
+
+    template <>
+    struct RecordSchema<MemoryBandwidth> { static constexpr const auto& fields = MemoryBandwidthSchema; };
+
+    template <>
+    struct RecordSchema<MemoryLatency> { static constexpr const auto& fields = MemoryLatencySchema; };
+
+    template <>
+    struct RecordSchema<CpuBenchmark> { static constexpr const auto& fields = CpuBenchmarkSchema; };
+
+    template <>
+    struct RecordSchema<CpuKernelRate> { static constexpr const auto& fields = CpuKernelRateSchema; };
+
+    template <>
+    struct RecordSchema<CpuScalingPoint> { static constexpr const auto& fields = CpuScalingPointSchema; };
+
+    template <>
+    struct RecordSchema<PluginField> { static constexpr const auto& fields = PluginFieldSchema; };
+
+    template <>
+    struct RecordSchema<EnergyReading> { static constexpr const auto& fields = EnergyReadingSchema; };
+
+    template <>
+    struct RecordSchema<AuditFinding> { static constexpr const auto& fields = AuditFindingSchema; };
+}
+
+// 顺序即序列化与 C 接口的字段顺序，只在末尾追加
+inline constexpr auto HardwareSnapshotSchema = std::make_tuple(
+    schema::MakeField("BaseBoardManufacturer", "BaseBoard", &HardwareSnapshot::BaseBoardManufacturer),
+    schema::MakeField("BaseBoardProduct", "BaseBoard", &HardwareSnapshot::BaseBoardProduct),
+    schema::MakeField("CPUManufacturer", "CPU", &HardwareSnapshot::CPUManufacturer),
+    schema::MakeField("CPUName", "CPU", &HardwareSnapshot::CPUName),
+    schema::MakeField("CPUMaxClockSpeed", "CPU", &HardwareSnapshot::CPUMaxClockSpeed),
+    schema::MakeField("TotalPhysicalMemory", "Memory", &HardwareSnapshot::TotalPhysicalMemory),
+    schema::MakeField("MemoryType", "Memory", &HardwareSnapshot::MemoryType),
+    schema::MakeField("MemorySpeed", "Memory", &HardwareSnapshot::MemorySpeed),
+    schema::MakeField("DiskModels", "Disk", &HardwareSnapshot::DiskModels),
+    schema::MakeField("DiskSerialNumbers", "Disk", &HardwareSnapshot::DiskSerialNumbers),
+    schema::MakeField("MACAddresses", "Network", &HardwareSnapshot::MACAddresses),
+    schema::MakeField("BIOSManufacturer", "BIOS", &HardwareSnapshot::BIOSManufacturer),
+    schema::MakeField("BIOSVersion", "BIOS", &HardwareSnapshot::BIOSVersion),
+    schema::MakeField("BIOSReleaseDate", "BIOS", &HardwareSnapshot::BIOSReleaseDate),
+    schema::MakeField("SystemUUID", "SystemUUID", &HardwareSnapshot::SystemUUID),
+    schema::MakeField("MachineFingerprint", (const char*)nullptr, &HardwareSnapshot::MachineFingerprint),
+    schema::MakeField("ComponentFingerprint", (const char*)nullptr, &HardwareSnapshot::ComponentFingerprintCode),
+    schema::MakeField("Status", (const char*)nullptr, &HardwareSnapshot::ProbeReports),
+    schema::MakeField("PciDevices", "PCI", &HardwareSnapshot::PciDevices),
+    schema::MakeField("NumaNodes", "NUMA", &HardwareSnapshot::NumaNodes),
+    schema::MakeField("DiskBenchmarks", (const char*)nullptr, &HardwareSnapshot::DiskBenchmarks),
+    schema::MakeField("MemoryBandwidths", (const char*)nullptr, &HardwareSnapshot::MemoryBandwidths),
+    schema::MakeField("MemoryLatencies", (const char*)nullptr, &HardwareSnapshot::MemoryLatencies),
+    schema::MakeField("CpuBenchmarks", (const char*)nullptr, &HardwareSnapshot::CpuBenchmarks),
+    schema::MakeField("CpuKernelRates", (const char*)nullptr, &HardwareSnapshot::CpuKernelRates),
+    schema::MakeField("CpuScaling", (const char*)nullptr, &HardwareSnapshot::CpuScaling),
+    schema::MakeField("PluginFields", (const char*)nullptr, &HardwareSnapshot::PluginFields),
+    schema::MakeField("EnergyReadings", (const char*)nullptr, &HardwareSnapshot::EnergyReadings),
+    schema::MakeField("Virtualization", "Environment", &HardwareSnapshot::Virtualization),
+    schema::MakeField("Hypervisor", "Environment", &HardwareSnapshot::Hypervisor),
+    schema::MakeField("Container", "Environment", &HardwareSnapshot::Container),
+    schema::MakeField("ResourceLimits", "Environment", &HardwareSnapshot::ResourceLimits),
+    schema::MakeField("LogicalProcessors", "Environment", &HardwareSnapshot::LogicalProcessors),
+    schema::MakeField("AllowedCpus", "Environment", &HardwareSnapshot::AllowedCpus),
+    schema::MakeField("CpuQuotaMilli", "Environment", &HardwareSnapshot::CpuQuotaMilli),
+    schema::MakeField("EffectiveCpuMilli", "Environment", &HardwareSnapshot::EffectiveCpuMilli),
+    schema::MakeField("MemoryLimit", "Environment", &HardwareSnapshot::MemoryLimit),
+    schema::MakeField("EffectiveMemory", "Environment", &HardwareSnapshot::EffectiveMemory),
+    schema::MakeField("MemoryRatedSpeed", "Memory", &HardwareSnapshot::MemoryRatedSpeed),
+    schema::MakeField("AuditFindings", (const char*)nullptr, &HardwareSnapshot::AuditFindings)
+);
+
+// ========== 由字段表生成的操作 ==========
+namespace schema
+{
+    // 扁平键值（UTF-8）：列表展开为 "DiskModels[0]"，探测状态展开为 "Status.Disk" = "timed-out"，
+    // 结构列表展开为 "PciDevices[0].DeviceName"
+    using KeyValueSink = std::function<void(const std::string& key, const std::string& value)>;
+    void ForEachKeyValue(const HardwareSnapshot& snap, const KeyValueSink& sink);
+
+    // 文本格式：每行 "键=值"，值中的 '\\' 与换行转义；探测耗时不进入文本格式
+    std::string ToText(const HardwareSnapshot& snap);
+    bool FromText(const std::string& text, HardwareSnapshot* out);
+
+    // 二进制格式：魔数 "MTS1" + 按字段的带长度记录，读取时跳过未知字段
+    std::string ToBinary(const HardwareSnapshot& snap);
+    bool FromBinary(const std::string& data, HardwareSnapshot* out);
+
+    // 增量格式：魔数 "MTD1" + 与 base 相比变化的字段（记录格式同二进制），结构列表逐元素只写变化的字段。
+    // 探测耗时的变化不进入增量；易变插件字段与采集能耗的取值照常写入
+    std::string ToBinaryDelta(const HardwareSnapshot& base, const HardwareSnapshot& snap);
+    // 把增量应用到 *inout（应为写出增量时的 base）；失败时 *inout 不变
+    bool ApplyBinaryDelta(const std::string& data, HardwareSnapshot* inout);
+
+    // 逐字段比较；探测状态只比较名称与状态，不比较耗时；易变插件字段只比较键，不比较取值；
+    // 采集能耗只比较计数器（域与来源），读数的变化不算作硬件变化
+    struct FieldChange
+    {
+        const char* name;
+        const char* section;
+    };
+    std::vector<FieldChange> Diff(const HardwareSnapshot& a, const HardwareSnapshot& b);
+
+    // 把 src 中属于 section 的字段移动到 dst（合并各探测的临时结果）
+    void MoveSection(HardwareSnapshot& dst, HardwareSnapshot& src, const char* section);
+
+    // 按键名查找字段所属探测，未找到返回 nullptr
+    const char* SectionOf(const char* name);
+}
+
+#endif // SNAPSHOT_H
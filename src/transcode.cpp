@@ -0,0 +1,170 @@
+#include "transcode.h"
+#include <cstdint>
+#include <cstring>   // memcpy
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define TRANSCODE_SSE2 1
+#endif
+
+namespace transcode
+{
+
+static const char16_t kReplacement = 0xFFFD;
+
+// 写入一个码点的 UTF-8 编码，返回字节数
+static inline size_t EncodeUtf8(uint32_t cp, char* dst)
+{
+    if (cp < 0x80) {
+        dst[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        dst[0] = (char)(0xC0 | (cp >> 6));
+        dst[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        dst[0] = (char)(0xE0 | (cp >> 12));
+        dst[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        dst[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    dst[0] = (char)(0xF0 | (cp >> 18));
+    dst[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    dst[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    dst[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+// ========== UTF-16 → UTF-8 ==========
+size_t Utf16ToUtf8(const char16_t* src, size_t len, char* dst)
+{
+    char* out = dst;
+    size_t i = 0;
+
+    while (i < len) {
+#ifdef TRANSCODE_SSE2
+        // ASCII 快速路径：8 个码元全部 < 0x80 时直接压缩为 8 字节
+        const __m128i highMask = _mm_set1_epi16((short)0xFF80);
+        while (i + 8 <= len) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i high = _mm_and_si128(v, highMask);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) != 0xFFFF) break;
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(v, v));
+            out += 8;
+            i += 8;
+        }
+        if (i >= len) break;
+#endif
+        uint32_t c = src[i++];
+        if (c < 0x80) {
+            *out++ = (char)c;
+            continue;
+        }
+        if (c >= 0xD800 && c <= 0xDBFF) {
+            // 高代理项：需要紧跟低代理项
+            if (i < len && src[i] >= 0xDC00 && src[i] <= 0xDFFF) {
+                uint32_t lo = src[i++];
+                c = 0x10000 + ((c - 0xD800) << 10) + (lo - 0xDC00);
+            } else {
+                c = kReplacement;
+            }
+        } else if (c >= 0xDC00 && c <= 0xDFFF) {
+            c = kReplacement;  // 孤立低代理项
+        }
+        out += EncodeUtf8(c, out);
+    }
+
+    return (size_t)(out - dst);
+}
+
+// ========== UTF-8 → UTF-16 ==========
+size_t Utf8ToUtf16(const char* src, size_t len, char16_t* dst)
+{
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(src);
+    char16_t* out = dst;
+    size_t i = 0;
+
+    while (i < len) {
+#ifdef TRANSCODE_SSE2
+        // ASCII 快速路径：16 字节最高位全为 0 时零扩展为 16 个码元
+        while (i + 16 <= len) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+            if (_mm_movemask_epi8(v) != 0) break;
+            __m128i zero = _mm_setzero_si128();
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(v, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(v, zero));
+            out += 16;
+            i += 16;
+        }
+        if (i >= len) break;
+#endif
+        uint32_t c = s[i];
+        if (c < 0x80) {
+            *out++ = (char16_t)c;
+            ++i;
+            continue;
+        }
+
+        // 多字节序列：确定长度与最小码点（拒绝超长编码）
+        size_t need;
+        uint32_t minCp;
+        if ((c & 0xE0) == 0xC0)      { need = 1; minCp = 0x80;    c &= 0x1F; }
+        else if ((c & 0xF0) == 0xE0) { need = 2; minCp = 0x800;   c &= 0x0F; }
+        else if ((c & 0xF8) == 0xF0) { need = 3; minCp = 0x10000; c &= 0x07; }
+        else {
+            *out++ = kReplacement;
+            ++i;
+            continue;
+        }
+
+        size_t j = 1;
+        for (; j <= need && i + j < len; ++j) {
+            unsigned char cc = s[i + j];
+            if ((cc & 0xC0) != 0x80) break;
+            c = (c << 6) | (cc & 0x3F);
+        }
+        if (j <= need) {
+            // 截断或中途遇到非续字节：只消费已检查过的字节
+            *out++ = kReplacement;
+            i += j;
+            continue;
+        }
+        i += need + 1;
+
+        if (c < minCp || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+            *out++ = kReplacement;
+        } else if (c >= 0x10000) {
+            c -= 0x10000;
+            *out++ = (char16_t)(0xD800 + (c >> 10));
+            *out++ = (char16_t)(0xDC00 + (c & 0x3FF));
+        } else {
+            *out++ = (char16_t)c;
+        }
+    }
+
+    return (size_t)(out - dst);
+}
+
+size_t Utf16Length(const char16_t* src, size_t maxLen)
+{
+    size_t n = 0;
+    while (n < maxLen && src[n] != 0) ++n;
+    return n;
+}
+
+// ========== 十进制数字 ==========
+size_t FormatDecimal(unsigned long long value, char* dst)
+{
+    char digits[kMaxDecimalLength];
+    size_t n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    for (size_t i = 0; i < n; ++i) dst[i] = digits[n - 1 - i];
+    return n;
+}
+
+} // namespace transcode
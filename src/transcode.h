@@ -0,0 +1,62 @@
+#ifndef TRANSCODE_H
+#define TRANSCODE_H
+
+#include <cstddef>
+#include <memory>
+
+// ========== UTF-16 ⇄ UTF-8 转码层 ==========
+// 单趟转换：输出缓冲区按最坏情况一次性预留，不再"先测长度再转换"。
+// 纯 ASCII 段走 SIMD 快速路径（SSE2，每次 8/16 个字符），其余逐字符处理。
+// 不依赖 windows.h / wxWidgets，可在 Linux 上独立编译测试。
+namespace transcode
+{
+    // 最坏情况下的输出长度（不含结尾 NUL）
+    // UTF-16 每个码元最多 3 字节（代理对 2 码元 → 4 字节）
+    constexpr size_t MaxUtf8Length(size_t utf16Len) { return utf16Len * 3; }
+    // UTF-8 每个字节最多产生 1 个 UTF-16 码元
+    constexpr size_t MaxUtf16Length(size_t utf8Len) { return utf8Len; }
+
+    // UTF-16 → UTF-8，dst 容量至少为 MaxUtf8Length(len)，返回写入字节数
+    // 孤立代理项替换为 U+FFFD
+    size_t Utf16ToUtf8(const char16_t* src, size_t len, char* dst);
+
+    // UTF-8 → UTF-16，dst 容量至少为 MaxUtf16Length(len)，返回写入码元数
+    // 非法序列替换为 U+FFFD
+    size_t Utf8ToUtf16(const char* src, size_t len, char16_t* dst);
+
+    // 以 NUL 结尾或长度受限的 UTF-16 串长度（注册表缓冲区可能带结尾 NUL）
+    size_t Utf16Length(const char16_t* src, size_t maxLen);
+
+    // 无符号整数的十进制 ASCII，dst 容量至少为 kMaxDecimalLength，返回写入字节数（不写 NUL）。
+    // 数值字段不必经 printf 格式化再转宽字符
+    constexpr size_t kMaxDecimalLength = 20;
+    size_t FormatDecimal(unsigned long long value, char* dst);
+
+    // ===== 小缓冲区：N 个元素以内放在栈上，超出时才堆分配 =====
+    template <typename T, size_t N>
+    class SmallBuffer
+    {
+    public:
+        explicit SmallBuffer(size_t capacity)
+            : m_data(m_inline)
+        {
+            if (capacity > N) {
+                m_heap.reset(new T[capacity]);
+                m_data = m_heap.get();
+            }
+        }
+
+        SmallBuffer(const SmallBuffer&) = delete;
+        SmallBuffer& operator=(const SmallBuffer&) = delete;
+
+        T* data() { return m_data; }
+        const T* data() const { return m_data; }
+
+    private:
+        T m_inline[N];
+        std::unique_ptr<T[]> m_heap;
+        T* m_data;
+    };
+}
+
+#endif // TRANSCODE_H
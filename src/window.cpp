@@ -9,48 +9,183 @@
 #include <wx/aboutdlg.h>
 #include <wx/txtstrm.h>
 #include <wx/wfstream.h>
+#include <wx/arrstr.h>
+#include <wx/choicdlg.h>
+#include <wx/dcbuffer.h>
+#include <wx/dirdlg.h>
+#include <wx/progdlg.h>
+#include <wx/filename.h>
+#include <wx/notebook.h>
+#include <wx/scrolwin.h>
+#include <wx/slider.h>
+#include <wx/stdpaths.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <stop_token>
+#include <thread>
+#include "diskbench.h"
+
+// ========== 采集执行器共享状态 ==========
+// 由执行器与线程共同持有：关闭超时后线程仍可安全访问，直到自行退出
+struct CollectorState
+{
+    wxMutex mutex;
+    wxCondition wakeCond;      // 有新请求或要求退出
+    wxCondition exitCond;      // 线程已退出
+    wxEvtHandler* handler;     // 关闭后置空，不再投递事件
+    std::stop_source stop;     // 当前这一轮的取消源
+    CollectOptions options;    // 采集预算：卡住的探测标记为超时，其余部分照常显示
+    unsigned long generation;  // 最新请求的代号
+    unsigned long running;     // 正在采集的代号（0 表示空闲）
+    bool pending;              // 有待执行的请求
+    bool quit;
+    bool exited;
+    
+    CollectorState(wxEvtHandler* h)
+        : wakeCond(mutex), exitCond(mutex), handler(h), generation(0), running(0),
+          pending(false), quit(false), exited(false)
+    {
+        options.TotalBudget = std::chrono::milliseconds(5000);
+        options.ProbeTimeout = std::chrono::milliseconds(3000);
+    }
+};
 
 // ========== 硬件采集线程实现 ==========
-HardwareCollectorThread::HardwareCollectorThread(wxEvtHandler* eventHandler)
-    : wxThread(wxTHREAD_DETACHED), m_eventHandler(eventHandler)
+HardwareCollectorThread::HardwareCollectorThread(std::shared_ptr<CollectorState> state)
+    : wxThread(wxTHREAD_DETACHED), m_state(std::move(state))
 {
 }
 
 wxThread::ExitCode HardwareCollectorThread::Entry()
 {
-    Hardware hw;
-    hw.GetInfo();
+    CollectorState& st = *m_state;
     
-    HardwareData data;
-    data.BaseBoardManufacturer = hw.BaseBoardManufacturer;
-    data.BaseBoardProduct = hw.BaseBoardProduct;
-    data.CPUManufacturer = hw.CPUManufacturer;
-    data.CPUName = hw.CPUName;
-    data.CPUMaxClockSpeed = hw.CPUMaxClockSpeed;
-    data.TotalPhysicalMemory = hw.TotalPhysicalMemory;
-    data.MemoryType = hw.MemoryType;
-    data.MemorySpeed = hw.MemorySpeed;
-    data.DiskModels = hw.DiskModels;
-    data.DiskSerialNumbers = hw.DiskSerialNumbers;
-    data.MACAddresses = hw.MACAddresses;
-    data.BIOSManufacturer = hw.BIOSManufacturer;
-    data.BIOSVersion = hw.BIOSVersion;
-    data.BIOSReleaseDate = hw.BIOSReleaseDate;
-    data.SystemUUID = hw.SystemUUID;
-    data.MachineFingerprint = hw.MachineFingerprint;
-    data.CollectionTime = wxDateTime::Now();
-    
-    wxThreadEvent* evt = new wxThreadEvent(wxEVT_THREAD, wxID_ANY);
-    evt->SetPayload<HardwareData>(data);
-    wxQueueEvent(m_eventHandler, evt);
+    for (;;) {
+        unsigned long generation;
+        std::stop_token stop;
+        {
+            wxMutexLocker lock(st.mutex);
+            while (!st.pending && !st.quit) {
+                st.wakeCond.Wait();
+            }
+            if (st.quit) break;
+            st.pending = false;
+            generation = st.generation;
+            st.running = generation;
+            stop = st.stop.get_token();
+        }
+        
+        // 界面只是异步采集接口的一个使用者：各探测在共享线程池上并发执行。
+        // 线程池不归本状态所有，关闭窗口时不会在卡住的探测上 join
+        Hardware hw = mt::SyncWait(Hardware::CollectAsync(Hardware::SharedPool(), stop, st.options));
+        
+        // 整体移动：字段只在 Hardware 中分配一次，之后经事件原样交给界面
+        auto data = std::make_shared<HardwareData>();
+        if (!stop.stop_requested()) {
+            static_cast<HardwareSnapshot&>(*data) = std::move(hw);
+            data->CollectionTime = wxDateTime::Now();
+        }
+        
+        wxMutexLocker lock(st.mutex);
+        st.running = 0;
+        // 已取消或已被取代的结果直接丢弃；窗口关闭后 handler 为空
+        if (!stop.stop_requested() && generation == st.generation && st.handler) {
+            wxThreadEvent* evt = new wxThreadEvent(wxEVT_THREAD, wxID_ANY);
+            evt->SetExtraLong((long)generation);
+            evt->SetPayload(data);
+            wxQueueEvent(st.handler, evt);
+        }
+    }
     
+    wxMutexLocker lock(st.mutex);
+    st.exited = true;
+    st.exitCond.Broadcast();
     return (wxThread::ExitCode)0;
 }
 
+// ========== 采集执行器实现 ==========
+HardwareCollector::HardwareCollector(wxEvtHandler* eventHandler)
+    : m_state(std::make_shared<CollectorState>(eventHandler)), m_started(false)
+{
+}
+
+HardwareCollector::~HardwareCollector()
+{
+    Shutdown();
+}
+
+bool HardwareCollector::Start()
+{
+    if (m_started) return true;
+    
+    HardwareCollectorThread* thread = new HardwareCollectorThread(m_state);
+    if (thread->Create() != wxTHREAD_NO_ERROR || thread->Run() != wxTHREAD_NO_ERROR) {
+        delete thread;
+        return false;
+    }
+    m_started = true;
+    return true;
+}
+
+unsigned long HardwareCollector::Request()
+{
+    wxMutexLocker lock(m_state->mutex);
+    // 已有请求排队，或正在采集且未被取代：并入当前这一轮
+    if (m_state->pending || (m_state->running != 0 && m_state->running == m_state->generation)) {
+        return m_state->generation;
+    }
+    m_state->pending = true;
+    ++m_state->generation;
+    m_state->wakeCond.Signal();
+    return m_state->generation;
+}
+
+bool HardwareCollector::Cancel()
+{
+    wxMutexLocker lock(m_state->mutex);
+    if (!m_state->pending && m_state->running == 0) return false;
+    m_state->stop.request_stop();
+    m_state->stop = std::stop_source();  // 下一轮使用新的取消源
+    m_state->pending = false;
+    ++m_state->generation;               // 使进行中的结果过期
+    return true;
+}
+
+void HardwareCollector::Shutdown(unsigned int timeoutMs)
+{
+    if (!m_started) return;
+    m_started = false;
+    
+    wxMutexLocker lock(m_state->mutex);
+    m_state->handler = nullptr;
+    m_state->quit = true;
+    m_state->stop.request_stop();
+    m_state->wakeCond.Signal();
+    
+    // 探测在步骤之间检查取消令牌；单个系统调用卡住时不无限等待，
+    // 线程稍后自行退出（共享状态由线程继续持有）
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!m_state->exited) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (left.count() <= 0) break;
+        m_state->exitCond.WaitTimeout((unsigned long)left.count());
+    }
+}
+
+bool HardwareCollector::IsCurrent(unsigned long generation) const
+{
+    wxMutexLocker lock(m_state->mutex);
+    return generation == m_state->generation;
+}
+
 // ========== 事件表 ==========
 wxBEGIN_EVENT_TABLE(MainWindow, wxFrame)
     EVT_THREAD(wxID_ANY, MainWindow::OnHardwareCollected)
     EVT_MENU(wxID_REFRESH, MainWindow::OnRefresh)
+    EVT_MENU(wxID_STOP, MainWindow::OnStop)
     EVT_MENU(wxID_COPY, MainWindow::OnCopyAll)
     EVT_MENU(wxID_SAVE, MainWindow::OnExport)
     EVT_MENU(wxID_EXIT, MainWindow::OnExit)
@@ -69,24 +204,854 @@ static bool wxStringToULL(const wxString& str, unsigned long long* out)
     return clean.ToULongLong(out);
 }
 
+static const ProbeReport* FindReport(const HardwareData& data, const char* section)
+{
+    if (!section) return nullptr;
+    for (const ProbeReport& report : data.ProbeReports) {
+        if (report.Section == section) return &report;
+    }
+    return nullptr;
+}
+
+// 探测状态的界面文字；正常完成时为空
+static wxString ProbeStatusText(ProbeStatus status)
+{
+    switch (status) {
+        case ProbeStatus::Fallback: return wxT("备用方案");
+        case ProbeStatus::Failed:   return wxT("采集失败");
+        case ProbeStatus::TimedOut: return wxT("超时");
+        case ProbeStatus::Skipped:  return wxT("已跳过");
+        case ProbeStatus::Hung:     return wxT("卡住未返回");
+        default:                    return wxEmptyString;
+    }
+}
+
+static bool IsMissing(ProbeStatus status)
+{
+    return status == ProbeStatus::Failed || status == ProbeStatus::TimedOut || status == ProbeStatus::Skipped ||
+           status == ProbeStatus::Hung;
+}
+
+// ========== 信息行格式化 ==========
+static wxString FormatBoardManufacturer(const HardwareData& data)
+{
+    return data.BaseBoardManufacturer.IsEmpty() || data.BaseBoardManufacturer.Contains(wxT("Unknown"))
+        ? wxString(wxT("未知"))
+        : data.BaseBoardManufacturer;
+}
+
+static wxString FormatBoardProduct(const HardwareData& data)
+{
+    return data.BaseBoardProduct.IsEmpty() || data.BaseBoardProduct.Contains(wxT("Unknown"))
+        ? wxString(wxT("未知"))
+        : data.BaseBoardProduct;
+}
+
+static wxString FormatCpu(const HardwareData& data)
+{
+    wxString cpuInfo = data.CPUName;
+    if (data.CPUMaxClockSpeed > 0) {
+        cpuInfo += wxString::Format(wxT(" @ %.2f GHz"), data.CPUMaxClockSpeed / 1000.0);
+    }
+    return cpuInfo.IsEmpty() ? wxString(wxT("未知")) : cpuInfo;
+}
+
+static wxString FormatMemory(const HardwareData& data)
+{
+    unsigned long long bytes = 0;
+    wxString memInfo = wxT("未知");
+    if (!data.TotalPhysicalMemory.IsEmpty() && wxStringToULL(data.TotalPhysicalMemory, &bytes) && bytes > 0) {
+        double gb = bytes / (1024.0 * 1024.0 * 1024.0);
+        memInfo = wxString::Format(wxT("%.2f GB"), gb);
+        if (!data.MemoryType.IsEmpty() && !data.MemoryType.Contains(wxT("Unknown"))) {
+            memInfo += wxT(" (") + data.MemoryType + wxT(")");
+        }
+        if (!data.MemoryRatedSpeed.IsEmpty() && !data.MemorySpeed.Contains(wxT("Unknown"))) {
+            memInfo += wxT(" ") + data.MemorySpeed + wxT(" / ") + data.MemoryRatedSpeed + wxT(" MT/s");
+        }
+    }
+    return memInfo;
+}
+
+static wxString FormatBios(const HardwareData& data)
+{
+    wxString biosInfo = data.BIOSManufacturer;
+    if (!data.BIOSVersion.IsEmpty() && !data.BIOSVersion.Contains(wxT("Unknown"))) {
+        if (!biosInfo.IsEmpty()) biosInfo += wxT(" v");
+        biosInfo += data.BIOSVersion;
+    }
+    return biosInfo.IsEmpty() ? wxString(wxT("未知")) : biosInfo;
+}
+
+static wxString FormatUuid(const HardwareData& data)
+{
+    return data.SystemUUID.IsEmpty() ? wxString(wxT("未知")) : data.SystemUUID.Left(36);
+}
+
+// ========== 运行环境格式化 ==========
+static wxString FormatEnvironment(const HardwareData& data)
+{
+    if (data.Virtualization.IsEmpty() || data.Virtualization.StartsWith("Unknown")) return wxT("未知");
+    wxString env;
+    if (data.Virtualization.Contains(wxT("vm"))) env = wxT("虚拟机 (") + data.Hypervisor + wxT(")");
+    if (data.Virtualization.Contains(wxT("container"))) {
+        if (!env.IsEmpty()) env += wxT(" · ");
+        env += wxT("容器 (") + data.Container + wxT(")");
+    }
+    if (env.IsEmpty()) {
+        env = wxT("物理机");
+        if (data.Hypervisor != wxT("none")) env += wxT(" (") + data.Hypervisor + wxT(")");
+    }
+    return env;
+}
+
+// 有效值与可见值并列："2.50 / 16 核 (CPU 0-3, cgroup v2) · 内存 4.00 / 62.80 GB"
+static wxString FormatEffectiveResources(const HardwareData& data)
+{
+    if (data.LogicalProcessors <= 0) return wxT("未知");
+    wxString text = wxString::Format(wxT("%.2f / %ld 核"), data.EffectiveCpuMilli / 1000.0, data.LogicalProcessors);
+    wxString detail;
+    if (!data.AllowedCpus.IsEmpty()) detail = wxT("CPU ") + data.AllowedCpus;
+    if (!data.ResourceLimits.IsEmpty()) {
+        if (!detail.IsEmpty()) detail += wxT(", ");
+        detail += data.ResourceLimits;
+    }
+    if (!detail.IsEmpty()) text += wxT(" (") + detail + wxT(")");
+
+    unsigned long long effective = 0, visible = 0;
+    if (wxStringToULL(data.EffectiveMemory, &effective) && effective > 0) {
+        const double gb = 1024.0 * 1024.0 * 1024.0;
+        text += wxString::Format(wxT(" · 内存 %.2f"), effective / gb);
+        if (wxStringToULL(data.TotalPhysicalMemory, &visible) && visible > 0) {
+            text += wxString::Format(wxT(" / %.2f"), visible / gb);
+        }
+        text += wxT(" GB");
+    }
+    return text;
+}
+
+// ========== PCI 设备格式化 ==========
+static wxString FormatPciName(const PciDevice& dev)
+{
+    wxString name = dev.VendorName;
+    if (!dev.DeviceName.IsEmpty()) {
+        if (!name.IsEmpty()) name += wxT(" ");
+        name += dev.DeviceName;
+    }
+    wxString ids = wxString::Format(wxT("[%04lx:%04lx]"), dev.VendorId, dev.DeviceId);
+    return name.IsEmpty() ? ids : name + wxT(" ") + ids;
+}
+
+static wxString FormatPciLink(const PciDevice& dev)
+{
+    if (dev.LinkWidth <= 0) return wxT("—");
+    wxString link = wxString::Format(wxT("x%ld"), dev.LinkWidth);
+    if (!dev.LinkSpeed.IsEmpty()) link += wxT(" ") + dev.LinkSpeed;
+    // 低于最大能力时一并列出：插槽、转接卡或节能降速一目了然
+    if (dev.MaxLinkWidth > dev.LinkWidth || (!dev.MaxLinkSpeed.IsEmpty() && dev.MaxLinkSpeed != dev.LinkSpeed)) {
+        link += wxString::Format(wxT(" (最大 x%ld %s)"), dev.MaxLinkWidth, dev.MaxLinkSpeed);
+    }
+    return link;
+}
+
+static wxString FormatNumaNode(const PciDevice& dev)
+{
+    return dev.NumaNode < 0 ? wxString(wxT("—")) : wxString::Format(wxT("%ld"), dev.NumaNode);
+}
+
+// ========== 插件字段格式化 ==========
+// 参与指纹的字段标 🔑，易变字段标 ~
+static wxString FormatPluginKey(const PluginField& field)
+{
+    wxString key = field.Key;
+    if (field.Fingerprint) key += wxT(" 🔑");
+    if (field.Volatile) key += wxT(" ~");
+    return key;
+}
+
+// ========== NUMA 节点格式化 ==========
+// 节点列表固定列：节点、CPU、内存、大页；其后每个节点一列距离
+static const int kNumaFixedColumns = 4;
+
+// ========== 调优检查格式化 ==========
+static wxString AuditSeverityText(const wxString& severity)
+{
+    if (severity == wxT("critical")) return wxT("⛔ 严重");
+    if (severity == wxT("warning")) return wxT("⚠ 警告");
+    return wxT("ℹ 提示");
+}
+
+static wxString FormatNumaCpus(const NumaNode& node)
+{
+    if (node.CpuCount == 0) return wxT("—");
+    return wxString::Format(wxT("%s (%ld)"), node.Cpus, node.CpuCount);
+}
+
+static wxString FormatNumaMemory(const NumaNode& node)
+{
+    if (node.MemoryTotalMB <= 0) {
+        return node.MemoryFreeMB > 0 ? wxString::Format(wxT("%.1f GB 空闲"), node.MemoryFreeMB / 1024.0)
+                                     : wxString(wxT("未知"));
+    }
+    return wxString::Format(wxT("%.1f / %.1f GB"), node.MemoryFreeMB / 1024.0, node.MemoryTotalMB / 1024.0);
+}
+
+// "2048kB:512/480 1048576kB:4/4" → "2M 480/512, 1G 4/4"（空闲/总数），全为 0 的池不显示
+static wxString FormatNumaHugePages(const NumaNode& node)
+{
+    wxString out;
+    wxArrayString pools = wxSplit(node.HugePages, ' ', '\0');
+    for (const wxString& pool : pools) {
+        unsigned long sizeKB = 0, total = 0, free = 0;
+        wxString size = pool.BeforeFirst(':');
+        wxString counts = pool.AfterFirst(':');
+        if (!size.BeforeFirst('k').ToULong(&sizeKB) || !counts.BeforeFirst('/').ToULong(&total) ||
+            !counts.AfterFirst('/').ToULong(&free) || total == 0) {
+            continue;
+        }
+        if (!out.IsEmpty()) out += wxT(", ");
+        out += sizeKB >= 1024 * 1024 ? wxString::Format(wxT("%luG"), sizeKB / (1024 * 1024))
+                                     : wxString::Format(wxT("%luM"), sizeKB / 1024);
+        out += wxString::Format(wxT(" %lu/%lu"), free, total);
+    }
+    return out.IsEmpty() ? wxString(wxT("—")) : out;
+}
+
+// ========== 传感器读数格式化 ==========
+static wxString FormatSensorValue(double value, sensors::Kind kind)
+{
+    const char* unit = sensors::UnitOf(kind);
+    wxString suffix = wxT(" ") + Hardware::Utf8ToWxString(unit, strlen(unit));
+    switch (kind) {
+        case sensors::Kind::Fan: return wxString::Format(wxT("%.0f"), value) + suffix;
+        case sensors::Kind::Voltage: return wxString::Format(wxT("%.3f"), value) + suffix;
+        case sensors::Kind::Current: return wxString::Format(wxT("%.2f"), value) + suffix;
+        default: return wxString::Format(wxT("%.1f"), value) + suffix;
+    }
+}
+
+// ========== 硬盘性能测试 ==========
+// 硬盘列表在型号、序列号之后为每项默认测试加一列吞吐量，列顺序与 diskbench::DefaultSpecs 一致
+constexpr long kDiskFixedColumns = 2;
+
+// "1M 顺序写 QD8"、"4K 随机读 QD32"
+static wxString FormatBenchSpec(const wxString& test, long blockSize, long queueDepth)
+{
+    wxString size = blockSize % (1 << 20) == 0 ? wxString::Format(wxT("%ldM"), blockSize >> 20)
+                                               : wxString::Format(wxT("%ldK"), blockSize >> 10);
+    wxString name = test == wxT("seq-write") ? wxT("顺序写") : test == wxT("seq-read") ? wxT("顺序读") : wxT("随机读");
+    return wxString::Format(wxT("%s %s QD%ld"), size, name, queueDepth);
+}
+
+static wxString FormatBenchSpec(const diskbench::Spec& spec)
+{
+    return FormatBenchSpec(diskbench::PatternName(spec.pattern), (long)spec.blockSize, (long)spec.queueDepth);
+}
+
+// 结果对应的列；不属于默认测试序列时返回 -1
+static long DiskBenchmarkColumn(const DiskBenchmark& bench)
+{
+    std::vector<diskbench::Spec> specs = diskbench::DefaultSpecs();
+    for (size_t i = 0; i < specs.size(); ++i) {
+        if (bench.Test == diskbench::PatternName(specs[i].pattern) && bench.BlockSize == (long)specs[i].blockSize &&
+            bench.QueueDepth == (long)specs[i].queueDepth) {
+            return kDiskFixedColumns + (long)i;
+        }
+    }
+    return -1;
+}
+
+static wxString FormatThroughput(const DiskBenchmark& bench)
+{
+    return wxString::Format(wxT("%.1f MB/s"), bench.ThroughputKBps / 1000.0);
+}
+
+// ========== 进程列表 ==========
+enum ProcessColumn
+{
+    ColPid,
+    ColName,
+    ColCpu,
+    ColMemory,
+    ColRead,
+    ColWrite,
+    ColCpuTime,
+};
+
+static wxString FormatBytes(double bytes)
+{
+    if (bytes < 1024) return wxString::Format(wxT("%.0f B"), bytes);
+    if (bytes < 1024.0 * 1024) return wxString::Format(wxT("%.1f KB"), bytes / 1024);
+    if (bytes < 1024.0 * 1024 * 1024) return wxString::Format(wxT("%.1f MB"), bytes / (1024.0 * 1024));
+    return wxString::Format(wxT("%.2f GB"), bytes / (1024.0 * 1024 * 1024));
+}
+
+static wxString FormatCpuTime(uint64_t ms)
+{
+    unsigned long long s = ms / 1000;
+    return wxString::Format(wxT("%llu:%02llu:%02llu"), s / 3600, s / 60 % 60, s % 60);
+}
+
+template <typename T>
+static int CompareValues(const T& a, const T& b)
+{
+    return a < b ? -1 : b < a ? 1 : 0;
+}
+
+ProcessListCtrl::ProcessListCtrl(wxWindow* parent)
+    : wxListCtrl(parent, wxID_ANY, wxDefaultPosition, wxSize(-1, 200),
+                 wxLC_REPORT | wxLC_VIRTUAL | wxLC_SINGLE_SEL | wxLC_HRULES),
+      m_sortColumn(ColCpu),
+      m_ascending(false)
+{
+    InsertColumn(ColPid, wxT("PID"), wxLIST_FORMAT_RIGHT, 70);
+    InsertColumn(ColName, wxT("名称"), wxLIST_FORMAT_LEFT, 180);
+    InsertColumn(ColCpu, wxT("CPU %"), wxLIST_FORMAT_RIGHT, 70);
+    InsertColumn(ColMemory, wxT("内存"), wxLIST_FORMAT_RIGHT, 90);
+    InsertColumn(ColRead, wxT("读取/s"), wxLIST_FORMAT_RIGHT, 90);
+    InsertColumn(ColWrite, wxT("写入/s"), wxLIST_FORMAT_RIGHT, 90);
+    InsertColumn(ColCpuTime, wxT("CPU 时间"), wxLIST_FORMAT_RIGHT, 90);
+    ShowSortIndicator(m_sortColumn, m_ascending);
+    Bind(wxEVT_LIST_COL_CLICK, &ProcessListCtrl::OnColumnClick, this);
+}
+
+void ProcessListCtrl::SetProcesses(std::shared_ptr<const procs::ProcessList> processes)
+{
+    // 行号随排序变化：按 pid 记住选中项，换数据后重新选中
+    long selected = GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
+    bool hasSelection = selected >= 0 && (size_t)selected < m_order.size();
+    uint32_t selectedPid = hasSelection ? (*m_processes)[m_order[selected]].pid : 0;
+    if (hasSelection) SetItemState(selected, 0, wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED);
+    
+    m_processes = std::move(processes);
+    sortRows();
+    SetItemCount((long)m_order.size());
+    
+    for (size_t i = 0; hasSelection && i < m_order.size(); ++i) {
+        if ((*m_processes)[m_order[i]].pid == selectedPid) {
+            SetItemState((long)i, wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED,
+                         wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED);
+            break;
+        }
+    }
+    Refresh();
+}
+
+void ProcessListCtrl::sortRows()
+{
+    const procs::ProcessList& list = *m_processes;
+    m_order.resize(list.size());
+    for (size_t i = 0; i < list.size(); ++i) m_order[i] = (uint32_t)i;
+    
+    auto compare = [this](const procs::Process& a, const procs::Process& b) {
+        switch (m_sortColumn) {
+            case ColName: return CompareValues(a.name, b.name);
+            case ColCpu: return CompareValues(a.cpuPercent, b.cpuPercent);
+            case ColMemory: return CompareValues(a.rssBytes, b.rssBytes);
+            case ColRead: return CompareValues(a.readRate, b.readRate);
+            case ColWrite: return CompareValues(a.writeRate, b.writeRate);
+            case ColCpuTime: return CompareValues(a.cpuTimeMs, b.cpuTimeMs);
+            default: return CompareValues(a.pid, b.pid);
+        }
+    };
+    // 相等时按 pid，刷新前后顺序稳定
+    std::sort(m_order.begin(), m_order.end(), [&](uint32_t x, uint32_t y) {
+        int c = compare(list[x], list[y]);
+        if (c == 0) return list[x].pid < list[y].pid;
+        return m_ascending ? c < 0 : c > 0;
+    });
+}
+
+wxString ProcessListCtrl::OnGetItemText(long item, long column) const
+{
+    if (!m_processes || item < 0 || (size_t)item >= m_order.size()) return wxString();
+    const procs::Process& p = (*m_processes)[m_order[item]];
+    const wxString unknown = wxT("—");
+    switch (column) {
+        case ColPid: return wxString::Format(wxT("%lu"), (unsigned long)p.pid);
+        case ColName: return p.name.empty() ? unknown : Hardware::Utf8ToWxString(p.name.data(), p.name.size());
+        case ColCpu: return p.known ? wxString::Format(wxT("%.1f"), p.cpuPercent) : unknown;
+        case ColMemory: return p.known ? FormatBytes((double)p.rssBytes) : unknown;
+        case ColRead: return p.ioKnown ? FormatBytes(p.readRate) : unknown;
+        case ColWrite: return p.ioKnown ? FormatBytes(p.writeRate) : unknown;
+        case ColCpuTime: return p.known ? FormatCpuTime(p.cpuTimeMs) : unknown;
+        default: return wxString();
+    }
+}
+
+std::vector<uint32_t> ProcessListCtrl::VisiblePids() const
+{
+    std::vector<uint32_t> pids;
+    if (!m_processes || !IsShownOnScreen()) return pids;
+    long top = std::max(0L, GetTopItem());
+    long end = std::min<long>(top + GetCountPerPage() + 1, (long)m_order.size());
+    for (long i = top; i < end; ++i) pids.push_back((*m_processes)[m_order[i]].pid);
+    return pids;
+}
+
+bool ProcessListCtrl::SortsByIo() const
+{
+    return m_sortColumn == ColRead || m_sortColumn == ColWrite;
+}
+
+// 点击新列时数值列默认从大到小、PID 与名称从小到大；再次点击同一列反向
+void ProcessListCtrl::OnColumnClick(wxListEvent& event)
+{
+    int column = event.GetColumn();
+    if (column < 0) return;
+    if (column == m_sortColumn) {
+        m_ascending = !m_ascending;
+    } else {
+        m_sortColumn = column;
+        m_ascending = column == ColPid || column == ColName;
+    }
+    ShowSortIndicator(m_sortColumn, m_ascending);
+    if (m_processes) SetProcesses(m_processes);
+}
+
+// ========== 内存性能图 ==========
+static const wxColour kSeriesColours[] = {
+    wxColour(52, 120, 200), wxColour(240, 140, 40), wxColour(80, 165, 90),
+    wxColour(200, 70, 70), wxColour(140, 100, 190), wxColour(120, 120, 120),
+};
+
+// 刻度间隔取 1、2、5 × 10^n，使坐标轴约有 ticks 格
+static double NiceStep(double range, int ticks)
+{
+    double raw = range / ticks;
+    double magnitude = std::pow(10.0, std::floor(std::log10(raw)));
+    double normalized = raw / magnitude;
+    return (normalized <= 1 ? 1 : normalized <= 2 ? 2 : normalized <= 5 ? 5 : 10) * magnitude;
+}
+
+// 以 KB 计的容量："48K"、"2M"、"1.5G"
+static wxString FormatSizeKB(double kb)
+{
+    if (kb >= 1024.0 * 1024) return wxString::Format(wxT("%gG"), std::round(kb / (1024 * 1024) * 10) / 10);
+    if (kb >= 1024) return wxString::Format(wxT("%gM"), std::round(kb / 1024 * 10) / 10);
+    return wxString::Format(wxT("%gK"), std::round(kb * 10) / 10);
+}
+
+static wxString FormatMemorySeries(long node, long nonTemporal)
+{
+    wxString name = node < 0 ? wxString(wxT("全部节点")) : wxString::Format(wxT("节点 %ld"), node);
+    return name + (nonTemporal ? wxT(" 流式写") : wxT(" 普通写"));
+}
+
+MemoryBenchPanel::MemoryBenchPanel(wxWindow* parent)
+    : wxPanel(parent, wxID_ANY, wxDefaultPosition, wxSize(-1, 220)),
+      m_caches(membench::CacheLevels())
+{
+    SetBackgroundStyle(wxBG_STYLE_PAINT);
+    Bind(wxEVT_PAINT, &MemoryBenchPanel::OnPaint, this);
+    Bind(wxEVT_SIZE, [this](wxSizeEvent& event) {
+        Refresh();
+        event.Skip();
+    });
+}
+
+void MemoryBenchPanel::SetResults(const std::vector<MemoryBandwidth>& bandwidth, const std::vector<MemoryLatency>& latency)
+{
+    m_bandwidth = bandwidth;
+    m_latency = latency;
+    Refresh();
+}
+
+void MemoryBenchPanel::OnPaint(wxPaintEvent& WXUNUSED(event))
+{
+    wxAutoBufferedPaintDC dc(this);
+    dc.SetBackground(wxBrush(wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOW)));
+    dc.Clear();
+    dc.SetFont(GetFont());
+    dc.SetTextForeground(wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOWTEXT));
+    
+    wxSize size = GetClientSize();
+    if (m_bandwidth.empty() && m_latency.empty()) {
+        wxString hint = wxT("尚未测试：点击\"运行内存测试\"测量内存带宽与各级缓存延迟");
+        wxSize extent = dc.GetTextExtent(hint);
+        dc.DrawText(hint, (size.x - extent.x) / 2, (size.y - extent.y) / 2);
+        return;
+    }
+    int split = size.x * 2 / 5;
+    drawBandwidth(dc, wxRect(0, 0, split, size.y));
+    drawLatency(dc, wxRect(split, 0, size.x - split, size.y));
+}
+
+// 每个内核一组柱，组内依次为各（节点, 写方式）组合；纵轴 GB/s
+void MemoryBenchPanel::drawBandwidth(wxDC& dc, const wxRect& area)
+{
+    if (m_bandwidth.empty()) return;
+    std::vector<std::pair<long, long>> series;
+    double maxMBps = 1;
+    for (const MemoryBandwidth& bench : m_bandwidth) {
+        std::pair<long, long> key(bench.Node, bench.NonTemporal);
+        if (std::find(series.begin(), series.end(), key) == series.end()) series.push_back(key);
+        maxMBps = std::max(maxMBps, (double)bench.MBps);
+    }
+    
+    int line = dc.GetCharHeight();
+    int legendRows = ((int)series.size() + 1) / 2;
+    wxRect plot(area.x + 48, area.y + line + 8, area.width - 60, area.height - line * (legendRows + 2) - 20);
+    if (plot.width < 40 || plot.height < 20) return;
+    dc.DrawText(wxT("带宽 (GB/s)"), area.x + 8, area.y + 4);
+    
+    double top = maxMBps / 1000.0;
+    double step = NiceStep(top, 4);
+    top = std::ceil(top / step) * step;
+    dc.SetPen(wxPen(wxColour(225, 225, 225)));
+    for (int i = 0; i * step <= top + step / 2; ++i) {
+        int y = plot.GetBottom() - (int)(i * step / top * plot.height);
+        dc.DrawLine(plot.x, y, plot.GetRight(), y);
+        wxString label = wxString::Format(wxT("%g"), i * step);
+        dc.DrawText(label, plot.x - dc.GetTextExtent(label).x - 4, y - line / 2);
+    }
+    
+    const membench::Kernel kernels[] = { membench::Kernel::Copy, membench::Kernel::Scale, membench::Kernel::Add,
+                                         membench::Kernel::Triad };
+    int groupWidth = plot.width / 4;
+    int barWidth = std::max(2, (groupWidth - 10) / (int)series.size());
+    dc.SetPen(*wxTRANSPARENT_PEN);
+    for (int k = 0; k < 4; ++k) {
+        wxString kernel = membench::KernelName(kernels[k]);
+        int left = plot.x + k * groupWidth + (groupWidth - barWidth * (int)series.size()) / 2;
+        for (const MemoryBandwidth& bench : m_bandwidth) {
+            if (bench.Kernel != kernel) continue;
+            size_t s = std::find(series.begin(), series.end(), std::make_pair(bench.Node, bench.NonTemporal)) - series.begin();
+            int height = (int)(bench.MBps / 1000.0 / top * plot.height);
+            dc.SetBrush(wxBrush(kSeriesColours[s % WXSIZEOF(kSeriesColours)]));
+            dc.DrawRectangle(left + (int)s * barWidth, plot.GetBottom() - height, std::max(1, barWidth - 1), height);
+        }
+        wxSize extent = dc.GetTextExtent(kernel);
+        dc.DrawText(kernel, plot.x + k * groupWidth + (groupWidth - extent.x) / 2, plot.GetBottom() + 4);
+    }
+    
+    // 图例：两列
+    for (size_t s = 0; s < series.size(); ++s) {
+        int x = area.x + 8 + (int)(s % 2) * (area.width / 2);
+        int y = plot.GetBottom() + line + 10 + (int)(s / 2) * (line + 2);
+        dc.SetBrush(wxBrush(kSeriesColours[s % WXSIZEOF(kSeriesColours)]));
+        dc.DrawRectangle(x, y + line / 4, line / 2, line / 2);
+        dc.DrawText(FormatMemorySeries(series[s].first, series[s].second), x + line, y);
+    }
+}
+
+// 横轴工作集（对数），纵轴单次载入延迟 ns（对数）
+void MemoryBenchPanel::drawLatency(wxDC& dc, const wxRect& area)
+{
+    if (m_latency.size() < 2) return;
+    double minKB = std::max(1L, m_latency.front().WorkingSetKB);
+    double maxKB = std::max(minKB * 2, (double)m_latency.back().WorkingSetKB);
+    double minNs = 1e9, maxNs = 0;
+    for (const MemoryLatency& point : m_latency) {
+        double ns = std::max(point.LatencyPs, 1L) / 1000.0;
+        minNs = std::min(minNs, ns);
+        maxNs = std::max(maxNs, ns);
+    }
+    double lowDecade = std::floor(std::log10(minNs));
+    double highDecade = std::max(lowDecade + 1, std::ceil(std::log10(maxNs)));
+    
+    int line = dc.GetCharHeight();
+    wxRect plot(area.x + 48, area.y + line + 8, area.width - 64, area.height - line * 2 - 24);
+    if (plot.width < 40 || plot.height < 20) return;
+    dc.DrawText(wxT("延迟 (ns) / 工作集"), area.x + 8, area.y + 4);
+    
+    auto mapX = [&](double kb) {
+        return plot.x + (int)((std::log2(kb) - std::log2(minKB)) / (std::log2(maxKB) - std::log2(minKB)) * plot.width);
+    };
+    auto mapY = [&](double ns) {
+        return plot.GetBottom() - (int)((std::log10(ns) - lowDecade) / (highDecade - lowDecade) * plot.height);
+    };
+    
+    // 纵轴每个数量级一条线，横轴每 4 倍一个刻度
+    dc.SetPen(wxPen(wxColour(225, 225, 225)));
+    for (double decade = lowDecade; decade <= highDecade; decade += 1) {
+        int y = mapY(std::pow(10.0, decade));
+        dc.DrawLine(plot.x, y, plot.GetRight(), y);
+        wxString label = wxString::Format(wxT("%g"), std::pow(10.0, decade));
+        dc.DrawText(label, plot.x - dc.GetTextExtent(label).x - 4, y - line / 2);
+    }
+    for (double kb = std::exp2(std::ceil(std::log2(minKB) / 2) * 2); kb <= maxKB; kb *= 4) {
+        int x = mapX(kb);
+        dc.DrawLine(x, plot.y, x, plot.GetBottom());
+        wxString label = FormatSizeKB(kb);
+        dc.DrawText(label, x - dc.GetTextExtent(label).x / 2, plot.GetBottom() + 4);
+    }
+    
+    // 本机各级缓存容量
+    dc.SetPen(wxPen(wxColour(160, 160, 160), 1, wxPENSTYLE_SHORT_DASH));
+    dc.SetTextForeground(wxColour(120, 120, 120));
+    for (const membench::CacheLevel& cache : m_caches) {
+        double kb = cache.bytes / 1024.0;
+        if (kb < minKB || kb > maxKB) continue;
+        int x = mapX(kb);
+        dc.DrawLine(x, plot.y, x, plot.GetBottom());
+        dc.DrawText(wxString::Format(wxT("L%d"), cache.level), x + 2, plot.y);
+    }
+    dc.SetTextForeground(wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOWTEXT));
+    
+    std::vector<wxPoint> points;
+    for (const MemoryLatency& point : m_latency) {
+        points.push_back(wxPoint(mapX(std::max(1L, point.WorkingSetKB)), mapY(std::max(point.LatencyPs, 1L) / 1000.0)));
+    }
+    dc.SetPen(wxPen(kSeriesColours[0], 2));
+    dc.DrawLines((int)points.size(), points.data());
+    dc.SetBrush(wxBrush(kSeriesColours[0]));
+    for (const wxPoint& point : points) dc.DrawCircle(point, 2);
+}
+
+// ========== CPU 性能图 ==========
+static const char* const kCpuKernels[] = { "integer", "float", "hash", "compress" };
+static const char* const kCpuIsas[] = { "scalar", "sse4.1", "avx2", "avx512" };
+
+static wxString FormatCpuMode(const wxString& mode)
+{
+    return mode == wxT("soak") ? wxString(wxT("长时间")) : wxString(wxT("快速"));
+}
+
+CpuBenchPanel::CpuBenchPanel(wxWindow* parent)
+    : wxPanel(parent, wxID_ANY, wxDefaultPosition, wxSize(-1, 240))
+{
+    SetBackgroundStyle(wxBG_STYLE_PAINT);
+    Bind(wxEVT_PAINT, &CpuBenchPanel::OnPaint, this);
+    Bind(wxEVT_SIZE, [this](wxSizeEvent& event) {
+        Refresh();
+        event.Skip();
+    });
+}
+
+void CpuBenchPanel::SetResults(const std::vector<CpuBenchmark>& summary, const std::vector<CpuKernelRate>& rates,
+                               const std::vector<CpuScalingPoint>& scaling)
+{
+    m_summary = summary;
+    m_rates = rates;
+    m_scaling = scaling;
+    Refresh();
+}
+
+void CpuBenchPanel::OnPaint(wxPaintEvent& WXUNUSED(event))
+{
+    wxAutoBufferedPaintDC dc(this);
+    dc.SetBackground(wxBrush(wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOW)));
+    dc.Clear();
+    dc.SetFont(GetFont());
+    dc.SetTextForeground(wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOWTEXT));
+    
+    wxSize size = GetClientSize();
+    if (m_summary.empty()) {
+        wxString hint = wxT("尚未测试：点击\"快速测试\"测量单核/全核算力、SIMD 加速比与多核扩展");
+        wxSize extent = dc.GetTextExtent(hint);
+        dc.DrawText(hint, (size.x - extent.x) / 2, (size.y - extent.y) / 2);
+        return;
+    }
+    
+    // 摘要：每种模式一行；全核持续频率明显低于瞬时频率时标橙，提示功耗墙或温度墙
+    int line = dc.GetCharHeight();
+    int y = 4;
+    for (const CpuBenchmark& bench : m_summary) {
+        wxString text = wxString::Format(wxT("%s（%s）：单核 %ld，全核 %ld（%ld 线程 / %ld 核，扩展效率 %.0f%%）"),
+                                         FormatCpuMode(bench.Mode), bench.Isa, bench.SingleCoreScore, bench.AllCoreScore,
+                                         bench.Threads, bench.Cores, bench.ScalingPermille / 10.0);
+        dc.DrawText(text, 8, y);
+        if (bench.BurstMHz > 0 && bench.SustainedMHz > 0) {
+            wxString clock = wxString::Format(wxT("  瞬时 %ld MHz → 全核 %ld MHz"), bench.BurstMHz, bench.SustainedMHz);
+            bool throttled = bench.SustainedMHz < bench.BurstMHz * 85 / 100;
+            if (throttled) dc.SetTextForeground(wxColour(220, 120, 0));
+            dc.DrawText(clock, 8 + dc.GetTextExtent(text).x, y);
+            dc.SetTextForeground(wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOWTEXT));
+        }
+        y += line + 2;
+    }
+    
+    int split = size.x * 2 / 5;
+    drawSpeedup(dc, wxRect(0, y, split, size.y - y));
+    drawScaling(dc, wxRect(split, y, size.x - split, size.y - y));
+}
+
+// 每个内核一组柱，组内为各指令集相对标量版的单线程加速比
+void CpuBenchPanel::drawSpeedup(wxDC& dc, const wxRect& area)
+{
+    if (m_rates.empty()) return;
+    auto rateOf = [&](const char* kernel, const char* isa) {
+        for (const CpuKernelRate& rate : m_rates) {
+            if (rate.Kernel == kernel && rate.Isa == isa) return (double)rate.Rate;
+        }
+        return 0.0;
+    };
+    std::vector<size_t> isas;   // 结果中出现过的指令集，kCpuIsas 下标
+    double maxSpeedup = 1;
+    for (size_t i = 0; i < WXSIZEOF(kCpuIsas); ++i) {
+        bool present = false;
+        for (const char* kernel : kCpuKernels) {
+            double scalar = rateOf(kernel, "scalar");
+            double rate = rateOf(kernel, kCpuIsas[i]);
+            if (rate <= 0) continue;
+            present = true;
+            if (scalar > 0) maxSpeedup = std::max(maxSpeedup, rate / scalar);
+        }
+        if (present) isas.push_back(i);
+    }
+    if (isas.empty()) return;
+    
+    int line = dc.GetCharHeight();
+    wxRect plot(area.x + 40, area.y + line + 8, area.width - 52, area.height - line * 3 - 20);
+    if (plot.width < 40 || plot.height < 20) return;
+    dc.DrawText(wxT("相对标量版加速比（单线程）"), area.x + 8, area.y + 4);
+    
+    double step = NiceStep(maxSpeedup, 4);
+    double top = std::ceil(maxSpeedup / step) * step;
+    dc.SetPen(wxPen(wxColour(225, 225, 225)));
+    for (int i = 0; i * step <= top + step / 2; ++i) {
+        int y = plot.GetBottom() - (int)(i * step / top * plot.height);
+        dc.DrawLine(plot.x, y, plot.GetRight(), y);
+        wxString label = wxString::Format(wxT("%g×"), i * step);
+        dc.DrawText(label, plot.x - dc.GetTextExtent(label).x - 4, y - line / 2);
+    }
+    
+    int groupWidth = plot.width / (int)WXSIZEOF(kCpuKernels);
+    int barWidth = std::max(2, (groupWidth - 10) / (int)isas.size());
+    dc.SetPen(*wxTRANSPARENT_PEN);
+    for (size_t k = 0; k < WXSIZEOF(kCpuKernels); ++k) {
+        double scalar = rateOf(kCpuKernels[k], "scalar");
+        int left = plot.x + (int)k * groupWidth + (groupWidth - barWidth * (int)isas.size()) / 2;
+        for (size_t s = 0; s < isas.size() && scalar > 0; ++s) {
+            double speedup = rateOf(kCpuKernels[k], kCpuIsas[isas[s]]) / scalar;
+            int height = (int)(speedup / top * plot.height);
+            dc.SetBrush(wxBrush(kSeriesColours[isas[s] % WXSIZEOF(kSeriesColours)]));
+            dc.DrawRectangle(left + (int)s * barWidth, plot.GetBottom() - height, std::max(1, barWidth - 1), height);
+        }
+        wxString kernel = kCpuKernels[k];
+        wxSize extent = dc.GetTextExtent(kernel);
+        dc.DrawText(kernel, plot.x + (int)k * groupWidth + (groupWidth - extent.x) / 2, plot.GetBottom() + 4);
+    }
+    
+    // 图例：一行
+    int x = area.x + 8;
+    int y = plot.GetBottom() + line + 10;
+    for (size_t s = 0; s < isas.size(); ++s) {
+        dc.SetBrush(wxBrush(kSeriesColours[isas[s] % WXSIZEOF(kSeriesColours)]));
+        dc.DrawRectangle(x, y + line / 4, line / 2, line / 2);
+        wxString name = kCpuIsas[isas[s]];
+        dc.DrawText(name, x + line, y);
+        x += line + dc.GetTextExtent(name).x + 12;
+    }
+}
+
+// 横轴线程数，纵轴分数；虚线为单核分数 × 线程数
+void CpuBenchPanel::drawScaling(wxDC& dc, const wxRect& area)
+{
+    if (m_scaling.empty()) return;
+    double single = 0, maxScore = 1;
+    long maxThreads = 1;
+    for (const CpuScalingPoint& point : m_scaling) {
+        if (point.Threads == 1 && point.Pinned) single = (double)point.Score;
+        maxScore = std::max(maxScore, (double)point.Score);
+        maxThreads = std::max(maxThreads, point.Threads);
+    }
+    maxScore = std::max(maxScore, single * maxThreads);
+    
+    int line = dc.GetCharHeight();
+    wxRect plot(area.x + 56, area.y + line + 8, area.width - 72, area.height - line * 3 - 20);
+    if (plot.width < 40 || plot.height < 20) return;
+    dc.DrawText(wxT("多核扩展（分数 / 线程数）"), area.x + 8, area.y + 4);
+    
+    double yStep = NiceStep(maxScore, 4);
+    double top = std::ceil(maxScore / yStep) * yStep;
+    double xStep = std::max(1.0, NiceStep((double)maxThreads, 8));
+    double right = std::ceil(maxThreads / xStep) * xStep;
+    auto mapX = [&](double threads) { return plot.x + (int)(threads / right * plot.width); };
+    auto mapY = [&](double score) { return plot.GetBottom() - (int)(score / top * plot.height); };
+    
+    dc.SetPen(wxPen(wxColour(225, 225, 225)));
+    for (int i = 0; i * yStep <= top + yStep / 2; ++i) {
+        int y = mapY(i * yStep);
+        dc.DrawLine(plot.x, y, plot.GetRight(), y);
+        wxString label = wxString::Format(wxT("%g"), i * yStep);
+        dc.DrawText(label, plot.x - dc.GetTextExtent(label).x - 4, y - line / 2);
+    }
+    for (int i = 0; i * xStep <= right + xStep / 2; ++i) {
+        int x = mapX(i * xStep);
+        dc.DrawLine(x, plot.y, x, plot.GetBottom());
+        wxString label = wxString::Format(wxT("%g"), i * xStep);
+        dc.DrawText(label, x - dc.GetTextExtent(label).x / 2, plot.GetBottom() + 4);
+    }
+    
+    if (single > 0) {
+        dc.SetPen(wxPen(wxColour(160, 160, 160), 1, wxPENSTYLE_SHORT_DASH));
+        dc.DrawLine(mapX(0), mapY(0), mapX((double)maxThreads), mapY(single * maxThreads));
+    }
+    
+    // 绑核与不绑核各一条折线
+    const wxString names[] = { wxT("不绑核"), wxT("绑核") };
+    int legendX = area.x + 8;
+    for (long pinned = 1; pinned >= 0; --pinned) {
+        std::vector<wxPoint> points;
+        for (const CpuScalingPoint& point : m_scaling) {
+            if (point.Pinned == pinned) points.push_back(wxPoint(mapX((double)point.Threads), mapY((double)point.Score)));
+        }
+        if (points.empty()) continue;
+        const wxColour& colour = kSeriesColours[pinned ? 0 : 1];
+        dc.SetPen(wxPen(colour, 2));
+        if (points.size() > 1) dc.DrawLines((int)points.size(), points.data());
+        dc.SetBrush(wxBrush(colour));
+        for (const wxPoint& point : points) dc.DrawCircle(point, 2);
+        
+        int y = plot.GetBottom() + line + 10;
+        dc.SetPen(*wxTRANSPARENT_PEN);
+        dc.DrawRectangle(legendX, y + line / 4, line / 2, line / 2);
+        dc.DrawText(names[pinned], legendX + line, y);
+        legendX += line + dc.GetTextExtent(names[pinned]).x + 12;
+    }
+    int y = plot.GetBottom() + line + 10;
+    dc.SetPen(wxPen(wxColour(160, 160, 160), 1, wxPENSTYLE_SHORT_DASH));
+    dc.DrawLine(legendX, y + line / 2, legendX + line, y + line / 2);
+    dc.DrawText(wxT("线性扩展"), legendX + line + 4, y);
+}
+
+// ========== 信息行绑定 ==========
+// 界面信息区与导出报告共用：标签 + 字段表中的键（决定所属探测与状态标记）+ 显示文字
+struct InfoRowBinding
+{
+    const wxChar* label;
+    const char* field;
+    wxString (*format)(const HardwareData& data);
+};
+
+static const InfoRowBinding s_infoRows[] = {
+    { wxT("主板制造商:"), "BaseBoardManufacturer", FormatBoardManufacturer },
+    { wxT("主板型号:"),   "BaseBoardProduct",      FormatBoardProduct },
+    { wxT("CPU 信息:"),   "CPUName",               FormatCpu },
+    { wxT("内存信息:"),   "TotalPhysicalMemory",   FormatMemory },
+    { wxT("BIOS 信息:"),  "BIOSManufacturer",      FormatBios },
+    { wxT("系统 UUID:"),  "SystemUUID",            FormatUuid },
+    { wxT("运行环境:"),   "Virtualization",        FormatEnvironment },
+    { wxT("可用资源:"),   "EffectiveCpuMilli",     FormatEffectiveResources },
+};
+
 // ========== 主窗口实现（标签文字放大，层次清晰）==========
 MainWindow::MainWindow(const wxString& title)
-    : wxFrame(nullptr, wxID_ANY, title, wxDefaultPosition, wxSize(800, 560)),
+    : wxFrame(nullptr, wxID_ANY, title, wxDefaultPosition, wxSize(1000, 720)),
       m_fingerprintText(nullptr),
-      m_boardManufacturerText(nullptr),
-      m_boardProductText(nullptr),
-      m_cpuInfoText(nullptr),
-      m_memInfoText(nullptr),
-      m_biosInfoText(nullptr),
-      m_uuidText(nullptr),
       m_diskList(nullptr),
       m_netList(nullptr),
+      m_pciList(nullptr),
+      m_numaList(nullptr),
+      m_pluginList(nullptr),
+      m_auditList(nullptr),
+      m_sensorList(nullptr),
+      m_processList(nullptr),
+      m_memoryPanel(nullptr),
+      m_cpuPanel(nullptr),
       m_statusLabel(nullptr),
-      m_progress(nullptr)
+      m_progress(nullptr),
+      m_historySlider(nullptr),
+      m_historyLabel(nullptr),
+      m_collector(this),
+      m_liveTimer(this)
 {
     // 菜单栏
     wxMenu* menuFile = new wxMenu;
     menuFile->Append(wxID_SAVE, wxT("&导出...\tCtrl+S"));
+    menuFile->Append(wxID_STOP, wxT("停止采集\tEsc"));
     menuFile->AppendSeparator();
     menuFile->Append(wxID_EXIT, wxT("退出\tAlt+F4"));
     
@@ -101,6 +1066,7 @@ MainWindow::MainWindow(const wxString& title)
     // 工具栏
     wxToolBar* toolBar = CreateToolBar(wxTB_HORIZONTAL | wxTB_TEXT | wxTB_NODIVIDER);
     toolBar->AddTool(wxID_REFRESH, wxT("🔄 刷新"), wxArtProvider::GetBitmap(wxART_REDO, wxART_TOOLBAR), wxT("刷新硬件信息"));
+    toolBar->AddTool(wxID_STOP, wxT("⏹ 停止"), wxArtProvider::GetBitmap(wxART_CROSS_MARK, wxART_TOOLBAR), wxT("取消进行中的采集"));
     toolBar->AddTool(wxID_COPY, wxT("📋 复制"), wxArtProvider::GetBitmap(wxART_COPY, wxART_TOOLBAR), wxT("复制全部信息"));
     toolBar->AddTool(wxID_SAVE, wxT("💾 导出"), wxArtProvider::GetBitmap(wxART_FILE_SAVE, wxART_TOOLBAR), wxT("导出报告"));
     toolBar->Realize();
@@ -140,8 +1106,45 @@ MainWindow::MainWindow(const wxString& title)
     topPanel->SetSizer(topSizer);
     mainSizer->Add(topPanel, 0, wxEXPAND | wxBOTTOM, 8);
     
+    // === 历史时间轴：拖动回看以往各次采集时的状态 ===
+    wxBoxSizer* historySizer = new wxBoxSizer(wxHORIZONTAL);
+    wxStaticText* historyTitle = new wxStaticText(this, wxID_ANY, wxT("🕘 历史"));
+    historyTitle->SetFont(historyTitle->GetFont().Bold());
+    m_historySlider = new wxSlider(this, wxID_ANY, 1, 0, 1);
+    m_historySlider->Disable();
+    m_historyLabel = new wxStaticText(this, wxID_ANY, wxT("暂无记录"), wxDefaultPosition, wxSize(240, -1));
+    m_historyLabel->SetForegroundColour(wxColour(90, 90, 90));
+    wxButton* latestBtn = new wxButton(this, wxID_ANY, wxT("回到最新"));
+    historySizer->Add(historyTitle, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 8);
+    historySizer->Add(m_historySlider, 1, wxALIGN_CENTER_VERTICAL);
+    historySizer->Add(m_historyLabel, 0, wxALIGN_CENTER_VERTICAL | wxLEFT | wxRIGHT, 8);
+    historySizer->Add(latestBtn, 0, wxALIGN_CENTER_VERTICAL);
+    mainSizer->Add(historySizer, 0, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 12);
+    
+    // === 分页：各区域按主题分到标签页，页内可滚动，窗口高度不再随区域数增长 ===
+    // 新增的区域放进对应的页（或新开一页），不要直接加到 mainSizer
+    wxNotebook* notebook = new wxNotebook(this, wxID_ANY);
+    auto AddPage = [notebook](const wxString& title) {
+        wxScrolledWindow* page = new wxScrolledWindow(notebook, wxID_ANY);
+        page->SetScrollRate(0, 12);
+        page->SetSizer(new wxBoxSizer(wxVERTICAL));
+        notebook->AddPage(page, title);
+        return page;
+    };
+    
+    wxScrolledWindow* overviewPage = AddPage(wxT("概览"));
+    wxScrolledWindow* devicePage = AddPage(wxT("设备"));
+    wxScrolledWindow* benchPage = AddPage(wxT("性能测试"));
+    wxScrolledWindow* monitorPage = AddPage(wxT("实时监控"));
+    wxScrolledWindow* auditPage = AddPage(wxT("调优检查"));
+    wxSizer* overviewSizer = overviewPage->GetSizer();
+    wxSizer* deviceSizer = devicePage->GetSizer();
+    wxSizer* benchSizer = benchPage->GetSizer();
+    wxSizer* monitorSizer = monitorPage->GetSizer();
+    wxSizer* auditSizer = auditPage->GetSizer();
+    
     // === 信息区域：主板拆分为两行，标签放大 ===
-    wxPanel* infoPanel = new wxPanel(this, wxID_ANY);
+    wxPanel* infoPanel = new wxPanel(overviewPage, wxID_ANY);
     wxFlexGridSizer* infoSizer = new wxFlexGridSizer(2, 15, 10);  // 行距微调至10，更宽松
     infoSizer->AddGrowableCol(1, 1);
     
@@ -158,39 +1161,149 @@ MainWindow::MainWindow(const wxString& title)
         infoSizer->Add(valueCtrl, 1, wxEXPAND | wxALIGN_CENTER_VERTICAL);
     };
     
-    // ✅ 主板拆分为两行独立显示（标签已放大）
-    AddInfoRow(wxT("主板制造商:"), m_boardManufacturerText);
-    AddInfoRow(wxT("主板型号:"), m_boardProductText);
-    
-    AddInfoRow(wxT("CPU 信息:"), m_cpuInfoText);
-    AddInfoRow(wxT("内存信息:"), m_memInfoText);
-    AddInfoRow(wxT("BIOS 信息:"), m_biosInfoText);
-    AddInfoRow(wxT("系统 UUID:"), m_uuidText);
+    // ✅ 主板拆分为两行独立显示（标签已放大）；行定义见 s_infoRows
+    for (const InfoRowBinding& row : s_infoRows) {
+        wxStaticText* valueCtrl = nullptr;
+        AddInfoRow(row.label, valueCtrl);
+        m_infoValues.push_back(valueCtrl);
+    }
     
     infoPanel->SetSizer(infoSizer);
-    mainSizer->Add(infoPanel, 0, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 12);
+    overviewSizer->Add(infoPanel, 0, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 12);
     
     // === 硬盘列表 ===
-    wxStaticText* diskLabel = new wxStaticText(this, wxID_ANY, wxT("🗄️ 硬盘信息"));
+    wxStaticText* diskLabel = new wxStaticText(overviewPage, wxID_ANY, wxT("🗄️ 硬盘信息"));
     diskLabel->SetFont(diskLabel->GetFont().Bold().Larger());  // 区域标题放大加粗
-    mainSizer->Add(diskLabel, 0, wxLEFT | wxTOP, 8);
+    overviewSizer->Add(diskLabel, 0, wxLEFT | wxTOP, 8);
     
-    m_diskList = new wxListCtrl(this, wxID_ANY, wxDefaultPosition, wxSize(-1, 100),
+    m_diskList = new wxListCtrl(overviewPage, wxID_ANY, wxDefaultPosition, wxSize(-1, 100),
                                 wxLC_REPORT | wxLC_SINGLE_SEL | wxLC_HRULES);
     m_diskList->InsertColumn(0, wxT("型号"), wxLIST_FORMAT_LEFT, 380);
     m_diskList->InsertColumn(1, wxT("序列号"), wxLIST_FORMAT_LEFT, 180);
-    mainSizer->Add(m_diskList, 0, wxEXPAND | wxLEFT | wxRIGHT | wxTOP | wxBOTTOM, 8);
+    // 性能测试结果：右键菜单或双击行运行
+    std::vector<diskbench::Spec> benchSpecs = diskbench::DefaultSpecs();
+    for (size_t i = 0; i < benchSpecs.size(); ++i) {
+        m_diskList->InsertColumn(kDiskFixedColumns + (long)i, FormatBenchSpec(benchSpecs[i]), wxLIST_FORMAT_RIGHT, 110);
+    }
+    overviewSizer->Add(m_diskList, 0, wxEXPAND | wxLEFT | wxRIGHT | wxTOP | wxBOTTOM, 8);
     
     // === 网卡列表 ===
-    wxStaticText* netLabel = new wxStaticText(this, wxID_ANY, wxT("🌐 网络适配器"));
+    wxStaticText* netLabel = new wxStaticText(overviewPage, wxID_ANY, wxT("🌐 网络适配器"));
     netLabel->SetFont(netLabel->GetFont().Bold().Larger());  // 区域标题放大加粗
-    mainSizer->Add(netLabel, 0, wxLEFT | wxTOP, 8);
+    overviewSizer->Add(netLabel, 0, wxLEFT | wxTOP, 8);
     
-    m_netList = new wxListCtrl(this, wxID_ANY, wxDefaultPosition, wxSize(-1, 80),
+    m_netList = new wxListCtrl(overviewPage, wxID_ANY, wxDefaultPosition, wxSize(-1, 80),
                                wxLC_REPORT | wxLC_SINGLE_SEL | wxLC_HRULES);
     m_netList->InsertColumn(0, wxT("MAC 地址"), wxLIST_FORMAT_LEFT, 200);
     m_netList->InsertColumn(1, wxT("状态"), wxLIST_FORMAT_LEFT, 100);
-    mainSizer->Add(m_netList, 0, wxEXPAND | wxLEFT | wxRIGHT | wxTOP | wxBOTTOM, 8);
+    overviewSizer->Add(m_netList, 1, wxEXPAND | wxLEFT | wxRIGHT | wxTOP | wxBOTTOM, 8);
+    
+    // === PCI 设备 ===
+    wxStaticText* pciLabel = new wxStaticText(devicePage, wxID_ANY, wxT("🔌 PCI 设备"));
+    pciLabel->SetFont(pciLabel->GetFont().Bold().Larger());  // 区域标题放大加粗
+    deviceSizer->Add(pciLabel, 0, wxLEFT | wxTOP, 8);
+    
+    m_pciList = new wxListCtrl(devicePage, wxID_ANY, wxDefaultPosition, wxSize(-1, 140),
+                               wxLC_REPORT | wxLC_SINGLE_SEL | wxLC_HRULES);
+    m_pciList->InsertColumn(0, wxT("地址"), wxLIST_FORMAT_LEFT, 100);
+    m_pciList->InsertColumn(1, wxT("设备"), wxLIST_FORMAT_LEFT, 300);
+    m_pciList->InsertColumn(2, wxT("类别"), wxLIST_FORMAT_LEFT, 170);
+    m_pciList->InsertColumn(3, wxT("链路"), wxLIST_FORMAT_LEFT, 130);
+    m_pciList->InsertColumn(4, wxT("NUMA"), wxLIST_FORMAT_LEFT, 50);
+    m_pciList->InsertColumn(5, wxT("驱动"), wxLIST_FORMAT_LEFT, 90);
+    deviceSizer->Add(m_pciList, 0, wxEXPAND | wxLEFT | wxRIGHT | wxTOP | wxBOTTOM, 8);
+    
+    // === NUMA 拓扑 ===
+    wxStaticText* numaLabel = new wxStaticText(devicePage, wxID_ANY, wxT("🧩 NUMA 拓扑"));
+    numaLabel->SetFont(numaLabel->GetFont().Bold().Larger());  // 区域标题放大加粗
+    deviceSizer->Add(numaLabel, 0, wxLEFT | wxTOP, 8);
+    
+    m_numaList = new wxListCtrl(devicePage, wxID_ANY, wxDefaultPosition, wxSize(-1, 90),
+                                wxLC_REPORT | wxLC_SINGLE_SEL | wxLC_HRULES | wxLC_VRULES);
+    m_numaList->InsertColumn(0, wxT("节点"), wxLIST_FORMAT_LEFT, 50);
+    m_numaList->InsertColumn(1, wxT("CPU"), wxLIST_FORMAT_LEFT, 170);
+    m_numaList->InsertColumn(2, wxT("内存 (空闲/总计)"), wxLIST_FORMAT_LEFT, 140);
+    m_numaList->InsertColumn(3, wxT("大页 (空闲/总数)"), wxLIST_FORMAT_LEFT, 140);
+    deviceSizer->Add(m_numaList, 0, wxEXPAND | wxLEFT | wxRIGHT | wxTOP | wxBOTTOM, 8);
+    
+    // === 插件 ===
+    wxStaticText* pluginLabel = new wxStaticText(devicePage, wxID_ANY, wxT("🧷 插件"));
+    pluginLabel->SetFont(pluginLabel->GetFont().Bold().Larger());  // 区域标题放大加粗
+    deviceSizer->Add(pluginLabel, 0, wxLEFT | wxTOP, 8);
+    
+    m_pluginList = new wxListCtrl(devicePage, wxID_ANY, wxDefaultPosition, wxSize(-1, 90),
+                                  wxLC_REPORT | wxLC_SINGLE_SEL | wxLC_HRULES);
+    m_pluginList->InsertColumn(0, wxT("探测"), wxLIST_FORMAT_LEFT, 140);
+    m_pluginList->InsertColumn(1, wxT("项目"), wxLIST_FORMAT_LEFT, 170);
+    m_pluginList->InsertColumn(2, wxT("值"), wxLIST_FORMAT_LEFT, 400);
+    deviceSizer->Add(m_pluginList, 1, wxEXPAND | wxLEFT | wxRIGHT | wxTOP | wxBOTTOM, 8);
+    
+    // === 内存性能 ===
+    wxBoxSizer* memoryHeader = new wxBoxSizer(wxHORIZONTAL);
+    wxStaticText* memoryLabel = new wxStaticText(benchPage, wxID_ANY, wxT("🧠 内存性能"));
+    memoryLabel->SetFont(memoryLabel->GetFont().Bold().Larger());  // 区域标题放大加粗
+    wxButton* memoryBtn = new wxButton(benchPage, wxID_ANY, wxT("运行内存测试"));
+    memoryHeader->Add(memoryLabel, 0, wxALIGN_CENTER_VERTICAL);
+    memoryHeader->AddStretchSpacer();
+    memoryHeader->Add(memoryBtn, 0, wxALIGN_CENTER_VERTICAL);
+    benchSizer->Add(memoryHeader, 0, wxEXPAND | wxLEFT | wxRIGHT | wxTOP, 8);
+    
+    m_memoryPanel = new MemoryBenchPanel(benchPage);
+    benchSizer->Add(m_memoryPanel, 0, wxEXPAND | wxLEFT | wxRIGHT | wxTOP | wxBOTTOM, 8);
+    
+    // === CPU 性能 ===
+    wxBoxSizer* cpuHeader = new wxBoxSizer(wxHORIZONTAL);
+    wxStaticText* cpuLabel = new wxStaticText(benchPage, wxID_ANY, wxT("🧮 CPU 性能"));
+    cpuLabel->SetFont(cpuLabel->GetFont().Bold().Larger());  // 区域标题放大加粗
+    wxButton* cpuQuickBtn = new wxButton(benchPage, wxID_ANY, wxT("快速测试"));
+    wxButton* cpuSoakBtn = new wxButton(benchPage, wxID_ANY, wxT("长时间测试"));
+    cpuHeader->Add(cpuLabel, 0, wxALIGN_CENTER_VERTICAL);
+    cpuHeader->AddStretchSpacer();
+    cpuHeader->Add(cpuQuickBtn, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 6);
+    cpuHeader->Add(cpuSoakBtn, 0, wxALIGN_CENTER_VERTICAL);
+    benchSizer->Add(cpuHeader, 0, wxEXPAND | wxLEFT | wxRIGHT | wxTOP, 8);
+    
+    m_cpuPanel = new CpuBenchPanel(benchPage);
+    benchSizer->Add(m_cpuPanel, 0, wxEXPAND | wxLEFT | wxRIGHT | wxTOP | wxBOTTOM, 8);
+    
+    // === 传感器 ===
+    wxStaticText* sensorLabel = new wxStaticText(monitorPage, wxID_ANY, wxT("🌡 传感器"));
+    sensorLabel->SetFont(sensorLabel->GetFont().Bold().Larger());  // 区域标题放大加粗
+    monitorSizer->Add(sensorLabel, 0, wxLEFT | wxTOP, 8);
+    
+    m_sensorList = new wxListCtrl(monitorPage, wxID_ANY, wxDefaultPosition, wxSize(-1, 140),
+                                  wxLC_REPORT | wxLC_SINGLE_SEL | wxLC_HRULES);
+    m_sensorList->InsertColumn(0, wxT("芯片"), wxLIST_FORMAT_LEFT, 110);
+    m_sensorList->InsertColumn(1, wxT("传感器"), wxLIST_FORMAT_LEFT, 150);
+    m_sensorList->InsertColumn(2, wxT("当前"), wxLIST_FORMAT_RIGHT, 90);
+    m_sensorList->InsertColumn(3, wxT("最小"), wxLIST_FORMAT_RIGHT, 90);
+    m_sensorList->InsertColumn(4, wxT("最大"), wxLIST_FORMAT_RIGHT, 90);
+    m_sensorList->InsertColumn(5, wxT("平均"), wxLIST_FORMAT_RIGHT, 90);
+    monitorSizer->Add(m_sensorList, 0, wxEXPAND | wxLEFT | wxRIGHT | wxTOP | wxBOTTOM, 8);
+    
+    // === 进程 ===
+    wxStaticText* processLabel = new wxStaticText(monitorPage, wxID_ANY, wxT("📊 进程"));
+    processLabel->SetFont(processLabel->GetFont().Bold().Larger());  // 区域标题放大加粗
+    monitorSizer->Add(processLabel, 0, wxLEFT | wxTOP, 8);
+    
+    m_processList = new ProcessListCtrl(monitorPage);
+    monitorSizer->Add(m_processList, 1, wxEXPAND | wxLEFT | wxRIGHT | wxTOP | wxBOTTOM, 8);
+    
+    // === 调优检查 ===
+    wxStaticText* auditLabel = new wxStaticText(auditPage, wxID_ANY, wxT("🩺 调优检查"));
+    auditLabel->SetFont(auditLabel->GetFont().Bold().Larger());  // 区域标题放大加粗
+    auditSizer->Add(auditLabel, 0, wxLEFT | wxTOP, 8);
+    
+    m_auditList = new wxListCtrl(auditPage, wxID_ANY, wxDefaultPosition, wxSize(-1, 120),
+                                 wxLC_REPORT | wxLC_SINGLE_SEL | wxLC_HRULES);
+    m_auditList->InsertColumn(0, wxT("级别"), wxLIST_FORMAT_LEFT, 70);
+    m_auditList->InsertColumn(1, wxT("规则"), wxLIST_FORMAT_LEFT, 110);
+    m_auditList->InsertColumn(2, wxT("问题"), wxLIST_FORMAT_LEFT, 260);
+    m_auditList->InsertColumn(3, wxT("实际值"), wxLIST_FORMAT_LEFT, 220);
+    m_auditList->InsertColumn(4, wxT("建议"), wxLIST_FORMAT_LEFT, 300);
+    auditSizer->Add(m_auditList, 1, wxEXPAND | wxLEFT | wxRIGHT | wxTOP | wxBOTTOM, 8);
+    
+    mainSizer->Add(notebook, 1, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 8);
     
     // === 底部状态栏 ===
     wxPanel* statusPanel = new wxPanel(this, wxID_ANY, wxDefaultPosition, wxSize(-1, 28));  // 稍高
@@ -209,10 +1322,50 @@ MainWindow::MainWindow(const wxString& title)
     statusPanel->SetSizer(statusSizer);
     mainSizer->Add(statusPanel, 0, wxEXPAND);
     
-    SetSizerAndFit(mainSizer);
+    SetSizer(mainSizer);
+    SetMinSize(wxSize(720, 520));
     
     // 事件绑定
     Bind(wxEVT_BUTTON, &MainWindow::OnCopyFingerprint, this, copyBtn->GetId());
+    Bind(wxEVT_BUTTON, &MainWindow::OnMemoryBenchmark, this, memoryBtn->GetId());
+    Bind(wxEVT_BUTTON, [this](wxCommandEvent&) { RunCpuBenchmark(cpubench::Mode::Quick); }, cpuQuickBtn->GetId());
+    Bind(wxEVT_BUTTON, [this](wxCommandEvent&) { RunCpuBenchmark(cpubench::Mode::Soak); }, cpuSoakBtn->GetId());
+    Bind(wxEVT_TIMER, &MainWindow::OnLiveTimer, this, m_liveTimer.GetId());
+    Bind(wxEVT_SLIDER, &MainWindow::OnHistorySlider, this, m_historySlider->GetId());
+    Bind(wxEVT_BUTTON, [this](wxCommandEvent&) {
+        m_historySlider->SetValue(m_historySlider->GetMax());
+        ShowHistoryAt(m_historySlider->GetMax());
+    }, latestBtn->GetId());
+    m_diskList->Bind(wxEVT_LIST_ITEM_RIGHT_CLICK, &MainWindow::OnDiskContextMenu, this);
+    m_diskList->Bind(wxEVT_LIST_ITEM_ACTIVATED, &MainWindow::OnDiskActivated, this);
+    
+    // 传感器只在启动时发现一次，之后采样线程复用已打开的输入
+    m_sensors = std::make_unique<sensors::Sampler>();
+    if (m_sensors->Discover() > 0) {
+        for (size_t i = 0; i < m_sensors->Sensors().size(); ++i) {
+            const sensors::Sensor& sensor = m_sensors->Sensors()[i];
+            long idx = m_sensorList->InsertItem(i, Hardware::Utf8ToWxString(sensor.chip.data(), sensor.chip.size()));
+            m_sensorList->SetItem(idx, 1, Hardware::Utf8ToWxString(sensor.label.data(), sensor.label.size()));
+        }
+        m_sensors->Start(std::chrono::milliseconds(100));
+    } else {
+        m_sensorList->InsertItem(0, wxT("未检测到传感器"));
+    }
+    
+    m_processes = std::make_unique<procs::Monitor>();
+    m_processes->Start(std::chrono::milliseconds(1000));
+    m_liveTimer.Start(1000);
+    
+    // 快照历史保存在用户数据目录；同一文件已被另一实例打开时本实例不记录
+    wxString historyDir = wxStandardPaths::Get().GetUserDataDir();
+    wxFileName::Mkdir(historyDir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    m_history = std::make_unique<history::Store>();
+    std::string historyError;
+    if (!m_history->Open(Hardware::ToUtf8(historyDir + wxFILE_SEP_PATH + wxT("history.mth")), &historyError)) {
+        m_historyLabel->SetLabel(wxT("历史不可用：") + Hardware::Utf8ToWxString(historyError.data(), historyError.size()));
+        m_history.reset();
+    }
+    UpdateHistoryTimeline();
     
     // 启动采集
     StartHardwareCollection();
@@ -221,7 +1374,16 @@ MainWindow::MainWindow(const wxString& title)
     Show();
 }
 
-MainWindow::~MainWindow() = default;
+MainWindow::~MainWindow()
+{
+    // 先于窗口销毁断开采集线程，避免向已销毁的窗口投递事件；
+    // 进行中的一轮先取消，探测在步骤之间看到令牌后尽早退出
+    m_collector.Cancel();
+    m_collector.Shutdown();
+    m_liveTimer.Stop();
+    m_sensors->Stop();
+    m_processes->Stop();
+}
 
 void MainWindow::StartHardwareCollection()
 {
@@ -230,12 +1392,10 @@ void MainWindow::StartHardwareCollection()
     m_progress->Pulse();
     Layout();
     
-    HardwareCollectorThread* thread = new HardwareCollectorThread(this);
-    if (thread->Create() != wxTHREAD_NO_ERROR) {
+    if (!m_collector.Start()) {
         m_statusLabel->SetLabel(wxT("❌ 线程创建失败"));
         m_progress->Hide();
         Layout();
-        delete thread;
         
         // 降级：1秒后显示空界面
         wxTimer* timer = new wxTimer(this, wxID_ANY);
@@ -243,71 +1403,434 @@ void MainWindow::StartHardwareCollection()
             PopulateUI(HardwareData());
             timer->Stop();
             delete timer;
-        }, wxID_ANY);
+        }, timer->GetId());  // 只接收本定时器，不截走传感器定时器的事件
         timer->Start(1000, wxTIMER_ONE_SHOT);
     } else {
-        thread->Run();
+        m_collector.Request();
     }
 }
 
 void MainWindow::OnHardwareCollected(wxThreadEvent& event)
 {
-    HardwareData data = event.GetPayload<HardwareData>();
-    PopulateUI(data);
-    m_hardwareData = data;
+    // 被取代的旧一轮结果不再刷新界面
+    if (!m_collector.IsCurrent((unsigned long)event.GetExtraLong())) return;
+    
+    // 载荷是共享指针：事件传递不复制快照，这里再整体移入 m_hardwareData
+    std::shared_ptr<HardwareData> data = event.GetPayload<std::shared_ptr<HardwareData>>();
+    data->DiskBenchmarks = m_hardwareData.DiskBenchmarks;   // 测试结果不由采集产生，跨刷新保留
+    data->MemoryBandwidths = m_hardwareData.MemoryBandwidths;
+    data->MemoryLatencies = m_hardwareData.MemoryLatencies;
+    data->CpuBenchmarks = m_hardwareData.CpuBenchmarks;
+    data->CpuKernelRates = m_hardwareData.CpuKernelRates;
+    data->CpuScaling = m_hardwareData.CpuScaling;
+    PopulateUI(*data);
+    
+    // 与上一次结果比较，列出变化的字段
+    wxString changed;
+    if (m_hardwareData.CollectionTime.IsValid()) {
+        for (const schema::FieldChange& change : schema::Diff(m_hardwareData, *data)) {
+            if (!changed.IsEmpty()) changed += wxT(", ");
+            changed += change.name;
+        }
+    }
+    m_hardwareData = std::move(*data);
+    
+    // 追加到历史，时间轴回到最新（界面已显示本次结果）
+    if (m_history) {
+        std::string error;
+        if (!m_history->Append((int64_t)m_hardwareData.CollectionTime.GetTicks(), m_hardwareData, &error)) {
+            m_historyLabel->SetLabel(wxT("历史写入失败：") + Hardware::Utf8ToWxString(error.data(), error.size()));
+        } else {
+            UpdateHistoryTimeline();
+        }
+    }
     
-    m_statusLabel->SetLabel(wxString::Format(wxT("✓ 完成 %s"), data.CollectionTime.FormatTime().Mid(0, 8)));
+    // 部分结果：列出未能取得的部分
+    wxString missing;
+    for (const ProbeReport& report : m_hardwareData.ProbeReports) {
+        if (!IsMissing(report.Status)) continue;
+        if (!missing.IsEmpty()) missing += wxT(", ");
+        missing += report.Section + wxT(" ") + ProbeStatusText(report.Status);
+    }
+    wxString time = m_hardwareData.CollectionTime.FormatTime().Mid(0, 8);
+    wxString status = missing.IsEmpty()
+        ? wxString::Format(wxT("✓ 完成 %s"), time)
+        : wxString::Format(wxT("⚠ 部分完成 %s（%s）"), time, missing);
+    if (!changed.IsEmpty()) {
+        status += wxString::Format(wxT("  · 变化: %s"), changed);
+    }
+    m_statusLabel->SetLabel(status);
     m_progress->Hide();
     Layout();
 }
 
-void MainWindow::PopulateUI(const HardwareData& data)
+// 实时区域每秒刷新：传感器行在启动时已建好，这里只改数值列；进程表换成最新一次采样
+void MainWindow::OnLiveTimer(wxTimerEvent& WXUNUSED(event))
 {
-    // 机器指纹
-    m_fingerprintText->SetLabel(data.MachineFingerprint.IsEmpty() ? wxT("N/A") : data.MachineFingerprint);
+    std::shared_ptr<const procs::ProcessList> processes = m_processes->Latest();
+    if (processes.get() != m_processList->Processes()) m_processList->SetProcesses(std::move(processes));
+    // 读写计数只为看得见的行读取；按读写速率排序时全部读取
+    m_processes->SetVisible(m_processList->VisiblePids(), m_processList->SortsByIo());
+    
+    std::vector<sensors::Stats> stats = m_sensors->Snapshot();
+    const std::vector<sensors::Sensor>& list = m_sensors->Sensors();
+    for (size_t i = 0; i < stats.size() && i < list.size(); ++i) {
+        if (stats[i].samples == 0) {
+            m_sensorList->SetItem(i, 2, wxT("—"));
+            continue;
+        }
+        m_sensorList->SetItem(i, 2, FormatSensorValue(stats[i].current, list[i].kind));
+        m_sensorList->SetItem(i, 3, FormatSensorValue(stats[i].min, list[i].kind));
+        m_sensorList->SetItem(i, 4, FormatSensorValue(stats[i].max, list[i].kind));
+        m_sensorList->SetItem(i, 5, FormatSensorValue(stats[i].average, list[i].kind));
+    }
+}
+
+void MainWindow::OnDiskContextMenu(wxListEvent& event)
+{
+    long row = event.GetIndex();
+    if (row < 0 || (size_t)row >= m_hardwareData.DiskModels.size()) return;
+    wxMenu menu;
+    menu.Append(wxID_EXECUTE, wxT("性能测试..."));
+    if (m_diskList->GetPopupMenuSelectionFromUser(menu) == wxID_EXECUTE) RunDiskBenchmark(row);
+}
+
+void MainWindow::OnDiskActivated(wxListEvent& event)
+{
+    long row = event.GetIndex();
+    if (row >= 0 && (size_t)row < m_hardwareData.DiskModels.size()) RunDiskBenchmark(row);
+}
+
+void MainWindow::FillDiskBenchmarkColumns(long row, const HardwareData& data)
+{
+    for (const DiskBenchmark& bench : data.DiskBenchmarks) {
+        long column = DiskBenchmarkColumn(bench);
+        if (column >= 0 && bench.Disk == data.DiskModels[row]) m_diskList->SetItem(row, column, FormatThroughput(bench));
+    }
+}
+
+// 测试在工作线程上阻塞运行，界面线程显示模态进度对话框并轮询进度；"取消"转为 stop 请求，
+// 等在途请求完成后返回，已跑完的测试项照常保存
+void MainWindow::RunDiskBenchmark(long row)
+{
+    wxString model = m_hardwareData.DiskModels[row];
     
-    // ✅ 主板拆分显示
-    m_boardManufacturerText->SetLabel(
-        data.BaseBoardManufacturer.IsEmpty() || data.BaseBoardManufacturer.Contains(wxT("Unknown")) 
-            ? wxT("未知") 
-            : data.BaseBoardManufacturer
-    );
+    // 测试目录：型号对应的挂载点只有一个时直接使用，多个时让用户选，找不到时手动指定
+    std::vector<std::string> mounts = diskbench::MountPoints(Hardware::ToUtf8(model));
+    wxString directory;
+    if (mounts.size() == 1) {
+        directory = Hardware::Utf8ToWxString(mounts[0].data(), mounts[0].size());
+    } else if (mounts.size() > 1) {
+        wxArrayString choices;
+        for (const std::string& mount : mounts) choices.Add(Hardware::Utf8ToWxString(mount.data(), mount.size()));
+        wxSingleChoiceDialog dlg(this, wxString::Format(wxT("%s 上有多个分区，选择测试文件所在的位置："), model),
+                                 wxT("硬盘性能测试"), choices);
+        if (dlg.ShowModal() != wxID_OK) return;
+        directory = dlg.GetStringSelection();
+    } else {
+        wxDirDialog dlg(this, wxString::Format(wxT("未能确定 %s 的挂载位置，请选择该硬盘上的一个可写目录"), model),
+                        wxEmptyString, wxDD_DEFAULT_STYLE | wxDD_DIR_MUST_EXIST);
+        if (dlg.ShowModal() != wxID_OK) return;
+        directory = dlg.GetPath();
+    }
     
-    m_boardProductText->SetLabel(
-        data.BaseBoardProduct.IsEmpty() || data.BaseBoardProduct.Contains(wxT("Unknown")) 
-            ? wxT("未知") 
-            : data.BaseBoardProduct
-    );
+    diskbench::Options options;
+    options.directory = Hardware::ToUtf8(directory);
+    wxString prompt = wxString::Format(
+        wxT("将在 %s 写入最多 %llu MB 临时数据（测试结束后删除），共 %zu 项测试，每项最长 %lld 秒。\n")
+        wxT("测试期间该硬盘负载很高，是否继续？"),
+        directory, (unsigned long long)(options.maxBytesWritten >> 20), options.specs.size(),
+        (long long)std::chrono::duration_cast<std::chrono::seconds>(options.testDuration).count());
+    if (wxMessageBox(prompt, wxT("硬盘性能测试"), wxYES_NO | wxICON_QUESTION, this) != wxYES) return;
     
-    // CPU 信息
-    wxString cpuInfo = data.CPUName;
-    if (data.CPUMaxClockSpeed > 0) {
-        cpuInfo += wxString::Format(wxT(" @ %.2f GHz"), data.CPUMaxClockSpeed / 1000.0);
+    std::atomic<size_t> current(0);
+    std::atomic<double> fraction(0);
+    std::atomic<bool> done(false);
+    std::stop_source stop;
+    diskbench::Report report;
+    std::thread worker([&] {
+        diskbench::Run(options, &report, stop.get_token(), [&](size_t test, double value) {
+            current = test;
+            fraction = value;
+        });
+        done = true;
+    });
+    
+    size_t count = options.specs.size();
+    wxProgressDialog progress(wxT("硬盘性能测试"), model, 1000, this, wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME);
+    while (!done) {
+        size_t test = std::min(current.load(), count - 1);
+        int value = std::min(999, (int)((test + fraction.load()) * 1000 / count));
+        wxString message = stop.stop_requested() ? wxString(wxT("正在取消..."))
+                                                 : model + wxT("\n") + FormatBenchSpec(options.specs[test]);
+        if (!progress.Update(value, message)) stop.request_stop();
+        wxMilliSleep(100);
     }
-    m_cpuInfoText->SetLabel(cpuInfo.IsEmpty() ? wxT("未知") : cpuInfo);
+    worker.join();
     
-    // 内存信息
-    unsigned long long bytes = 0;
-    wxString memInfo = wxT("未知");
-    if (!data.TotalPhysicalMemory.IsEmpty() && wxStringToULL(data.TotalPhysicalMemory, &bytes) && bytes > 0) {
-        double gb = bytes / (1024.0 * 1024.0 * 1024.0);
-        memInfo = wxString::Format(wxT("%.2f GB"), gb);
-        if (!data.MemoryType.IsEmpty() && !data.MemoryType.Contains(wxT("Unknown"))) {
-            memInfo += wxT(" (") + data.MemoryType + wxT(")");
+    // 对话框期间可能完成了一次重新采集，按型号重新定位行
+    row = m_diskList->FindItem(-1, model);
+    
+    // 同一硬盘的旧结果整体替换
+    wxString time = wxDateTime::Now().FormatISOCombined(' ');
+    std::vector<DiskBenchmark>& benches = m_hardwareData.DiskBenchmarks;
+    if (!report.results.empty()) {
+        benches.erase(std::remove_if(benches.begin(), benches.end(),
+                                     [&](const DiskBenchmark& bench) { return bench.Disk == model; }),
+                      benches.end());
+    }
+    for (const diskbench::Result& result : report.results) {
+        DiskBenchmark bench;
+        bench.Disk = model;
+        bench.Path = directory;
+        bench.Time = time;
+        bench.Test = diskbench::PatternName(result.spec.pattern);
+        bench.BlockSize = (long)result.spec.blockSize;
+        bench.QueueDepth = (long)result.spec.queueDepth;
+        bench.Engine = Hardware::Utf8ToWxString(report.engine.data(), report.engine.size());
+        bench.Direct = report.direct ? 1 : 0;
+        bench.ThroughputKBps = std::lround(result.throughputMBps * 1000);
+        bench.Iops = std::lround(result.iops);
+        bench.LatencyAvgUs = std::lround(result.latencyAvgUs);
+        bench.LatencyP50Us = std::lround(result.latencyP50Us);
+        bench.LatencyP99Us = std::lround(result.latencyP99Us);
+        bench.LatencyP999Us = std::lround(result.latencyP999Us);
+        bench.LatencyMaxUs = std::lround(result.latencyMaxUs);
+        benches.push_back(bench);
+    }
+    if (row >= 0) {
+        for (long column = kDiskFixedColumns; column < m_diskList->GetColumnCount(); ++column) {
+            m_diskList->SetItem(row, column, wxEmptyString);
         }
+        FillDiskBenchmarkColumns(row, m_hardwareData);
     }
-    m_memInfoText->SetLabel(memInfo);
     
-    // BIOS 信息
-    wxString biosInfo = data.BIOSManufacturer;
-    if (!data.BIOSVersion.IsEmpty() && !data.BIOSVersion.Contains(wxT("Unknown"))) {
-        if (!biosInfo.IsEmpty()) biosInfo += wxT(" v");
-        biosInfo += data.BIOSVersion;
+    if (!report.error.empty()) {
+        wxMessageBox(wxT("测试失败：") + Hardware::Utf8ToWxString(report.error.data(), report.error.size()),
+                     wxT("硬盘性能测试"), wxOK | wxICON_ERROR, this);
+    }
+    wxString status = report.cancelled ? wxString(wxT("⚠ 硬盘测试已取消"))
+                    : report.error.empty() ? wxString(wxT("✓ 硬盘测试完成")) : wxString(wxT("❌ 硬盘测试失败"));
+    status += wxString::Format(wxT("（%s，已写入 %llu MB%s）"),
+                               Hardware::Utf8ToWxString(report.engine.data(), report.engine.size()), (unsigned long long)(report.bytesWritten >> 20),
+                               report.direct ? wxT("") : wxT("，文件系统不支持直接 I/O，结果含系统缓存"));
+    m_statusLabel->SetLabel(status);
+}
+
+// 与硬盘测试相同：工作线程阻塞运行，模态进度对话框轮询；取消时已完成的部分照常显示
+void MainWindow::OnMemoryBenchmark(wxCommandEvent& WXUNUSED(event))
+{
+    wxString prompt = wxT("测试期间所有处理器核心与内存带宽满载，约需半分钟，系统响应会变慢。\n")
+                      wxT("测试前请关闭其它负载较高的程序，是否继续？");
+    if (wxMessageBox(prompt, wxT("内存性能测试"), wxYES_NO | wxICON_QUESTION, this) != wxYES) return;
+    
+    membench::Options options;
+    std::atomic<double> fraction(0);
+    std::atomic<bool> done(false);
+    std::stop_source stop;
+    membench::Report report;
+    std::thread worker([&] {
+        membench::Run(options, &report, stop.get_token(), [&](double value) { fraction = value; });
+        done = true;
+    });
+    
+    wxProgressDialog progress(wxT("内存性能测试"), wxT("STREAM 带宽与指针追逐延迟"), 1000, this,
+                              wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME);
+    while (!done) {
+        int value = std::min(999, (int)(fraction.load() * 1000));
+        wxString message = stop.stop_requested() ? wxString(wxT("正在取消...")) : wxString(wxT("STREAM 带宽与指针追逐延迟"));
+        if (!progress.Update(value, message)) stop.request_stop();
+        wxMilliSleep(100);
+    }
+    worker.join();
+    
+    if (!report.bandwidth.empty()) {
+        m_hardwareData.MemoryBandwidths.clear();
+        m_hardwareData.MemoryLatencies.clear();
+        for (const membench::Bandwidth& result : report.bandwidth) {
+            MemoryBandwidth bench;
+            bench.Kernel = membench::KernelName(result.kernel);
+            bench.NonTemporal = result.nonTemporal ? 1 : 0;
+            bench.Node = result.node;
+            bench.Threads = (long)result.threads;
+            bench.MBps = std::lround(result.bytesPerSecond / 1e6);
+            m_hardwareData.MemoryBandwidths.push_back(bench);
+        }
+        for (const membench::LatencyPoint& result : report.latency) {
+            MemoryLatency point;
+            point.WorkingSetKB = (long)(result.workingSetBytes >> 10);
+            point.LatencyPs = std::lround(result.nanoseconds * 1000);
+            m_hardwareData.MemoryLatencies.push_back(point);
+        }
+        m_memoryPanel->SetResults(m_hardwareData.MemoryBandwidths, m_hardwareData.MemoryLatencies);
+    }
+    
+    if (!report.error.empty()) {
+        wxMessageBox(wxT("测试失败：") + Hardware::Utf8ToWxString(report.error.data(), report.error.size()),
+                     wxT("内存性能测试"), wxOK | wxICON_ERROR, this);
+    }
+    wxString status = report.cancelled ? wxString(wxT("⚠ 内存测试已取消"))
+                    : report.error.empty() ? wxString(wxT("✓ 内存测试完成")) : wxString(wxT("❌ 内存测试失败"));
+    // 整机 triad 带宽与最大工作集上的延迟（即内存本身的延迟）
+    for (const membench::Bandwidth& result : report.bandwidth) {
+        if (result.kernel == membench::Kernel::Triad && result.node < 0 && !result.nonTemporal) {
+            status += wxString::Format(wxT("（triad %.1f GB/s"), result.bytesPerSecond / 1e9);
+            if (!report.latency.empty()) status += wxString::Format(wxT("，内存延迟 %.0f ns"), report.latency.back().nanoseconds);
+            status += wxT("）");
+        }
+    }
+    m_statusLabel->SetLabel(status);
+}
+
+// 与内存测试相同的工作线程 + 模态进度对话框；长时间模式中途取消时，已完成的快速部分与满载样本照常保存
+void MainWindow::RunCpuBenchmark(cpubench::Mode mode)
+{
+    cpubench::Options options;
+    options.mode = mode;
+    wxString prompt = mode == cpubench::Mode::Soak
+        ? wxString::Format(wxT("测试期间所有处理器核心持续满载约 %lld 分钟，风扇噪音与温度会明显升高，系统响应会变慢。\n")
+                           wxT("可随时取消，已完成的部分照常保存。是否继续？"), (long long)options.soakDuration.count() / 60)
+        : wxString(wxT("测试期间处理器核心依次满载，约需 10 秒，系统响应会变慢。\n")
+                   wxT("测试前请关闭其它负载较高的程序，是否继续？"));
+    if (wxMessageBox(prompt, wxT("CPU 性能测试"), wxYES_NO | wxICON_QUESTION, this) != wxYES) return;
+    
+    std::atomic<double> fraction(0);
+    std::atomic<bool> done(false);
+    std::stop_source stop;
+    cpubench::Report report;
+    std::thread worker([&] {
+        cpubench::Run(options, &report, stop.get_token(), [&](double value) { fraction = value; });
+        done = true;
+    });
+    
+    wxString title = mode == cpubench::Mode::Soak ? wxString(wxT("整数 / 浮点 / 哈希 / 压缩，之后全核持续满载"))
+                                                  : wxString(wxT("整数 / 浮点 / 哈希 / 压缩"));
+    wxProgressDialog progress(wxT("CPU 性能测试"), title, 1000, this, wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME);
+    while (!done) {
+        int value = std::min(999, (int)(fraction.load() * 1000));
+        if (!progress.Update(value, stop.stop_requested() ? wxString(wxT("正在取消...")) : title)) stop.request_stop();
+        wxMilliSleep(100);
+    }
+    worker.join();
+    
+    if (report.allCoreScore > 0) {
+        CpuBenchmark bench;
+        bench.Mode = cpubench::ModeName(mode);
+        bench.Time = wxDateTime::Now().FormatISOCombined(' ');
+        bench.Isa = cpubench::IsaName(report.bestIsa);
+        bench.Threads = (long)report.threads;
+        bench.Cores = (long)report.cores;
+        bench.SingleCoreScore = std::lround(report.singleCoreScore);
+        bench.AllCoreScore = std::lround(report.allCoreScore);
+        bench.ScalingPermille = std::lround(report.scalingEfficiency * 1000);
+        bench.BurstMHz = std::lround(report.burstMHz);
+        bench.SustainedMHz = std::lround(report.sustainedMHz);
+        // 每种模式只保留最近一次
+        std::vector<CpuBenchmark>& list = m_hardwareData.CpuBenchmarks;
+        list.erase(std::remove_if(list.begin(), list.end(), [&](const CpuBenchmark& old) { return old.Mode == bench.Mode; }),
+                   list.end());
+        list.push_back(bench);
+        std::sort(list.begin(), list.end(), [](const CpuBenchmark& a, const CpuBenchmark& b) { return a.Mode < b.Mode; });
+        
+        m_hardwareData.CpuKernelRates.clear();
+        for (const cpubench::KernelRate& result : report.kernels) {
+            CpuKernelRate rate;
+            rate.Kernel = cpubench::KernelName(result.kernel);
+            rate.Isa = cpubench::IsaName(result.isa);
+            rate.Rate = std::lround(result.rate);
+            m_hardwareData.CpuKernelRates.push_back(rate);
+        }
+        m_hardwareData.CpuScaling.clear();
+        for (const cpubench::ScalingPoint& result : report.scaling) {
+            CpuScalingPoint point;
+            point.Threads = (long)result.threads;
+            point.Pinned = result.pinned ? 1 : 0;
+            point.Score = std::lround(result.score);
+            point.MHz = std::lround(result.mhz);
+            m_hardwareData.CpuScaling.push_back(point);
+        }
+        m_cpuPanel->SetResults(m_hardwareData.CpuBenchmarks, m_hardwareData.CpuKernelRates, m_hardwareData.CpuScaling);
+    }
+    
+    if (!report.error.empty()) {
+        wxMessageBox(wxT("测试失败：") + Hardware::Utf8ToWxString(report.error.data(), report.error.size()),
+                     wxT("CPU 性能测试"), wxOK | wxICON_ERROR, this);
+    }
+    wxString status = report.cancelled ? wxString(wxT("⚠ CPU 测试已取消"))
+                    : report.error.empty() ? wxString(wxT("✓ CPU 测试完成")) : wxString(wxT("❌ CPU 测试失败"));
+    if (report.allCoreScore > 0) {
+        status += wxString::Format(wxT("（%s：单核 %.0f，全核 %.0f"), cpubench::IsaName(report.bestIsa),
+                                   report.singleCoreScore, report.allCoreScore);
+        if (report.burstMHz > 0 && report.sustainedMHz > 0) {
+            status += wxString::Format(wxT("，%.0f → %.0f MHz"), report.burstMHz, report.sustainedMHz);
+        }
+        status += wxT("）");
+    }
+    if (!report.rejected.empty()) {
+        status += wxT("，结果与标量版不一致已弃用：");
+        for (size_t i = 0; i < report.rejected.size(); ++i) {
+            status += (i ? wxT(" ") : wxT("")) + wxString(cpubench::IsaName(report.rejected[i]));
+        }
+    }
+    m_statusLabel->SetLabel(status);
+}
+
+// ========== 历史时间轴 ==========
+// 范围随帧数更新并回到最右端；最右端即最新一帧
+void MainWindow::UpdateHistoryTimeline()
+{
+    size_t count = m_history ? m_history->Count() : 0;
+    if (count < 2) {
+        m_historySlider->SetRange(0, 1);
+        m_historySlider->SetValue(1);
+        m_historySlider->Disable();
+    } else {
+        m_historySlider->SetRange(0, (int)count - 1);
+        m_historySlider->SetValue((int)count - 1);
+        m_historySlider->Enable();
+    }
+    if (count > 0) m_historyLabel->SetLabel(wxString::Format(wxT("最新 · 共 %zu 条记录"), count));
+}
+
+void MainWindow::OnHistorySlider(wxCommandEvent& event)
+{
+    ShowHistoryAt(event.GetInt());
+}
+
+// 从历史还原第 position 帧并刷新界面；实时区域（传感器、进程）不受影响
+void MainWindow::ShowHistoryAt(int position)
+{
+    size_t count = m_history ? m_history->Count() : 0;
+    if (count == 0) return;
+    if (position >= (int)count - 1 && m_hardwareData.CollectionTime.IsValid()) {
+        PopulateUI(m_hardwareData);
+        m_historyLabel->SetLabel(wxString::Format(wxT("最新 · 共 %zu 条记录"), count));
+        m_statusLabel->SetLabel(wxString::Format(wxT("✓ 最新 %s"), m_hardwareData.CollectionTime.FormatTime().Mid(0, 8)));
+        return;
+    }
+    
+    position = std::clamp(position, 0, (int)count - 1);
+    HardwareData data;
+    if (!m_history->Load((size_t)position, &data)) {
+        m_historyLabel->SetLabel(wxT("❌ 无法还原该记录"));
+        return;
     }
-    m_biosInfoText->SetLabel(biosInfo.IsEmpty() ? wxT("未知") : biosInfo);
+    data.CollectionTime = wxDateTime((time_t)m_history->TimeAt((size_t)position));
+    PopulateUI(data);
+    wxString time = data.CollectionTime.FormatISOCombined(' ');
+    m_historyLabel->SetLabel(wxString::Format(wxT("%s · %d/%zu"), time, position + 1, count));
+    m_statusLabel->SetLabel(wxString::Format(wxT("🕘 正在查看 %s 的记录，点击\"回到最新\"返回"), time));
+}
+
+void MainWindow::PopulateUI(const HardwareData& data)
+{
+    // 机器指纹
+    m_fingerprintText->SetLabel(data.MachineFingerprint.IsEmpty() ? wxT("N/A") : data.MachineFingerprint);
     
-    // 系统 UUID
-    m_uuidText->SetLabel(data.SystemUUID.IsEmpty() ? wxT("未知") : data.SystemUUID.Left(36));
+    // 信息行
+    for (size_t i = 0; i < m_infoValues.size(); ++i) {
+        m_infoValues[i]->SetLabel(s_infoRows[i].format(data));
+    }
     
     // 硬盘列表
     m_diskList->DeleteAllItems();
@@ -315,6 +1838,7 @@ void MainWindow::PopulateUI(const HardwareData& data)
     for (size_t i = 0; i < count; ++i) {
         long idx = m_diskList->InsertItem(i, data.DiskModels[i]);
         m_diskList->SetItem(idx, 1, data.DiskSerialNumbers[i]);
+        FillDiskBenchmarkColumns(idx, data);
     }
     if (count == 0) {
         long idx = m_diskList->InsertItem(0, wxT("未检测到硬盘"));
@@ -331,6 +1855,121 @@ void MainWindow::PopulateUI(const HardwareData& data)
         long idx = m_netList->InsertItem(0, wxT("未检测到网卡"));
         m_netList->SetItem(idx, 1, wxT("N/A"));
     }
+    
+    // PCI 设备列表
+    m_pciList->DeleteAllItems();
+    for (size_t i = 0; i < data.PciDevices.size(); ++i) {
+        const PciDevice& dev = data.PciDevices[i];
+        long idx = m_pciList->InsertItem(i, dev.Address);
+        m_pciList->SetItem(idx, 1, FormatPciName(dev));
+        m_pciList->SetItem(idx, 2, dev.ClassName);
+        m_pciList->SetItem(idx, 3, FormatPciLink(dev));
+        m_pciList->SetItem(idx, 4, FormatNumaNode(dev));
+        m_pciList->SetItem(idx, 5, dev.Driver);
+    }
+    if (data.PciDevices.empty()) {
+        m_pciList->InsertItem(0, wxT("未检测到 PCI 设备"));
+    }
+    
+    // NUMA 节点：距离矩阵的列随节点数变化，先删去上次的距离列
+    m_numaList->DeleteAllItems();
+    while (m_numaList->GetColumnCount() > kNumaFixedColumns) {
+        m_numaList->DeleteColumn(kNumaFixedColumns);
+    }
+    for (size_t i = 0; i < data.NumaNodes.size(); ++i) {
+        m_numaList->InsertColumn(kNumaFixedColumns + i, wxString::Format(wxT("→%ld"), data.NumaNodes[i].Id),
+                                 wxLIST_FORMAT_RIGHT, 44);
+    }
+    for (size_t i = 0; i < data.NumaNodes.size(); ++i) {
+        const NumaNode& node = data.NumaNodes[i];
+        long idx = m_numaList->InsertItem(i, wxString::Format(wxT("%ld"), node.Id));
+        m_numaList->SetItem(idx, 1, FormatNumaCpus(node));
+        m_numaList->SetItem(idx, 2, FormatNumaMemory(node));
+        m_numaList->SetItem(idx, 3, FormatNumaHugePages(node));
+        wxArrayString distances = wxSplit(node.Distances, ' ', '\0');
+        for (size_t j = 0; j < distances.size() && j < data.NumaNodes.size(); ++j) {
+            m_numaList->SetItem(idx, kNumaFixedColumns + j, distances[j]);
+        }
+    }
+    if (data.NumaNodes.empty()) {
+        m_numaList->InsertItem(0, wxT("未检测到 NUMA 信息"));
+    }
+    
+    // 插件字段：未能取得的插件探测各占一行注明状态
+    m_pluginList->DeleteAllItems();
+    for (const PluginField& field : data.PluginFields) {
+        long idx = m_pluginList->InsertItem(m_pluginList->GetItemCount(), field.Section);
+        m_pluginList->SetItem(idx, 1, FormatPluginKey(field));
+        m_pluginList->SetItem(idx, 2, field.Value);
+    }
+    for (const ProbeReport& report : data.ProbeReports) {
+        if (!IsMissing(report.Status) || !Hardware::IsPluginProbe(report.Section)) continue;
+        long idx = m_pluginList->InsertItem(m_pluginList->GetItemCount(), report.Section);
+        m_pluginList->SetItem(idx, 2, wxT("⚠ ") + ProbeStatusText(report.Status));
+    }
+    if (m_pluginList->GetItemCount() == 0) {
+        m_pluginList->InsertItem(0, Hardware::PluginErrors().empty() ? wxT("未加载插件") : wxT("⚠ 插件加载失败，详见导出报告"));
+    }
+    
+    // 调优检查：每条未通过的规则一行，按规则包顺序
+    m_auditList->DeleteAllItems();
+    for (const AuditFinding& finding : data.AuditFindings) {
+        long idx = m_auditList->InsertItem(m_auditList->GetItemCount(), AuditSeverityText(finding.Severity));
+        m_auditList->SetItem(idx, 1, finding.Rule);
+        m_auditList->SetItem(idx, 2, finding.Title);
+        m_auditList->SetItem(idx, 3, finding.Detail);
+        m_auditList->SetItem(idx, 4, finding.Advice);
+    }
+    const ProbeReport* auditReport = FindReport(data, "Audit");
+    if (auditReport && IsMissing(auditReport->Status)) {
+        m_auditList->InsertItem(0, wxT("⚠ 检查") + ProbeStatusText(auditReport->Status) + wxT("（超出采集预算），结果不完整"));
+    } else if (data.AuditFindings.empty()) {
+        m_auditList->InsertItem(0, Hardware::AuditRuleErrors().empty() ? wxT("✓ 未发现问题") : wxT("⚠ 规则文件有误，详见导出报告"));
+    }
+    
+    m_memoryPanel->SetResults(data.MemoryBandwidths, data.MemoryLatencies);
+    m_cpuPanel->SetResults(data.CpuBenchmarks, data.CpuKernelRates, data.CpuScaling);
+    
+    // 各部分的采集状态：超时/失败的部分不再与"未知"混为一谈
+    for (size_t i = 0; i < m_infoValues.size(); ++i) {
+        MarkSection(m_infoValues[i], data, schema::SectionOf(s_infoRows[i].field));
+    }
+    
+    const ProbeReport* disk = FindReport(data, "Disk");
+    if (disk && IsMissing(disk->Status)) {
+        m_diskList->SetItemText(0, wxT("⚠ ") + ProbeStatusText(disk->Status));
+    }
+    const ProbeReport* net = FindReport(data, "Network");
+    if (net && IsMissing(net->Status)) {
+        m_netList->SetItemText(0, wxT("⚠ ") + ProbeStatusText(net->Status));
+    }
+    const ProbeReport* pci = FindReport(data, "PCI");
+    if (pci && IsMissing(pci->Status)) {
+        m_pciList->SetItemText(0, wxT("⚠ ") + ProbeStatusText(pci->Status));
+    }
+    const ProbeReport* numa = FindReport(data, "NUMA");
+    if (numa && IsMissing(numa->Status)) {
+        m_numaList->SetItemText(0, wxT("⚠ ") + ProbeStatusText(numa->Status));
+    }
+}
+
+void MainWindow::MarkSection(wxStaticText* ctrl, const HardwareData& data, const char* section)
+{
+    const ProbeReport* report = FindReport(data, section);
+    if (!report || report->Status == ProbeStatus::Ok) {
+        ctrl->SetForegroundColour(wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOWTEXT));
+        ctrl->SetToolTip(wxEmptyString);
+        return;
+    }
+    
+    wxString text = ProbeStatusText(report->Status);
+    if (IsMissing(report->Status)) {
+        ctrl->SetLabel(wxT("⚠ ") + text);
+        ctrl->SetForegroundColour(wxColour(200, 100, 0));
+    } else {
+        ctrl->SetForegroundColour(wxColour(120, 120, 120));  // 备用方案：值可用但不精确
+    }
+    ctrl->SetToolTip(wxString::Format(wxT("%s: %s (%ld ms)"), report->Section, text, report->ElapsedMs));
 }
 
 void MainWindow::OnRefresh(wxCommandEvent& event)
@@ -338,6 +1977,15 @@ void MainWindow::OnRefresh(wxCommandEvent& event)
     StartHardwareCollection();
 }
 
+void MainWindow::OnStop(wxCommandEvent& event)
+{
+    // 卡住的一轮被放弃：结果到达时已过期，不再刷新界面；再次刷新即开始新的一轮
+    if (!m_collector.Cancel()) return;
+    m_statusLabel->SetLabel(wxT("⏹ 已取消采集"));
+    m_progress->Hide();
+    Layout();
+}
+
 void MainWindow::OnCopyAll(wxCommandEvent& event)
 {
     if (m_hardwareData.MachineFingerprint.IsEmpty()) {
@@ -413,37 +2061,214 @@ wxString MainWindow::GenerateTextReport(const HardwareData& data) const
     report << wxString::Format(wxT("时间: %s\n"), data.CollectionTime.FormatISOCombined(' '));
     report << wxString::Format(wxT("系统: %s\n\n"), wxGetOsDescription());
     
-    // ✅ 报告中也拆分主板信息
-    report << wxString::Format(wxT("主板制造商: %s\n"), 
-        data.BaseBoardManufacturer.IsEmpty() || data.BaseBoardManufacturer.Contains(wxT("Unknown"))
-            ? wxT("N/A") 
-            : data.BaseBoardManufacturer);
+    // 信息行与界面共用同一张绑定表；超时/失败的部分注明状态
+    for (const InfoRowBinding& row : s_infoRows) {
+        wxString value = row.format(data);
+        const ProbeReport* probe = FindReport(data, schema::SectionOf(row.field));
+        if (probe && IsMissing(probe->Status)) value = wxT("⚠ ") + ProbeStatusText(probe->Status);
+        report << row.label << wxT(" ") << value << wxT("\n");
+    }
+    
+    report << wxString::Format(wxT("\n机器指纹: %s\n"), 
+        data.MachineFingerprint.IsEmpty() ? wxT("N/A") : data.MachineFingerprint);
     
-    report << wxString::Format(wxT("主板型号: %s\n"), 
-        data.BaseBoardProduct.IsEmpty() || data.BaseBoardProduct.Contains(wxT("Unknown"))
-            ? wxT("N/A") 
-            : data.BaseBoardProduct);
+    report << wxString::Format(wxT("组件指纹: %s\n"), 
+        data.ComponentFingerprintCode.IsEmpty() ? wxT("N/A") : data.ComponentFingerprintCode);
     
-    report << wxString::Format(wxT("CPU: %s @ %.2f GHz\n"), 
-        data.CPUName.IsEmpty() ? wxT("N/A") : data.CPUName,
-        data.CPUMaxClockSpeed > 0 ? data.CPUMaxClockSpeed / 1000.0 : 0.0);
+    // PCI 设备：地址、名称 [厂商:设备]、类别、链路、NUMA 节点、驱动
+    const ProbeReport* pci = FindReport(data, "PCI");
+    if (pci && IsMissing(pci->Status)) {
+        report << wxT("\nPCI 设备: ⚠ ") << ProbeStatusText(pci->Status) << wxT("\n");
+    } else if (!data.PciDevices.empty()) {
+        report << wxT("\nPCI 设备:\n");
+        for (const PciDevice& dev : data.PciDevices) {
+            report << wxString::Format(wxT("  %-13s %s | %s | %s | NUMA %s | %s\n"),
+                dev.Address, FormatPciName(dev), dev.ClassName, FormatPciLink(dev), FormatNumaNode(dev),
+                dev.Driver.IsEmpty() ? wxString(wxT("—")) : dev.Driver);
+        }
+    }
     
-    unsigned long long bytes = 0;
-    if (!data.TotalPhysicalMemory.IsEmpty() && wxStringToULL(data.TotalPhysicalMemory, &bytes) && bytes > 0) {
-        double gb = bytes / (1024.0 * 1024.0 * 1024.0);
-        report << wxString::Format(wxT("内存: %.2f GB (%s)\n"), gb,
-            data.MemoryType.IsEmpty() ? wxT("N/A") : data.MemoryType);
+    // NUMA 拓扑：每节点一行，随后是节点间距离矩阵
+    const ProbeReport* numa = FindReport(data, "NUMA");
+    if (numa && IsMissing(numa->Status)) {
+        report << wxT("\nNUMA 拓扑: ⚠ ") << ProbeStatusText(numa->Status) << wxT("\n");
+    } else if (!data.NumaNodes.empty()) {
+        report << wxT("\nNUMA 拓扑:\n");
+        for (const NumaNode& node : data.NumaNodes) {
+            report << wxString::Format(wxT("  节点 %ld: CPU %s | 内存 %s | 大页 %s\n"),
+                node.Id, FormatNumaCpus(node), FormatNumaMemory(node), FormatNumaHugePages(node));
+        }
+        report << wxT("  距离:");
+        for (const NumaNode& node : data.NumaNodes) report << wxString::Format(wxT(" %4ld"), node.Id);
+        report << wxT("\n");
+        for (const NumaNode& node : data.NumaNodes) {
+            report << wxString::Format(wxT("  %4ld:"), node.Id);
+            wxArrayString distances = wxSplit(node.Distances, ' ', '\0');
+            for (const wxString& distance : distances) report << wxString::Format(wxT(" %4s"), distance);
+            report << wxT("\n");
+        }
     }
     
-    report << wxString::Format(wxT("BIOS: %s v%s\n"),
-        data.BIOSManufacturer.IsEmpty() ? wxT("N/A") : data.BIOSManufacturer,
-        data.BIOSVersion.IsEmpty() ? wxT("N/A") : data.BIOSVersion);
+    // 插件：按探测分组，每字段一行；随后是未能取得的插件探测与加载问题
+    wxString plugins;
+    wxString section;
+    for (const PluginField& field : data.PluginFields) {
+        if (field.Section != section) {
+            section = field.Section;
+            plugins << wxT("  ") << section << wxT("\n");
+        }
+        plugins << wxT("    ") << FormatPluginKey(field) << wxT(": ") << field.Value << wxT("\n");
+    }
+    for (const ProbeReport& probe : data.ProbeReports) {
+        if (!IsMissing(probe.Status) || !Hardware::IsPluginProbe(probe.Section)) continue;
+        plugins << wxT("  ") << probe.Section << wxT(": ⚠ ") << ProbeStatusText(probe.Status) << wxT("\n");
+    }
+    for (const std::string& error : Hardware::PluginErrors()) {
+        plugins << wxT("  ⚠ ") << Hardware::Utf8ToWxString(error.data(), error.size()) << wxT("\n");
+    }
+    if (!plugins.IsEmpty()) report << wxT("\n插件:\n") << plugins;
     
-    report << wxString::Format(wxT("\n系统 UUID: %s\n"), 
-        data.SystemUUID.IsEmpty() ? wxT("N/A") : data.SystemUUID);
+    // 调优检查：发现按规则包顺序，规则文件的解析错误附在最后
+    if (!data.AuditFindings.empty() || !Hardware::AuditRuleErrors().empty()) {
+        report << wxT("\n调优检查:\n");
+        for (const AuditFinding& finding : data.AuditFindings) {
+            report << wxT("  [") << AuditSeverityText(finding.Severity) << wxT("] ") << finding.Rule
+                   << wxT(": ") << finding.Title << wxT("\n");
+            if (!finding.Detail.IsEmpty()) report << wxT("      实际: ") << finding.Detail << wxT("\n");
+            if (!finding.Advice.IsEmpty()) report << wxT("      建议: ") << finding.Advice << wxT("\n");
+        }
+        for (const std::string& error : Hardware::AuditRuleErrors()) {
+            report << wxT("  ⚠ ") << Hardware::Utf8ToWxString(error.data(), error.size()) << wxT("\n");
+        }
+    }
     
-    report << wxString::Format(wxT("机器指纹: %s\n"), 
-        data.MachineFingerprint.IsEmpty() ? wxT("N/A") : data.MachineFingerprint);
+    // 采集能耗：本次采集期间各 RAPL 域的能耗与平均功率，"本进程" 按 CPU 时间份额折算
+    if (!data.EnergyReadings.empty()) {
+        report << wxT("\n采集能耗（本进程为按 CPU 时间份额的估计）:\n");
+        for (const EnergyReading& reading : data.EnergyReadings) {
+            report << wxString::Format(wxT("  %-16s %9.3f J | 本进程 %9.3f J | 平均 %7.2f W | %s\n"),
+                reading.Domain, reading.CollectionMj / 1000.0, reading.AttributedMj / 1000.0,
+                reading.PowerMw / 1000.0, reading.Source);
+        }
+    }
+    
+    // 硬盘性能测试：吞吐量、IOPS 与延迟分位数
+    if (!data.DiskBenchmarks.empty()) {
+        report << wxT("\n硬盘性能测试（延迟单位 µs：平均 / P50 / P99 / P99.9 / 最大）:\n");
+        wxString disk;
+        for (const DiskBenchmark& bench : data.DiskBenchmarks) {
+            if (bench.Disk != disk) {
+                disk = bench.Disk;
+                report << wxString::Format(wxT("  %s（%s，%s，%s%s）\n"), bench.Disk, bench.Path, bench.Time, bench.Engine,
+                                           bench.Direct ? wxT("") : wxT("，含系统缓存"));
+            }
+            report << wxString::Format(wxT("    %-16s %10.1f MB/s %9ld IOPS  %ld / %ld / %ld / %ld / %ld\n"),
+                FormatBenchSpec(bench.Test, bench.BlockSize, bench.QueueDepth), bench.ThroughputKBps / 1000.0, bench.Iops,
+                bench.LatencyAvgUs, bench.LatencyP50Us, bench.LatencyP99Us, bench.LatencyP999Us, bench.LatencyMaxUs);
+        }
+    }
+    
+    // 内存性能测试：各内核带宽（STREAM 口径），延迟曲线每行一个工作集
+    if (!data.MemoryBandwidths.empty()) {
+        report << wxT("\n内存性能测试（带宽 MB/s：copy / scale / add / triad）:\n");
+        // 同一节点、同一写方式的四个内核连续存放，合为一行
+        for (size_t i = 0; i < data.MemoryBandwidths.size(); ++i) {
+            const MemoryBandwidth& bench = data.MemoryBandwidths[i];
+            bool first = i == 0 || bench.Node != data.MemoryBandwidths[i - 1].Node ||
+                         bench.NonTemporal != data.MemoryBandwidths[i - 1].NonTemporal;
+            if (first) {
+                if (i > 0) report << wxT("\n");
+                report << wxString::Format(wxT("  %-16s %3ld 线程  %ld"), FormatMemorySeries(bench.Node, bench.NonTemporal),
+                                           bench.Threads, bench.MBps);
+            } else {
+                report << wxString::Format(wxT(" / %ld"), bench.MBps);
+            }
+        }
+        report << wxT("\n");
+        if (!data.MemoryLatencies.empty()) {
+            report << wxT("  随机访问延迟:\n");
+            for (const MemoryLatency& point : data.MemoryLatencies) {
+                report << wxString::Format(wxT("    %8s %8.1f ns\n"), FormatSizeKB(point.WorkingSetKB), point.LatencyPs / 1000.0);
+            }
+        }
+    }
+    
+    // CPU 性能测试：每种模式一行摘要，之后为最近一次测试的各内核单线程速率与扩展曲线
+    if (!data.CpuBenchmarks.empty()) {
+        report << wxT("\nCPU 性能测试（分数为四个内核速率的几何平均）:\n");
+        for (const CpuBenchmark& bench : data.CpuBenchmarks) {
+            report << wxString::Format(wxT("  %s %s  %s  单核 %ld  全核 %ld（%ld 线程 / %ld 核，扩展效率 %.1f%%）"),
+                                       FormatCpuMode(bench.Mode), bench.Time, bench.Isa, bench.SingleCoreScore,
+                                       bench.AllCoreScore, bench.Threads, bench.Cores, bench.ScalingPermille / 10.0);
+            if (bench.BurstMHz > 0) report << wxString::Format(wxT("  瞬时 %ld MHz / 全核 %ld MHz"), bench.BurstMHz, bench.SustainedMHz);
+            report << wxT("\n");
+        }
+        if (!data.CpuKernelRates.empty()) {
+            report << wxT("  单线程速率:\n");
+            for (const CpuKernelRate& rate : data.CpuKernelRates) {
+                const char* unit = "";
+                for (cpubench::Kernel kernel : { cpubench::Kernel::Integer, cpubench::Kernel::Float, cpubench::Kernel::Hash,
+                                                 cpubench::Kernel::Compress }) {
+                    if (rate.Kernel == cpubench::KernelName(kernel)) unit = cpubench::KernelUnit(kernel);
+                }
+                report << wxString::Format(wxT("    %-10s %-8s %10ld %s\n"), rate.Kernel, rate.Isa, rate.Rate, unit);
+            }
+        }
+        if (!data.CpuScaling.empty()) {
+            report << wxT("  扩展曲线（线程数：分数 / 频率）:\n");
+            for (const CpuScalingPoint& point : data.CpuScaling) {
+                report << wxString::Format(wxT("    %4ld %-6s %8ld"), point.Threads,
+                                           point.Pinned ? wxT("绑核") : wxT("不绑核"), point.Score);
+                if (point.MHz > 0) report << wxString::Format(wxT("  %ld MHz"), point.MHz);
+                report << wxT("\n");
+            }
+        }
+    }
+    
+    // 传感器：启动以来的当前/最小/最大/平均
+    if (m_sensors && !m_sensors->Sensors().empty()) {
+        report << wxT("\n传感器（当前 / 最小 / 最大 / 平均）:\n");
+        std::vector<sensors::Stats> stats = m_sensors->Snapshot();
+        const std::vector<sensors::Sensor>& list = m_sensors->Sensors();
+        for (size_t i = 0; i < stats.size() && i < list.size(); ++i) {
+            wxString name = Hardware::Utf8ToWxString(list[i].chip.data(), list[i].chip.size()) + wxT("/") +
+                            Hardware::Utf8ToWxString(list[i].label.data(), list[i].label.size());
+            if (stats[i].samples == 0) {
+                report << wxString::Format(wxT("  %-28s —\n"), name);
+                continue;
+            }
+            report << wxString::Format(wxT("  %-28s %s / %s / %s / %s\n"), name,
+                FormatSensorValue(stats[i].current, list[i].kind), FormatSensorValue(stats[i].min, list[i].kind),
+                FormatSensorValue(stats[i].max, list[i].kind), FormatSensorValue(stats[i].average, list[i].kind));
+        }
+    }
+    
+    // 进程：按 CPU 占用取前 10 个
+    std::shared_ptr<const procs::ProcessList> processes = m_processes ? m_processes->Latest() : nullptr;
+    if (processes && !processes->empty()) {
+        std::vector<const procs::Process*> top;
+        for (const procs::Process& p : *processes) {
+            if (p.known) top.push_back(&p);
+        }
+        size_t count = std::min<size_t>(top.size(), 10);
+        std::partial_sort(top.begin(), top.begin() + count, top.end(),
+                          [](const procs::Process* a, const procs::Process* b) { return a->cpuPercent > b->cpuPercent; });
+        report << wxString::Format(wxT("\n进程（共 %zu 个，CPU 占用前 %zu）:\n"), processes->size(), count);
+        for (size_t i = 0; i < count; ++i) {
+            const procs::Process& p = *top[i];
+            report << wxString::Format(wxT("  %7lu %-24s CPU %5.1f%%  内存 %s\n"), (unsigned long)p.pid,
+                Hardware::Utf8ToWxString(p.name.data(), p.name.size()), p.cpuPercent, FormatBytes((double)p.rssBytes));
+        }
+    }
+    
+    // 采集状态：便于区分"确实未知"与"超时/失败"
+    if (!data.ProbeReports.empty()) {
+        report << wxT("\n采集状态:\n");
+        for (const ProbeReport& probe : data.ProbeReports) {
+            report << wxString::Format(wxT("  %-10s %-9s %ld ms\n"),
+                probe.Section, Hardware::ProbeStatusName(probe.Status), probe.ElapsedMs);
+        }
+    }
     
     report << wxT("\n--- Hardware Inspector v1.2 ---");
     return report;
@@ -6,52 +6,122 @@
 #include <wx/gauge.h>
 #include <wx/listctrl.h>
 #include <vector>
+#include <memory>
+#include "hardware.h"
+#include "sensors.h"
+#include "procs.h"
+#include "membench.h"
+#include "cpubench.h"
+#include "history.h"
 
-struct HardwareData
+// 界面持有的快照：字段来自 HardwareSnapshot（见 snapshot.h），另加采集时间
+struct HardwareData : HardwareSnapshot
 {
-    wxString BaseBoardManufacturer, BaseBoardProduct;
-    wxString CPUManufacturer, CPUName;
-    long CPUMaxClockSpeed;
-    wxString TotalPhysicalMemory, MemoryType, MemorySpeed;
-    std::vector<wxString> DiskModels, DiskSerialNumbers;
-    std::vector<wxString> MACAddresses;
-    wxString BIOSManufacturer, BIOSVersion, BIOSReleaseDate;
-    wxString SystemUUID, MachineFingerprint;
     wxDateTime CollectionTime;
-    
-    HardwareData() : CPUMaxClockSpeed(0) {}
-    HardwareData(const HardwareData& other) { *this = other; }
-    HardwareData& operator=(const HardwareData& other) {
-        BaseBoardManufacturer = other.BaseBoardManufacturer;
-        BaseBoardProduct = other.BaseBoardProduct;
-        CPUManufacturer = other.CPUManufacturer;
-        CPUName = other.CPUName;
-        CPUMaxClockSpeed = other.CPUMaxClockSpeed;
-        TotalPhysicalMemory = other.TotalPhysicalMemory;
-        MemoryType = other.MemoryType;
-        MemorySpeed = other.MemorySpeed;
-        DiskModels = other.DiskModels;
-        DiskSerialNumbers = other.DiskSerialNumbers;
-        MACAddresses = other.MACAddresses;
-        BIOSManufacturer = other.BIOSManufacturer;
-        BIOSVersion = other.BIOSVersion;
-        BIOSReleaseDate = other.BIOSReleaseDate;
-        SystemUUID = other.SystemUUID;
-        MachineFingerprint = other.MachineFingerprint;
-        CollectionTime = other.CollectionTime;
-        return *this;
-    }
 };
 
+// ========== 采集执行器 ==========
+// 单个常驻采集线程 + 代号（generation）+ 取消令牌：
+//   - 采集进行中的刷新请求并入当前这一轮，不再叠加新线程
+//   - 每轮结果携带代号，被取代的旧代号结果在到达 UI 前丢弃
+//   - 停止（Esc / 工具栏）取消进行中的一轮：换用新的取消源并使代号过期，下次刷新重新开始
+//   - 关闭时先断开事件处理器再等待线程退出（有上限），线程不会向已销毁窗口投递事件
+struct CollectorState;
+
 class HardwareCollectorThread : public wxThread
 {
 public:
-    HardwareCollectorThread(wxEvtHandler* eventHandler);
+    HardwareCollectorThread(std::shared_ptr<CollectorState> state);
     virtual ~HardwareCollectorThread() {}
 protected:
     virtual ExitCode Entry() override;
 private:
-    wxEvtHandler* m_eventHandler;
+    std::shared_ptr<CollectorState> m_state;
+};
+
+class HardwareCollector
+{
+public:
+    explicit HardwareCollector(wxEvtHandler* eventHandler);
+    ~HardwareCollector();
+    
+    bool Start();                      // 创建常驻线程，失败返回 false
+    unsigned long Request();           // 请求采集，返回结果将携带的代号
+    bool Cancel();                     // 取消进行中或排队的采集，其结果将被丢弃；空闲时返回 false
+    void Shutdown(unsigned int timeoutMs = 2000);  // 有上限地等待线程退出
+    
+    bool IsCurrent(unsigned long generation) const;  // 结果是否属于最新代号
+    
+private:
+    std::shared_ptr<CollectorState> m_state;
+    bool m_started;
+};
+
+// ========== 进程列表 ==========
+// 虚拟列表：控件本身不存行，绘制时回调 OnGetItemText 从最近一次采样结果取文字；
+// 点击列头按该列排序，再次点击反向。刷新时保持选中的进程。
+class ProcessListCtrl : public wxListCtrl
+{
+public:
+    explicit ProcessListCtrl(wxWindow* parent);
+    
+    void SetProcesses(std::shared_ptr<const procs::ProcessList> processes);
+    const procs::ProcessList* Processes() const { return m_processes.get(); }
+    
+    // 当前显示在屏幕上的行的 pid（控件不可见时为空），供采样方只为它们读读写计数
+    std::vector<uint32_t> VisiblePids() const;
+    bool SortsByIo() const;
+    
+private:
+    wxString OnGetItemText(long item, long column) const override;
+    void OnColumnClick(wxListEvent& event);
+    void sortRows();
+    
+    std::shared_ptr<const procs::ProcessList> m_processes;
+    std::vector<uint32_t> m_order;   // 显示顺序 → m_processes 下标
+    int m_sortColumn;
+    bool m_ascending;
+};
+
+// ========== 内存性能图 ==========
+// 左侧为各内核的带宽柱状图（每个节点/写方式一种颜色），右侧为延迟曲线：
+// 横轴为工作集（对数），竖虚线标出本机各级缓存容量，曲线台阶应与之对齐
+class MemoryBenchPanel : public wxPanel
+{
+public:
+    explicit MemoryBenchPanel(wxWindow* parent);
+    
+    void SetResults(const std::vector<MemoryBandwidth>& bandwidth, const std::vector<MemoryLatency>& latency);
+    
+private:
+    void OnPaint(wxPaintEvent& event);
+    void drawBandwidth(wxDC& dc, const wxRect& area);
+    void drawLatency(wxDC& dc, const wxRect& area);
+    
+    std::vector<MemoryBandwidth> m_bandwidth;
+    std::vector<MemoryLatency> m_latency;
+    std::vector<membench::CacheLevel> m_caches;
+};
+
+// ========== CPU 性能图 ==========
+// 顶部为摘要（单核/全核分数、扩展效率、瞬时/持续频率）；左侧为各内核 SIMD 版本相对标量版的加速比，
+// 右侧为扩展曲线：绑核与不绑核两条，虚线为理想线性扩展
+class CpuBenchPanel : public wxPanel
+{
+public:
+    explicit CpuBenchPanel(wxWindow* parent);
+    
+    void SetResults(const std::vector<CpuBenchmark>& summary, const std::vector<CpuKernelRate>& rates,
+                    const std::vector<CpuScalingPoint>& scaling);
+    
+private:
+    void OnPaint(wxPaintEvent& event);
+    void drawSpeedup(wxDC& dc, const wxRect& area);
+    void drawScaling(wxDC& dc, const wxRect& area);
+    
+    std::vector<CpuBenchmark> m_summary;
+    std::vector<CpuKernelRate> m_rates;
+    std::vector<CpuScalingPoint> m_scaling;
 };
 
 class MainWindow : public wxFrame
@@ -63,31 +133,57 @@ public:
 private:
     // UI 控件指针
     wxStaticText* m_fingerprintText;
-    wxStaticText* m_boardManufacturerText;
-    wxStaticText* m_boardProductText;
-    wxStaticText* m_cpuInfoText;
-    wxStaticText* m_memInfoText;
-    wxStaticText* m_biosInfoText;
-    wxStaticText* m_uuidText;
+    std::vector<wxStaticText*> m_infoValues;   // 与信息行绑定表一一对应
     
     wxListCtrl* m_diskList;
     wxListCtrl* m_netList;
+    wxListCtrl* m_pciList;
+    wxListCtrl* m_numaList;    // 固定列之后每个节点一列距离，构成距离矩阵
+    wxListCtrl* m_pluginList;  // 插件探测的键值，每字段一行
+    wxListCtrl* m_auditList;   // 调优检查的发现，每条规则一行
+    wxListCtrl* m_sensorList;
+    ProcessListCtrl* m_processList;
+    MemoryBenchPanel* m_memoryPanel;
+    CpuBenchPanel* m_cpuPanel;
     wxStaticText* m_statusLabel;
     wxGauge* m_progress;
+    wxSlider* m_historySlider;     // 每次采集一格，最右端为最新
+    wxStaticText* m_historyLabel;
     
     HardwareData m_hardwareData;
+    HardwareCollector m_collector;
+    
+    // 实时区域：传感器后台 10 Hz 采样、进程表 1 Hz 采样，界面由同一定时器每秒刷新
+    std::unique_ptr<sensors::Sampler> m_sensors;
+    std::unique_ptr<procs::Monitor> m_processes;
+    wxTimer m_liveTimer;
+    
+    // 快照历史：每次采集追加一帧；打开失败时为空
+    std::unique_ptr<history::Store> m_history;
     
     // 事件处理器
     void OnHardwareCollected(wxThreadEvent& event);
     void OnRefresh(wxCommandEvent& event);
+    void OnStop(wxCommandEvent& event);
     void OnCopyAll(wxCommandEvent& event);
     void OnCopyFingerprint(wxCommandEvent& event);
     void OnExport(wxCommandEvent& event);
     void OnExit(wxCommandEvent& event);
     void OnAbout(wxCommandEvent& event);
+    void OnLiveTimer(wxTimerEvent& event);
+    void OnDiskContextMenu(wxListEvent& event);
+    void OnDiskActivated(wxListEvent& event);
+    void OnMemoryBenchmark(wxCommandEvent& event);
+    void OnHistorySlider(wxCommandEvent& event);
     
     void StartHardwareCollection();
     void PopulateUI(const HardwareData& data);
+    void FillDiskBenchmarkColumns(long row, const HardwareData& data);
+    void RunDiskBenchmark(long row);
+    void RunCpuBenchmark(cpubench::Mode mode);
+    void UpdateHistoryTimeline();
+    void ShowHistoryAt(int position);
+    void MarkSection(wxStaticText* ctrl, const HardwareData& data, const char* section);
     wxString GenerateTextReport(const HardwareData& data) const;
     
     wxDECLARE_EVENT_TABLE();
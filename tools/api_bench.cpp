@@ -0,0 +1,180 @@
+// api_bench - C 接口缓存读取的多线程争用测试
+// 用法: api_bench [每档秒数=2] [最多线程数=CPU 数]
+//
+// 只经 mt_api.h 访问，与嵌入方相同。首次调用的采集耗时单独列出；
+// 之后按 1、2、4 … 个线程并发读取指纹与快照字段，每档分两轮：
+// 静默（无刷新），以及另有线程连续 mt_refresh_async 的刷新轮。
+// 读取按批计时（每批 1000 次），报告单次调用的 p50 / p99 与总吞吐；
+// 刷新轮同时测量 mt_set_collect_budget 的最长耗时：设置调用不应等待进行中的采集。
+
+#include "mt_api.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int kBatch = 1000;
+
+    struct RoundResult
+    {
+        std::vector<double> batchNs;  // 每批中单次调用的平均纳秒，升序
+        unsigned long long calls = 0;
+        double seconds = 0;
+        unsigned refreshes = 0;
+        double maxSetBudgetUs = 0;
+    };
+
+    // 一次读取：指纹加一个快照字段，与授权校验的典型调用相同
+    bool ReadOnce(char* buf, size_t size)
+    {
+        if (mt_get_fingerprint(buf, size, nullptr) != MT_OK) return false;
+        const mt_snapshot* snap = mt_get_snapshot();
+        return snap && mt_snapshot_get(snap, "CPUName");
+    }
+
+    // 连续刷新：上一次完成后立即发起下一次
+    struct Refresher
+    {
+        std::mutex mutex;
+        std::condition_variable cond;
+        bool done = false;
+        unsigned count = 0;
+
+        static void OnRefreshed(int, const mt_snapshot*, void* user)
+        {
+            Refresher* self = static_cast<Refresher*>(user);
+            std::lock_guard<std::mutex> lock(self->mutex);
+            self->done = true;
+            ++self->count;
+            self->cond.notify_all();
+        }
+
+        void Run(const std::atomic<bool>& stop)
+        {
+            while (!stop.load(std::memory_order_relaxed)) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done = false;
+                }
+                if (mt_refresh_async(&Refresher::OnRefreshed, this) != MT_OK) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [this] { return done; });
+            }
+        }
+    };
+
+    RoundResult RunRound(unsigned threads, std::chrono::seconds duration, bool refreshing)
+    {
+        RoundResult result;
+        std::atomic<bool> stop{false};
+        std::atomic<bool> failed{false};
+        std::vector<std::vector<double>> samples(threads);
+        std::vector<unsigned long long> calls(threads, 0);
+
+        Refresher refresher;
+        std::thread refreshThread;
+        std::thread budgetThread;
+        double maxSetBudgetUs = 0;
+        if (refreshing) {
+            refreshThread = std::thread([&] { refresher.Run(stop); });
+            budgetThread = std::thread([&] {
+                while (!stop.load(std::memory_order_relaxed)) {
+                    auto begin = Clock::now();
+                    mt_set_collect_budget(5000, 3000);
+                    double us = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+                    maxSetBudgetUs = std::max(maxSetBudgetUs, us);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                }
+            });
+        }
+
+        auto start = Clock::now();
+        std::vector<std::thread> readers;
+        for (unsigned i = 0; i < threads; ++i) {
+            readers.emplace_back([&, i] {
+                char buf[128];
+                while (!stop.load(std::memory_order_relaxed)) {
+                    auto begin = Clock::now();
+                    for (int k = 0; k < kBatch; ++k) {
+                        if (!ReadOnce(buf, sizeof(buf))) failed = true;
+                    }
+                    double ns = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+                    samples[i].push_back(ns / kBatch);
+                    calls[i] += kBatch;
+                }
+            });
+        }
+        std::this_thread::sleep_for(duration);
+        stop = true;
+        for (std::thread& t : readers) t.join();
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (refreshThread.joinable()) refreshThread.join();
+        if (budgetThread.joinable()) budgetThread.join();
+        if (failed) fprintf(stderr, "warning: some reads failed\n");
+
+        for (unsigned i = 0; i < threads; ++i) {
+            result.batchNs.insert(result.batchNs.end(), samples[i].begin(), samples[i].end());
+            result.calls += calls[i];
+        }
+        std::sort(result.batchNs.begin(), result.batchNs.end());
+        result.refreshes = refresher.count;
+        result.maxSetBudgetUs = maxSetBudgetUs;
+        return result;
+    }
+
+    double Percentile(const std::vector<double>& sorted, double p)
+    {
+        if (sorted.empty()) return 0;
+        size_t index = (size_t)(p * sorted.size());
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::chrono::seconds duration(argc > 1 ? atoi(argv[1]) : 2);
+    unsigned maxThreads = argc > 2 ? (unsigned)atoi(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+    if (duration.count() <= 0 || maxThreads == 0) {
+        fprintf(stderr, "usage: %s [seconds-per-round] [max-threads]\n", argv[0]);
+        return 2;
+    }
+
+    // 有预算的采集：刷新轮中每次刷新按期结束
+    mt_set_collect_budget(5000, 3000);
+    auto begin = Clock::now();
+    const mt_snapshot* first = mt_get_snapshot();
+    double firstMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    if (!first) {
+        fprintf(stderr, "collection failed\n");
+        return 1;
+    }
+    printf("api v%d, first collection %.1f ms, %zu fields\n", mt_api_version(), firstMs, mt_snapshot_field_count(first));
+
+    printf("\n%7s %-8s %12s %9s %9s %10s %14s\n",
+           "threads", "round", "Mcalls/s", "p50 ns", "p99 ns", "refreshes", "max budget us");
+    for (unsigned threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        for (bool refreshing : { false, true }) {
+            RoundResult r = RunRound(threads, duration, refreshing);
+            printf("%7u %-8s %12.2f %9.1f %9.1f %10u", threads, refreshing ? "refresh" : "quiet",
+                   r.calls / r.seconds / 1e6, Percentile(r.batchNs, 0.50), Percentile(r.batchNs, 0.99), r.refreshes);
+            if (refreshing) printf(" %14.1f\n", r.maxSetBudgetUs);
+            else printf(" %14s\n", "-");
+        }
+        if (threads == maxThreads) break;
+    }
+
+    mt_shutdown();
+    return 0;
+}
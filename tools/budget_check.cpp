@@ -0,0 +1,60 @@
+// budget_check - 采集预算检查：带 TotalBudget 的采集（含调优检查与能耗读数）须按期返回
+// 用法: budget_check [预算 ms ...]（默认 0 5000 1 3）
+//
+// 每个预算跑一次完整采集，报告实际耗时、"Audit" 探测的状态与检查结果数、能耗读数数。
+// 预算为 0 表示不限，只作对照；其余预算下耗时超过 预算 + kSlackMs 记为失败
+// （余量覆盖合并与指纹计算，以及看门狗定时器的调度误差）。
+// 很小的预算（1、3 ms）下调优检查来不及完成，应看到 Audit 为 timed-out 或 skipped 且无检查结果。
+
+#include "hardware.h"
+#include <wx/init.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    const double kSlackMs = 20;
+}
+
+int main(int argc, char** argv)
+{
+    wxInitializer init;
+    if (!init.IsOk()) {
+        fprintf(stderr, "failed to initialize wxWidgets\n");
+        return 1;
+    }
+
+    std::vector<int> budgets;
+    for (int i = 1; i < argc; ++i) {
+        int ms = atoi(argv[i]);
+        if (ms < 0) {
+            fprintf(stderr, "usage: %s [budget-ms ...]\n", argv[0]);
+            return 2;
+        }
+        budgets.push_back(ms);
+    }
+    if (budgets.empty()) budgets = { 0, 5000, 1, 3 };
+
+    int exitCode = 0;
+    printf("%10s %10s %12s %10s %9s %7s %8s\n", "budget ms", "took ms", "audit", "audit ms", "findings", "energy", "result");
+    for (int budget : budgets) {
+        CollectOptions options;
+        options.TotalBudget = std::chrono::milliseconds(budget);
+
+        auto begin = Clock::now();
+        Hardware hw = mt::SyncWait(Hardware::CollectAsync(Hardware::SharedPool(), {}, options));
+        double took = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+        const ProbeReport* audit = hw.FindProbeReport(wxT("Audit"));
+        bool late = budget > 0 && took > budget + kSlackMs;
+        if (late) exitCode = 1;
+        printf("%10d %10.1f %12s %10ld %9zu %7zu %8s\n", budget, took,
+               audit ? Hardware::ProbeStatusName(audit->Status) : "none", audit ? audit->ElapsedMs : -1L,
+               hw.AuditFindings.size(), hw.EnergyReadings.size(), budget == 0 ? "-" : late ? "LATE" : "ok");
+    }
+    return exitCode;
+}
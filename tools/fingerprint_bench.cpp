@@ -0,0 +1,205 @@
+// fingerprint_bench - 分组件指纹 LSH 索引的进程内测试（授权服务器端的查询性能与召回率）
+// 用法: fingerprint_bench [库存机器数=200000] [查询数=20000] [查询线程数=1]
+//
+// 库存为少数几种型号的机群：同型号机器的主板、CPU、硬盘型号相同，只有序列号、MAC、UUID 不同，
+// 这是 LSH 最难区分的情形。查询取自库存中的随机机器并施加一种变化：
+//   nic     —— 换一块网卡，且网卡顺序打乱
+//   disk    —— 换一块硬盘
+//   uuid    —— 主板更换后 UUID 改变（主板型号不变）
+//   two     —— 同时换网卡和硬盘
+//   foreign —— 库存中不存在的机器（同型号），应当查不到
+// 召回率：前几种变化下首个结果为原机器的比例；foreign 统计误报率。
+
+#include "fingerprint.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    enum class Change { Nic, Disk, Uuid, Two, Foreign, Count };
+    const char* const kChangeNames[] = { "nic", "disk", "uuid", "two", "foreign" };
+
+    struct Model
+    {
+        std::string board, product, cpu, disk;
+    };
+
+    const Model kModels[] = {
+        { "Dell Inc.", "0K240Y", "Intel(R) Xeon(R) Gold 6338 CPU @ 2.00GHz", "SAMSUNG MZ7L3960HCJR" },
+        { "Supermicro", "X12DPi-NT6", "Intel(R) Xeon(R) Silver 4314 CPU @ 2.40GHz", "INTEL SSDSC2KB960G8" },
+        { "HPE", "ProLiant DL385 Gen10 Plus", "AMD EPYC 7543 32-Core Processor", "MICRON 5300 MTFDDAK960TDS" },
+        { "LENOVO", "7X06CTO1WW", "Intel(R) Xeon(R) Gold 5218 CPU @ 2.30GHz", "SEAGATE ST2000NM0055" },
+    };
+
+    std::string Hex(std::mt19937_64& rng, int digits)
+    {
+        static const char kDigits[] = "0123456789ABCDEF";
+        std::string out;
+        uint64_t bits = rng();
+        for (int i = 0; i < digits; ++i) {
+            if (i % 16 == 15) bits = rng();
+            out += kDigits[bits & 15];
+            bits >>= 4;
+        }
+        return out;
+    }
+
+    std::string Mac(std::mt19937_64& rng)
+    {
+        std::string hex = Hex(rng, 12), out;
+        for (int i = 0; i < 12; i += 2) {
+            if (i) out += ':';
+            out += hex.substr(i, 2);
+        }
+        return out;
+    }
+
+    std::string Uuid(std::mt19937_64& rng)
+    {
+        std::string hex = Hex(rng, 32);
+        return hex.substr(0, 8) + "-" + hex.substr(8, 4) + "-" + hex.substr(12, 4) + "-" +
+               hex.substr(16, 4) + "-" + hex.substr(20, 12);
+    }
+
+    FingerprintInput RandomMachine(std::mt19937_64& rng)
+    {
+        const Model& model = kModels[rng() % (sizeof(kModels) / sizeof(kModels[0]))];
+        FingerprintInput in;
+        in.boardManufacturer = model.board;
+        in.boardProduct = model.product;
+        in.cpuManufacturer = model.cpu.find("AMD") != std::string::npos ? "AuthenticAMD" : "GenuineIntel";
+        in.cpuName = model.cpu;
+        for (int i = 0; i < 2; ++i) in.disks.push_back(model.disk + "|" + Hex(rng, 14));
+        for (int i = 0; i < 4; ++i) in.macs.push_back(Mac(rng));
+        in.systemUUID = Uuid(rng);
+        return in;
+    }
+
+    FingerprintInput Perturb(const FingerprintInput& original, Change change, std::mt19937_64& rng)
+    {
+        FingerprintInput in = original;
+        switch (change) {
+            case Change::Nic:
+                in.macs[rng() % in.macs.size()] = Mac(rng);
+                std::shuffle(in.macs.begin(), in.macs.end(), rng);
+                break;
+            case Change::Disk:
+                in.disks[rng() % in.disks.size()] = in.disks[0].substr(0, in.disks[0].find('|') + 1) + Hex(rng, 14);
+                break;
+            case Change::Uuid:
+                in.systemUUID = Uuid(rng);
+                break;
+            case Change::Two:
+                in.macs[rng() % in.macs.size()] = Mac(rng);
+                in.disks[rng() % in.disks.size()] = in.disks[0].substr(0, in.disks[0].find('|') + 1) + Hex(rng, 14);
+                break;
+            default:
+                break;
+        }
+        return in;
+    }
+
+    struct Query
+    {
+        ComponentFingerprint fp;
+        Change change;
+        uint32_t expected;   // foreign 时无意义
+    };
+
+    struct ChangeStats
+    {
+        unsigned queries = 0;
+        unsigned hits = 0;   // 首个结果为原机器；foreign 为有任何结果（误报）
+    };
+
+    double Percentile(std::vector<double>& sorted, double p)
+    {
+        if (sorted.empty()) return 0;
+        size_t index = (size_t)(p * sorted.size());
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t stored = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+    size_t queryCount = argc > 2 ? strtoul(argv[2], nullptr, 10) : 20000;
+    unsigned threads = argc > 3 ? (unsigned)atoi(argv[3]) : 1;
+    if (stored == 0 || queryCount == 0 || threads == 0) {
+        fprintf(stderr, "usage: %s [stored-machines] [queries] [threads]\n", argv[0]);
+        return 2;
+    }
+
+    std::mt19937_64 rng(20260419);
+    std::vector<FingerprintInput> machines;
+    machines.reserve(stored);
+    for (size_t i = 0; i < stored; ++i) machines.push_back(RandomMachine(rng));
+
+    FingerprintIndex index;
+    auto begin = Clock::now();
+    for (const FingerprintInput& machine : machines) index.Add(ComponentFingerprint::FromInput(machine));
+    index.Build();
+    double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+    std::vector<Query> queries;
+    queries.reserve(queryCount);
+    for (size_t i = 0; i < queryCount; ++i) {
+        Change change = (Change)(i % (size_t)Change::Count);
+        uint32_t id = (uint32_t)(rng() % stored);
+        FingerprintInput in = change == Change::Foreign ? RandomMachine(rng) : Perturb(machines[id], change, rng);
+        queries.push_back(Query{ ComponentFingerprint::FromInput(in), change, id });
+    }
+
+    // 查询线程按下标交错分担，各自记录延迟与命中
+    std::vector<std::vector<double>> latencies(threads);
+    std::vector<std::vector<ChangeStats>> stats(threads, std::vector<ChangeStats>((size_t)Change::Count));
+    begin = Clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (size_t i = t; i < queries.size(); i += threads) {
+                const Query& q = queries[i];
+                auto start = Clock::now();
+                std::vector<FingerprintIndex::Result> results = index.Query(q.fp);
+                latencies[t].push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+                ChangeStats& s = stats[t][(size_t)q.change];
+                ++s.queries;
+                if (q.change == Change::Foreign) s.hits += !results.empty();
+                else s.hits += !results.empty() && results[0].id == q.expected;
+            }
+        });
+    }
+    for (std::thread& w : workers) w.join();
+    double querySeconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    std::vector<double> all;
+    for (const std::vector<double>& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+
+    printf("stored %zu machines (%zu models), index built in %.0f ms\n",
+           stored, sizeof(kModels) / sizeof(kModels[0]), buildMs);
+    printf("%zu queries on %u thread(s): %.0f queries/s, p50 %.1f us, p99 %.1f us, max %.1f us\n",
+           queries.size(), threads, queries.size() / querySeconds,
+           Percentile(all, 0.50), Percentile(all, 0.99), all.back());
+    printf("\n%-8s %8s %10s\n", "change", "queries", "recall");
+    for (size_t c = 0; c < (size_t)Change::Count; ++c) {
+        ChangeStats total;
+        for (unsigned t = 0; t < threads; ++t) {
+            total.queries += stats[t][c].queries;
+            total.hits += stats[t][c].hits;
+        }
+        double rate = total.queries ? 100.0 * total.hits / total.queries : 0;
+        if ((Change)c == Change::Foreign) printf("%-8s %8u %9.2f%% false matches\n", kChangeNames[c], total.queries, rate);
+        else printf("%-8s %8u %9.2f%%\n", kChangeNames[c], total.queries, rate);
+    }
+    return 0;
+}
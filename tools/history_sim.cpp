@@ -0,0 +1,192 @@
+// history_sim - 快照历史（src/history.h）的模拟：三年每小时一帧的文件大小、追加耗时、任意时刻还原与崩溃恢复
+// 用法: history_sim [帧数=26280] [历史文件路径]
+//
+// 基准快照为本机采集结果外加 40 个合成 PCI 设备（使完整快照在各机器上都有约 20 KB）。
+// 模拟中空闲内存大多数小时都变化，BIOS 版本每 2000 帧变一次，每 5000 帧拔插一个 PCI 设备。
+// 追加完成后重新打开并做一次完整压缩，报告帧数与文件大小；随机 2000 个时刻 LoadAt，
+// 与追加时记录的期望状态比较。崩溃恢复：尾部写入半帧垃圾、截断到帧中间、残留上次压缩中断的临时文件，
+// 三种情况下重新打开都须恢复到最后一个完整帧并可继续追加与压缩。任一检查失败时返回 1。
+// 未指定路径时写到临时目录，结束后删除。
+
+#include "hardware.h"
+#include "history.h"
+#include <wx/init.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <random>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    namespace fs = std::filesystem;
+
+    const int64_t kStartTime = 1700000000;
+    const int64_t kStep = 3600;
+
+    int g_failures = 0;
+
+    void Check(bool ok, const char* what)
+    {
+        printf("  %-48s %s\n", what, ok ? "ok" : "FAIL");
+        if (!ok) ++g_failures;
+    }
+
+    HardwareSnapshot BaseSnapshot()
+    {
+        Hardware hw;
+        hw.GetInfo();
+        HardwareSnapshot base = hw;
+        for (int i = 0; i < 40; ++i) {
+            PciDevice device;
+            device.Address = wxString::Format("0000:%02x:00.0", i);
+            device.VendorId = 0x8086;
+            device.DeviceId = 0x1000 + i;
+            device.VendorName = "Intel Corporation";
+            device.DeviceName = "Some very long device name for a PCIe bridge controller";
+            device.ClassName = "Bridge";
+            base.PciDevices.push_back(device);
+        }
+        if (base.NumaNodes.empty()) {
+            NumaNode node;
+            node.Cpus = "0-3";
+            node.MemoryTotalMB = 16000;
+            base.NumaNodes.push_back(node);
+        }
+        return base;
+    }
+
+    double Ms(Clock::time_point begin)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    wxInitializer init;
+    if (!init.IsOk()) {
+        fprintf(stderr, "failed to initialize wxWidgets\n");
+        return 1;
+    }
+
+    int frames = argc > 1 ? atoi(argv[1]) : 26280;
+    if (frames <= 0) {
+        fprintf(stderr, "usage: %s [frames] [history-file]\n", argv[0]);
+        return 2;
+    }
+    bool temporary = argc <= 2;
+    std::string path = temporary
+        ? (fs::temp_directory_path() / ("history_sim_" + std::to_string(Clock::now().time_since_epoch().count()) + ".mth")).string()
+        : argv[2];
+    fs::remove(path);
+
+    HardwareSnapshot base = BaseSnapshot();
+    printf("full snapshot: %zu bytes\n", schema::ToBinary(base).size());
+
+    history::Store store;
+    std::string error;
+    if (!store.Open(path, &error)) {
+        fprintf(stderr, "open %s: %s\n", path.c_str(), error.c_str());
+        return 1;
+    }
+    {
+        history::Store second;
+        std::string secondError;
+        Check(!second.Open(path, &secondError), "second open of the same file is refused");
+    }
+
+    // ===== 追加 =====
+    std::mt19937 rng(1);
+    std::map<int64_t, long> expectFree;
+    std::map<int64_t, wxString> expectBios;
+    HardwareSnapshot snap = base;
+    auto begin = Clock::now();
+    for (int i = 0; i < frames; ++i) {
+        int64_t time = kStartTime + i * kStep;
+        if (rng() % 4) snap.NumaNodes[0].MemoryFreeMB = 8000 + rng() % 4000;
+        if (i % 2000 == 0) snap.BIOSVersion = wxString::Format("v%d", i);
+        if (i % 5000 == 2500) snap.PciDevices.pop_back();
+        if (i % 5000 == 3000) snap.PciDevices.push_back(base.PciDevices.back());
+        if (!store.Append(time, snap, &error)) {
+            fprintf(stderr, "append %d: %s\n", i, error.c_str());
+            return 1;
+        }
+        expectFree[time] = snap.NumaNodes[0].MemoryFreeMB;
+        expectBios[time] = snap.BIOSVersion;
+    }
+    double appendMs = Ms(begin);
+    store.Close();
+    store.Open(path, &error);
+    printf("appended %d frames in %.2f s (including background compaction): %zu frames, %llu KB\n",
+           frames, appendMs / 1e3, store.Count(), (unsigned long long)store.FileSize() / 1024);
+    int64_t end = kStartTime + (int64_t)frames * kStep;
+    bool compacted = store.Compact(end, &error);
+    printf("after final compaction: %zu frames, %llu KB\n", store.Count(), (unsigned long long)store.FileSize() / 1024);
+
+    // ===== 任意时刻还原 =====
+    int mismatches = 0;
+    double worstMs = 0;
+    for (int k = 0; k < 2000; ++k) {
+        int64_t time = kStartTime + (int64_t)(rng() % ((uint64_t)frames * kStep));
+        HardwareSnapshot out;
+        auto loadBegin = Clock::now();
+        bool loaded = store.LoadAt(time, &out);
+        worstMs = std::max(worstMs, Ms(loadBegin));
+        auto expected = --expectFree.upper_bound(time);
+        if (!loaded || out.NumaNodes.empty() || out.NumaNodes[0].MemoryFreeMB != expected->second ||
+            out.BIOSVersion != expectBios[expected->first] || out.PciDevices.size() < base.PciDevices.size() - 1) {
+            ++mismatches;
+        }
+    }
+    printf("2000 random LoadAt: %d mismatches, slowest %.2f ms\n\n", mismatches, worstMs);
+    Check(compacted, "final compaction succeeds");
+    Check(mismatches == 0, "LoadAt matches the appended state");
+    HardwareSnapshot before;
+    Check(!store.LoadAt(kStartTime - 1, &before), "LoadAt before the first frame fails");
+
+    // ===== 崩溃恢复 =====
+    uint64_t size = store.FileSize();
+    size_t count = store.Count();
+    store.Close();
+
+    // 追加到一半时崩溃：尾部是半帧
+    if (FILE* file = fopen(path.c_str(), "ab")) {
+        fwrite("garbage-xxxxxxxxxxxxxxxxxxxxxx", 1, 30, file);
+        fclose(file);
+    }
+    Check(store.Open(path, &error) && store.Count() == count && store.FileSize() == size,
+          "torn tail is dropped on open");
+    store.Close();
+
+    // 最后一帧只落盘了一部分
+    fs::resize_file(path, size - 5);
+    Check(store.Open(path, &error) && store.Count() == count - 1, "frame cut mid-payload is dropped on open");
+    HardwareSnapshot last;
+    Check(store.Load(store.Count() - 1, &last), "last complete frame loads");
+    Check(store.Append(end + 5, snap, &error), "append after recovery succeeds");
+    Check(store.Load(store.Count() - 1, &last) && schema::Diff(last, snap).empty(), "appended frame round-trips");
+    store.Close();
+
+    // 压缩写临时文件时崩溃：残留的临时文件不影响打开，下次压缩覆盖它
+    if (FILE* file = fopen((path + ".tmp").c_str(), "wb")) {
+        fwrite("MTH1partial", 1, 11, file);
+        fclose(file);
+    }
+    count = store.Open(path, &error) ? store.Count() : 0;
+    Check(count > 0, "open ignores a leftover compaction file");
+    Check(store.Compact(end + kStep, &error) && store.Count() <= count, "compaction over a leftover file succeeds");
+    Check(store.LoadAt(end + 5, &last) && schema::Diff(last, snap).empty(), "latest state survives compaction");
+    store.Close();
+
+    if (temporary) {
+        std::error_code ec;
+        fs::remove(path, ec);
+        fs::remove(path + ".tmp", ec);
+    }
+    printf("\n%s\n", g_failures ? "FAILED" : "all checks passed");
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,167 @@
+// impact_bench - 测量采集对同机业务延迟的影响（低影响模式的验收工具）
+// 用法: impact_bench [每阶段秒数=10] [业务线程数=CPU 数/2] [每线程每秒请求数=1000] [每请求计算 µs=100]
+//
+// 合成业务：若干线程按固定节拍（开环）发出请求，每个请求做固定量的计算；
+// 延迟从请求的计划开始时刻算到完成，排队等待也计入（避免协同遗漏）。
+// 依次运行三个阶段：不采集、连续普通采集、连续低影响采集，比较各阶段的延迟分位数。
+
+#include "hardware.h"
+#include "lowimpact.h"
+#include <wx/init.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Workload
+    {
+        unsigned workers = 1;
+        unsigned rate = 1000;             // 每线程每秒请求数
+        uint64_t iterationsPerRequest = 0;
+    };
+
+    struct PhaseResult
+    {
+        const char* name;
+        std::vector<uint32_t> latencyUs;  // 升序
+        unsigned collections = 0;
+        double collectMs = 0;             // 平均单次采集耗时
+    };
+
+    // 固定量的整数计算；返回值防止被优化掉
+    uint64_t Work(uint64_t iterations)
+    {
+        uint64_t x = 0x9e3779b97f4a7c15ULL;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+        }
+        return x;
+    }
+
+    // 空闲时每微秒的迭代次数，取多次中的最快一次
+    double Calibrate()
+    {
+        const uint64_t iterations = 2000000;
+        double best = 0;
+        for (int round = 0; round < 5; ++round) {
+            auto start = Clock::now();
+            volatile uint64_t sink = Work(iterations);
+            (void)sink;
+            double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+            if (us > 0) best = std::max(best, iterations / us);
+        }
+        return best;
+    }
+
+    void RunWorker(const Workload& load, Clock::time_point start, Clock::time_point end, std::vector<uint32_t>* out)
+    {
+        auto period = std::chrono::nanoseconds(1000000000LL / std::max(1u, load.rate));
+        volatile uint64_t sink = 0;
+        for (auto due = start; due < end; due += period) {
+            std::this_thread::sleep_until(due);
+            sink = sink + Work(load.iterationsPerRequest);
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - due).count();
+            out->push_back((uint32_t)std::min<long long>(us, UINT32_MAX));
+        }
+    }
+
+    // collect 为空时只运行业务（基线）
+    PhaseResult RunPhase(const char* name, const Workload& load, std::chrono::seconds duration,
+                         const CollectOptions* collect)
+    {
+        PhaseResult result{ name, {} };
+        std::stop_source stop;
+        std::thread collector;
+        std::atomic<unsigned> collections{0};
+        std::atomic<long long> collectUs{0};
+        if (collect) {
+            collector = std::thread([&] {
+                while (!stop.stop_requested()) {
+                    auto begin = Clock::now();
+                    Hardware hw = mt::SyncWait(Hardware::CollectAsync(Hardware::SharedPool(), stop.get_token(), *collect));
+                    if (stop.stop_requested()) break;
+                    collectUs += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - begin).count();
+                    ++collections;
+                }
+            });
+        }
+
+        auto start = Clock::now() + std::chrono::milliseconds(100);
+        auto end = start + duration;
+        std::vector<std::vector<uint32_t>> samples(load.workers);
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < load.workers; ++i) {
+            workers.emplace_back(RunWorker, std::cref(load), start, end, &samples[i]);
+        }
+        for (std::thread& t : workers) t.join();
+        stop.request_stop();
+        if (collector.joinable()) collector.join();
+
+        for (const std::vector<uint32_t>& s : samples) result.latencyUs.insert(result.latencyUs.end(), s.begin(), s.end());
+        std::sort(result.latencyUs.begin(), result.latencyUs.end());
+        result.collections = collections;
+        result.collectMs = collections ? collectUs / 1000.0 / collections : 0;
+        return result;
+    }
+
+    uint32_t Percentile(const std::vector<uint32_t>& sorted, double p)
+    {
+        if (sorted.empty()) return 0;
+        size_t index = (size_t)(p * sorted.size());
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+}
+
+int main(int argc, char** argv)
+{
+    wxInitializer init;
+    if (!init.IsOk()) {
+        fprintf(stderr, "failed to initialize wxWidgets\n");
+        return 1;
+    }
+
+    unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+    std::chrono::seconds duration(argc > 1 ? atoi(argv[1]) : 10);
+    Workload load;
+    load.workers = argc > 2 ? (unsigned)atoi(argv[2]) : std::max(1u, cpus / 2);
+    load.rate = argc > 3 ? (unsigned)atoi(argv[3]) : 1000;
+    unsigned workUs = argc > 4 ? (unsigned)atoi(argv[4]) : 100;
+    if (duration.count() <= 0 || load.workers == 0 || load.rate == 0) {
+        fprintf(stderr, "usage: %s [seconds-per-phase] [workers] [requests-per-second] [work-us]\n", argv[0]);
+        return 2;
+    }
+    load.iterationsPerRequest = (uint64_t)(Calibrate() * workUs);
+
+    std::vector<int> housekeeping = lowimpact::HousekeepingCpus();
+    std::string cpuList;
+    for (int cpu : housekeeping) cpuList += (cpuList.empty() ? "" : ",") + std::to_string(cpu);
+    printf("workload: %u threads x %u req/s, %u us per request; housekeeping cpus: %s\n",
+           load.workers, load.rate, workUs, cpuList.empty() ? "(none)" : cpuList.c_str());
+
+    CollectOptions normal;
+    CollectOptions lowImpact;
+    lowImpact.LowImpact = true;
+
+    std::vector<PhaseResult> results;
+    results.push_back(RunPhase("baseline", load, duration, nullptr));
+    results.push_back(RunPhase("normal", load, duration, &normal));
+    results.push_back(RunPhase("low-impact", load, duration, &lowImpact));
+
+    printf("\n%-11s %9s %8s %8s %9s %8s %12s %10s %11s\n",
+           "phase", "requests", "p50 us", "p99 us", "p99.9 us", "max us", "collections", "avg ms", "p99 delta");
+    uint32_t baseP99 = Percentile(results[0].latencyUs, 0.99);
+    for (const PhaseResult& r : results) {
+        uint32_t p99 = Percentile(r.latencyUs, 0.99);
+        printf("%-11s %9zu %8u %8u %9u %8u %12u %10.1f %+10ld\n", r.name, r.latencyUs.size(),
+               Percentile(r.latencyUs, 0.50), p99, Percentile(r.latencyUs, 0.999),
+               r.latencyUs.empty() ? 0u : r.latencyUs.back(), r.collections, r.collectMs, (long)p99 - (long)baseP99);
+    }
+    return 0;
+}
@@ -0,0 +1,225 @@
+// ipc_bench - 守护进程 IPC 的流水线吞吐测试（验收目标：本机回环 100k 请求/秒）
+// 用法: ipc_bench [连接数=4] [流水线深度=64] [每轮秒数=5] [端点]
+//
+// 未指定端点时在进程内启动一个守护进程（私有端点与共享内存名，不影响已在运行的实例），
+// 等首次采集完成后开始测量；指定端点时连接已运行的 mini_tool --daemon。
+// 每个连接一个线程，保持深度个请求在途：先发满，之后每收到一半就补发一半并一次写出。
+// 请求轮流为 OpGetField("CPUName")、OpGetFingerprint、OpGetGeneration。
+// 先以深度 1（逐个往返）跑一轮作对照，再以指定深度跑一轮；延迟从请求写入发送缓冲算到收到响应。
+
+#include "daemon.h"
+#include "ipc.h"
+#include <wx/init.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    const double kTargetQps = 100000;
+
+    struct Request
+    {
+        uint8_t op;
+        const char* payload;
+    };
+
+    const Request kMix[] = {
+        { ipc::OpGetField, "CPUName" },
+        { ipc::OpGetFingerprint, "" },
+        { ipc::OpGetGeneration, "" },
+    };
+
+    struct RoundResult
+    {
+        std::vector<float> latencyUs;   // 升序
+        double seconds = 0;
+        unsigned long long errors = 0;  // 非 StatusOk 的响应
+        bool failed = false;            // 连接失败或中途断开
+    };
+
+    struct WorkerResult
+    {
+        std::vector<float> latencyUs;
+        unsigned long long errors = 0;
+        bool failed = false;
+    };
+
+    void RunConnection(const std::string& endpoint, unsigned depth, const std::atomic<bool>& stop, WorkerResult* out)
+    {
+        ipc::Client client;
+        if (!client.Connect(endpoint)) {
+            out->failed = true;
+            return;
+        }
+
+        std::deque<Clock::time_point> inFlight;   // 响应按请求顺序返回
+        size_t next = 0;
+        auto issue = [&](unsigned count) {
+            for (unsigned i = 0; i < count; ++i) {
+                const Request& r = kMix[next++ % (sizeof(kMix) / sizeof(kMix[0]))];
+                client.Send(r.op, r.payload);
+                inFlight.push_back(Clock::now());
+            }
+            return client.Flush();
+        };
+        auto receive = [&]() {
+            ipc::Frame frame;
+            if (!client.Receive(&frame)) return false;
+            auto now = Clock::now();
+            out->latencyUs.push_back(std::chrono::duration<float, std::micro>(now - inFlight.front()).count());
+            inFlight.pop_front();
+            if (frame.status != ipc::StatusOk) ++out->errors;
+            return true;
+        };
+
+        unsigned refill = std::max(1u, depth / 2);
+        if (!issue(depth)) {
+            out->failed = true;
+            return;
+        }
+        while (!stop.load(std::memory_order_relaxed)) {
+            for (unsigned i = 0; i < refill; ++i) {
+                if (!receive()) {
+                    out->failed = true;
+                    return;
+                }
+            }
+            if (!issue(refill)) {
+                out->failed = true;
+                return;
+            }
+        }
+        while (!inFlight.empty()) {
+            if (!receive()) {
+                out->failed = true;
+                return;
+            }
+        }
+    }
+
+    RoundResult RunRound(const std::string& endpoint, unsigned connections, unsigned depth, std::chrono::seconds duration)
+    {
+        RoundResult result;
+        std::atomic<bool> stop{false};
+        std::vector<WorkerResult> workers(connections);
+        std::vector<std::thread> threads;
+
+        auto start = Clock::now();
+        for (unsigned i = 0; i < connections; ++i) {
+            threads.emplace_back(RunConnection, std::cref(endpoint), depth, std::cref(stop), &workers[i]);
+        }
+        std::this_thread::sleep_for(duration);
+        stop = true;
+        for (std::thread& t : threads) t.join();
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        for (const WorkerResult& w : workers) {
+            result.latencyUs.insert(result.latencyUs.end(), w.latencyUs.begin(), w.latencyUs.end());
+            result.errors += w.errors;
+            result.failed = result.failed || w.failed;
+        }
+        std::sort(result.latencyUs.begin(), result.latencyUs.end());
+        return result;
+    }
+
+    float Percentile(const std::vector<float>& sorted, double p)
+    {
+        if (sorted.empty()) return 0;
+        size_t index = (size_t)(p * sorted.size());
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    // 首次采集完成前守护进程回复 StatusUnavailable
+    bool WaitReady(const std::string& endpoint, std::chrono::seconds timeout)
+    {
+        auto deadline = Clock::now() + timeout;
+        while (Clock::now() < deadline) {
+            ipc::Client client;
+            ipc::Frame frame;
+            if (client.Connect(endpoint) && client.Call(ipc::OpGetGeneration, std::string(), &frame) &&
+                frame.status == ipc::StatusOk) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        return false;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    wxInitializer init;
+    if (!init.IsOk()) {
+        fprintf(stderr, "failed to initialize wxWidgets\n");
+        return 1;
+    }
+
+    unsigned connections = argc > 1 ? (unsigned)atoi(argv[1]) : 4;
+    unsigned depth = argc > 2 ? (unsigned)atoi(argv[2]) : 64;
+    std::chrono::seconds duration(argc > 3 ? atoi(argv[3]) : 5);
+    if (connections == 0 || depth == 0 || duration.count() <= 0) {
+        fprintf(stderr, "usage: %s [connections] [pipeline-depth] [seconds-per-round] [endpoint]\n", argv[0]);
+        return 2;
+    }
+
+    std::unique_ptr<Daemon> daemon;
+    std::thread daemonThread;
+    std::string endpoint;
+    if (argc > 4) {
+        endpoint = argv[4];
+    } else {
+        DaemonOptions options;
+        options.endpoint = ipc::DefaultEndpoint() + "_bench";
+        options.sharedName = ipc::DefaultSharedName() + "_bench";
+        options.refreshInterval = std::chrono::hours(24);   // 测量期间不重新采集
+        daemon = std::make_unique<Daemon>(options);
+        std::string error;
+        if (!daemon->Start(&error)) {
+            fprintf(stderr, "failed to start daemon: %s\n", error.c_str());
+            return 1;
+        }
+        daemonThread = std::thread([&] { daemon->Run(); });
+        endpoint = options.endpoint;
+    }
+
+    int exitCode = 0;
+    if (!WaitReady(endpoint, std::chrono::seconds(60))) {
+        fprintf(stderr, "daemon at %s not ready\n", endpoint.c_str());
+        exitCode = 1;
+    } else {
+        printf("endpoint %s%s, %u connection(s)\n", endpoint.c_str(), daemon ? " (in-process daemon)" : "", connections);
+        printf("\n%6s %12s %9s %9s %9s %9s %8s\n", "depth", "requests/s", "p50 us", "p99 us", "p99.9 us", "max us", "errors");
+        double pipelinedQps = 0;
+        for (unsigned d : { 1u, depth }) {
+            RoundResult r = RunRound(endpoint, connections, d, duration);
+            if (r.failed) {
+                fprintf(stderr, "connection failed at depth %u\n", d);
+                exitCode = 1;
+                break;
+            }
+            double qps = r.latencyUs.size() / r.seconds;
+            printf("%6u %12.0f %9.1f %9.1f %9.1f %9.1f %8llu\n", d, qps,
+                   Percentile(r.latencyUs, 0.50), Percentile(r.latencyUs, 0.99), Percentile(r.latencyUs, 0.999),
+                   r.latencyUs.empty() ? 0.0f : r.latencyUs.back(), r.errors);
+            pipelinedQps = qps;
+            if (d == depth) break;
+        }
+        if (exitCode == 0) {
+            printf("\ntarget %.0f requests/s: %s\n", kTargetQps, pipelinedQps >= kTargetQps ? "met" : "NOT met");
+        }
+    }
+
+    if (daemon) {
+        daemon->RequestStop();
+        daemonThread.join();
+    }
+    return exitCode;
+}
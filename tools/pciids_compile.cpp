@@ -0,0 +1,36 @@
+// pciids_compile - 构建期工具：把 pci.ids 编译为 pci_ids.idx（格式见 src/pciids.h）
+// 用法: pciids_compile <pci.ids> <pci_ids.idx>
+
+#include "pciids.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+int main(int argc, char** argv)
+{
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <pci.ids> <pci_ids.idx>\n", argv[0]);
+        return 2;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in) {
+        fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+
+    std::string index, error;
+    if (!pciids::BuildIndex(text.str(), &index, &error)) {
+        fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+        return 1;
+    }
+
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    if (!out.write(index.data(), (std::streamsize)index.size())) {
+        fprintf(stderr, "cannot write %s\n", argv[2]);
+        return 1;
+    }
+    return 0;
+}
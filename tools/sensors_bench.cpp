@@ -0,0 +1,199 @@
+// sensors_bench - 传感器采样开销测试（验收场景：200 个传感器、10 Hz）
+// 用法: sensors_bench [传感器数=200] [采样频率 Hz=10] [采样秒数=10] [hwmon 目录]
+//
+// 未指定目录时在临时目录下生成伪造的 hwmon 树：每个芯片 20 个输入（温度、风扇、电压），
+// 带 name 与部分 *_label，测完删除。伪造树在普通文件系统上，pread 比 sysfs 便宜，
+// 结果是采样器自身开销（系统调用次数、解析、统计）的下限；指向 /sys/class/hwmon 可测真实驱动。
+// 先单独计时 SampleOnce，并与每次重新 open/read/close 的做法对照；
+// 再以后台线程按频率采样，报告进程 CPU 占比与实际达到的采样频率。Windows 上忽略目录，读 PDH 热区。
+
+#include "sensors.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/resource.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    namespace fs = std::filesystem;
+
+    const size_t kInputsPerChip = 20;
+
+    double ProcessCpuSeconds()
+    {
+#ifdef _WIN32
+        FILETIME creation, exit, kernel, user;
+        if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) return 0;
+        auto value = [](const FILETIME& t) { return ((uint64_t)t.dwHighDateTime << 32 | t.dwLowDateTime) / 1e7; };
+        return value(kernel) + value(user);
+#else
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+        auto value = [](const timeval& t) { return t.tv_sec + t.tv_usec / 1e6; };
+        return value(usage.ru_utime) + value(usage.ru_stime);
+#endif
+    }
+
+    void WriteText(const fs::path& path, const std::string& text)
+    {
+        std::ofstream(path) << text << '\n';
+    }
+
+    // 每个芯片 8 个温度、6 个风扇、6 个电压；前两个温度带 label
+    void BuildFakeTree(const fs::path& root, size_t sensors)
+    {
+        fs::create_directories(root);
+        for (size_t chip = 0; chip * kInputsPerChip < sensors; ++chip) {
+            fs::path dir = root / ("hwmon" + std::to_string(chip));
+            fs::create_directory(dir);
+            WriteText(dir / "name", "fakechip" + std::to_string(chip));
+            size_t count = std::min(kInputsPerChip, sensors - chip * kInputsPerChip);
+            for (size_t i = 0; i < count; ++i) {
+                if (i < 8) {
+                    WriteText(dir / ("temp" + std::to_string(i + 1) + "_input"), std::to_string(40000 + 500 * i));
+                    if (i < 2) WriteText(dir / ("temp" + std::to_string(i + 1) + "_label"), "Core " + std::to_string(i));
+                } else if (i < 14) {
+                    WriteText(dir / ("fan" + std::to_string(i - 7) + "_input"), std::to_string(900 + 10 * i));
+                } else {
+                    WriteText(dir / ("in" + std::to_string(i - 14) + "_input"), std::to_string(1000 + 7 * i));
+                }
+            }
+        }
+    }
+
+    // 对照：每次采样都按路径重新打开每个输入
+    std::vector<std::string> InputPaths(const fs::path& root)
+    {
+        std::vector<std::string> paths;
+        std::error_code ec;
+        for (const fs::directory_entry& chip : fs::directory_iterator(root, ec)) {
+            for (const fs::directory_entry& file : fs::directory_iterator(chip.path(), ec)) {
+                std::string name = file.path().filename().string();
+                if (name.size() > 6 && name.compare(name.size() - 6, 6, "_input") == 0) paths.push_back(file.path().string());
+            }
+        }
+        return paths;
+    }
+
+    double ReopenOnce(const std::vector<std::string>& paths)
+    {
+        double sum = 0;
+        char buf[32];
+        for (const std::string& path : paths) {
+#ifdef _WIN32
+            FILE* f = fopen(path.c_str(), "rb");
+            if (!f) continue;
+            size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+            fclose(f);
+#else
+            int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) continue;
+            ssize_t n = read(fd, buf, sizeof(buf) - 1);
+            close(fd);
+            if (n < 0) continue;
+#endif
+            buf[n] = 0;
+            sum += strtod(buf, nullptr);
+        }
+        return sum;
+    }
+
+    template <typename Fn>
+    std::vector<double> TimeCalls(int count, Fn&& fn)
+    {
+        std::vector<double> us;
+        us.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            auto begin = Clock::now();
+            fn();
+            us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - begin).count());
+        }
+        std::sort(us.begin(), us.end());
+        return us;
+    }
+
+    double Percentile(const std::vector<double>& sorted, double p)
+    {
+        if (sorted.empty()) return 0;
+        size_t index = (size_t)(p * sorted.size());
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t sensorCount = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200;
+    unsigned hz = argc > 2 ? (unsigned)atoi(argv[2]) : 10;
+    int seconds = argc > 3 ? atoi(argv[3]) : 10;
+    if (sensorCount == 0 || hz == 0 || hz > 1000 || seconds <= 0) {
+        fprintf(stderr, "usage: %s [sensors] [hz] [seconds] [hwmon-root]\n", argv[0]);
+        return 2;
+    }
+
+    fs::path root;
+    bool fake = argc <= 4;
+    if (fake) {
+        std::error_code ec;
+        root = fs::temp_directory_path(ec) / ("sensors_bench_" + std::to_string((unsigned long long)Clock::now().time_since_epoch().count()));
+        BuildFakeTree(root, sensorCount);
+    } else {
+        root = argv[4];
+    }
+
+    int exitCode = 0;
+    {
+        sensors::Sampler sampler(root.string());
+        size_t found = sampler.Discover();
+        printf("%s %s: %zu sensors\n", fake ? "fake hwmon tree" : "hwmon root", root.string().c_str(), found);
+        if (found == 0) {
+            fprintf(stderr, "no sensors found\n");
+            exitCode = 1;
+        } else {
+            // 单次采样耗时：保持描述符的 pread 与每次重新打开对照
+            const int calls = 2000;
+            std::vector<double> held = TimeCalls(calls, [&] { sampler.SampleOnce(); });
+            std::vector<std::string> paths = InputPaths(root);
+            volatile double sink = 0;
+            std::vector<double> reopen = TimeCalls(calls, [&] { sink = sink + ReopenOnce(paths); });
+            printf("\n%-16s %9s %9s %9s\n", "per sample", "p50 us", "p99 us", "max us");
+            printf("%-16s %9.1f %9.1f %9.1f\n", "held fds", Percentile(held, 0.50), Percentile(held, 0.99), held.back());
+            if (!paths.empty()) {
+                printf("%-16s %9.1f %9.1f %9.1f   (%zu inputs)\n", "reopen each", Percentile(reopen, 0.50),
+                       Percentile(reopen, 0.99), reopen.back(), paths.size());
+            }
+
+            // 后台按频率采样，本线程只睡眠：进程 CPU 时间即采样开销
+            sampler.Reset();
+            double cpuBegin = ProcessCpuSeconds();
+            auto begin = Clock::now();
+            sampler.Start(std::chrono::milliseconds(1000 / hz));
+            std::this_thread::sleep_for(std::chrono::seconds(seconds));
+            sampler.Stop();
+            double wall = std::chrono::duration<double>(Clock::now() - begin).count();
+            double cpu = ProcessCpuSeconds() - cpuBegin;
+            uint64_t samples = sampler.Snapshot()[0].samples;
+            printf("\nbackground %u Hz for %.1f s: %llu samples (%.2f Hz), cpu %.1f ms total, %.3f%% of one core, %.1f us per sample\n",
+                   hz, wall, (unsigned long long)samples, samples / wall, cpu * 1e3, 100.0 * cpu / wall,
+                   samples ? cpu * 1e6 / samples : 0.0);
+        }
+    }
+
+    if (fake) {
+        std::error_code ec;
+        fs::remove_all(root, ec);
+    }
+    return exitCode;
+}
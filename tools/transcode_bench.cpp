@@ -0,0 +1,209 @@
+// transcode_bench - 转码层（src/transcode.h）的正确性检查与吞吐测试，不依赖 Windows 与 wxWidgets
+// 用法: transcode_bench [每项秒数=1]
+//
+// 检查：随机码点（含代理对、长 ASCII 段以覆盖 SIMD 快速路径的边界）按参考编码器生成 UTF-16 与 UTF-8，
+// 两个方向的转换须与之逐字节一致；孤立代理项、超长编码、截断与越界序列须替换为 U+FFFD；
+// FormatDecimal 须与 snprintf("%llu") 一致。任一不符时返回 1。
+// 吞吐：ASCII、中文、混合三类文本，短串（64 字符，注册表值的典型长度）与长串（64 K 字符）两个方向。
+
+#include "transcode.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // ===== 参考实现：逐码点，不做任何优化 =====
+    void AppendUtf16(std::u16string& out, uint32_t cp)
+    {
+        if (cp < 0x10000) {
+            out.push_back((char16_t)cp);
+        } else {
+            cp -= 0x10000;
+            out.push_back((char16_t)(0xD800 + (cp >> 10)));
+            out.push_back((char16_t)(0xDC00 + (cp & 0x3FF)));
+        }
+    }
+
+    void AppendUtf8(std::string& out, uint32_t cp)
+    {
+        if (cp < 0x80) {
+            out.push_back((char)cp);
+        } else if (cp < 0x800) {
+            out.push_back((char)(0xC0 | (cp >> 6)));
+            out.push_back((char)(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back((char)(0xE0 | (cp >> 12)));
+            out.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back((char)(0xF0 | (cp >> 18)));
+            out.push_back((char)(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    std::string ToUtf8(const std::u16string& s)
+    {
+        std::string out(transcode::MaxUtf8Length(s.size()), '\0');
+        out.resize(transcode::Utf16ToUtf8(s.data(), s.size(), &out[0]));
+        return out;
+    }
+
+    std::u16string ToUtf16(const std::string& s)
+    {
+        std::u16string out(transcode::MaxUtf16Length(s.size()), u'\0');
+        out.resize(transcode::Utf8ToUtf16(s.data(), s.size(), &out[0]));
+        return out;
+    }
+
+    // 随机码点：多数落在 ASCII 段里，其余覆盖 2/3/4 字节编码
+    uint32_t RandomCodePoint(std::mt19937& rng)
+    {
+        switch (rng() % 8) {
+            case 0: return 0x80 + rng() % (0x800 - 0x80);
+            case 1: {
+                uint32_t cp = 0x800 + rng() % (0x10000 - 0x800);
+                return (cp >= 0xD800 && cp <= 0xDFFF) ? 0x4E2D : cp;
+            }
+            case 2: return 0x10000 + rng() % (0x110000 - 0x10000);
+            default: return 0x20 + rng() % 0x5F;
+        }
+    }
+
+    int g_failures = 0;
+
+    void Fail(const char* what, size_t index)
+    {
+        if (++g_failures <= 10) fprintf(stderr, "FAIL %s (case %zu)\n", what, index);
+    }
+
+    void CheckRoundTrip()
+    {
+        std::mt19937 rng(12345);
+        for (size_t n = 0; n < 20000; ++n) {
+            std::u16string utf16;
+            std::string utf8;
+            size_t count = rng() % 80;
+            for (size_t i = 0; i < count; ++i) {
+                uint32_t cp = RandomCodePoint(rng);
+                AppendUtf16(utf16, cp);
+                AppendUtf8(utf8, cp);
+            }
+            if (ToUtf8(utf16) != utf8) Fail("utf16 -> utf8", n);
+            if (ToUtf16(utf8) != utf16) Fail("utf8 -> utf16", n);
+        }
+    }
+
+    void CheckInvalid()
+    {
+        const std::u16string r(1, (char16_t)0xFFFD);
+        struct Utf8Case { const char* bytes; std::u16string expected; };
+        const Utf8Case utf8Cases[] = {
+            { "\xC0\x80", r },               // 超长编码
+            { "\xED\xA0\x80", r },           // 编码后的代理项
+            { "\xF4\x90\x80\x80", r },       // 超出 U+10FFFF
+            { "\x80", r },                   // 孤立续字节
+            { "\xE4\xB8", r },               // 结尾截断
+            { "\xE4" "A", r + u"A" },        // 中途遇到非续字节：只消费首字节
+        };
+        for (size_t i = 0; i < sizeof(utf8Cases) / sizeof(utf8Cases[0]); ++i) {
+            if (ToUtf16(utf8Cases[i].bytes) != utf8Cases[i].expected) Fail("invalid utf8", i);
+        }
+
+        const std::string replacement = "\xEF\xBF\xBD";
+        struct Utf16Case { std::u16string units; std::string expected; };
+        const Utf16Case utf16Cases[] = {
+            { std::u16string(1, (char16_t)0xD800), replacement },                       // 结尾的高代理
+            { std::u16string(1, (char16_t)0xDC00) + u"A", replacement + "A" },          // 孤立低代理
+            { std::u16string(1, (char16_t)0xD800) + u"A", replacement + "A" },          // 高代理后不是低代理
+        };
+        for (size_t i = 0; i < sizeof(utf16Cases) / sizeof(utf16Cases[0]); ++i) {
+            if (ToUtf8(utf16Cases[i].units) != utf16Cases[i].expected) Fail("invalid utf16", i);
+        }
+    }
+
+    void CheckDecimal()
+    {
+        std::mt19937_64 rng(6789);
+        std::vector<unsigned long long> values = { 0, 1, 9, 10, 99, 100, 4294967295ULL, 4294967296ULL, ~0ULL };
+        for (int i = 0; i < 10000; ++i) values.push_back(rng() >> (rng() % 64));
+        for (size_t i = 0; i < values.size(); ++i) {
+            char expected[32], actual[transcode::kMaxDecimalLength];
+            int n = snprintf(expected, sizeof(expected), "%llu", values[i]);
+            size_t m = transcode::FormatDecimal(values[i], actual);
+            if ((size_t)n != m || memcmp(expected, actual, m) != 0) Fail("FormatDecimal", i);
+        }
+    }
+
+    // ===== 吞吐 =====
+    std::u16string MakeText(const char* kind, size_t units)
+    {
+        std::mt19937 rng(42);
+        std::u16string s;
+        while (s.size() < units) {
+            uint32_t cp;
+            if (strcmp(kind, "ascii") == 0) cp = 0x20 + rng() % 0x5F;
+            else if (strcmp(kind, "chinese") == 0) cp = 0x4E00 + rng() % 0x5000;
+            else cp = rng() % 4 ? 0x20 + rng() % 0x5F : 0x4E00 + rng() % 0x5000;
+            AppendUtf16(s, cp);
+        }
+        s.resize(units);
+        return s;
+    }
+
+    // 在 seconds 内反复转换，返回每秒处理的输入码元数（百万）
+    template <typename Fn>
+    double Rate(double seconds, size_t unitsPerCall, Fn&& fn)
+    {
+        size_t calls = 0;
+        auto begin = Clock::now();
+        double elapsed = 0;
+        while (elapsed < seconds) {
+            for (int i = 0; i < 64; ++i) fn();
+            calls += 64;
+            elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+        }
+        return (double)calls * unitsPerCall / elapsed / 1e6;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 1.0;
+    if (seconds <= 0) {
+        fprintf(stderr, "usage: %s [seconds-per-case]\n", argv[0]);
+        return 2;
+    }
+
+    CheckRoundTrip();
+    CheckInvalid();
+    CheckDecimal();
+    printf("checks: %s\n", g_failures ? "FAILED" : "ok");
+
+    printf("\n%-8s %8s %16s %16s\n", "text", "units", "utf16->8 Mu/s", "utf8->16 Mu/s");
+    volatile size_t sink = 0;
+    for (const char* kind : { "ascii", "chinese", "mixed" }) {
+        for (size_t units : { (size_t)64, (size_t)65536 }) {
+            std::u16string utf16 = MakeText(kind, units);
+            std::string utf8 = ToUtf8(utf16);
+            std::vector<char> out8(transcode::MaxUtf8Length(utf16.size()));
+            std::vector<char16_t> out16(transcode::MaxUtf16Length(utf8.size()));
+            double to8 = Rate(seconds, utf16.size(), [&] {
+                sink = sink + transcode::Utf16ToUtf8(utf16.data(), utf16.size(), out8.data());
+            });
+            double to16 = Rate(seconds, utf8.size(), [&] {
+                sink = sink + transcode::Utf8ToUtf16(utf8.data(), utf8.size(), out16.data());
+            });
+            printf("%-8s %8zu %16.0f %16.0f\n", kind, units, to8, to16);
+        }
+    }
+    return g_failures ? 1 : 0;
+}